@@ -8,6 +8,7 @@ namespace dnn {
     public:
         AudioUnit() {
             active_features_.resize(384, 0.0);
+            publish(active_features_);
         }
 
         std::string name() const override { return "Auditory Cortex (Audio)"; }
@@ -24,6 +25,7 @@ namespace dnn {
             
             if (raw_data.empty()) {
                 std::fill(active_features_.begin(), active_features_.end(), 0.0);
+                publish(active_features_);
                 return active_features_;
             }
 
@@ -38,6 +40,7 @@ namespace dnn {
                 active_features_[i] = (0.7 * dis(gen) + 0.3 * data_hint) * balance;
             }
 
+            publish(active_features_);
             return active_features_;
         }
 
@@ -0,0 +1,85 @@
+#pragma once
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <cstdint>
+#include "dnn.hpp"
+
+namespace dnn {
+
+    /**
+     * Applies online plasticity off the response path.
+     *
+     * Producers submit (network, input, target, rate) records to a bounded
+     * queue and return immediately. A single learner thread drains the queue,
+     * discards records older than the staleness bound, groups the rest by
+     * network and rate, and trains each group as mini-batches while holding
+     * the model mutex (the same lock inference takes). When the queue is full
+     * the oldest record is dropped, or, with drop_when_full = false, the
+     * producer waits for room.
+     */
+    class BackgroundLearner {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        struct Options {
+            std::size_t capacity = 256;                        // Queued records
+            std::size_t max_batch = 32;                        // Records per train() call
+            std::chrono::milliseconds max_staleness{5000};     // Older records are skipped; 0: no bound
+            bool drop_when_full = true;                        // false: submit() blocks
+        };
+
+        struct Stats {
+            std::uint64_t submitted = 0;
+            std::uint64_t applied = 0;
+            std::uint64_t dropped_overload = 0;
+            std::uint64_t dropped_stale = 0;
+            std::uint64_t batches = 0;
+            std::size_t queue_depth = 0;
+            std::size_t max_queue_depth = 0;
+        };
+
+        BackgroundLearner(std::recursive_mutex& model_mutex, Options options);
+        ~BackgroundLearner(); // stop()
+
+        BackgroundLearner(const BackgroundLearner&) = delete;
+        BackgroundLearner& operator=(const BackgroundLearner&) = delete;
+
+        // False once stopped (the record is discarded).
+        bool submit(NeuralNetwork* network, std::vector<double> input, std::vector<double> target, double rate);
+        void flush(); // Wait until everything submitted so far is applied or dropped
+        void stop();  // Drain the queue and join the thread
+
+        Stats stats() const;
+        const Options& options() const { return options_; }
+
+    private:
+        struct Record {
+            NeuralNetwork* network;
+            std::vector<double> input;
+            std::vector<double> target;
+            double rate;
+            Clock::time_point queued;
+        };
+
+        void run();
+        void apply(std::vector<Record>& work);
+
+        std::recursive_mutex& model_mutex_;
+        Options options_;
+
+        mutable std::mutex mutex_;
+        std::condition_variable work_cv_;
+        std::condition_variable space_cv_;
+        std::condition_variable idle_cv_;
+        std::deque<Record> queue_;
+        bool busy_ = false;
+        bool stopping_ = false;
+        Stats stats_;
+        std::thread thread_;
+    };
+
+} // namespace dnn
@@ -8,6 +8,7 @@
 #include <map>
 #include "task_manager.hpp"
 #include "redis_client.hpp"
+#include "recall_cache.hpp"
 #include "planning_unit.hpp"
 #include "metacognition.hpp"
 #include "tool_registry.hpp"
@@ -27,14 +28,25 @@
 #include <thread>
 #include <chrono>
 #include <deque>
+#include <span>
 #include <atomic>
 #include <mutex>
 #include <map>
 #include <filesystem>
 #include <fstream>
 #include <unordered_set>
+#include <future>
+#include <array>
+#include <cstdint>
 #include "cognitive_core.hpp"
 #include "skill_manager.hpp"
+#include "snapshot_writer.hpp"
+#include "embedding_store.hpp"
+#include "scheduler.hpp"
+#include "state_publisher.hpp"
+#include "background_learner.hpp"
+#include "event_bus.hpp"
+#include "response_cache.hpp"
 
 
 // Simple thread-safe logger
@@ -87,6 +99,95 @@ struct UserModel {
     std::deque<std::string> intent_history;
 };
 
+// Point-in-time copy of everything Brain::save persists. Captured under
+// brain_mutex, then serialised without it so chat keeps responding.
+struct BrainSnapshot {
+    Personality personality;
+    Emotions emotions;
+    std::map<size_t, std::string> vocab_decode;
+    std::vector<dnn::NeuralNetwork> regions; // encoder, decoder, memory, cognitive
+    std::map<std::string, std::vector<Reflex::WeightedResponse>> instincts;
+    uint64_t checkpoint_epoch = 0; // Non-zero: base of a delta chain (written as a trailer)
+};
+
+// Wall-clock breakdown of Brain::Brain(). Phases marked parallel ran on the
+// startup pool and overlap, so their sum can exceed total_ms.
+struct StartupReport {
+    struct Phase {
+        std::string name;
+        double ms = 0.0;
+        bool parallel = false;
+    };
+    std::vector<Phase> phases;
+    std::vector<std::string> deferred; // Built on first use instead of at startup
+    double total_ms = 0.0;
+
+    std::string to_string() const;
+};
+
+// Curriculum teaching (Brain::teach_batch). Decoder training runs epochs
+// of mini-batches; progress is reported after each epoch.
+struct TeachProgress {
+    int epoch = 0;
+    int epochs = 0;
+    size_t pairs = 0;
+    double loss = 0.0;          // Decoder MSE over the epoch
+    double elapsed_ms = 0.0;
+    double pairs_per_sec = 0.0; // Pair-epochs trained per second so far
+};
+
+struct TeachOptions {
+    int epochs = 5;
+    int batch_size = 32;
+    double learning_rate = 0.1;
+    double reinforce_rate = 0.05;                         // Hebbian pass over the encoder path
+    double time_budget_ms = 0.0;                          // No new batch starts past this (0: no limit)
+    std::function<void(const TeachProgress&)> on_progress; // Default: one log line per epoch
+};
+
+struct TeachReport {
+    size_t pairs = 0;
+    int epochs = 0;
+    double vectorise_ms = 0.0;
+    double forward_ms = 0.0;
+    double train_ms = 0.0;
+    double total_ms = 0.0;
+    double pairs_per_sec = 0.0;
+    double final_loss = 0.0;
+    bool budget_exhausted = false; // pairs/epochs are what fit in time_budget_ms
+
+    std::string to_string() const;
+};
+
+// REM replay (Brain::perform_rem_cycle): during sleep a random sample of past
+// interactions is re-taught through teach_batch within a wall-clock budget.
+// Sources are the learned-interactions journal, the current conversation,
+// response-cache hits (BRAIN_RESPONSE_CACHE_LEARN=1) and the most recent
+// stored memories (replayed auto-associatively).
+struct ReplayOptions {
+    size_t samples = 128;
+    int recent_memories = 32;
+    std::string journal_path = "state/learned_interactions.txt"; // Not read when headless
+    TeachOptions teach = {2, 16, 0.05, 0.01, 2000.0, nullptr};
+};
+
+struct ReplayReport {
+    size_t journal_pairs = 0;      // Candidates seen per source
+    size_t conversation_pairs = 0;
+    size_t cache_hit_pairs = 0;    // Response-cache hits awaiting learning
+    size_t memory_pairs = 0;
+    TeachReport teach;             // teach.pairs were replayed
+
+    std::string to_string() const;
+};
+
+// Construction options. A headless brain runs on a VirtualClock with a manual
+// scheduler (see BrainSimulation) and has no outside side effects: no network
+// research, no tool execution, no writes under state/.
+struct BrainOptions {
+    bool headless = false;
+};
+
 // Region represents a distinct functional area of the brain
 class Region {
 public:
@@ -120,6 +221,8 @@ public:
         }
     }
 
+    const std::vector<double>& get_last_input() const { return last_input; }
+
 private:
     std::vector<double> last_input;
 };
@@ -161,9 +264,7 @@ public:
     TaskManager task_manager;
     std::unique_ptr<PlanningUnit> planning_unit;
     
-    std::atomic<bool> running{true};
     mutable std::recursive_mutex brain_mutex; // Protects shared state (recursive to allow internal calls)
-    std::thread background_thread;
     std::chrono::steady_clock::time_point last_yawn;
     std::string current_thought = "Idle";
     
@@ -183,7 +284,10 @@ public:
 
     // Explicit Memory (Database & Cache)
     std::unique_ptr<MemoryStore> memory_store;
-    std::unique_ptr<RedisClient> redis_cache;
+    std::shared_ptr<RedisClient> redis_cache;
+    // Associative recall ("assoc:" and "sim:" keys) in process, then Redis;
+    // cleared whenever memories are stored
+    std::unique_ptr<dnn::RecallCache> recall_cache;
     std::string db_conn_str = "host=postgres dbname=brain_db user=brain_user password=brain_password";
 
     // Multi-Modal Sensory Bridge [Pillar 3]
@@ -192,9 +296,13 @@ public:
     void update_sensory_focus(); // Adjusts focus levels based on intent/context
     std::vector<double> get_aggregate_sensory_input();
     
-    // Neural Bypass UI [Pillar 4]
+    // Neural Bypass UI [Pillar 4]. The payload is only built if a Neural
+    // subscriber exists; repeats of one type are coalesced (BRAIN_EVENT_COALESCE_MS).
     std::atomic<bool> bypass_enabled{true};
-    void emit_neural_event(const std::string& type, const std::string& data);
+    template <typename F>
+    void emit_neural_event(const char* type, F&& make_payload) {
+        if (bypass_enabled.load(std::memory_order_relaxed)) events.emit(dnn::EventTopic::Neural, type, std::forward<F>(make_payload));
+    }
 
     // Context Window (Short-term Conversation History)
     std::deque<std::string> conversation_context;
@@ -210,7 +318,7 @@ public:
     
     // Synonym Mapping (Word -> Root Meaning)
     std::map<std::string, std::string> synonyms;
-    std::map<std::string, std::vector<double>> word_embeddings;
+    dnn::EmbeddingStore word_embeddings{VECTOR_DIM}; // mmap'd state/vocab.bin + learned words
     
     // NLU Helpers
     std::unordered_set<std::string> stopwords_;
@@ -233,22 +341,42 @@ public:
     
     // Feature 5: Metabolism
     void metabolize_step();
-    // Feature 6: REM Logic
-    void perform_rem_cycle();
+    // Feature 6: REM Logic. Replays a sample of past interactions (see
+    // ReplayOptions); brain_mutex is taken per batch, not for the whole cycle.
+    ReplayReport perform_rem_cycle();
+    ReplayOptions replay_options;
 
     // Cognitive Core - Unified access to all 100 AI features
+    // cognitive_core and skill_manager are built lazily; go through the getters.
     std::unique_ptr<dnn::CognitiveCore> cognitive_core;
     std::unique_ptr<dnn::CognitiveEngine> cognitive_engine;
     std::unique_ptr<dnn::SkillManager> skill_manager;
+    dnn::CognitiveCore* get_cognitive_core();
+    dnn::SkillManager* get_skill_manager();
+
+    StartupReport get_startup_report() const;
 
     // Infrastructure Bridges
     std::unique_ptr<dnn::infra::RosBridge> ros_bridge;
 
 
-    Brain();
+    explicit Brain(BrainOptions options = {});
     ~Brain();
 
     std::string interact(const std::string& input_text);
+    // Many utterances at once, replies in input order. Utterances are
+    // vectorised in parallel, each region runs one batched forward pass per
+    // chunk and memory is searched with a single ranked multi-query search.
+    // Differences from calling interact() in a loop:
+    //  - every utterance sees the conversation context as it was when the call
+    //    began, not the earlier utterances of the batch or their replies; all
+    //    turns are appended to the context, in order, at the end;
+    //  - plasticity is one averaged Hebbian step per chunk instead of one
+    //    step per utterance, and sensory input is sampled once;
+    //  - emotions, reflex feedback, reflex replies and the response cache are
+    //    still applied utterance by utterance, in order; skill commands
+    //    (Learn:/Do:) and low-energy replies go through interact() itself.
+    std::vector<std::string> interact_batch(std::span<const std::string> inputs);
     std::string decode_output(const std::vector<double>& logits);
     std::string get_associative_memory(const std::string& input);
     bool CheckPrintable(char c);
@@ -268,21 +396,58 @@ public:
 
     long long get_knowledge_size();
 
-    // Autonomy Loop
-    void automata_loop();
+    // Autonomy: each activity is a scheduler job with its own period
+    // (BRAIN_<JOB>_PERIOD_MS overrides, e.g. BRAIN_RL_STEP_PERIOD_MS=500)
+    std::unique_ptr<dnn::Scheduler> scheduler;
+    std::shared_ptr<dnn::BrainClock> clock;           // Steady clock, or virtual_clock when headless
+    std::shared_ptr<dnn::VirtualClock> virtual_clock; // Headless only
+    bool is_headless() const { return options_.headless; }
+    std::map<TaskType, size_t> completed_tasks;       // Guarded by brain_mutex
+    void start_autonomy();
+    void rl_step();
+    void run_next_task();
+    void regulate_state();
     // Mega-Batch 6: Enhanced Planning
     void evaluate_goals();
     
     std::string get_status();
+    // Sections are re-serialised only when their values change; large sensory
+    // activity arrays are mean-pooled to state_activity_bins (0: full resolution).
     std::string get_json_state();
+    // Sections changed since `version` ("" if none; 0 means everything); advances `version`
+    std::string get_json_state_delta(uint64_t& version);
+    dnn::StatePublisher::Stats get_state_publisher_stats() const { return state_publisher_.stats(); }
+
+    // Replies to repeated inputs (BRAIN_RESPONSE_CACHE=1; off by default). Keyed
+    // by normalised input, mood and context, invalidated whenever response_epoch() moves.
+    dnn::ResponseCache response_cache;
+    uint64_t response_epoch() const { return response_epoch_.load(std::memory_order_relaxed); }
+
+    // Online plasticity from interact() runs on this thread (null: applied inline,
+    // as in headless mode or with BRAIN_ASYNC_PLASTICITY=0)
+    std::unique_ptr<dnn::BackgroundLearner> learner;
+    size_t state_activity_bins = 64;
     void update_from_json(const std::string& json);
 
     void save(const std::string& filename);
+    std::future<bool> save_async(const std::string& filename); // Snapshot now, write on the writer thread
     void load(const std::string& filename);
+
+    BrainSnapshot capture_snapshot();
+    static bool write_snapshot(const BrainSnapshot& snap, std::ostream& os);
+    std::unique_ptr<dnn::SnapshotWriter> snapshot_writer;
+
+    // Incremental checkpoint: appends only the weights touched since the last
+    // checkpoint to "<filename>.delta"; compacts into a full snapshot when the
+    // chain gets long or a delta would be nearly as big as the base.
+    void checkpoint(const std::string& filename = "state/brain_autosave.bin");
+    size_t checkpoint_max_deltas = 16;
+    double checkpoint_compaction_ratio = 0.5;
     
     // Phase 4: Language Acquisition
-    void save_vocab(const std::string& filename = "state/vocab.txt");
-    void load_vocab(const std::string& filename = "state/vocab.txt");
+    // Binary embedding file; a legacy vocab.txt next to it is converted once on load
+    void save_vocab(const std::string& filename = "state/vocab.bin");
+    void load_vocab(const std::string& filename = "state/vocab.bin");
     void learn_word(const std::string& word); // One-shot learning
     
     // ========== COGNITIVE CORE ACCESS METHODS ==========
@@ -321,20 +486,61 @@ public:
     // Supervised Learning
 
     void teach(const std::string& input, const std::string& target);
+    // Whole curriculum at once: pairs are vectorised up front, encoder/memory/
+    // cognitive forward passes run in parallel, the decoder trains on real
+    // mini-batches. brain_mutex is held per batch, not for the whole run.
+    TeachReport teach_batch(const std::vector<std::pair<std::string, std::string>>& pairs,
+                            const TeachOptions& options = {});
+    // "input|target" lines, e.g. data/english_basics.txt
+    TeachReport teach_curriculum(const std::string& path, const TeachOptions& options = {});
     
-    // Event Callbacks
-    std::function<void(const std::string&)> on_log;
-    std::function<void(const std::string&)> on_error;
-    std::function<void(const std::string&)> on_thought;
-    std::function<void(const std::string&)> on_emotion_update;
-    std::function<void(const std::string&, const std::string&)> on_neural_event;
-    std::function<void(const std::string&)> on_research_update;
-    
-    void set_log_callback(std::function<void(const std::string&)> cb) { on_log = cb; }
-    void set_error_callback(std::function<void(const std::string&)> cb) { on_error = cb; }
-    void set_thought_callback(std::function<void(const std::string&)> cb) { on_thought = cb; }
+    // Telemetry (logs, errors, thoughts, emotions, research, neural events).
+    // Subscribers run on the bus's dispatcher thread; see dnn::EventBus.
+    dnn::EventBus events;
 
 private:
-    void emit_log(const std::string& msg) { if(on_log) on_log(msg); else std::cout << msg << std::endl; }
-    void emit_thought(const std::string& msg) { if(on_thought) on_thought(msg); }
+    // Logs go to stdout while nobody subscribes to them
+    void emit_log(const std::string& msg) {
+        if (events.has_subscribers(dnn::EventTopic::Log)) events.emit(dnn::EventTopic::Log, "log", msg);
+        else std::cout << msg << std::endl;
+    }
+
+    std::array<dnn::NeuralNetwork*, 4> region_networks();
+    BrainOptions options_;
+
+    StartupReport startup_report;
+    mutable std::mutex startup_mutex_;
+    void record_startup_phase(const std::string& name, std::chrono::steady_clock::time_point start, bool parallel);
+    std::once_flag cognitive_core_once_;
+    std::once_flag skill_manager_once_;
+    std::atomic<bool> task_in_flight_{false};
+    void execute_task(const Task& task);
+    void replay_checkpoint_deltas(const std::string& delta_path, uint64_t epoch);
+    std::string checkpoint_path_;
+    uint64_t checkpoint_epoch_ = 0;
+    size_t checkpoint_deltas_ = 0;
+    std::atomic<bool> checkpoint_write_failed_{false}; // Set by the writer thread or a short delta replay; the next checkpoint is a full one
+    uint64_t checkpoint_vocab_hash_ = 0;
+    uint64_t checkpoint_instinct_hash_ = 0;
+    dnn::StatePublisher state_publisher_{{"personality", "emotions", "sensory_activity", "thought", "learning", "metadata"}};
+    void refresh_state();
+    void reinforce_regions(double intensity);
+    // Steps shared by interact() and interact_batch()
+    void update_focus();
+    void apply_input_mood(const std::string& input_text); // Sentiment and reflex reward feedback
+    // Empty: not cacheable. `turns` is how many leading lines of `context` precede the utterance.
+    std::string response_cache_key(const std::string& input_text, const std::deque<std::string>& context, size_t turns) const;
+    std::string reflex_reply(const std::string& input_text);              // Empty: no reflex
+    std::string modulate_personality(std::string response);
+    void push_context(std::string line);
+    // Associative recall: extracted entities (weighted up) then words longer
+    // than three letters, ranked together by MemoryStore::search
+    std::vector<MemoryQueryTerm> recall_terms(const std::string& text, size_t& entity_count);
+    std::string recall_reply(const std::vector<MemoryQueryTerm>& terms, size_t entity_count, const Memory& mem) const;
+    // Weights, vocabulary, reflexes or personality changed: cached replies are stale
+    std::atomic<uint64_t> response_epoch_{0};
+    void bump_response_epoch() { response_epoch_.fetch_add(1, std::memory_order_relaxed); }
+    void emit_thought(const std::string& msg) { events.emit(dnn::EventTopic::Thought, "thought", msg); }
+    template <typename F, typename = std::enable_if_t<std::is_invocable_r_v<std::string, F&>>>
+    void emit_thought(F&& make_msg) { events.emit(dnn::EventTopic::Thought, "thought", std::forward<F>(make_msg)); }
 };
@@ -0,0 +1,54 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace dnn {
+
+    /**
+     * Source of "now" for Brain activity (scheduler ticks, simulated waits).
+     * Live brains use the steady clock; headless simulations own a VirtualClock
+     * that only moves when the driver advances it, so a simulated day costs
+     * CPU time rather than wall time.
+     */
+    class BrainClock {
+    public:
+        using clock = std::chrono::steady_clock;
+        using time_point = clock::time_point;
+        using duration = clock::duration;
+
+        virtual ~BrainClock() = default;
+        virtual time_point now() const = 0;
+        virtual void sleep_for(duration d) = 0;
+        virtual bool is_virtual() const = 0;
+    };
+
+    class SteadyBrainClock : public BrainClock {
+    public:
+        time_point now() const override { return clock::now(); }
+        void sleep_for(duration d) override { std::this_thread::sleep_for(d); }
+        bool is_virtual() const override { return false; }
+    };
+
+    class VirtualClock : public BrainClock {
+    public:
+        explicit VirtualClock(time_point start = time_point{}) : ticks_(start.time_since_epoch().count()) {}
+
+        time_point now() const override { return time_point(duration(ticks_.load(std::memory_order_acquire))); }
+        void sleep_for(duration d) override { advance(d); } // Simulated waits cost nothing
+        bool is_virtual() const override { return true; }
+
+        void advance(duration d) { ticks_.fetch_add(d.count(), std::memory_order_acq_rel); }
+
+        // Move forward to t; never backwards (a job that "slept" may already be past it)
+        void advance_to(time_point t) {
+            auto target = t.time_since_epoch().count();
+            auto cur = ticks_.load(std::memory_order_acquire);
+            while (cur < target && !ticks_.compare_exchange_weak(cur, target, std::memory_order_acq_rel)) {}
+        }
+
+    private:
+        std::atomic<duration::rep> ticks_;
+    };
+
+} // namespace dnn
@@ -29,6 +29,7 @@ public:
     std::unique_ptr<TcpServer> graph_server;     // 9012 (Knowledge Graph)
     std::unique_ptr<TcpServer> input_server;     // 9013 ( afferent / sensory)
     std::unique_ptr<TcpServer> output_server;    // 9014 ( efferent / motor )
+    std::vector<dnn::EventBus::SubscriptionId> subscriptions;
 
     BrainServer(Brain& b) : brain(b) {
         std::string token = dnn::infra::Config::get("BRAIN_TOKEN", "");
@@ -66,41 +67,56 @@ public:
             std::cout << "[Security] Authentication enabled for all ports." << std::endl;
         }
 
-        // Wire Brain Events
-        brain.set_log_callback([this](const std::string& msg) {
-            log_server->broadcast(msg + "\n");
-            dash_server->broadcast("{\"type\": \"log\", \"payload\": \"" + msg + "\"}\n");
-            // Also echo to console for docker logs
-            std::cout << msg << std::endl; 
-        });
-        
-        brain.set_error_callback([this](const std::string& msg) {
-            error_server->broadcast(msg);
-            std::cerr << msg << std::endl;
-        });
-        
-        brain.set_thought_callback([this](const std::string& msg) {
-            thought_server->broadcast(msg + "\n");
-            dash_server->broadcast("{\"type\": \"thought\", \"payload\": \"" + msg + "\"}\n");
-        });
-        
-        brain.on_emotion_update = [this](const std::string& msg) {
-            emotion_server->broadcast(msg);
-            // Also update dashboard
-             std::stringstream ss;
-             ss << "{\"type\":\"emotions\", \"data\": \"" << msg << "\"}";
-             dash_server->broadcast(ss.str());
-        };
-        
-        brain.on_research_update = [this](const std::string& msg) {
-            research_server->broadcast(msg);
+        // Wire Brain Events. Subscribers run on the event bus's dispatcher
+        // thread; dashboard JSON is only built while a dashboard is connected.
+        using dnn::EventTopic;
+        auto dash_event = [this](const char* type, const char* key, const std::string& value) {
+            if (dash_server->client_count() == 0) return;
+            std::string out = "{\"type\": \"";
+            out += type;
+            out += "\", \"";
+            out += key;
+            out += "\": ";
+            dnn::StatePublisher::append_string(out, value);
+            out += "}\n";
+            dash_server->broadcast(out);
         };
+        subscriptions.push_back(brain.events.subscribe(EventTopic::Log, [this, dash_event](const dnn::Event& e) {
+            log_server->broadcast(e.payload + "\n");
+            dash_event("log", "payload", e.payload);
+            // Also echo to console for docker logs
+            std::cout << e.payload << std::endl;
+        }));
 
-        brain.on_neural_event = [this](const std::string& type, const std::string& data) {
-            std::stringstream ss;
-            ss << "{\"type\": \"neural_event\", \"event_type\": \"" << type << "\", \"data\": \"" << data << "\"}\n";
-            dash_server->broadcast(ss.str());
-        };
+        subscriptions.push_back(brain.events.subscribe(EventTopic::Error, [this](const dnn::Event& e) {
+            error_server->broadcast(e.payload);
+            std::cerr << e.payload << std::endl;
+        }));
+
+        subscriptions.push_back(brain.events.subscribe(EventTopic::Thought, [this, dash_event](const dnn::Event& e) {
+            thought_server->broadcast(e.payload + "\n");
+            dash_event("thought", "payload", e.payload);
+        }));
+
+        subscriptions.push_back(brain.events.subscribe(EventTopic::Emotion, [this, dash_event](const dnn::Event& e) {
+            emotion_server->broadcast(e.payload);
+            dash_event("emotions", "data", e.payload);
+        }));
+
+        subscriptions.push_back(brain.events.subscribe(EventTopic::Research, [this](const dnn::Event& e) {
+            research_server->broadcast(e.payload);
+        }));
+
+        subscriptions.push_back(brain.events.subscribe(EventTopic::Neural, [this](const dnn::Event& e) {
+            if (dash_server->client_count() == 0) return;
+            std::string out = "{\"type\": \"neural_event\", \"event_type\": ";
+            dnn::StatePublisher::append_string(out, e.type);
+            out += ", \"data\": ";
+            dnn::StatePublisher::append_string(out, e.payload);
+            if (e.coalesced > 0) out += ", \"coalesced\": " + std::to_string(e.coalesced);
+            out += "}\n";
+            dash_server->broadcast(out);
+        }));
         
         // Handle Chat Input
         chat_server->on_input([this](const std::string& msg) {
@@ -207,6 +223,10 @@ public:
         });
     }
     
+    ~BrainServer() {
+        for (auto id : subscriptions) brain.events.unsubscribe(id);
+    }
+
     void start() {
         dash_server->start();
         emotion_server->start();
@@ -231,11 +251,22 @@ public:
             }
         }).detach();
 
-        // Background thread to push State Updates to 9011 (Control) and 9001 (Dashboard)
+        // Background thread to push State Updates to 9011 (Control) and 9001 (Dashboard).
+        // Only changed top-level sections are sent (clients merge them); a full
+        // state goes out when a client connects and every 30th tick.
         std::thread([this]() {
+            uint64_t version = 0;
+            uint64_t last_joins = 0;
+            size_t ticks = 0;
             while(true) {
                 std::this_thread::sleep_for(std::chrono::milliseconds(2000));
-                std::string state = brain.get_json_state();
+                uint64_t joins = control_server->join_generation() + dash_server->join_generation();
+                if (control_server->client_count() + dash_server->client_count() == 0) continue;
+                if (joins != last_joins || ++ticks % 30 == 0) version = 0;
+                last_joins = joins;
+
+                std::string state = brain.get_json_state_delta(version);
+                if (state.empty()) continue;
                 control_server->broadcast(state + "\n");
                 dash_server->broadcast("{\"type\": \"state\", \"payload\": " + state + "}\n");
             }
@@ -0,0 +1,44 @@
+#pragma once
+#include "brain.hpp"
+#include <chrono>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+// One headless run: a Brain on a virtual clock, advanced as fast as the CPU allows.
+struct SimulationConfig {
+    std::string name = "sim";
+    std::chrono::milliseconds duration = std::chrono::hours(24);
+    std::chrono::milliseconds step = std::chrono::minutes(1);       // Granularity of advance() and on_step
+    std::chrono::milliseconds goal_period = std::chrono::seconds(10); // Autonomous goal selection; 0 disables
+    std::map<std::string, std::chrono::milliseconds> job_periods;   // Per-job overrides, e.g. {"rl_step", 500ms}
+
+    std::function<void(Brain&)> setup;                                  // Before the clock starts
+    std::function<void(Brain&, std::chrono::milliseconds)> on_step;     // After each step, with elapsed time
+};
+
+struct SimulationResult {
+    std::string name;
+    std::chrono::milliseconds simulated{0};
+    double setup_ms = 0.0;  // Brain construction
+    double run_ms = 0.0;    // Wall time spent advancing the clock
+    double speedup = 0.0;   // Simulated time / run time
+    std::size_t job_runs = 0;
+    std::map<TaskType, size_t> completed_tasks;
+    Emotions emotions;
+    Hormones hormones;
+    Metabolism metabolism;
+    std::vector<dnn::Scheduler::JobStats> job_stats;
+    std::string error;      // Non-empty if the run threw
+};
+
+class BrainSimulation {
+public:
+    static SimulationResult run(const SimulationConfig& config);
+
+    // Independent simulations on a thread pool (threads = 0: hardware concurrency).
+    // Results are returned in config order.
+    static std::vector<SimulationResult> run_batch(const std::vector<SimulationConfig>& configs,
+                                                   std::size_t threads = 0);
+};
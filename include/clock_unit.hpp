@@ -9,6 +9,7 @@ namespace dnn {
     public:
         ClockUnit() {
             active_features_.resize(384, 0.0);
+            publish(active_features_);
             start_time_ = std::chrono::steady_clock::now();
         }
 
@@ -38,6 +39,7 @@ namespace dnn {
                     active_features_[i] = std::cos(elapsed * freq);
                 }
             }
+            publish(active_features_);
         }
 
         double get_idle_seconds() const {
@@ -6,6 +6,8 @@
 #include <mutex>
 #include <iostream>
 #include <memory>
+#include <cstdint>
+#include <algorithm>
 
 namespace dnn {
 
@@ -31,6 +33,16 @@ namespace dnn {
         std::vector<double> a_cache;
         std::vector<std::size_t> indices;
 
+        // Changes since the last checkpoint (incremental saves). Output rows are
+        // the unit everywhere; layers wider than they are tall (the vocabulary
+        // encoder) also track input columns, since a sparse input touches every
+        // row but only a few columns. In those layers the untouched columns of a
+        // touched row move only by its homeostatic shifts, which are logged.
+        std::vector<std::uint8_t> dirty_rows;
+        std::vector<std::uint8_t> dirty_cols;
+        std::vector<std::vector<double>> row_shifts;
+        bool dirty_scalars{false}; // Biases of a column-tracked layer
+
         double hebbian_learning_rate{0.01};
         double homeostatic_strength{0.001};
         double decay_rate{0.95};
@@ -53,6 +65,21 @@ namespace dnn {
                       std::vector<double> &grad_b,
                       Activation act) const;
 
+        // Mini-batch variants: each weight row is visited once per batch rather
+        // than once per sample. backward_batch writes the gradient summed over
+        // the batch; input_grad = false skips dL_dinput (nothing upstream).
+        using Batch = std::vector<std::vector<double>>;
+        void forward_batch(const Batch &inputs, Batch &z_out, Batch &a_out, Activation act) const;
+        void backward_batch(const Batch &inputs,
+                            const Batch &z,
+                            const Batch &a,
+                            const Batch &dL_dout,
+                            Batch &dL_dinput,
+                            std::vector<double> &grad_w,
+                            std::vector<double> &grad_b,
+                            Activation act,
+                            bool input_grad = true) const;
+
         void apply_gradients(const std::vector<double> &grad_w,
                              const std::vector<double> &grad_b,
                              double lr,
@@ -64,6 +91,31 @@ namespace dnn {
         
         void save(std::ostream &os) const;
         void load(std::istream &is);
+
+        // Dirty tracking for checkpoint deltas
+        bool tracks_columns() const { return in_size > out_size; }
+        void mark_all_dirty();
+        void clear_dirty();
+        std::size_t dirty_row_count() const;
+        std::vector<std::pair<std::size_t, std::size_t>> dirty_ranges() const; // Rows, [begin, end)
+        std::vector<std::pair<std::size_t, std::size_t>> dirty_column_ranges() const;
+        std::size_t row_bytes() const; // Serialised size of one row in save_rows
+        std::size_t snapshot_bytes() const; // Serialised size of the layer in save
+        bool has_delta() const;
+        std::size_t delta_bytes() const; // Serialised size of save_delta
+
+        // Serialise rows [begin, end): weights, mask, bias and homeostatic target.
+        // Plasticity rates are fixed at construction and eligibility traces never
+        // feed back into the weights, so deltas leave both to the full snapshot.
+        void save_rows(std::ostream &os, std::size_t begin, std::size_t end) const;
+        bool load_rows(std::istream &is, std::size_t begin, std::size_t end);
+
+        // Everything changed since clear_dirty(). skip_delta checks a record
+        // against this layer's shape and steps over it; load_delta applies a
+        // record that skip_delta accepted.
+        void save_delta(std::ostream &os) const;
+        bool skip_delta(std::istream &is) const;
+        void load_delta(std::istream &is);
     };
 
     class NeuralNetwork {
@@ -94,14 +146,20 @@ namespace dnn {
         std::size_t input_size() const { return plastic_layers_.empty() ? 0 : plastic_layers_.front().in_size; }
         std::size_t output_size() const { return plastic_layers_.empty() ? 0 : plastic_layers_.back().out_size; }
         std::size_t get_layer_count() const { return plastic_layers_.size(); }
+        std::vector<PlasticLayer>& layers() { return plastic_layers_; }
+        const std::vector<PlasticLayer>& layers() const { return plastic_layers_; }
 
         std::vector<double> predict(const std::vector<double> &input) const;
-
-        void train(const std::vector<std::vector<double>> &X,
-                   const std::vector<std::vector<double>> &Y,
-                   int epochs,
-                   int batch_size,
-                   double learning_rate);
+        std::vector<std::vector<double>> predict_batch(const std::vector<std::vector<double>> &inputs) const;
+
+        // Mini-batch SGD: gradients are averaged over batch_size samples and applied
+        // once per batch (Hebbian terms use the batch-mean activity). Returns the
+        // mean squared error of the last epoch.
+        double train(const std::vector<std::vector<double>> &X,
+                     const std::vector<std::vector<double>> &Y,
+                     int epochs,
+                     int batch_size,
+                     double learning_rate);
                    
         void save(std::ostream &os) const;
         void load(std::istream &is);
@@ -0,0 +1,86 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <ostream>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+
+namespace dnn {
+
+    /**
+     * Word -> float32 embedding table backed by a memory-mapped binary file.
+     *
+     * File layout (little endian, see write()):
+     *   header (64 bytes) | u64 string offsets[count + 1] | word bytes (sorted) |
+     *   zero padding to 64 | float32 matrix[count][dim]
+     *
+     * Opening a file is O(header + offsets) validation plus one mmap; rows are
+     * paged in on first touch. Words learned afterwards live in an in-memory
+     * overlay; updating a mapped word writes to a private copy-on-write page.
+     */
+    class EmbeddingStore {
+    public:
+        static constexpr char kMagic[4] = {'B', 'E', 'M', 'B'};
+        static constexpr std::uint32_t kVersion = 1;
+
+        explicit EmbeddingStore(std::size_t dim);
+        ~EmbeddingStore();
+
+        EmbeddingStore(const EmbeddingStore&) = delete;
+        EmbeddingStore& operator=(const EmbeddingStore&) = delete;
+
+        // Replace the contents with a mapped embedding file. False if missing,
+        // malformed or of a different dimension (the store is then left empty).
+        bool map_file(const std::string& path);
+        bool is_mapped() const { return map_base_ != nullptr; }
+
+        // Serialise mapped and overlay words together, sorted, in the file layout.
+        bool write(std::ostream& os) const;
+
+        // One-time migration from the legacy "word v1 v2 ... vN" text format.
+        static bool convert_text(const std::string& text_path, const std::string& bin_path,
+                                 std::size_t dim, std::size_t* words_out = nullptr);
+
+        std::size_t dim() const { return dim_; }
+        std::size_t size() const { return base_count_ + overlay_words_.size(); }
+        bool empty() const { return size() == 0; }
+        bool contains(std::string_view word) const { return find(word) != nullptr; }
+
+        // Row for a word, or nullptr. Pointers stay valid until the next set()/clear().
+        const float* find(std::string_view word) const;
+
+        // Positional access over [0, size()): mapped words first, then learned ones.
+        std::string_view word(std::size_t i) const;
+        const float* row(std::size_t i) const;
+
+        void set(const std::string& word, const std::vector<double>& vec);
+        void clear();
+
+    private:
+        std::size_t base_index(std::string_view word) const; // base_count_ if absent
+        void unmap();
+
+        std::size_t dim_;
+
+        // Mapped base table
+        void* map_base_ = nullptr;
+        std::size_t map_bytes_ = 0;
+        std::size_t base_count_ = 0;
+        const std::uint64_t* base_offsets_ = nullptr;
+        const char* base_strings_ = nullptr;
+        float* base_matrix_ = nullptr;
+
+        // Words learned since the file was mapped
+        std::vector<std::string> overlay_words_;
+        std::vector<float> overlay_rows_;
+        struct WordHash {
+            using is_transparent = void;
+            std::size_t operator()(std::string_view s) const { return std::hash<std::string_view>{}(s); }
+        };
+        std::unordered_map<std::string, std::size_t, WordHash, std::equal_to<>> overlay_index_;
+    };
+
+} // namespace dnn
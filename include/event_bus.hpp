@@ -0,0 +1,150 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <array>
+#include <map>
+#include <memory>
+#include <functional>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <cstdint>
+#include <type_traits>
+
+namespace dnn {
+
+    enum class EventTopic : std::uint8_t {
+        Log,
+        Error,
+        Thought,
+        Emotion,
+        Research,
+        Neural,
+        Count
+    };
+
+    struct Event {
+        EventTopic topic = EventTopic::Log;
+        std::string type;     // Sub-type, e.g. "sensory_focus"; the coalescing key
+        std::string payload;
+        std::chrono::steady_clock::time_point time;
+        std::uint32_t coalesced = 0; // Events folded into this one by rate limiting
+    };
+
+    /**
+     * Typed publish/subscribe bus for brain telemetry.
+     *
+     * Emitting checks a per-topic subscriber count first (one relaxed atomic
+     * load), so an unobserved topic costs a few nanoseconds and the payload,
+     * passed as a callable, is never built. Observed events go into the
+     * emitting thread's own ring buffer; a dispatcher thread drains the rings
+     * every `dispatch_interval` and runs subscribers, so formatting and socket
+     * writes stay off the emitting thread. A topic can be rate limited: within
+     * the interval, events of the same type replace the pending one (last
+     * wins) and are delivered once the interval has passed.
+     */
+    class EventBus {
+    public:
+        using Callback = std::function<void(const Event&)>;
+        using SubscriptionId = std::uint64_t;
+
+        struct Options {
+            std::size_t ring_capacity = 1024;                   // Events per emitting thread
+            std::chrono::milliseconds dispatch_interval{5};
+        };
+
+        struct Stats {
+            std::uint64_t published = 0;   // Reached a ring
+            std::uint64_t dropped = 0;     // Ring full
+            std::uint64_t coalesced = 0;   // Folded by rate limiting
+            std::uint64_t delivered = 0;   // Events handed to subscribers
+        };
+
+        EventBus() : EventBus(Options{}) {}
+        explicit EventBus(Options options);
+        ~EventBus();
+
+        EventBus(const EventBus&) = delete;
+        EventBus& operator=(const EventBus&) = delete;
+
+        // Callbacks run on the dispatcher thread (or in flush()), one at a time.
+        // Do not subscribe/unsubscribe from inside a callback.
+        SubscriptionId subscribe(EventTopic topic, Callback callback);
+        void unsubscribe(SubscriptionId id);
+
+        bool has_subscribers(EventTopic topic) const {
+            return subscriber_counts_[index(topic)].load(std::memory_order_relaxed) > 0;
+        }
+
+        // Events of one type on `topic` are delivered at most once per interval (0: no limit)
+        void set_rate_limit(EventTopic topic, std::chrono::milliseconds interval);
+
+        // `make_payload` (returning std::string) runs only if someone listens
+        template <typename F, typename = std::enable_if_t<std::is_invocable_r_v<std::string, F&>>>
+        bool emit(EventTopic topic, const char* type, F&& make_payload) {
+            if (!has_subscribers(topic)) return false;
+            return push(topic, type, make_payload());
+        }
+        bool emit(EventTopic topic, const char* type, std::string payload) {
+            if (!has_subscribers(topic)) return false;
+            return push(topic, type, std::move(payload));
+        }
+
+        // Deliver everything emitted so far (pending coalesced events included)
+        void flush();
+        void stop();
+        Stats stats() const;
+
+    private:
+        struct Ring {
+            explicit Ring(std::size_t capacity) : slots(capacity) {}
+            std::vector<Event> slots;
+            alignas(64) std::atomic<std::size_t> head{0}; // Producer
+            alignas(64) std::atomic<std::size_t> tail{0}; // Consumer
+        };
+
+        struct Subscriber {
+            SubscriptionId id;
+            EventTopic topic;
+            Callback callback;
+        };
+
+        struct Pending {
+            Event event;
+            std::chrono::steady_clock::time_point last_delivery{};
+            bool waiting = false;
+            bool delivered = false; // steady_clock's epoch may be recent, so last_delivery alone can't say "never"
+        };
+
+        static std::size_t index(EventTopic topic) { return static_cast<std::size_t>(topic); }
+        bool push(EventTopic topic, const char* type, std::string payload);
+        Ring& local_ring();
+        void dispatch(bool force);   // Caller holds dispatch_mutex_
+        void deliver(const Event& event);
+        void run();
+
+        Options options_;
+        const std::uint64_t id_;
+        std::array<std::atomic<int>, static_cast<std::size_t>(EventTopic::Count)> subscriber_counts_{};
+        std::array<std::chrono::milliseconds, static_cast<std::size_t>(EventTopic::Count)> rate_limits_{};
+
+        mutable std::mutex rings_mutex_;
+        std::vector<std::shared_ptr<Ring>> rings_; // Shared with the producing thread
+        std::shared_ptr<const void> alive_ = std::make_shared<const char>(0); // Expires with the bus
+
+        mutable std::mutex dispatch_mutex_;
+        std::vector<Subscriber> subscribers_;
+        std::map<std::pair<EventTopic, std::string>, Pending> pending_;
+        SubscriptionId next_subscription_ = 1;
+        Stats stats_;
+        std::atomic<std::uint64_t> dropped_{0};
+
+        std::mutex wake_mutex_;
+        std::condition_variable wake_cv_;
+        bool stopping_ = false;
+        std::thread thread_;
+    };
+
+} // namespace dnn
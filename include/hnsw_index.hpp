@@ -0,0 +1,122 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <span>
+#include <iosfwd>
+#include <random>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+
+namespace dnn {
+
+    /**
+     * Approximate nearest-neighbour index over float32 vectors under cosine
+     * distance (pgvector's <=>), as a hierarchical navigable small-world graph.
+     *
+     * Vectors are normalised on insert, so distance is 1 - dot product (AVX2).
+     * Every node is linked on level 0 (up to 2m neighbours) and, with
+     * probability falling by 1/m per level, on the levels above (up to m);
+     * neighbours are chosen with the diversity heuristic, so links span
+     * clusters instead of crowding one. A search descends greedily from the
+     * top entry point, then runs a best-first beam of width ef on level 0.
+     * Inserts are incremental; re-adding a key moves its node and relinks it.
+     * Concurrent searches are safe; the owner serialises writers against them.
+     */
+    class HnswIndex {
+    public:
+        using Node = std::uint32_t;
+        static constexpr Node kNoNode = ~Node{0};
+
+        struct Options {
+            std::size_t m = 16;                // Links per node above level 0; 2m on level 0
+            std::size_t ef_construction = 200; // Beam width while linking a new node
+            std::size_t ef_search = 64;        // Default beam width of search()
+            std::uint32_t seed = 42;           // Level draws (reproducible graphs)
+        };
+
+        struct Hit {
+            Node node = kNoNode;
+            float distance = 0.0f; // 1 - cosine similarity
+        };
+
+        struct Stats {
+            std::size_t nodes = 0;
+            std::size_t levels = 0;
+            std::size_t links = 0;
+            std::size_t bytes = 0; // Vectors, links and keys
+        };
+
+        static constexpr char kMagic[4] = {'B', 'H', 'N', 'S'};
+        static constexpr std::uint32_t kVersion = 1;
+
+        // dim 0: taken from the first add()
+        explicit HnswIndex(std::size_t dim = 0);
+        HnswIndex(std::size_t dim, Options options);
+
+        std::size_t dim() const { return dim_; }
+        std::size_t size() const { return keys_.size(); }
+        const Options& options() const { return options_; }
+        void set_ef_search(std::size_t ef) { options_.ef_search = ef; }
+
+        // Vectors of another dimension are ignored; returns false for them
+        bool add(std::string_view key, std::span<const float> vector);
+        bool add(std::string_view key, const std::vector<double>& vector);
+        Node find(std::string_view key) const; // kNoNode if absent
+        std::string_view key(Node node) const { return keys_[node]; }
+        // The vector as added (float precision); empty if absent
+        std::vector<double> vector(std::string_view key) const;
+
+        // Up to k nearest, nearest first; ef 0 uses options().ef_search
+        std::vector<Hit> search(std::span<const float> query, std::size_t k, std::size_t ef = 0) const;
+        std::vector<std::string> search_keys(const std::vector<double>& query, std::size_t k) const;
+        // Exact scan for recall measurements
+        std::vector<Hit> brute_force(std::span<const float> query, std::size_t k) const;
+
+        void clear();
+        bool write(std::ostream& os) const;
+        bool read(std::istream& is); // Replaces the contents; false (and empty) on a damaged file
+        Stats stats() const;
+
+    private:
+        using Candidate = std::pair<float, Node>; // (distance, node)
+
+        const float* data(Node node) const { return vectors_.data() + static_cast<std::size_t>(node) * dim_; }
+        float distance(const float* a, const float* b) const;
+        std::size_t capacity(int level) const { return level == 0 ? 2 * options_.m : options_.m; }
+        // [count, ids...] of a node's neighbours on one level
+        std::uint32_t* links(Node node, int level);
+        const std::uint32_t* links(Node node, int level) const;
+
+        int random_level();
+        std::vector<float> normalised(std::span<const float> vector, float* norm) const;
+        Node greedy(const float* query, Node entry, int level) const;
+        // Best-first beam of width ef; nearest first
+        std::vector<Candidate> search_level(const float* query, Node entry, std::size_t ef, int level) const;
+        std::vector<Node> select(const std::vector<Candidate>& candidates, std::size_t limit) const;
+        void connect(Node node, int top_level);
+        void link_back(Node from, Node to, int level);
+
+        struct KeyHash {
+            using is_transparent = void;
+            std::size_t operator()(std::string_view s) const noexcept { return std::hash<std::string_view>{}(s); }
+        };
+
+        std::size_t dim_ = 0;
+        Options options_;
+        double level_scale_ = 0.0; // 1 / ln(m)
+        std::mt19937 rng_;
+        std::vector<float> vectors_; // dim_ floats per node, unit length
+        std::vector<float> norms_;   // Original lengths, for vector()
+        std::vector<std::uint8_t> levels_;
+        std::vector<std::uint32_t> links0_;              // (2m + 1) slots per node
+        std::vector<std::vector<std::uint32_t>> upper_;  // (m + 1) slots per level above 0
+        std::vector<std::string> keys_;
+        std::unordered_map<std::string, Node, KeyHash, std::equal_to<>> nodes_;
+        Node entry_ = kNoNode;
+        int max_level_ = -1;
+    };
+
+} // namespace dnn
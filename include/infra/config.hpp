@@ -25,7 +25,9 @@ public:
         return val ? std::stod(val) : defaultValue;
     }
 
+    // DB_BACKEND=sqlite: an embedded database file (DB_PATH) instead of a server
     static std::string get_db_conn_str() {
+        if (get("DB_BACKEND", "postgres") == "sqlite") return "sqlite:" + get("DB_PATH", "state/memory.db");
         std::string host = get("DB_HOST", "postgres");
         std::string port = get("DB_PORT", "5432");
         std::string dbname = get("DB_NAME", "brain_db");
@@ -1,23 +1,20 @@
 #pragma once
 #include <string>
+#include <string_view>
 #include <vector>
 #include <iostream>
 #include <mutex>
+#include <shared_mutex>
+#include <atomic>
 #include <memory>
 #include <unordered_map>
-
-struct Memory {
-    int id;
-    long long timestamp;
-    std::string type; // "Observation", "Thought", "Research"
-    std::string content;
-    std::string tags;
-    
-    // Feature 6 & 10 fields
-    std::string acl_label = "PUBLIC"; // PUBLIC, PRIVATE, RESTRICTED
-    double strength = 1.0; // Decay factor (Ebbinghaus)
-    long long last_recall_time = 0;
-};
+#include <span>
+#include <cstdint>
+#include "posting_index.hpp"
+#include "hnsw_index.hpp"
+#include "memory_types.hpp"
+#include "recall_cache.hpp"
+#include "sqlite_memory_store.hpp"
 
 #ifdef USE_POSTGRES
 #include "postgres_client.hpp"
@@ -25,55 +22,216 @@ struct Memory {
 
 class MemoryStore {
 public:
+    // "sqlite:<path>" runs the same API on an embedded SQLite file instead
+    // (SqliteMemoryStore); anything else is a libpq connection string
     MemoryStore(const std::string& conn_str);
     ~MemoryStore();
+    static bool is_embedded(const std::string& conn_str) { return conn_str.rfind("sqlite:", 0) == 0; }
 
+    // Loads the index snapshot and indexes only newer rows, or rebuilds it from
+    // the table when there is none, it belongs to another table generation, or
+    // its row count falls short of the table's up to its newest id.
+    // BRAIN_MEMORY_INDEX_VERIFY=1 also rebuilds and compares (verify_index()).
     bool init();
+    // Snapshot files (default $BRAIN_MEMORY_INDEX or state/memory_index.bin, and
+    // $BRAIN_MEMORY_VECTORS or state/memory_vectors.bin); set before init(),
+    // empty disables them
+    void set_index_path(const std::string& path) { index_path_ = path; }
+    void set_vector_path(const std::string& path) {
+        vector_path_ = path;
+        if (sqlite_) sqlite_->set_vector_path(path);
+    }
+    // Writes both snapshots (also done after init() and on destruction when changed)
+    bool save_index();
+    // Rebuilds the index from the table; keeps the rebuilt one and returns
+    // false if the live index disagreed. Full scan: for maintenance windows.
+    bool verify_index();
     bool store(const std::string& type, const std::string& content, const std::string& tags = "", const std::string& acl = "PUBLIC");
+    // All rows and embeddings in one statement (one round trip, all or nothing)
+    bool store_batch(const std::vector<MemoryRecord>& records);
+    // Independent rows (each commits on its own), pipelined on one connection
+    // without waiting for each reply; returns how many were written
+    size_t store_many(const std::vector<MemoryRecord>& records);
+    // Large imports: binary COPY of rows and embeddings in one transaction,
+    // then one index merge; returns records.size(), or 0 if nothing was written.
+    // store_batch() switches to this from kBulkLoadThreshold records.
+    size_t bulk_load(const std::vector<MemoryRecord>& records);
+    static constexpr size_t kBulkLoadThreshold = 256;
     std::vector<Memory> query(const std::string& keyword, const std::string& user_acl = "PUBLIC");
+    // query() for many keywords in one round trip; keywords without a match are absent
+    std::unordered_map<std::string, std::vector<Memory>> query_many(const std::vector<std::string>& keywords,
+                                                                    const std::string& user_acl = "PUBLIC");
+    // Ranked retrieval: BM25 over the index for all terms at once (any term,
+    // or every term with require_all), best `k` first, in one round trip
+    std::vector<Memory> search(const std::vector<MemoryQueryTerm>& terms, size_t k = 5,
+                               const std::string& user_acl = "PUBLIC", bool require_all = false);
+    // search() for many queries, still one round trip
+    std::vector<std::vector<Memory>> search_many(const std::vector<std::vector<MemoryQueryTerm>>& queries, size_t k = 5,
+                                                 const std::string& user_acl = "PUBLIC", bool require_all = false);
     std::vector<Memory> get_recent(int limit = 10);
     long long get_memory_count();
     std::string get_graph_json(int max_nodes = 50);
     void clear();
     
-    // Mega-Batch 8: Vector Support
+    // Mega-Batch 8: Vector Support. The vector store stays the system of record;
+    // an in-process HNSW index over the same embeddings (loaded at init())
+    // answers retrieve_embedding and search_similar without a round trip.
+    // BRAIN_HNSW_M, BRAIN_HNSW_EF_CONSTRUCTION and BRAIN_HNSW_EF_SEARCH tune it.
     void store_embedding(const std::string& key, const std::vector<double>& embedding);
     std::vector<double> retrieve_embedding(const std::string& key);
     std::vector<std::string> search_similar(const std::vector<double>& embedding, int limit);
     
     void optimize_latency() {}
 
+    dnn::HnswIndex::Stats vector_stats() const {
+        if (sqlite_) return sqlite_->vector_stats();
+        std::shared_lock<std::shared_mutex> lock(vector_mutex_);
+        return vectors_.stats();
+    }
+
+    // Wait time and utilisation of the connection pool both clients share
+    PgConnectionPool::Stats pool_stats() const { return pool_ ? pool_->stats() : PgConnectionPool::Stats{}; }
+    dnn::PostingIndex::Stats index_stats() const {
+        std::shared_lock<std::shared_mutex> lock(index_mutex_);
+        return index_.stats();
+    }
+
 private:
+    // Statements run on pooled connections and do not serialise on the store;
+    // index_mutex_ only guards the in-memory inverted index
+    std::shared_ptr<PgConnectionPool> pool_;
     std::unique_ptr<PostgresClient> pg_client;
     std::unique_ptr<PostgresStorage> kv_store;
     std::string conn_str_;
-    mutable std::mutex db_mutex_;
-    std::unordered_map<std::string, std::vector<int>> inverted_index_;
+    mutable std::shared_mutex index_mutex_;
+    dnn::PostingIndex index_; // Token -> memory ids, sorted and compressed
+    std::atomic<long long> memory_count_{-1}; // Kept in step with store()/clear(); -1 until known
+    std::string index_path_;
+    int indexed_max_id_ = -1;      // Guarded by index_mutex_, like the two below
+    long long indexed_rows_ = 0;
+    std::atomic<bool> index_dirty_{false}; // Changed since the snapshot was written
+    mutable std::shared_mutex vector_mutex_;
+    dnn::HnswIndex vectors_; // Embedding key -> vector
+    std::string vector_path_;
+    long long vectors_version_ = -1; // Newest brain_kv_store embedding_version in vectors_; guarded by vector_mutex_
+    long long vectors_xmin_ = 0;     // xmin of the snapshot vectors_version_ was read in; same guard
+    std::atomic<bool> vectors_dirty_{false}; // Set under vector_mutex_ held exclusively, cleared by save_vectors()
+    std::unique_ptr<SqliteMemoryStore> sqlite_; // Embedded backend; every call forwards to it
+    // query() results by term in process, then Redis; stores drop their terms
+    dnn::RecallCache recall_cache_;
 
+    bool load_index();
+    void load_vectors();
+    bool save_postings();
+    bool save_vectors();
+    void index_embeddings(const std::vector<const MemoryRecord*>& records);
     void build_index();
-    void index_memory(int id, const std::string& content);
+    // Caller holds index_mutex_ exclusively
+    void index_memory(int id, std::string_view content);
+    void index_memory(int id, std::span<const std::string> tokens);
+    // Drops cached query() results for the terms of stored rows, once they are indexed
+    void invalidate_queries(std::span<const std::string_view> contents);
+    void invalidate_queries(std::span<const std::vector<std::string>> tokens);
+    std::uint64_t row_fingerprint(int id); // Identifies one row's version across clear()
+    void add_to_count(long long n) {
+        long long count = memory_count_.load();
+        while (count >= 0 && !memory_count_.compare_exchange_weak(count, count + n)) {}
+    }
 };
 
 #else
 
-// STUB IMPLEMENTATION
+// Without PostgreSQL: SqliteMemoryStore for "sqlite:" connection strings,
+// otherwise a stub that keeps nothing but embeddings
 class MemoryStore {
 public:
-    MemoryStore(const std::string& conn_str) {}
+    MemoryStore(const std::string& conn_str) {
+        if (is_embedded(conn_str)) sqlite_ = std::make_unique<SqliteMemoryStore>(conn_str.substr(7));
+    }
     ~MemoryStore() {}
+    static bool is_embedded(const std::string& conn_str) { return conn_str.rfind("sqlite:", 0) == 0; }
 
-    bool init() { return true; } // Pretend success
-    bool store(const std::string& type, const std::string& content, const std::string& tags = "", const std::string& acl = "PUBLIC") { return true; }
-    std::vector<Memory> query(const std::string& keyword, const std::string& user_acl = "PUBLIC") { return {}; }
-    std::vector<Memory> get_recent(int limit = 10) { return {}; }
-    long long get_memory_count() { return 0; }
-    std::string get_graph_json(int max_nodes = 50) { return "{}"; }
-    void clear() {}
+    bool init() { return sqlite_ ? sqlite_->init() : true; } // The stub pretends success
+    void set_index_path(const std::string& path) {}
+    void set_vector_path(const std::string& path) { if (sqlite_) sqlite_->set_vector_path(path); }
+    bool save_index() { return sqlite_ ? sqlite_->save_index() : false; }
+    bool verify_index() { return sqlite_ ? sqlite_->verify_index() : true; }
+    bool store(const std::string& type, const std::string& content, const std::string& tags = "", const std::string& acl = "PUBLIC") {
+        return sqlite_ ? sqlite_->store(type, content, tags, acl) : true;
+    }
+    bool store_batch(const std::vector<MemoryRecord>& records) {
+        if (sqlite_) return sqlite_->store_batch(records);
+        store_embeddings(records);
+        return true;
+    }
+    size_t store_many(const std::vector<MemoryRecord>& records) {
+        if (sqlite_) return sqlite_->store_many(records);
+        store_embeddings(records);
+        return records.size();
+    }
+    size_t bulk_load(const std::vector<MemoryRecord>& records) {
+        if (sqlite_) return sqlite_->bulk_load(records);
+        store_embeddings(records);
+        return records.size();
+    }
+    std::vector<Memory> query(const std::string& keyword, const std::string& user_acl = "PUBLIC") {
+        return sqlite_ ? sqlite_->query(keyword, user_acl) : std::vector<Memory>{};
+    }
+    std::unordered_map<std::string, std::vector<Memory>> query_many(const std::vector<std::string>& keywords, const std::string& user_acl = "PUBLIC") {
+        if (sqlite_) return sqlite_->query_many(keywords, user_acl);
+        return {};
+    }
+    std::vector<Memory> search(const std::vector<MemoryQueryTerm>& terms, size_t k = 5, const std::string& user_acl = "PUBLIC", bool require_all = false) {
+        return sqlite_ ? sqlite_->search(terms, k, user_acl, require_all) : std::vector<Memory>{};
+    }
+    std::vector<std::vector<Memory>> search_many(const std::vector<std::vector<MemoryQueryTerm>>& queries, size_t k = 5, const std::string& user_acl = "PUBLIC", bool require_all = false) {
+        if (sqlite_) return sqlite_->search_many(queries, k, user_acl, require_all);
+        return std::vector<std::vector<Memory>>(queries.size());
+    }
+    std::vector<Memory> get_recent(int limit = 10) { return sqlite_ ? sqlite_->get_recent(limit) : std::vector<Memory>{}; }
+    long long get_memory_count() { return sqlite_ ? sqlite_->get_memory_count() : 0; }
+    std::string get_graph_json(int max_nodes = 50) { return sqlite_ ? sqlite_->get_graph_json(max_nodes) : "{}"; }
+    void clear() { if (sqlite_) sqlite_->clear(); }
     
-    void store_embedding(const std::string& key, const std::vector<double>& embedding) {}
-    std::vector<double> retrieve_embedding(const std::string& key) { return {}; }
-    std::vector<std::string> search_similar(const std::vector<double>& embedding, int limit) { return {}; }
+    // The stub keeps embeddings only in the in-process HNSW index
+    void store_embedding(const std::string& key, const std::vector<double>& embedding) {
+        if (sqlite_) {
+            sqlite_->store_embedding(key, embedding);
+            return;
+        }
+        std::unique_lock<std::shared_mutex> lock(vector_mutex_);
+        vectors_.add(key, embedding);
+    }
+    std::vector<double> retrieve_embedding(const std::string& key) {
+        if (sqlite_) return sqlite_->retrieve_embedding(key);
+        std::shared_lock<std::shared_mutex> lock(vector_mutex_);
+        return vectors_.vector(key);
+    }
+    std::vector<std::string> search_similar(const std::vector<double>& embedding, int limit) {
+        if (sqlite_) return sqlite_->search_similar(embedding, limit);
+        if (limit <= 0) return {};
+        std::shared_lock<std::shared_mutex> lock(vector_mutex_);
+        return vectors_.search_keys(embedding, static_cast<size_t>(limit));
+    }
     
     void optimize_latency() {}
+    dnn::PostingIndex::Stats index_stats() const { return {}; }
+    dnn::HnswIndex::Stats vector_stats() const {
+        if (sqlite_) return sqlite_->vector_stats();
+        std::shared_lock<std::shared_mutex> lock(vector_mutex_);
+        return vectors_.stats();
+    }
+
+private:
+    std::unique_ptr<SqliteMemoryStore> sqlite_;
+    mutable std::shared_mutex vector_mutex_;
+    dnn::HnswIndex vectors_;
+
+    void store_embeddings(const std::vector<MemoryRecord>& records) {
+        std::unique_lock<std::shared_mutex> lock(vector_mutex_);
+        for (const auto& r : records) {
+            if (!r.embedding_key.empty() && !r.embedding.empty()) vectors_.add(r.embedding_key, r.embedding);
+        }
+    }
 };
 #endif
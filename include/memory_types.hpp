@@ -0,0 +1,94 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include "hnsw_index.hpp"
+#include "infra/config.hpp"
+
+struct Memory {
+    int id;
+    long long timestamp;
+    std::string type; // "Observation", "Thought", "Research"
+    std::string content;
+    std::string tags;
+
+    // Feature 6 & 10 fields
+    std::string acl_label = "PUBLIC"; // PUBLIC, PRIVATE, RESTRICTED
+    double strength = 1.0; // Decay factor (Ebbinghaus)
+    long long last_recall_time = 0;
+    double score = 0.0; // BM25 relevance from MemoryStore::search
+};
+
+// One term of a ranked search; its text is tokenised like memory content, so
+// a multi-word entity contributes each of its words
+struct MemoryQueryTerm {
+    std::string text;
+    double weight = 1.0;
+};
+
+// One row for MemoryStore::store_batch; an embedding_key also writes the
+// embedding into the vector store in the same transaction.
+struct MemoryRecord {
+    std::string type;
+    std::string content;
+    std::string tags{};
+    std::string acl = "PUBLIC";
+    std::string embedding_key{}; // Optional fields are defaulted so {type, content} is a complete record
+    std::vector<double> embedding{};
+};
+
+// Index tokens of memory content: lower-cased alphabetic runs of three or more letters
+template <typename F>
+void for_each_memory_token(std::string_view content, F&& f) {
+    std::string token;
+    for (size_t i = 0; i <= content.size(); ++i) {
+        const unsigned char c = i < content.size() ? static_cast<unsigned char>(content[i]) : ' ';
+        if (std::isalpha(c)) {
+            token += static_cast<char>(std::tolower(c));
+            continue;
+        }
+        if (token.length() >= 3) f(token);
+        token.clear();
+    }
+}
+
+// HNSW parameters for the memory stores' embedding index
+inline dnn::HnswIndex::Options memory_vector_options() {
+    using dnn::infra::Config;
+    dnn::HnswIndex::Options options;
+    options.m = static_cast<size_t>(std::max(2, Config::get_int("BRAIN_HNSW_M", 16)));
+    options.ef_construction = static_cast<size_t>(std::max(1, Config::get_int("BRAIN_HNSW_EF_CONSTRUCTION", 200)));
+    options.ef_search = static_cast<size_t>(std::max(1, Config::get_int("BRAIN_HNSW_EF_SEARCH", 64)));
+    return options;
+}
+
+// The memory stores' vector snapshot is this header followed by
+// HnswIndex::write(): a magic number, the highest embedding_version the
+// index covers and, for PostgreSQL, the xmin of the snapshot that version
+// was read in (0 otherwise), so a load can catch up on rows written since,
+// including rows from transactions still in flight when it was read
+constexpr std::uint32_t kVectorSnapshotMagic = 0x32525653; // "SVR2"
+
+inline bool write_vector_header(std::ostream& os, long long version, long long xmin) {
+    const std::uint32_t magic = kVectorSnapshotMagic;
+    const std::int64_t fields[2] = {version, xmin};
+    os.write(reinterpret_cast<const char*>(&magic), sizeof(magic));
+    os.write(reinterpret_cast<const char*>(fields), sizeof(fields));
+    return static_cast<bool>(os);
+}
+
+inline bool read_vector_header(std::istream& is, long long& version, long long& xmin) {
+    std::uint32_t magic = 0;
+    std::int64_t fields[2] = {0, 0};
+    is.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+    is.read(reinterpret_cast<char*>(fields), sizeof(fields));
+    if (!is || magic != kVectorSnapshotMagic || fields[0] < 0 || fields[1] < 0) return false;
+    version = fields[0];
+    xmin = fields[1];
+    return true;
+}
@@ -0,0 +1,111 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#ifdef USE_POSTGRES
+#include <libpq-fe.h>
+#endif
+
+/**
+ * Bounded pool of libpq connections to one database, shared by every
+ * PostgresClient and PostgresStorage built on it (see shared()).
+ *
+ * Connections open lazily up to `max_connections`. checkout() hands out an
+ * idle one (most recently used first), opens a new one, or waits up to
+ * `checkout_timeout` for one to come back. A connection that libpq reports as
+ * broken, or that sat idle past `idle_check_after` and fails a ping, is reset
+ * before it is handed out. Each connection keeps its own prepared statements,
+ * which are dropped when it is reset.
+ */
+class PgConnectionPool {
+public:
+    struct Options {
+        size_t max_connections = 4;
+        std::chrono::milliseconds checkout_timeout{2000};
+        std::chrono::milliseconds idle_check_after{30000};
+    };
+
+    struct Stats {
+        uint64_t checkouts = 0;
+        uint64_t timeouts = 0;          // No connection within checkout_timeout
+        uint64_t connect_failures = 0;
+        uint64_t reconnects = 0;        // Resets after a failed health check
+        double total_wait_ms = 0.0;     // Time callers spent in checkout()
+        double max_wait_ms = 0.0;
+        size_t capacity = 0;
+        size_t open = 0;
+        size_t in_use = 0;
+        size_t max_in_use = 0;
+        size_t prepared = 0;            // Statements prepared across open connections
+        double mean_wait_ms() const { return checkouts ? total_wait_ms / static_cast<double>(checkouts) : 0.0; }
+        double utilisation() const { return capacity ? static_cast<double>(in_use) / static_cast<double>(capacity) : 0.0; }
+    };
+
+    struct Connection {
+        PGconn* conn = nullptr;
+        std::unordered_map<std::string, std::string> prepared; // SQL -> statement name
+        std::chrono::steady_clock::time_point last_used;
+    };
+
+    // Exclusive use of one connection until destroyed or released
+    class Lease {
+    public:
+        Lease() = default;
+        Lease(PgConnectionPool* pool, Connection* connection) : pool_(pool), connection_(connection) {}
+        ~Lease() { release(); }
+        Lease(Lease&& other) noexcept : pool_(other.pool_), connection_(other.connection_) { other.connection_ = nullptr; }
+        Lease& operator=(Lease&& other) noexcept;
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+
+        explicit operator bool() const { return connection_ != nullptr; }
+        PGconn* get() const { return connection_ ? connection_->conn : nullptr; }
+
+        // Name of `sql` prepared on this connection, preparing it on first use;
+        // nullptr if the server rejects it
+        const char* statement(const std::string& sql, const Oid* types = nullptr, int n_types = 0);
+        void release();
+
+    private:
+        PgConnectionPool* pool_ = nullptr;
+        Connection* connection_ = nullptr;
+    };
+
+    PgConnectionPool(std::string conn_str) : PgConnectionPool(std::move(conn_str), Options{}) {}
+    PgConnectionPool(std::string conn_str, Options options);
+    ~PgConnectionPool();
+
+    PgConnectionPool(const PgConnectionPool&) = delete;
+    PgConnectionPool& operator=(const PgConnectionPool&) = delete;
+
+    // One pool per connection string for the whole process, sized from
+    // BRAIN_PG_POOL_SIZE (4) and BRAIN_PG_CHECKOUT_MS (2000)
+    static std::shared_ptr<PgConnectionPool> shared(const std::string& conn_str);
+
+    // Empty lease on timeout or when no connection can be opened
+    Lease checkout();
+    Stats stats() const;
+    const Options& options() const { return options_; }
+    const std::string& connection_string() const { return conn_str_; }
+
+private:
+    void give_back(Connection* connection);
+    bool healthy(Connection& connection);
+
+    const std::string conn_str_;
+    const Options options_;
+    mutable std::mutex mutex_;
+    std::condition_variable available_;
+    std::vector<std::unique_ptr<Connection>> connections_;
+    std::vector<Connection*> idle_; // Most recently returned last
+    size_t opening_ = 0;            // Connects in progress, counted against capacity
+    size_t in_use_ = 0;
+    Stats stats_;
+    std::atomic<size_t> prepared_{0};
+};
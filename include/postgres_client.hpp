@@ -1,33 +1,152 @@
 #pragma once
 #include <string>
+#include <string_view>
 #include <vector>
+#include <unordered_map>
+#include <span>
+#include <initializer_list>
+#include <cstdint>
 #ifdef USE_POSTGRES
 #include <libpq-fe.h>
 #endif
-#include <mutex>
+#include <memory>
+#include <atomic>
+#include "pg_connection_pool.hpp"
 
 struct PostgresRow {
     std::vector<std::string> columns;
 };
 
+// One statement parameter. Scalars go over the wire in binary (no formatting
+// or parsing on either side); `literal` is sent as text with its type left to
+// the server, for array literals and the like.
+struct PgParam {
+    std::string value;
+    Oid type = 0;
+    int format = 1;
+
+    static PgParam int4(std::int32_t v);
+    static PgParam int8(std::int64_t v);
+    static PgParam float8(double v);
+    static PgParam text(std::string_view v);
+    static PgParam int4_array(std::span<const int> values);
+    static PgParam literal(std::string v);
+};
+
+// One statement of a pipelined burst (PostgresClient::execute_pipelined)
+struct PgStatement {
+    std::string sql;
+    std::vector<PgParam> params;
+};
+
+// Owns a binary-format result; rows are views into libpq's buffer, so reading
+// a cell copies nothing and integers are decoded straight from network order.
+class PgResult {
+public:
+    class Row {
+    public:
+        Row(const PGresult* res, int row) : res_(res), row_(row) {}
+        bool is_null(int col) const { return PQgetisnull(res_, row_, col) != 0; }
+        std::string_view text(int col) const {
+            return {PQgetvalue(res_, row_, col), static_cast<size_t>(PQgetlength(res_, row_, col))};
+        }
+        std::int64_t integer(int col) const; // int2, int4 or int8 columns; 0 when NULL
+        double float8(int col) const;
+        std::vector<float> vector(int col) const; // pgvector columns; empty when NULL
+    private:
+        const PGresult* res_;
+        int row_;
+    };
+
+    PgResult() = default;
+    explicit PgResult(PGresult* res) : res_(res) {}
+    ~PgResult() { if (res_) PQclear(res_); }
+    PgResult(PgResult&& other) noexcept : res_(other.res_) { other.res_ = nullptr; }
+    PgResult& operator=(PgResult&& other) noexcept;
+    PgResult(const PgResult&) = delete;
+    PgResult& operator=(const PgResult&) = delete;
+
+    bool ok() const;
+    int size() const { return res_ ? PQntuples(res_) : 0; }
+    const PGresult* get() const { return res_; }
+    bool empty() const { return size() == 0; }
+    Row operator[](int row) const { return Row(res_, row); }
+
+private:
+    PGresult* res_ = nullptr;
+};
+
+// Payload for COPY ... FROM STDIN (FORMAT binary): a signature header, then
+// per row a field count and a (length, bytes) pair per field, all in network
+// order, so the server parses nothing but lengths.
+class PgCopyBuffer {
+public:
+    PgCopyBuffer();
+
+    void begin_row(std::int16_t fields);
+    void add_null();
+    void add_int4(std::int32_t v);
+    void add_int8(std::int64_t v);
+    void add_float8(double v);
+    void add_text(std::string_view v);
+    void add_vector(std::span<const double> v); // pgvector: dimension, unused, float4 elements
+
+    size_t rows() const { return rows_; }
+    size_t bytes() const { return data_.size(); }
+    // Appends the trailer (once) and returns the payload
+    const std::string& finish();
+
+private:
+    std::string data_;
+    size_t rows_ = 0;
+    bool finished_ = false;
+};
+
+// Runs statements on connections checked out of a PgConnectionPool, so
+// clients sharing a pool no longer queue behind a single connection.
 class PostgresClient {
 public:
-    PostgresClient(const std::string& conn_str);
+    PostgresClient(const std::string& conn_str);                 // Uses PgConnectionPool::shared()
+    explicit PostgresClient(std::shared_ptr<PgConnectionPool> pool);
     ~PostgresClient();
     
     bool connect();
-    void disconnect();
-    bool is_connected() const { return connected; }
+    void disconnect(); // Stops issuing statements; the pool's connections stay up for other users
+    bool is_connected() const { return connected.load(std::memory_order_acquire); }
     
     bool execute(const std::string& sql);
     std::vector<PostgresRow> query(const std::string& sql);
+    // Parameterised statement ($1..$n, text format); ok reports success when given
+    std::vector<PostgresRow> query_params(const std::string& sql, const std::vector<std::string>& params, bool* ok = nullptr);
+
+    // Prepared on first use (per pooled connection) and reused by SQL text;
+    // binary parameters and results. Check ok() on the result.
+    PgResult execute_prepared(const std::string& sql, std::span<const PgParam> params = {});
+    PgResult execute_prepared(const std::string& sql, std::initializer_list<PgParam> params) {
+        return execute_prepared(sql, std::span<const PgParam>(params.begin(), params.size()));
+    }
+    // The same on a connection the caller already holds (e.g. inside BEGIN/COMMIT)
+    static PgResult execute_prepared(PgConnectionPool::Lease& lease, const std::string& sql, std::span<const PgParam> params = {});
+    size_t prepared_count() const;
+    PgConnectionPool& pool() const { return *pool_; }
+
+    // Streams `data` to `copy_sql` (COPY ... FROM STDIN); rows copied or -1
+    static long long copy_in(PGconn* conn, const std::string& copy_sql, std::string_view data);
+
+    // Sends every statement on one connection in libpq pipeline mode, without
+    // waiting for each reply, and returns one result per statement in order.
+    // Each statement commits on its own, so a failed one (result not ok())
+    // leaves the others in place. Replies are read every kPipelineDepth.
+    std::vector<PgResult> execute_pipelined(std::span<const PgStatement> statements);
+    static constexpr size_t kPipelineDepth = 256;
     
-    // Helper for parameterized inserts (returns ID or -1)
-    int store_memory(long long timestamp, const std::string& type, const std::string& content, const std::string& tags);
+    // One INSERT ... RETURNING with every column (returns ID or -1)
+    int store_memory(long long timestamp, const std::string& type, const std::string& content, const std::string& tags,
+                     const std::string& acl = "PUBLIC");
+    static const char* const kInsertMemorySql;
 
 private:
     std::string connection_string;
-    PGconn* conn;
-    bool connected;
-    mutable std::mutex db_mutex;
+    std::shared_ptr<PgConnectionPool> pool_;
+    std::atomic<bool> connected{false};
 };
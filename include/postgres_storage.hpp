@@ -3,12 +3,19 @@
 #include "db_interface.hpp"
 #ifdef USE_POSTGRES
 #include <libpq-fe.h>
+#include "pg_connection_pool.hpp"
+#include "postgres_client.hpp"
 #endif
 #include <mutex>
+#include <memory>
+#include <atomic>
 
 class PostgresStorage : public DatabaseInterface {
 public:
-    PostgresStorage(const std::string& conn_str);
+    PostgresStorage(const std::string& conn_str); // Uses PgConnectionPool::shared()
+#ifdef USE_POSTGRES
+    explicit PostgresStorage(std::shared_ptr<PgConnectionPool> pool);
+#endif
     ~PostgresStorage() override;
 
     bool connect() override;
@@ -22,20 +29,40 @@ public:
     std::vector<double> retrieve_embedding(const std::string& key) override;
     std::vector<std::string> search_similar(const std::vector<double>& embedding, int limit) override;
     
-    // Transaction support
+    // Transaction support: begin_transaction() pins one pooled connection to
+    // this object until commit() or rollback()
     bool begin_transaction() override;
     bool commit() override;
     bool rollback() override;
 
+#ifdef USE_POSTGRES
+    // Upserts COPY rows of (key, value, embedding) into brain_kv_store on
+    // `conn`, inside the caller's transaction; NULL fields keep the stored
+    // column (a new key's NULL value is stored as '') and keys must be
+    // unique. Rows written, or -1.
+    static long long copy_upsert(PGconn* conn, PgCopyBuffer& rows);
+#endif
+
 private:
     std::string connection_string;
 #ifdef USE_POSTGRES
-    PGconn* conn;
-#else
-    void* conn; // Placeholder
+    std::shared_ptr<PgConnectionPool> pool_;
+    PgConnectionPool::Lease transaction_;
+    std::mutex transaction_mutex_;
+
+    // A pooled connection for one call, or the pinned transaction connection
+    struct Handle {
+        PgConnectionPool::Lease owned;
+        std::unique_lock<std::mutex> pinned;
+        PgConnectionPool::Lease* lease = nullptr;
+        explicit operator bool() const { return lease && *lease; }
+        PGconn* get() const { return lease->get(); }
+    };
+    bool acquire(Handle& handle);
+    PGresult* exec_prepared(Handle& handle, const char* sql, int n_params, const char* const* values);
+    void execute_non_query(PGconn* conn, const std::string& sql);
 #endif
-    std::mutex db_mutex;
+    std::atomic<bool> connected_{false};
 
     bool check_status();
-    void execute_non_query(const std::string& sql);
 };
@@ -0,0 +1,175 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <array>
+#include <iosfwd>
+#include <memory>
+#include <span>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+
+namespace dnn {
+
+    /**
+     * Inverted index from interned terms to compressed posting lists.
+     *
+     * Each term is interned once to a dense TermId. Its postings are document
+     * ids kept sorted and unique, each with the term's frequency in that
+     * document, stored as varint (gap, tf) pairs in blocks of kBlockSize;
+     * every block has a skip entry (the previous block's last id and the
+     * block's byte offset), so a Cursor can seek past whole blocks and
+     * decodes one block at a time into flat arrays. Ids normally arrive in
+     * increasing order and are appended in place; an older id re-encodes its
+     * list. Document lengths are kept for BM25 ranking (search()). An index
+     * can be written to a snapshot and mapped back (write()/map_file()). Not
+     * thread-safe: the owner serialises writers against readers.
+     */
+    class PostingIndex {
+        struct List;
+
+    public:
+        using TermId = std::uint32_t;
+        static constexpr TermId kNoTerm = ~TermId{0};
+        static constexpr std::size_t kBlockSize = 128;
+
+        struct QueryTerm {
+            TermId term = kNoTerm;
+            double weight = 1.0; // Multiplies the term's BM25 contribution
+        };
+
+        struct Hit {
+            int doc = 0;
+            double score = 0.0;
+        };
+
+        struct Bm25 {
+            double k1 = 1.2; // Term frequency saturation
+            double b = 0.75; // Document length normalisation
+        };
+
+        struct Stats {
+            std::size_t terms = 0;
+            std::size_t documents = 0;  // Added with add_document()
+            std::size_t postings = 0;
+            std::size_t posting_bytes = 0; // Encoded gaps and skip entries
+            std::size_t bytes = 0;         // posting_bytes plus term strings and per-term overhead
+            std::size_t mapped_bytes = 0;  // Snapshot file still mapped by map_file()
+        };
+
+        // Caller-defined metadata stored with a snapshot
+        struct SnapshotInfo {
+            std::int64_t max_doc = -1;     // Highest id the snapshot covers
+            std::uint64_t rows = 0;
+            std::uint64_t fingerprint = 0; // Identifies the source the ids came from
+        };
+
+        static constexpr char kMagic[4] = {'B', 'P', 'I', 'X'};
+        static constexpr std::uint32_t kVersion = 1;
+
+        // Forward iterator over one term's ids with skip-based seeking
+        class Cursor {
+        public:
+            bool valid() const { return pos_ < size_; }
+            int doc() const { return block_[pos_]; }
+            std::uint32_t freq() const { return freq_[pos_]; }
+            void next();
+            void seek(int target); // First id >= target: skips, then galloping within the block
+        private:
+            friend class PostingIndex;
+            explicit Cursor(const List* list);
+            void load(std::size_t block);
+            const List* list_ = nullptr;
+            std::size_t block_index_ = 0;
+            std::array<int, kBlockSize> block_{};
+            std::array<std::uint32_t, kBlockSize> freq_{};
+            std::size_t size_ = 0;
+            std::size_t pos_ = 0;
+        };
+
+        TermId intern(std::string_view term);
+        TermId find(std::string_view term) const; // kNoTerm if never indexed
+        std::string_view term(TermId id) const { return terms_[id]; }
+        std::size_t term_count() const { return terms_.size(); }
+
+        // Duplicates of an id already in the list are ignored
+        void add(TermId term, int doc, std::uint32_t tf = 1);
+        void add(std::string_view term, int doc, std::uint32_t tf = 1) { add(intern(term), doc, tf); }
+        // Every token of one document: term frequencies and its length (once per id)
+        void add_document(int doc, std::span<const std::string> tokens);
+        std::uint32_t document_length(int doc) const;
+
+        std::size_t doc_frequency(TermId term) const;
+        Cursor cursor(TermId term) const;
+        std::vector<int> postings(TermId term) const;
+        // Up to `n` largest ids, largest first
+        std::vector<int> newest(TermId term, std::size_t n) const;
+        // Ids in both lists (leapfrogging cursors)
+        std::size_t intersect_count(TermId a, TermId b) const;
+
+        // Top `k` documents by weighted BM25, best first (newer first on ties).
+        // require_all intersects the lists (rarest first, galloping); otherwise
+        // any matching term counts. Unknown terms match nothing.
+        std::vector<Hit> search(std::span<const QueryTerm> terms, std::size_t k, bool require_all, Bm25 params) const;
+        std::vector<Hit> search(std::span<const QueryTerm> terms, std::size_t k, bool require_all = false) const {
+            return search(terms, k, require_all, Bm25{});
+        }
+
+        // Every term with a non-empty list
+        void for_each_term(const std::function<void(TermId, std::string_view, std::size_t)>& fn) const;
+        // Same documents, lengths and postings (term ids may differ)
+        bool equivalent(const PostingIndex& other) const;
+
+        // Snapshot: list headers, skips, document lengths, term strings and the
+        // encoded postings, laid out back to back so map_file() can use them in place
+        bool write(std::ostream& os, const SnapshotInfo& info) const;
+        // Replaces the contents with a snapshot. Lists read straight from the
+        // mapping (paged in on first use) until their first write copies them
+        // out; only the term table and document lengths are rebuilt, so loading
+        // costs one hash insert per term rather than a pass over the postings.
+        bool map_file(const std::string& path, SnapshotInfo& info);
+
+        void clear();
+        void shrink_to_fit(); // Drops growth slack after a large load
+        Stats stats() const;
+
+    private:
+        struct Skip {
+            int base;              // Last id of the previous block (-1 for the first)
+            std::uint32_t offset;  // Byte offset of the block
+        };
+        struct List {
+            std::vector<std::uint8_t> bytes; // Varint gap and tf per id (see put_posting)
+            std::vector<Skip> skips;         // One per block
+            std::uint32_t count = 0;
+            int last = -1;
+            // Set by map_file() until the list is first written
+            bool mapped = false;
+            std::span<const std::uint8_t> mapped_bytes;
+            std::span<const Skip> mapped_skips;
+
+            std::span<const std::uint8_t> encoded() const { return mapped ? mapped_bytes : std::span<const std::uint8_t>(bytes); }
+            std::span<const Skip> skip_list() const { return mapped ? mapped_skips : std::span<const Skip>(skips); }
+        };
+
+        static void append(List& list, int doc, std::uint32_t tf);
+        static void unmap(List& list); // Copies a mapped list onto the heap
+        static std::vector<std::pair<int, std::uint32_t>> decode(const List& list);
+
+        struct TermHash {
+            using is_transparent = void;
+            std::size_t operator()(std::string_view s) const noexcept { return std::hash<std::string_view>{}(s); }
+        };
+        std::unordered_map<std::string, TermId, TermHash, std::equal_to<>> ids_;
+        std::vector<std::string_view> terms_; // Views of ids_ keys (node-stable)
+        std::vector<List> lists_;
+        std::vector<std::uint32_t> doc_lengths_; // By id; 0 for ids without add_document()
+        std::size_t documents_ = 0;
+        std::uint64_t total_length_ = 0;
+        std::shared_ptr<const void> mapping_; // Backs the mapped lists; munmap on release
+        std::size_t mapping_bytes_ = 0;
+    };
+
+} // namespace dnn
@@ -0,0 +1,115 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <list>
+#include <span>
+#include <memory>
+#include <mutex>
+#include <future>
+#include <chrono>
+#include <optional>
+#include <functional>
+#include <unordered_map>
+#include <cstdint>
+#include "memory_types.hpp"
+#include "redis_client.hpp"
+
+namespace dnn {
+
+    /**
+     * Two-level cache for recall results: sharded in-process LRU lists with a
+     * TTL (L1) in front of an optional Redis shared by replicas (L2).
+     *
+     * A key hashes to one of `shards` independently locked LRU lists, so
+     * concurrent lookups of different keys rarely contend and an L1 hit costs
+     * a hash and a splice. L1 misses try L2 and promote what they find.
+     * get_or_load() runs the loader once per key for all concurrent callers
+     * (the others wait for its result) and caches what it returns in both
+     * levels. invalidate() and clear() remove entries from both levels, and a
+     * load that overlaps them is handed to its callers but not cached.
+     */
+    class RecallCache {
+    public:
+        using Clock = std::chrono::steady_clock;
+        using Loader = std::function<std::optional<std::string>()>; // nullopt: nothing to cache
+
+        struct Options {
+            std::size_t capacity = 4096; // Entries across all shards
+            std::size_t shards = 16;     // Rounded up to a power of two
+            std::chrono::milliseconds ttl{60000};
+            std::string l2_prefix = "recall:"; // Namespace of this cache's Redis keys
+        };
+
+        struct Stats {
+            std::uint64_t hits = 0;      // L1
+            std::uint64_t l2_hits = 0;
+            std::uint64_t misses = 0;    // Neither level
+            std::uint64_t coalesced = 0; // Waited for another caller's load
+            std::uint64_t evictions = 0;
+            std::uint64_t expired = 0;
+            std::uint64_t invalidations = 0;
+            std::size_t entries = 0;
+            double hit_rate() const {
+                const auto lookups = hits + l2_hits + misses + coalesced;
+                return lookups ? static_cast<double>(hits + l2_hits + coalesced) / static_cast<double>(lookups) : 0.0;
+            }
+        };
+
+        RecallCache() : RecallCache(Options{}) {}
+        explicit RecallCache(Options options, std::shared_ptr<RedisClient> l2 = nullptr);
+
+        const Options& options() const { return options_; }
+        // Redis usually connects after the cache is built; null detaches it
+        void set_l2(std::shared_ptr<RedisClient> l2);
+
+        std::optional<std::string> get(const std::string& key);
+        void put(const std::string& key, std::string value);
+        // get(), or `load` once for every concurrent caller of the same key
+        std::optional<std::string> get_or_load(const std::string& key, const Loader& load);
+        void invalidate(std::span<const std::string> keys); // One Redis DEL for all of them
+        void invalidate(const std::string& key) { invalidate(std::span<const std::string>(&key, 1)); }
+        void clear();
+
+        Stats stats() const;
+
+    private:
+        struct Entry {
+            std::string key;
+            std::string value;
+            Clock::time_point expires;
+        };
+        struct Flight {
+            std::shared_future<std::optional<std::string>> result;
+            bool cacheable = true; // Cleared by an invalidation during the load
+        };
+        struct Shard {
+            mutable std::mutex mutex;
+            std::list<Entry> lru; // Most recent first
+            std::unordered_map<std::string, std::list<Entry>::iterator> index;
+            std::unordered_map<std::string, std::shared_ptr<Flight>> loading;
+            Stats stats;
+        };
+
+        Shard& shard_for(const std::string& key);
+        // Caller holds the shard's mutex
+        std::optional<std::string> lookup(Shard& shard, const std::string& key, Clock::time_point now);
+        void insert(Shard& shard, const std::string& key, std::string value, Clock::time_point now);
+        std::shared_ptr<RedisClient> l2() const;
+        int l2_ttl_seconds() const; // Whole seconds, at least 1
+
+        Options options_;
+        std::size_t shard_capacity_;
+        std::vector<Shard> shards_;
+        mutable std::mutex l2_mutex_;
+        std::shared_ptr<RedisClient> l2_;
+    };
+
+    // Length-prefixed binary form of recall results, for cache values: a u32
+    // count, then per memory its id, timestamp, strength, last recall and
+    // score as fixed-width little-endian fields and its type, content, tags
+    // and ACL label as (u32 length, bytes). Any byte may appear in a field.
+    std::string encode_memories(std::span<const Memory> memories);
+    std::optional<std::vector<Memory>> decode_memories(std::string_view bytes); // nullopt if malformed
+
+} // namespace dnn
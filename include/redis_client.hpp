@@ -3,6 +3,8 @@
 #include <iostream>
 #include <mutex>
 #include <optional>
+#include <vector>
+#include <chrono>
 
 #ifdef USE_REDIS
 #include <hiredis/hiredis.h>
@@ -20,6 +22,8 @@ public:
 
     bool connect() {
         if (context_) return true;
+        // A down server costs one connect timeout per backoff, not per call
+        if (std::chrono::steady_clock::now() < retry_at_) return false;
         
         struct timeval timeout = { 1, 500000 }; // 1.5 seconds
         context_ = redisConnectWithTimeout(host_.c_str(), port_, timeout);
@@ -32,41 +36,105 @@ public:
             } else {
                 std::cerr << "Connection error: can't allocate redis context" << std::endl;
             }
+            retry_at_ = std::chrono::steady_clock::now() + std::chrono::seconds(5);
             return false;
         }
         std::cout << "Connected to Redis at " << host_ << ":" << port_ << std::endl;
         return true;
     }
 
+    // Keys and values are binary-safe
     void set(const std::string& key, const std::string& value, int ttl_seconds = 60) {
         std::lock_guard<std::mutex> lock(mutex_);
         if (!connect()) return;
 
-        redisReply* reply = (redisReply*)redisCommand(context_, "SETEX %s %d %s", key.c_str(), ttl_seconds, value.c_str());
-        if (reply) freeReplyObject(reply);
+        redisReply* reply = (redisReply*)redisCommand(context_, "SETEX %b %d %b", key.data(), key.size(), ttl_seconds,
+                                                      value.data(), value.size());
+        release(reply);
     }
 
     std::optional<std::string> get(const std::string& key) {
         std::lock_guard<std::mutex> lock(mutex_);
         if (!connect()) return std::nullopt;
 
-        redisReply* reply = (redisReply*)redisCommand(context_, "GET %s", key.c_str());
+        redisReply* reply = (redisReply*)redisCommand(context_, "GET %b", key.data(), key.size());
         std::optional<std::string> result;
         
         if (reply) {
             if (reply->type == REDIS_REPLY_STRING) {
                 result = std::string(reply->str, reply->len);
             }
-            freeReplyObject(reply);
         }
+        release(reply);
         return result;
     }
 
+    // One DEL for all keys
+    void del(const std::vector<std::string>& keys) {
+        if (keys.empty()) return;
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!connect()) return;
+
+        std::vector<const char*> argv{"DEL"};
+        std::vector<size_t> lengths{3};
+        for (const auto& key : keys) {
+            argv.push_back(key.data());
+            lengths.push_back(key.size());
+        }
+        release((redisReply*)redisCommandArgv(context_, static_cast<int>(argv.size()), argv.data(), lengths.data()));
+    }
+
+    // Deletes every key matching a glob pattern, walking the keyspace with SCAN
+    // so the server is never blocked the way KEYS would block it
+    void del_matching(const std::string& pattern) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!connect()) return;
+
+        std::string cursor = "0";
+        do {
+            redisReply* reply = (redisReply*)redisCommand(context_, "SCAN %s MATCH %b COUNT 500", cursor.c_str(),
+                                                          pattern.data(), pattern.size());
+            if (!reply || reply->type != REDIS_REPLY_ARRAY || reply->elements != 2) {
+                release(reply);
+                return;
+            }
+            cursor.assign(reply->element[0]->str, reply->element[0]->len);
+            const redisReply* keys = reply->element[1];
+            if (keys->elements > 0) {
+                std::vector<const char*> argv{"DEL"};
+                std::vector<size_t> lengths{3};
+                for (size_t i = 0; i < keys->elements; ++i) {
+                    argv.push_back(keys->element[i]->str);
+                    lengths.push_back(keys->element[i]->len);
+                }
+                redisReply* deleted = (redisReply*)redisCommandArgv(context_, static_cast<int>(argv.size()), argv.data(), lengths.data());
+                if (!deleted) {
+                    freeReplyObject(reply);
+                    release(nullptr);
+                    return;
+                }
+                freeReplyObject(deleted);
+            }
+            freeReplyObject(reply);
+        } while (cursor != "0");
+    }
+
 private:
+    // A null reply means the connection broke; drop it so the next call reconnects
+    void release(redisReply* reply) {
+        if (reply) {
+            freeReplyObject(reply);
+        } else if (context_) {
+            redisFree(context_);
+            context_ = nullptr;
+        }
+    }
+
     std::string host_;
     int port_;
     redisContext* context_;
     std::mutex mutex_;
+    std::chrono::steady_clock::time_point retry_at_{};
 };
 #else
 
@@ -79,5 +147,7 @@ public:
     bool connect() { return false; } // Fail silently or just pretend
     void set(const std::string& key, const std::string& value, int ttl_seconds = 60) {}
     std::optional<std::string> get(const std::string& key) { return std::nullopt; }
+    void del(const std::vector<std::string>&) {}
+    void del_matching(const std::string&) {}
 };
 #endif
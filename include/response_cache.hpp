@@ -0,0 +1,86 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <mutex>
+#include <chrono>
+#include <optional>
+#include <cstdint>
+
+namespace dnn {
+
+    /**
+     * Memoised replies for repeated inputs (health probes, greetings, bots).
+     *
+     * Entries are keyed by a normalised input plus the caller's mood flags and
+     * are tagged with a state epoch; the owner bumps the epoch when weights,
+     * vocabulary or personality change meaningfully, which makes every older
+     * entry a miss. Entries also expire after `ttl` and the least recently
+     * used one is evicted beyond `capacity`. With `learn_on_hit`, hits are
+     * counted per entry and handed to the sleep-time replay instead of
+     * training inline.
+     */
+    class ResponseCache {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        struct Options {
+            bool enabled = false;
+            std::size_t capacity = 256;
+            std::chrono::milliseconds ttl{60000};
+            bool learn_on_hit = false;
+        };
+
+        struct Stats {
+            std::uint64_t hits = 0;
+            std::uint64_t misses = 0;
+            std::uint64_t stale = 0;     // Misses on an entry from an older epoch or past its TTL
+            std::uint64_t evictions = 0; // Capacity evictions
+            std::size_t entries = 0;
+            double hit_rate() const { return hits + misses ? static_cast<double>(hits) / static_cast<double>(hits + misses) : 0.0; }
+        };
+
+        ResponseCache() : ResponseCache(Options{}) {}
+        explicit ResponseCache(Options options) : options_(options) {}
+
+        void configure(Options options);
+        const Options& options() const { return options_; }
+        bool enabled() const { return options_.enabled; }
+
+        // Lower-cased, whitespace collapsed, trailing punctuation dropped
+        static std::string normalise(const std::string& input);
+
+        std::optional<std::string> lookup(const std::string& key, std::uint64_t epoch, Clock::time_point now);
+        // `input` is what take_hit_pairs() replays for this entry
+        void insert(const std::string& key, std::string input, std::string response, std::uint64_t epoch, Clock::time_point now);
+        void clear();
+
+        // (input, response) pairs hit since the last call, once per hit (learn_on_hit)
+        std::vector<std::pair<std::string, std::string>> take_hit_pairs();
+
+        Stats stats() const;
+
+    private:
+        struct Entry {
+            std::string key;
+            std::string input;
+            std::string response;
+            std::uint64_t epoch = 0;
+            Clock::time_point stored;
+            std::uint32_t unlearned_hits = 0;
+        };
+
+        void evict_to(std::size_t size);
+        void retire(Entry& entry); // Keeps its unlearned hits for take_hit_pairs()
+
+        Options options_;
+        mutable std::mutex mutex_;
+        std::list<Entry> lru_; // Most recent first
+        std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+        std::vector<std::pair<std::string, std::string>> retired_hits_; // Bounded by kMaxRetiredHits
+        static constexpr std::size_t kMaxRetiredHits = 1024;
+        Stats stats_;
+    };
+
+} // namespace dnn
@@ -0,0 +1,130 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include "brain_clock.hpp"
+
+namespace dnn {
+
+    /**
+     * Periodic job scheduler with a small worker pool.
+     *
+     * Each registered job has its own period and deadline. A dispatcher thread
+     * keeps jobs ordered by next due time and hands due jobs to the workers; a
+     * job never overlaps itself (a tick that finds it still running is skipped
+     * and counted). Long one-off work (research, tool calls) goes through
+     * submit_async() and runs on separate threads so it cannot stall the ticks.
+     *
+     * Constructed with a VirtualClock the scheduler is manual: no threads,
+     * advance() runs due jobs inline in due-time order, moving the clock to
+     * each job's due time, and async work executes immediately.
+     */
+    class Scheduler {
+    public:
+        using Clock = std::chrono::steady_clock;
+        using Duration = std::chrono::milliseconds;
+        using JobFn = std::function<void()>;
+
+        struct JobStats {
+            std::string name;
+            Duration period{0};
+            Duration deadline{0};
+            std::uint64_t runs = 0;
+            std::uint64_t deadline_misses = 0;  // Started late + ran longer than the deadline allows
+            std::uint64_t skipped_overlaps = 0; // Due while the previous run was still going
+            double last_ms = 0.0;
+            double max_ms = 0.0;
+        };
+
+        explicit Scheduler(std::size_t workers = 2, std::size_t async_workers = 2);
+        explicit Scheduler(std::shared_ptr<VirtualClock> clock);
+        ~Scheduler(); // stop()
+
+        Scheduler(const Scheduler&) = delete;
+        Scheduler& operator=(const Scheduler&) = delete;
+
+        // Register a periodic job; first run after one period unless run_immediately.
+        // A zero deadline means "within one period". Names are unique; re-adding replaces.
+        void add_job(const std::string& name, Duration period, JobFn fn,
+                     Duration deadline = Duration{0}, bool run_immediately = false);
+        bool remove_job(const std::string& name);
+        bool set_period(const std::string& name, Duration period);
+
+        // Long-running one-off work, off the periodic pool.
+        std::future<void> submit_async(const std::string& name, JobFn fn);
+        std::size_t async_pending() const;
+
+        // Manual mode only: run everything due within the next dt of virtual time.
+        // Returns the number of job runs.
+        std::size_t advance(Duration dt);
+        bool is_manual() const { return clock_ != nullptr; }
+
+        void start();
+        void stop(); // Waits for running jobs; queued async work is drained
+        bool is_running() const;
+
+        std::vector<JobStats> stats() const;
+
+    private:
+        struct Job {
+            JobFn fn;
+            JobStats stats;
+            Clock::time_point next_due;
+            std::uint64_t generation = 0; // Bumped on replace/reschedule to drop stale heap entries
+            bool running = false;
+        };
+        struct DueEntry {
+            Clock::time_point due;
+            std::string name;
+            std::uint64_t generation;
+            bool operator>(const DueEntry& o) const { return due > o.due; }
+        };
+        struct Work {
+            std::string name;
+            Clock::time_point due;
+            std::uint64_t generation;
+        };
+        struct AsyncWork {
+            std::string name;
+            JobFn fn;
+            std::promise<void> done;
+        };
+
+        void dispatcher_loop();
+        void worker_loop();
+        void async_worker_loop();
+        void push_due(const std::string& name, Job& job);
+        Clock::time_point now() const { return clock_ ? clock_->now() : Clock::now(); }
+        void finish_run(const std::string& name, Clock::time_point due, Clock::time_point start, Clock::time_point end);
+
+        std::size_t worker_count_;
+        std::size_t async_worker_count_;
+        std::shared_ptr<VirtualClock> clock_; // Set: manual mode
+
+        mutable std::mutex mutex_;
+        std::condition_variable dispatch_cv_;
+        std::condition_variable work_cv_;
+        std::condition_variable async_cv_;
+        std::map<std::string, Job> jobs_;
+        std::vector<DueEntry> heap_; // Min-heap on due time
+        std::deque<Work> work_;
+        std::deque<AsyncWork> async_work_;
+        std::size_t async_busy_ = 0;
+        bool running_ = false;
+        bool stopping_ = false;
+
+        std::thread dispatcher_;
+        std::vector<std::thread> workers_;
+        std::vector<std::thread> async_workers_;
+    };
+
+} // namespace dnn
@@ -3,6 +3,9 @@
 #include <string>
 #include <mutex>
 #include <atomic>
+#include <memory>
+#include <algorithm>
+#include <cstdint>
 
 namespace dnn {
 
@@ -23,24 +26,104 @@ namespace dnn {
 
         // Process raw input and convert to a feature vector (e.g. 384-dim)
         virtual std::vector<double> process_raw(const std::vector<unsigned char>& raw_data) = 0;
-        
+
         // Return current activity buffer for visualization
         virtual std::vector<double> get_current_activity() const {
-            std::lock_guard<std::mutex> lock(mu_);
-            return active_features_;
+            return snapshot();
+        }
+
+        /**
+         * Lock-free view of the last published feature vector.
+         *
+         * Features are double-buffered: the producer fills the slot readers are
+         * not pointed at, then flips `published_`. Each slot carries a sequence
+         * number that is odd while it is being written, so a reader that used
+         * the data in place confirms it with read_valid() afterwards and retries
+         * in the rare case the producer lapped it (two publishes mid-read).
+         */
+        struct FeatureView {
+            const double* data = nullptr;
+            size_t size = 0;
+            uint64_t version = 0; // Publish count; 0 before the first publish
+            uint64_t seq = 0;
+        };
+
+        FeatureView read_begin() const {
+            while (true) {
+                uint64_t version = published_.load(std::memory_order_acquire);
+                const Slot& slot = slots_[version & 1];
+                uint64_t seq = slot.seq.load(std::memory_order_acquire);
+                if (seq & 1) continue; // Being rewritten: the producer has moved on
+                // Size before data: a grown size is only visible with its grown buffer
+                size_t size = slot.size.load(std::memory_order_acquire);
+                return {slot.data.load(std::memory_order_acquire), size, version, seq};
+            }
+        }
+
+        bool read_valid(const FeatureView& view) const {
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return slots_[view.version & 1].seq.load(std::memory_order_relaxed) == view.seq;
+        }
+
+        // Consistent copy of the published features
+        std::vector<double> snapshot() const {
+            std::vector<double> out;
+            while (true) {
+                FeatureView view = read_begin();
+                out.assign(view.data, view.data + view.size);
+                if (read_valid(view)) return out;
+            }
         }
 
-        void set_focus(double level) { focus_level_ = level; }
-        double get_focus() const { return focus_level_; }
+        uint64_t feature_version() const { return published_.load(std::memory_order_acquire); }
+
+        void set_focus(double level) { focus_level_.store(level, std::memory_order_relaxed); }
+        double get_focus() const { return focus_level_.load(std::memory_order_relaxed); }
 
         bool is_active() const { return active_; }
         void set_active(bool a) { active_ = a; }
 
     protected:
+        // Makes `features` the vector readers see. One writer at a time: units
+        // publish while holding mu_.
+        void publish(const std::vector<double>& features) {
+            uint64_t next = published_.load(std::memory_order_relaxed) + 1;
+            Slot& slot = slots_[next & 1];
+            uint64_t seq = slot.seq.load(std::memory_order_relaxed);
+            slot.seq.store(seq + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+
+            if (features.size() > slot.capacity) {
+                // A lagging reader may still hold the old pointer; keep it alive
+                auto grown = std::make_unique<double[]>(features.size());
+                slot.data.store(grown.get(), std::memory_order_relaxed);
+                slot.capacity = features.size();
+                if (slot.storage) retired_.push_back(std::move(slot.storage));
+                slot.storage = std::move(grown);
+            }
+            std::copy(features.begin(), features.end(), slot.storage.get());
+            slot.size.store(features.size(), std::memory_order_release);
+
+            slot.seq.store(seq + 2, std::memory_order_release);
+            published_.store(next, std::memory_order_release);
+        }
+
         mutable std::mutex mu_;
         std::vector<double> active_features_;
         std::atomic<double> focus_level_{1.0}; // 0.0 to 1.0
         std::atomic<bool> active_{true};
+
+    private:
+        struct alignas(64) Slot {
+            std::atomic<uint64_t> seq{0};
+            std::atomic<const double*> data{nullptr};
+            std::atomic<size_t> size{0};
+            std::unique_ptr<double[]> storage; // Writer side
+            size_t capacity = 0;
+        };
+        Slot slots_[2];
+        std::atomic<uint64_t> published_{0};
+        std::vector<std::unique_ptr<double[]>> retired_;
     };
 
 } // namespace dnn
@@ -7,6 +7,7 @@
 #include <functional>
 #include <netinet/in.h>
 #include <map>
+#include <cstdint>
 #include "rate_limiter.hpp"
 
 class TcpServer {
@@ -28,6 +29,12 @@ public:
     // Set authentication token
     void set_token(const std::string& token);
 
+    // Clients that would receive a broadcast
+    std::size_t client_count();
+    // Bumped whenever a client starts receiving broadcasts; unlike client_count()
+    // it still moves when a disconnect and a connect cancel out
+    std::uint64_t join_generation() const { return joins_.load(std::memory_order_acquire); }
+
     int get_port() const { return port_; }
     std::string get_name() const { return name_; }
 
@@ -50,6 +57,7 @@ private:
     std::vector<int> client_sockets_;
     std::vector<int> authenticated_sockets_;
     std::mutex clients_mutex_;
+    std::atomic<std::uint64_t> joins_{0};
     
     // Rate Limiting
     dnn::RateLimiter rate_limiter_;
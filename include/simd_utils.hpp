@@ -30,6 +30,31 @@ namespace simd {
         return total;
     }
 
+    // Single precision dot product (embedding search): two accumulators of 8
+    inline float dot_product(const float* a, const float* b, size_t n) {
+        __m256 sum0 = _mm256_setzero_ps();
+        __m256 sum1 = _mm256_setzero_ps();
+        size_t i = 0;
+
+        for (; i + 16 <= n; i += 16) {
+            sum0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), sum0);
+            sum1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), sum1);
+        }
+        for (; i + 8 <= n; i += 8) {
+            sum0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), sum0);
+        }
+
+        alignas(32) float res[8];
+        _mm256_store_ps(res, _mm256_add_ps(sum0, sum1));
+        float total = ((res[0] + res[1]) + (res[2] + res[3])) + ((res[4] + res[5]) + (res[6] + res[7]));
+
+        for (; i < n; ++i) {
+            total += a[i] * b[i];
+        }
+
+        return total;
+    }
+
     // Optimized vector addition: dest += src * scale
     inline void add_scaled(double* dest, const double* src, double scale, size_t n) {
         __m256d vscale = _mm256_set1_pd(scale);
@@ -47,5 +72,20 @@ namespace simd {
         }
     }
 
+    // In-place scaling: dest *= scale
+    inline void scale(double* dest, double scale, size_t n) {
+        __m256d vscale = _mm256_set1_pd(scale);
+        const size_t vector_end = n & ~size_t{3}; // A bound GCC can prove does not wrap
+        size_t i = 0;
+
+        for (; i < vector_end; i += 4) {
+            _mm256_storeu_pd(dest + i, _mm256_mul_pd(_mm256_loadu_pd(dest + i), vscale));
+        }
+
+        for (; i < n; ++i) {
+            dest[i] *= scale;
+        }
+    }
+
 } // namespace simd
 } // namespace dnn
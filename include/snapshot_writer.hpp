@@ -0,0 +1,97 @@
+#pragma once
+#include <string>
+#include <functional>
+#include <future>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <streambuf>
+#include <ostream>
+#include <vector>
+
+namespace dnn {
+
+    /**
+     * std::streambuf over a raw file descriptor with a large staging buffer.
+     * Small writes (headers, lengths) are coalesced; payloads bigger than the
+     * buffer (weight matrices) go straight to write(2) without an extra copy.
+     */
+    class FdStreamBuf : public std::streambuf {
+    public:
+        FdStreamBuf(int fd, std::size_t buffer_bytes);
+        ~FdStreamBuf() override;
+
+        bool failed() const { return failed_; }
+
+    protected:
+        int_type overflow(int_type ch) override;
+        std::streamsize xsputn(const char* s, std::streamsize n) override;
+        int sync() override;
+
+    private:
+        bool flush_buffer();
+        bool write_all(const char* data, std::size_t len);
+
+        int fd_;
+        std::vector<char> buffer_;
+        bool failed_ = false;
+    };
+
+    /**
+     * Background writer for state snapshots.
+     * Every job streams into "<path>.tmp", is fsync'd and then renamed over
+     * <path>, so readers only ever observe a complete previous or complete new file.
+     * Append jobs (checkpoint logs) write to the end of <path> and fsync instead.
+     * Jobs run in submission order on a single thread.
+     */
+    class SnapshotWriter {
+    public:
+        using WriteFn = std::function<bool(std::ostream&)>;
+        using DoneFn = std::function<void(bool)>; // Runs on the writer thread before the future resolves
+
+        explicit SnapshotWriter(std::size_t buffer_bytes = 4 * 1024 * 1024);
+        ~SnapshotWriter(); // Drains queued jobs before returning
+
+        SnapshotWriter(const SnapshotWriter&) = delete;
+        SnapshotWriter& operator=(const SnapshotWriter&) = delete;
+
+        // Queue a write; the future resolves once the file has been renamed into place.
+        std::future<bool> submit(const std::string& path, WriteFn fn, DoneFn on_done = nullptr);
+
+        // Same atomic-replace semantics, executed on the calling thread.
+        bool write_now(const std::string& path, const WriteFn& fn);
+
+        // Append to <path> (created if missing); ordered with the replace jobs.
+        std::future<bool> submit_append(const std::string& path, WriteFn fn, DoneFn on_done = nullptr);
+        bool append_now(const std::string& path, const WriteFn& fn);
+
+        // Block until every queued job has finished.
+        void wait_idle();
+        std::size_t pending() const;
+
+    private:
+        struct Job {
+            std::string path;
+            WriteFn fn;
+            std::promise<bool> done;
+            bool append = false;
+            DoneFn on_done;
+        };
+
+        std::future<bool> enqueue(Job job);
+        bool stream_to_fd(int fd, const WriteFn& fn);
+
+        void worker_loop();
+
+        std::size_t buffer_bytes_;
+        std::deque<Job> queue_;
+        mutable std::mutex mutex_;
+        std::condition_variable cv_;
+        std::condition_variable idle_cv_;
+        bool busy_ = false;
+        bool stopping_ = false;
+        std::thread worker_;
+    };
+
+} // namespace dnn
@@ -18,6 +18,7 @@ namespace dnn {
     public:
         SpatialUnit() {
             active_features_.resize(384, 0.0);
+            publish(active_features_);
         }
 
         std::string name() const override { return "Spatial Cortex (Lidar)"; }
@@ -59,6 +60,7 @@ namespace dnn {
                 }
             }
 
+            publish(active_features_);
             return active_features_;
         }
 
@@ -0,0 +1,103 @@
+#pragma once
+#include <sqlite3.h>
+#include <string>
+#include <string_view>
+#include <span>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+
+// A prepared statement borrowed from SqliteClient's cache; reset and unbound
+// when it goes out of scope. Parameters count from 1 and columns from 0, as
+// in SQLite. Use it while holding the client's lock().
+class SqliteStatement {
+public:
+    SqliteStatement() = default;
+    explicit SqliteStatement(sqlite3_stmt* stmt) : stmt_(stmt) {}
+    SqliteStatement(SqliteStatement&& other) noexcept : stmt_(std::exchange(other.stmt_, nullptr)), failed_(other.failed_) {}
+    SqliteStatement& operator=(SqliteStatement&&) = delete;
+    ~SqliteStatement();
+
+    explicit operator bool() const { return stmt_ != nullptr; }
+    bool ok() const { return stmt_ && !failed_; }
+
+    SqliteStatement& bind_text(int index, std::string_view v);
+    SqliteStatement& bind_int(int index, std::int64_t v);
+    SqliteStatement& bind_double(int index, double v);
+    SqliteStatement& bind_blob(int index, std::span<const std::uint8_t> v);
+    SqliteStatement& bind_null(int index);
+
+    bool step(); // True while a row is available; check ok() after the last
+    bool run();  // Steps to completion; false on error
+    void reset(); // Ready to bind and run again
+
+    int columns() const { return sqlite3_column_count(stmt_); }
+    bool is_null(int col) const { return sqlite3_column_type(stmt_, col) == SQLITE_NULL; }
+    std::int64_t integer(int col) const { return sqlite3_column_int64(stmt_, col); }
+    double real(int col) const { return sqlite3_column_double(stmt_, col); }
+    std::string_view text(int col) const;
+    std::span<const std::uint8_t> blob(int col) const;
+
+private:
+    sqlite3_stmt* stmt_ = nullptr;
+    bool failed_ = false;
+};
+
+/**
+ * One SQLite connection for in-process storage: WAL journal (readers never
+ * block the writer), synchronous=NORMAL (a commit is an append to the WAL, not
+ * an fsync) and a busy timeout for other processes on the same file.
+ * Statements are prepared once and cached by SQL text. The connection is not
+ * shared between threads: callers take lock() around each operation, and a
+ * SqliteTransaction keeps it for its whole lifetime.
+ */
+class SqliteClient {
+public:
+    explicit SqliteClient(std::string path); // A file, or ":memory:"
+    ~SqliteClient();
+    SqliteClient(const SqliteClient&) = delete;
+    SqliteClient& operator=(const SqliteClient&) = delete;
+
+    bool open(); // Creates the file (and its directory) on first use
+    void close();
+    bool is_open() const { return db_ != nullptr; }
+    const std::string& path() const { return path_; }
+
+    std::unique_lock<std::recursive_mutex> lock() { return std::unique_lock<std::recursive_mutex>(mutex_); }
+    // Runs one or more statements without results
+    bool execute(const char* sql);
+    SqliteStatement prepare(const std::string& sql);
+    std::int64_t last_insert_id() const { return sqlite3_last_insert_rowid(db_); }
+    bool in_transaction() const { return db_ && !sqlite3_get_autocommit(db_); }
+    std::string error() const { return db_ ? sqlite3_errmsg(db_) : "not open"; }
+    size_t prepared_count() const { return statements_.size(); }
+
+private:
+    std::string path_;
+    sqlite3* db_ = nullptr;
+    std::recursive_mutex mutex_;
+    std::unordered_map<std::string, sqlite3_stmt*> statements_;
+};
+
+// BEGIN IMMEDIATE ... COMMIT, or a savepoint when the client is already in a
+// transaction, holding the client's lock throughout; rolls back unless
+// committed. Commit or roll back on the thread that began it.
+class SqliteTransaction {
+public:
+    explicit SqliteTransaction(SqliteClient& client);
+    ~SqliteTransaction();
+    SqliteTransaction(const SqliteTransaction&) = delete;
+    SqliteTransaction& operator=(const SqliteTransaction&) = delete;
+
+    explicit operator bool() const { return active_; }
+    bool commit();
+    void rollback();
+
+private:
+    SqliteClient& client_;
+    std::unique_lock<std::recursive_mutex> lock_;
+    bool nested_ = false;
+    bool active_ = false;
+};
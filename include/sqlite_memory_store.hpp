@@ -0,0 +1,89 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <atomic>
+#include <unordered_map>
+#include "memory_types.hpp"
+#include "hnsw_index.hpp"
+#include "sqlite_client.hpp"
+#include "sqlite_storage.hpp"
+
+/**
+ * The MemoryStore API on one embedded SQLite file, for single-node
+ * deployments without a database server (MemoryStore forwards to it for
+ * "sqlite:" connection strings).
+ *
+ * The memories table matches PostgreSQL's. An FTS5 index over content,
+ * kept in step by a trigger, answers query() (newest matches per keyword)
+ * and search() (FTS5's BM25, k1 1.2 and b 0.75 like PostingIndex). Its
+ * tokenizer splits on digits as well, so its tokens are the same alphabetic
+ * runs the PostgreSQL store indexes. Writes go through cached prepared
+ * statements; batches are one transaction. Embeddings live in
+ * brain_kv_store (SqliteStorage, same connection, so a batch's rows and
+ * embeddings commit together) and in an in-process HNSW index that is
+ * snapshotted beside the database.
+ */
+class SqliteMemoryStore {
+public:
+    explicit SqliteMemoryStore(const std::string& path); // A file, or ":memory:"
+    ~SqliteMemoryStore();
+
+    bool init();
+    // Default $BRAIN_MEMORY_VECTORS, or the database path plus ".vectors"; empty disables it
+    void set_vector_path(const std::string& path) { vector_path_ = path; }
+    bool save_index(); // The vector snapshot; FTS5 is part of the database
+    // FTS5 integrity check against the table; rebuilds and returns false on a mismatch
+    bool verify_index();
+    bool store(const std::string& type, const std::string& content, const std::string& tags = "", const std::string& acl = "PUBLIC");
+    bool store_batch(const std::vector<MemoryRecord>& records);
+    // Each record in its own savepoint, so a failing one is skipped; one commit
+    size_t store_many(const std::vector<MemoryRecord>& records);
+    size_t bulk_load(const std::vector<MemoryRecord>& records);
+    std::vector<Memory> query(const std::string& keyword, const std::string& user_acl = "PUBLIC");
+    std::unordered_map<std::string, std::vector<Memory>> query_many(const std::vector<std::string>& keywords,
+                                                                    const std::string& user_acl = "PUBLIC");
+    // Term weights are rounded to a repeat count (1 to kMaxTermRepeat): FTS5's
+    // bm25() weights columns, not phrases, but sums over repeated phrases
+    std::vector<Memory> search(const std::vector<MemoryQueryTerm>& terms, size_t k = 5,
+                               const std::string& user_acl = "PUBLIC", bool require_all = false);
+    std::vector<std::vector<Memory>> search_many(const std::vector<std::vector<MemoryQueryTerm>>& queries, size_t k = 5,
+                                                 const std::string& user_acl = "PUBLIC", bool require_all = false);
+    static constexpr int kMaxTermRepeat = 8;
+    std::vector<Memory> get_recent(int limit = 10);
+    long long get_memory_count();
+    std::string get_graph_json(int max_nodes = 50);
+    void clear();
+
+    void store_embedding(const std::string& key, const std::vector<double>& embedding);
+    std::vector<double> retrieve_embedding(const std::string& key);
+    std::vector<std::string> search_similar(const std::vector<double>& embedding, int limit);
+
+    dnn::HnswIndex::Stats vector_stats() const {
+        std::shared_lock<std::shared_mutex> lock(vector_mutex_);
+        return vectors_.stats();
+    }
+    size_t prepared_count() const { return client_->prepared_count(); }
+
+private:
+    std::shared_ptr<SqliteClient> client_;
+    SqliteStorage kv_store_;
+    std::atomic<bool> ready_{false};
+    std::atomic<long long> memory_count_{-1};
+    mutable std::shared_mutex vector_mutex_;
+    dnn::HnswIndex vectors_;
+    std::string vector_path_;
+    long long vectors_version_ = -1; // Newest embedding_version in vectors_; guarded by vector_mutex_
+    std::atomic<bool> vectors_dirty_{false};
+
+    size_t write_records(const std::vector<MemoryRecord>& records, bool independent);
+    bool insert(const MemoryRecord& record, long long timestamp); // Caller holds the client lock
+    void load_vectors();
+    void index_embeddings(const std::vector<const MemoryRecord*>& records);
+    void add_to_count(long long n) {
+        long long count = memory_count_.load();
+        while (count >= 0 && !memory_count_.compare_exchange_weak(count, count + n)) {}
+    }
+};
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "db_interface.hpp"
+#include "sqlite_client.hpp"
+#include <memory>
+#include <atomic>
+#include <span>
+#include <cstdint>
+
+// DatabaseInterface on an embedded SQLite file: the same brain_kv_store table
+// as PostgresStorage, with embeddings as native float32 blobs. Without
+// pgvector, search_similar() is an exact scan (MemoryStore answers it from
+// its HNSW index instead).
+class SqliteStorage : public DatabaseInterface {
+public:
+    explicit SqliteStorage(const std::string& path);
+    explicit SqliteStorage(std::shared_ptr<SqliteClient> client); // Shares a connection (and its transactions)
+    ~SqliteStorage() override;
+
+    bool connect() override;
+    void disconnect() override;
+
+    void store_memory(const std::string& key, const std::string& value) override;
+    void store_memories_bulk(const std::map<std::string, std::string>& memories) override;
+    std::string retrieve_memory(const std::string& key) override;
+
+    void store_embedding(const std::string& key, const std::vector<double>& embedding) override;
+    std::vector<double> retrieve_embedding(const std::string& key) override;
+    std::vector<std::string> search_similar(const std::vector<double>& embedding, int limit) override;
+
+    // Transaction support: the connection stays with the thread that called
+    // begin_transaction() until it calls commit() or rollback()
+    bool begin_transaction() override;
+    bool commit() override;
+    bool rollback() override;
+
+    // store_embedding() that reports failure (for callers inside a transaction)
+    bool write_embedding(const std::string& key, const std::vector<double>& embedding);
+    static std::vector<std::uint8_t> encode_embedding(const std::vector<double>& embedding);
+    static std::vector<float> decode_embedding(std::span<const std::uint8_t> blob);
+
+private:
+    std::shared_ptr<SqliteClient> client_;
+    std::unique_ptr<SqliteTransaction> transaction_;
+    std::atomic<bool> connected_{false};
+};
@@ -0,0 +1,63 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <functional>
+#include <mutex>
+#include <cstdint>
+
+namespace dnn {
+
+    /**
+     * Cached, section-wise serialisation of a JSON state object.
+     *
+     * The document is a fixed, ordered set of top-level sections. Callers pass
+     * each section's fingerprint (a hash of the values it is built from) with a
+     * serialiser; the serialiser only runs when the fingerprint changed. Every
+     * change bumps a version, so delta(since) can return just the sections that
+     * changed after a consumer's last seen version, and full() reuses the joined
+     * document until something changes.
+     */
+    class StatePublisher {
+    public:
+        struct Stats {
+            std::uint64_t updates = 0;      // update() calls
+            std::uint64_t serialised = 0;   // ... that re-ran the serialiser
+            std::uint64_t full_builds = 0;  // Times the joined document was rebuilt
+        };
+
+        explicit StatePublisher(std::vector<std::string> sections);
+
+        // Returns true if the section changed (and was re-serialised).
+        bool update(std::size_t section, std::uint64_t fingerprint, const std::function<std::string()>& serialise);
+        void invalidate(); // Next update() of every section re-serialises
+
+        std::uint64_t version() const;
+        std::string full() const;
+        // Object with the sections changed after `since` ("" if none); since = 0 gives the full document.
+        std::string delta(std::uint64_t since) const;
+        Stats stats() const;
+
+        // Helpers for section serialisers and fingerprints
+        static std::uint64_t fingerprint(const void* data, std::size_t bytes, std::uint64_t seed = 14695981039346656037ULL);
+        static std::vector<double> downsample(const std::vector<double>& values, std::size_t bins); // Mean per bin; 0 = as is
+        static void append_number(std::string& out, double v);       // Shortest form, 4 significant digits
+        static void append_string(std::string& out, const std::string& s); // Quoted and escaped
+
+    private:
+        struct Section {
+            std::string key;
+            std::string json;
+            std::uint64_t fingerprint = 0;
+            std::uint64_t version = 0; // 0: never set
+            bool stale = true;         // Re-serialise regardless of fingerprint
+        };
+
+        mutable std::mutex mutex_;
+        std::vector<Section> sections_;
+        std::uint64_t version_ = 0;
+        mutable std::string full_;
+        mutable std::uint64_t full_version_ = 0;
+        mutable Stats stats_;
+    };
+
+} // namespace dnn
@@ -9,6 +9,7 @@ namespace dnn {
     public:
         TactileUnit() {
             active_features_.resize(16, 0.0); // 16 sensors
+            publish(active_features_);
         }
 
         std::string name() const override { return "Somatosensory Cortex (Tactile)"; }
@@ -48,6 +49,7 @@ namespace dnn {
                 roughness_ /= raw_data.size();
             }
 
+            publish(active_features_);
             return active_features_;
         }
 
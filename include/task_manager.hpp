@@ -53,6 +53,7 @@ public:
 private:
     std::deque<Task> pending_queue;
     std::vector<Task> history; // Keep last 10
+    Task current_execution; // Per instance: several brains may run in one process
     Task* active_task = nullptr;
     int next_id = 1;
     std::mutex mutex_;
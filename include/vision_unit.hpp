@@ -2,15 +2,17 @@
 #include "sensory_unit.hpp"
 #include "dnn.hpp"
 #include <memory>
+#include <mutex>
 
 namespace dnn {
 
     class VisionUnit : public SensoryUnit {
     public:
-        VisionUnit(const std::vector<std::size_t>& feature_dims) {
-            // Internal network to compress visual raw data into thought space
-            compression_net_ = std::make_unique<NeuralNetwork>(feature_dims);
+        VisionUnit(const std::vector<std::size_t>& feature_dims) : feature_dims_(feature_dims) {
+            // The compression network (raw pixels -> thought space) is the largest
+            // allocation at startup; it is built on the first frame instead.
             active_features_.resize(feature_dims.back(), 0.0);
+            publish(active_features_);
         }
 
         std::string name() const override { return "Ocular Interface (Vision)"; }
@@ -24,15 +26,19 @@ namespace dnn {
             for (auto& val : input) val /= 255.0;
 
             // 2. Pass through compression network
+            std::call_once(net_once_, [this] { compression_net_ = std::make_unique<NeuralNetwork>(feature_dims_); });
             std::vector<double> features = compression_net_->predict(input);
 
             // 3. Update state
             std::lock_guard<std::mutex> lock(mu_);
             active_features_ = features;
+            publish(active_features_);
             return active_features_;
         }
 
     private:
+        std::vector<std::size_t> feature_dims_;
+        std::once_flag net_once_;
         std::unique_ptr<NeuralNetwork> compression_net_;
     };
 
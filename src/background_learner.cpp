@@ -0,0 +1,131 @@
+#include "background_learner.hpp"
+#include <algorithm>
+#include <iostream>
+
+namespace dnn {
+
+    BackgroundLearner::BackgroundLearner(std::recursive_mutex& model_mutex, Options options)
+        : model_mutex_(model_mutex), options_(options) {
+        options_.capacity = std::max<std::size_t>(1, options_.capacity);
+        options_.max_batch = std::max<std::size_t>(1, options_.max_batch);
+        thread_ = std::thread(&BackgroundLearner::run, this);
+    }
+
+    BackgroundLearner::~BackgroundLearner() {
+        stop();
+    }
+
+    bool BackgroundLearner::submit(NeuralNetwork* network, std::vector<double> input, std::vector<double> target, double rate) {
+        if (!network || input.empty() || target.empty()) return false;
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (stopping_) return false;
+
+        if (queue_.size() >= options_.capacity) {
+            if (options_.drop_when_full) {
+                queue_.pop_front(); // The newest activity is the most useful to learn from
+                ++stats_.dropped_overload;
+            } else {
+                space_cv_.wait(lock, [this] { return stopping_ || queue_.size() < options_.capacity; });
+                if (stopping_) return false;
+            }
+        }
+        queue_.push_back(Record{network, std::move(input), std::move(target), rate, Clock::now()});
+        ++stats_.submitted;
+        stats_.max_queue_depth = std::max(stats_.max_queue_depth, queue_.size());
+        lock.unlock();
+        work_cv_.notify_one();
+        return true;
+    }
+
+    void BackgroundLearner::flush() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        idle_cv_.wait(lock, [this] { return queue_.empty() && !busy_; });
+    }
+
+    void BackgroundLearner::stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stopping_ && !thread_.joinable()) return;
+            stopping_ = true;
+        }
+        work_cv_.notify_all();
+        space_cv_.notify_all();
+        if (thread_.joinable()) thread_.join();
+    }
+
+    BackgroundLearner::Stats BackgroundLearner::stats() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Stats s = stats_;
+        s.queue_depth = queue_.size();
+        return s;
+    }
+
+    void BackgroundLearner::run() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            work_cv_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+            if (queue_.empty()) break; // Stopping and drained
+
+            std::vector<Record> work(std::make_move_iterator(queue_.begin()), std::make_move_iterator(queue_.end()));
+            queue_.clear();
+            busy_ = true;
+            lock.unlock();
+            space_cv_.notify_all();
+
+            apply(work);
+
+            lock.lock();
+            busy_ = false;
+            idle_cv_.notify_all();
+        }
+        idle_cv_.notify_all();
+    }
+
+    void BackgroundLearner::apply(std::vector<Record>& work) {
+        const auto now = Clock::now();
+        std::uint64_t stale = 0;
+        if (options_.max_staleness.count() > 0) {
+            auto fresh_end = std::remove_if(work.begin(), work.end(), [&](const Record& r) {
+                return now - r.queued > options_.max_staleness;
+            });
+            stale = static_cast<std::uint64_t>(std::distance(fresh_end, work.end()));
+            work.erase(fresh_end, work.end());
+        }
+
+        // Group by (network, rate), keeping submission order within a group
+        std::stable_sort(work.begin(), work.end(), [](const Record& a, const Record& b) {
+            return a.network != b.network ? std::less<NeuralNetwork*>()(a.network, b.network) : a.rate < b.rate;
+        });
+
+        std::uint64_t applied = 0, batches = 0;
+        for (std::size_t begin = 0; begin < work.size();) {
+            std::size_t end = begin;
+            while (end < work.size() && end - begin < options_.max_batch &&
+                   work[end].network == work[begin].network && work[end].rate == work[begin].rate) {
+                ++end;
+            }
+            std::vector<std::vector<double>> X, Y;
+            X.reserve(end - begin);
+            Y.reserve(end - begin);
+            for (std::size_t i = begin; i < end; ++i) {
+                X.push_back(std::move(work[i].input));
+                Y.push_back(std::move(work[i].target));
+            }
+            try {
+                std::lock_guard<std::recursive_mutex> model_lock(model_mutex_);
+                work[begin].network->train(X, Y, 1, static_cast<int>(X.size()), work[begin].rate);
+            } catch (const std::exception& e) {
+                std::cerr << "[Learner] Update failed: " << e.what() << std::endl;
+            }
+            applied += end - begin;
+            ++batches;
+            begin = end;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.dropped_stale += stale;
+        stats_.applied += applied;
+        stats_.batches += batches;
+    }
+
+} // namespace dnn
@@ -1,10 +1,16 @@
 #include "brain.hpp"
+#include "simd_utils.hpp"
 #include "logger.hpp"
 #include <iostream>
 #include <fstream>
 #include <algorithm>
 #include <sstream>
 #include <regex>
+#include <random>
+#include <iomanip>
+#include <cmath>
+#include <execution>
+#include <numeric>
 #include "planning_unit.hpp"
 #include "vision_unit.hpp"
 #include "audio_unit.hpp"
@@ -61,7 +67,17 @@ private:
     }
 };
 
-Brain::Brain() {
+Brain::Brain(BrainOptions options) : options_(options) {
+    if (options_.headless) {
+        virtual_clock = std::make_shared<dnn::VirtualClock>();
+        clock = virtual_clock;
+    } else {
+        clock = std::make_shared<dnn::SteadyBrainClock>();
+    }
+
+    const auto startup_begin = std::chrono::steady_clock::now();
+    auto phase_start = startup_begin;
+
     // Load Environment based credentials
     db_conn_str = dnn::infra::Config::get_db_conn_str();
 
@@ -72,41 +88,93 @@ Brain::Brain() {
     personality.energy_decay = config.energy_decay;
 
     // Initialize Logger
-    Logger::instance().init("state/brain.log");
+    if (!is_headless()) Logger::instance().init("state/brain.log");
 
     safe_print("[Brain]: Loaded configuration. Energy Decay: " + std::to_string(personality.energy_decay));
 
+    snapshot_writer = std::make_unique<dnn::SnapshotWriter>();
+    record_startup_phase("config", phase_start, false);
+
+    // Independent subsystems are built concurrently. Each task writes only its
+    // own member, and everything is joined before the automata thread starts.
+    std::vector<std::future<void>> startup_tasks;
+    auto run_parallel = [this, &startup_tasks](const std::string& name, std::function<void()> fn) {
+        startup_tasks.push_back(std::async(std::launch::async, [this, name, fn = std::move(fn)]() {
+            auto start = std::chrono::steady_clock::now();
+            fn();
+            record_startup_phase(name, start, true);
+        }));
+    };
+
     // Input Text -> Thought Vector
-    language_encoder = std::make_unique<Region>("LanguageEncoder", std::vector<std::size_t>{VOCAB_SIZE, 128, VECTOR_DIM});
+    run_parallel("region:LanguageEncoder", [this] {
+        language_encoder = std::make_unique<Region>("LanguageEncoder", std::vector<std::size_t>{VOCAB_SIZE, 128, VECTOR_DIM});
+        language_encoder->network.set_plasticity(true);
+    });
 
     // Thought Vector -> Output Text Logits
-    language_decoder = std::make_unique<Region>("LanguageDecoder", std::vector<std::size_t>{VECTOR_DIM, 128, VOCAB_SIZE});
-    
+    run_parallel("region:LanguageDecoder", [this] {
+        language_decoder = std::make_unique<Region>("LanguageDecoder", std::vector<std::size_t>{VECTOR_DIM, 128, VOCAB_SIZE});
+        language_decoder->network.set_plasticity(true);
+    });
+
     // Thought Vector -> Memory Context
-    memory_center = std::make_unique<Region>("Memory", std::vector<std::size_t>{VECTOR_DIM, 128, VECTOR_DIM});
-    
-    // Thought + Memory + Sensory -> New Thought
-    cognitive_center = std::make_unique<Region>("Cognitive", std::vector<std::size_t>{VECTOR_DIM * 3, 256, VECTOR_DIM});
-    
-    // Enable plasticity
-    language_encoder->network.set_plasticity(true);
-    language_decoder->network.set_plasticity(true);
-    memory_center->network.set_plasticity(true);
-    cognitive_center->network.set_plasticity(true);
+    run_parallel("region:Memory", [this] {
+        memory_center = std::make_unique<Region>("Memory", std::vector<std::size_t>{VECTOR_DIM, 128, VECTOR_DIM});
+        memory_center->network.set_plasticity(true);
+    });
 
-    // Start Autonomy
-    background_thread = std::thread(&Brain::automata_loop, this);
-    
+    // Thought + Memory + Sensory -> New Thought
+    run_parallel("region:Cognitive", [this] {
+        cognitive_center = std::make_unique<Region>("Cognitive", std::vector<std::size_t>{VECTOR_DIM * 3, 256, VECTOR_DIM});
+        cognitive_center->network.set_plasticity(true);
+    });
+
+    // Initialize Memory Store: PostgreSQL, or an embedded SQLite file
+    // (DB_BACKEND=sqlite), which also works in builds without libpq.
+    // Headless brains get none, nor Redis or the ROS bridge: they touch nothing outside.
 #ifdef USE_POSTGRES
-    // Initialize Memory Store
-    memory_store = std::make_unique<MemoryStore>(db_conn_str);
-    if (!memory_store->init()) {
-        safe_print("[Brain]: Failed to initialize memory database (PostgreSQL)!");
-    } else {
-        safe_print("[Brain]: Connected to long-term memory (PostgreSQL).");
+    const bool server_memory = true;
+#else
+    const bool server_memory = false;
+#endif
+    if (!is_headless() && (server_memory || MemoryStore::is_embedded(db_conn_str))) {
+        run_parallel("memory_store", [this] {
+            memory_store = std::make_unique<MemoryStore>(db_conn_str);
+            const std::string backend = MemoryStore::is_embedded(db_conn_str) ? "SQLite" : "PostgreSQL";
+            if (!memory_store->init()) {
+                safe_print("[Brain]: Failed to initialize memory database (" + backend + ")!");
+            } else {
+                safe_print("[Brain]: Connected to long-term memory (" + backend + ").");
+            }
+        });
     }
+
+#ifdef USE_REDIS
+    if (!is_headless()) run_parallel("redis", [this] {
+        std::string redis_host = dnn::infra::Config::get("REDIS_HOST", "redis");
+        int redis_port = dnn::infra::Config::get_int("REDIS_PORT", 6379);
+        redis_cache = std::make_shared<RedisClient>(redis_host, redis_port);
+        if (redis_cache->connect()) {
+            safe_print("[Brain]: Connected to Redis cache layer at " + redis_host + ":" + std::to_string(redis_port));
+        }
+    });
 #endif
-    
+
+    // MEGA-BATCH 5: Load Reflex Weights
+    run_parallel("reflex", [this] { reflex.load("state/reflex_weights.json"); });
+
+    run_parallel("cognitive_engine", [this] { cognitive_engine = std::make_unique<dnn::CognitiveEngine>(); });
+
+    // Initialize ROS 2 Bridge
+    if (!is_headless()) run_parallel("ros_bridge", [this] {
+        ros_bridge = std::make_unique<dnn::infra::RosBridge>();
+        ros_bridge->connect();
+    });
+
+    // Meanwhile, the small lexical tables on this thread
+    phase_start = std::chrono::steady_clock::now();
+
     // Initialize Synonyms (Basic Thesaurus)
     synonyms["happy"] = "joy";
     synonyms["joyful"] = "joy";
@@ -137,22 +205,20 @@ Brain::Brain() {
     for (const auto& w : base_vocab) {
         std::vector<double> vec(VECTOR_DIM);
         for (auto& v : vec) v = static_cast<double>(rand()) / RAND_MAX * 2.0 - 1.0;
-        word_embeddings[w] = vec;
+        word_embeddings.set(w, vec);
     }
     
     // Load persisted vocabulary
     load_vocab();
-#ifdef USE_REDIS
-    std::string redis_host = dnn::infra::Config::get("REDIS_HOST", "redis");
-    int redis_port = dnn::infra::Config::get_int("REDIS_PORT", 6379);
-    redis_cache = std::make_unique<RedisClient>(redis_host, redis_port);
-    if (redis_cache->connect()) {
-        safe_print("[Brain]: Connected to Redis cache layer at " + redis_host + ":" + std::to_string(redis_port));
-    }
-#endif
+    record_startup_phase("lexicon+vocab", phase_start, false);
 
-    // MEGA-BATCH 5: Load Reflex Weights
-    reflex.load("state/reflex_weights.json");
+    // Join the pool; wait for every task before rethrowing so none outlives a failed constructor
+    phase_start = std::chrono::steady_clock::now();
+    for (auto& task : startup_tasks) task.wait();
+    for (auto& task : startup_tasks) task.get();
+    record_startup_phase("join", phase_start, false);
+
+    phase_start = std::chrono::steady_clock::now();
 
     // Pillar 3: Register initial sensory units
     register_sensory_unit(std::make_unique<dnn::VisionUnit>(std::vector<std::size_t>{64*64, 512, VECTOR_DIM}));
@@ -168,26 +234,116 @@ Brain::Brain() {
     // Mega-Batch 12 Init
     federation = std::make_unique<dnn::FederationUnit>();
     hardware = std::make_unique<dnn::CpuAccelerator>(); // Default to CPU
-    
-    // Initialize Cognitive Core - Unified AI System with all 100 features
-    safe_print("[Brain]: Initializing Cognitive Core with 100 AI features...");
-    cognitive_core = std::make_unique<dnn::CognitiveCore>();
-    cognitive_engine = std::make_unique<dnn::CognitiveEngine>();
-    skill_manager = std::make_unique<dnn::SkillManager>();
-    safe_print("[Brain]: Cognitive Core initialized - Reasoning, Perception, Learning systems online.");
+    record_startup_phase("sensory+components", phase_start, false);
+
+    // Cognitive Core (dozens of subsystems) and SkillManager (loads every skill
+    // file) only serve explicit commands; they are built on first use, as is
+    // the VisionUnit compression network (first camera frame).
+    startup_report.deferred = {"CognitiveCore", "SkillManager", "VisionUnit network"};
+
+    // Plasticity learner: interact() queues its Hebbian updates instead of
+    // training four networks before it can answer
+    if (!is_headless() && dnn::infra::Config::get("BRAIN_ASYNC_PLASTICITY", "1") != "0") {
+        dnn::BackgroundLearner::Options learner_options;
+        learner_options.capacity = static_cast<size_t>(std::max(1, dnn::infra::Config::get_int("BRAIN_LEARNER_QUEUE", 256)));
+        learner_options.max_batch = static_cast<size_t>(std::max(1, dnn::infra::Config::get_int("BRAIN_LEARNER_BATCH", 32)));
+        learner_options.max_staleness = std::chrono::milliseconds(std::max(0, dnn::infra::Config::get_int("BRAIN_LEARNER_STALENESS_MS", 5000)));
+        learner_options.drop_when_full = dnn::infra::Config::get("BRAIN_LEARNER_DROP", "1") != "0";
+        learner = std::make_unique<dnn::BackgroundLearner>(brain_mutex, learner_options);
+    }
+
+    dnn::ResponseCache::Options cache_options;
+    cache_options.enabled = dnn::infra::Config::get("BRAIN_RESPONSE_CACHE", "0") == "1";
+    cache_options.capacity = static_cast<size_t>(std::max(0, dnn::infra::Config::get_int("BRAIN_RESPONSE_CACHE_SIZE", 256)));
+    cache_options.ttl = std::chrono::milliseconds(std::max(0, dnn::infra::Config::get_int("BRAIN_RESPONSE_CACHE_TTL_MS", 60000)));
+    cache_options.learn_on_hit = dnn::infra::Config::get("BRAIN_RESPONSE_CACHE_LEARN", "0") == "1";
+    response_cache.configure(cache_options);
+
+    dnn::RecallCache::Options recall_options;
+    recall_options.capacity = static_cast<size_t>(std::max(1, dnn::infra::Config::get_int("BRAIN_RECALL_CACHE_SIZE", 4096)));
+    recall_options.ttl = std::chrono::minutes(5);
+    recall_options.l2_prefix = "brain:";
+    recall_cache = std::make_unique<dnn::RecallCache>(recall_options, redis_cache);
+
+    // Per-tick neural events (sensory focus etc.) reach dashboards at most this often per type
+    events.set_rate_limit(dnn::EventTopic::Neural,
+        std::chrono::milliseconds(std::max(0, dnn::infra::Config::get_int("BRAIN_EVENT_COALESCE_MS", 100))));
+
+    // Start Autonomy last: the jobs use the memory store, regions and bridges
+    start_autonomy();
+
+    startup_report.total_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - startup_begin).count();
+    safe_print("[Brain]: " + startup_report.to_string());
+}
 
-    // Initialize ROS 2 Bridge
-    ros_bridge = std::make_unique<dnn::infra::RosBridge>();
-    ros_bridge->connect();
+void Brain::record_startup_phase(const std::string& name, std::chrono::steady_clock::time_point start, bool parallel) {
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::lock_guard<std::mutex> lock(startup_mutex_);
+    startup_report.phases.push_back({name, ms, parallel});
+}
+
+StartupReport Brain::get_startup_report() const {
+    std::lock_guard<std::mutex> lock(startup_mutex_);
+    return startup_report;
+}
+
+std::string StartupReport::to_string() const {
+    std::ostringstream ss;
+    ss << std::fixed << std::setprecision(1);
+    ss << "Startup " << total_ms << " ms:";
+    for (const auto& phase : phases) {
+        ss << " " << phase.name << "=" << phase.ms << (phase.parallel ? "ms(par)" : "ms");
+    }
+    if (!deferred.empty()) {
+        ss << " | deferred:";
+        for (const auto& name : deferred) ss << " " << name;
+    }
+    return ss.str();
+}
+
+dnn::CognitiveCore* Brain::get_cognitive_core() {
+    std::call_once(cognitive_core_once_, [this] {
+        auto start = std::chrono::steady_clock::now();
+        safe_print("[Brain]: Initializing Cognitive Core with 100 AI features...");
+        cognitive_core = std::make_unique<dnn::CognitiveCore>();
+        record_startup_phase("deferred:CognitiveCore", start, false);
+        safe_print("[Brain]: Cognitive Core initialized - Reasoning, Perception, Learning systems online.");
+    });
+    return cognitive_core.get();
+}
+
+dnn::SkillManager* Brain::get_skill_manager() {
+    std::call_once(skill_manager_once_, [this] {
+        auto start = std::chrono::steady_clock::now();
+        skill_manager = std::make_unique<dnn::SkillManager>();
+        record_startup_phase("deferred:SkillManager", start, false);
+    });
+    return skill_manager.get();
 }
 
 Brain::~Brain() {
-    running = false;
-    if (background_thread.joinable()) background_thread.join();
+    if (scheduler) scheduler->stop(); // Waits for running jobs, drains async tasks
+    if (learner) learner->stop();     // Applies queued updates while the regions still exist
+    events.stop();                    // Delivers what is left while the brain is intact
+    if (snapshot_writer) snapshot_writer->wait_idle(); // Finish in-flight autosaves
     
     // MEGA-BATCH 5: Save Reflex Weights
-    reflex.save("state/reflex_weights.json");
-    safe_print("[Brain]: Reflex weights saved.");
+    if (!is_headless()) {
+        reflex.save("state/reflex_weights.json");
+        safe_print("[Brain]: Reflex weights saved.");
+    }
+}
+
+void Brain::reinforce_regions(double intensity) {
+    Region* regions[] = {language_encoder.get(), memory_center.get(), cognitive_center.get(), language_decoder.get()};
+    for (Region* region : regions) {
+        if (!learner) {
+            region->reinforce(intensity);
+        } else if (!region->get_last_input().empty() && !region->current_activity.empty()) {
+            learner->submit(&region->network, region->get_last_input(), region->current_activity, intensity);
+        }
+    }
 }
 
 std::string Brain::interact(const std::string& input_text) {
@@ -201,7 +357,7 @@ std::string Brain::interact(const std::string& input_text) {
             static_cast<dnn::ClockUnit*>(unit.get())->record_interaction();
         }
     }
-    emit_neural_event("input", input_text);
+    emit_neural_event("input", [&] { return input_text; });
     
     // MEGA-BATCH 2: Intelligent STM Cleanup
     // Prune if too long OR if too much time has passed (simulated 1 hour gap)
@@ -214,7 +370,7 @@ std::string Brain::interact(const std::string& input_text) {
 
     // MEGA-BATCH 14: Skill Teaching Interface
     // Syntax: "Learn: [Topic] Input: [X] Output: [Y]"
-    if (input_text.find("Learn:") == 0 && skill_manager) {
+    if (input_text.find("Learn:") == 0 && get_skill_manager()) {
         // Simple parser
         try {
              std::string rest = input_text.substr(6); // Skip "Learn:"
@@ -247,7 +403,7 @@ std::string Brain::interact(const std::string& input_text) {
     
     // Skill Query Interface
     // "Do: [Topic] Input: [X]"
-    if (input_text.find("Do:") == 0 && skill_manager) {
+    if (input_text.find("Do:") == 0 && get_skill_manager()) {
          try {
              std::string rest = input_text.substr(3); 
              size_t input_pos = rest.find("Input:");
@@ -282,61 +438,31 @@ std::string Brain::interact(const std::string& input_text) {
         return resp;
     }
 
-    // Sentiment modulation
-    double sentiment = analyze_sentiment(input_text);
-    if (sentiment > 0) emotions.happiness = std::min(1.0, emotions.happiness + 0.1);
-    else if (sentiment < 0) emotions.sadness = std::min(1.0, emotions.sadness + 0.1);
-
-    emotions.happiness = std::min(1.0, emotions.happiness + 0.1);
-    emotions.boredom = std::max(0.0, emotions.boredom - 0.2); // Not bored anymore
-
-    // MEGA-BATCH 3 & 8: Reflex Reinforcement
-    if (!last_reflex_trigger.empty()) {
-        double reward = 0.0;
-        if (input_text == "good" || input_text == "nice" || input_text == "correct" || input_text == "thanks") {
-            reward = 0.2;
-            emit_log("[Reflex]: Positive feedback received.");
-        } else if (input_text == "bad" || input_text == "wrong" || input_text == "stupid") {
-            reward = -0.2;
-            emit_log("[Reflex]: Negative feedback received.");
-        }
-        
-        if (reward != 0.0) {
-            update_reflex_learning(last_reflex_trigger, reward);
-            last_reflex_trigger = ""; // Clear after reinforcement
-        }
-    }
+    apply_input_mood(input_text);
 
     // 0. Update Focus based on current state
-    Task* active_task = task_manager.get_next_task();
-    if (active_task) {
-        focus_topic = active_task->description;
-        focus_level = 0.8;
-    } else if (current_research_topic != "None") {
-        focus_topic = current_research_topic;
-        focus_level = 0.5;
-    } else {
-        focus_level = std::max(0.0, focus_level - 0.1); // Decay focus
+    update_focus();
+
+    // Response cache: a repeated input skips the reflex scan, memory query,
+    // forward passes and plasticity. Reflex replies are not cached (they feed
+    // reward learning through last_reflex_trigger).
+    std::string cache_key = response_cache_key(input_text, conversation_context, conversation_context.size() - 1); // Before our "User:" turn
+    if (!cache_key.empty()) {
+        if (auto cached = response_cache.lookup(cache_key, response_epoch(), clock->now())) {
+            emit_thought([&] { return "Recalled reply for: " + input_text; });
+            push_context("Brain: " + *cached);
+            return *cached;
+        }
     }
 
     // 1. Reflex / Instinct Logic
-    std::string instinct = reflex.get_reaction(input_text);
+    std::string instinct = reflex_reply(input_text);
     if (!instinct.empty()) {
-        emit_log("[Reflex]: Activated for '" + input_text + "'");
-        emotions.boredom = std::max(0.0, emotions.boredom - 0.1);
-        emotions.happiness = std::min(1.0, emotions.happiness + 0.05);
-        
-        // Track for learning
-        last_reflex_trigger = input_text; // Simple trigger mapping
-        last_reflex_response = instinct;
-
-        conversation_context.push_back("Brain: " + instinct);
-        while (conversation_context.size() > MAX_CONTEXT_TURNS) conversation_context.pop_front();
+        push_context("Brain: " + instinct);
         return instinct;
     }
 
     // 2. Associative Memory Retrieval (RAG-lite) with full context
-#ifdef USE_POSTGRES
     if (memory_store) {
         // Build contextual query string (latest 2 turns + current)
         std::string contextual_query = "";
@@ -358,10 +484,10 @@ std::string Brain::interact(const std::string& input_text) {
             
             conversation_context.push_back("Brain: " + memory_response);
             while (conversation_context.size() > MAX_CONTEXT_TURNS) conversation_context.pop_front();
+            if (!cache_key.empty()) response_cache.insert(cache_key, input_text, memory_response, response_epoch(), clock->now());
             return memory_response;
         }
     }
-#endif
     
     // NOTE: User context was already added at top? No, I need to add it at the top!
     // Let me add the User context update at the start of the function in a separate chunk.
@@ -390,7 +516,7 @@ std::string Brain::interact(const std::string& input_text) {
     auto process_tokens = [&](std::vector<std::string>& ts) {
         for(auto& t : ts) {
             // One-Shot Learning Check
-            if (!word_embeddings.count(t) && t.length() > 2) {
+            if (!word_embeddings.contains(t) && t.length() > 2) {
                 // If it's a valid looking word, learn it
                 bool is_word = true;
                 for(char c : t) if (!isalpha(c)) is_word = false;
@@ -447,26 +573,24 @@ std::string Brain::interact(const std::string& input_text) {
     // ASSOCIATIVE MEMORY INJECTION
     // If we found a fact in step 2 (get_associative_memory), we should "feel" it too.
     // We re-query here to get the content, tokenize it, and add to memory_context
-#ifdef USE_POSTGRES
     if (memory_store) {
-        // Iterate current tokens to find triggers for direct neural injection
-        for(const auto& t : current_tokens) {
-             if (t.length() <= 3) continue;
-             auto results = memory_store->query(t);
-             if (!results.empty()) {
-                 // Vectorize the content of the memory
-                 auto mem_tokens = tokenize(results[0].content);
-                 for(const auto& mt : mem_tokens) {
-                     std::hash<std::string> h;
-                     // Add to memory context (fold into vector dim)
-                     size_t idx = h(mt) % VECTOR_DIM; 
-                     memory_context[idx] += 0.5; // Injection weight
-                 }
-                 break; // Only inject top relevance to avoid noise
-             }
+        // The current tokens, ranked together, pick the memory for direct neural injection
+        std::vector<MemoryQueryTerm> triggers;
+        for (const auto& t : current_tokens) {
+            if (t.length() > 3) triggers.push_back({t});
+        }
+        auto results = triggers.empty() ? std::vector<Memory>{} : memory_store->search(triggers, 1);
+        if (!results.empty()) {
+            // Vectorize the content of the memory
+            auto mem_tokens = tokenize(results[0].content);
+            for(const auto& mt : mem_tokens) {
+                std::hash<std::string> h;
+                // Add to memory context (fold into vector dim)
+                size_t idx = h(mt) % VECTOR_DIM; 
+                memory_context[idx] += 0.5; // Injection weight; only the top memory, to avoid noise
+            }
         }
     }
-#endif
 
     // 4. Cognition
     std::vector<double> cognitive_input = thought;
@@ -486,19 +610,119 @@ std::string Brain::interact(const std::string& input_text) {
 
     // 6. Plasticity / Reinforcement (The brain learns from its own thoughts/actions)
     // Self-supervised learning: strengthen the pathways just used
-    language_encoder->reinforce();
-    memory_center->reinforce();
-    cognitive_center->reinforce();
-    language_decoder->reinforce();
+    reinforce_regions(0.01);
     
     // 7. Decode output
     // 7. Decode output
     std::string response_text = decode_output(output_logits);
 
     // EMIT THOUGHT
-    emit_thought("Thinking about: " + input_text + " => " + response_text);
+    emit_thought([&] { return "Thinking about: " + input_text + " => " + response_text; });
 
     // PERSONALITY MODULATION
+    response_text = modulate_personality(std::move(response_text));
+
+    // Continuous Learning: Save interesting interactions
+    if (!is_headless() && input_text.length() > 20 && response_text.length() > 10 && response_text.find("...") == std::string::npos) {
+         // Only save if it's a "good" interaction (heuristic)
+         // Append to a learning file
+         std::ofstream learn_file("state/learned_interactions.txt", std::ios::app);
+         if (learn_file) {
+             learn_file << input_text << "|" << response_text << "\n";
+             safe_print("[Persistence]: Saved interaction to state/learned_interactions.txt");
+         } else {
+             safe_print("[Persistence]: Failed to open file for writing!");
+         }
+    } else {
+        // Debug why not saved (comment out in production)
+         // safe_print("[Persistence]: Skipped. InLen=" + std::to_string(input_text.length()) + 
+         //           " ResLen=" + std::to_string(response_text.length()) + " Res=" + response_text);
+    }
+    
+    // Save Brain's response to context
+    push_context("Brain: " + response_text);
+
+    if (!cache_key.empty()) response_cache.insert(cache_key, input_text, response_text, response_epoch(), clock->now());
+    return response_text;
+}
+
+void Brain::apply_input_mood(const std::string& input_text) {
+    // Sentiment modulation
+    double sentiment = analyze_sentiment(input_text);
+    if (sentiment > 0) emotions.happiness = std::min(1.0, emotions.happiness + 0.1);
+    else if (sentiment < 0) emotions.sadness = std::min(1.0, emotions.sadness + 0.1);
+
+    emotions.happiness = std::min(1.0, emotions.happiness + 0.1);
+    emotions.boredom = std::max(0.0, emotions.boredom - 0.2); // Not bored anymore
+
+    // MEGA-BATCH 3 & 8: Reflex Reinforcement
+    if (!last_reflex_trigger.empty()) {
+        double reward = 0.0;
+        if (input_text == "good" || input_text == "nice" || input_text == "correct" || input_text == "thanks") {
+            reward = 0.2;
+            emit_log("[Reflex]: Positive feedback received.");
+        } else if (input_text == "bad" || input_text == "wrong" || input_text == "stupid") {
+            reward = -0.2;
+            emit_log("[Reflex]: Negative feedback received.");
+        }
+        
+        if (reward != 0.0) {
+            update_reflex_learning(last_reflex_trigger, reward);
+            last_reflex_trigger = ""; // Clear after reinforcement
+        }
+    }
+}
+
+void Brain::update_focus() {
+    Task* active_task = task_manager.get_next_task();
+    if (active_task) {
+        focus_topic = active_task->description;
+        focus_level = 0.8;
+    } else if (current_research_topic != "None") {
+        focus_topic = current_research_topic;
+        focus_level = 0.5;
+    } else {
+        focus_level = std::max(0.0, focus_level - 0.1); // Decay focus
+    }
+}
+
+std::string Brain::response_cache_key(const std::string& input_text, const std::deque<std::string>& context, size_t turns) const {
+    if (!response_cache.enabled()) return "";
+    std::string key = dnn::ResponseCache::normalise(input_text);
+    if (key.empty()) return key;
+    key += '\x1f';
+    key += emotions.anger > 0.7 ? 'A' : '-'; // Anger changes the wording
+
+    // The reply also reads the conversation so far (memory query, history
+    // tokens), a focus topic the input mentions and the active senses.
+    // Stored memories and weights move the epoch instead.
+    size_t h = 0;
+    auto mix = [&h](std::string_view s) { h ^= std::hash<std::string_view>{}(s) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2); };
+    for (size_t i = 0; i < turns && i < context.size(); ++i) mix(context[i]);
+    if (focus_level > 0.1 && input_text.find(focus_topic) != std::string::npos) {
+        mix(focus_topic);
+        mix(std::to_string(focus_level));
+    }
+    for (const auto& unit : sensory_inputs) mix(unit->is_active() ? "+" : "-");
+    key += '\x1f';
+    key += std::to_string(h);
+    return key;
+}
+
+std::string Brain::reflex_reply(const std::string& input_text) {
+    std::string instinct = reflex.get_reaction(input_text);
+    if (instinct.empty()) return instinct;
+    emit_log("[Reflex]: Activated for '" + input_text + "'");
+    emotions.boredom = std::max(0.0, emotions.boredom - 0.1);
+    emotions.happiness = std::min(1.0, emotions.happiness + 0.05);
+
+    // Track for learning
+    last_reflex_trigger = input_text; // Simple trigger mapping
+    last_reflex_response = instinct;
+    return instinct;
+}
+
+std::string Brain::modulate_personality(std::string response_text) {
     // Anger = All Caps
     if (emotions.anger > 0.7) {
         std::transform(response_text.begin(), response_text.end(), response_text.begin(), ::toupper);
@@ -519,117 +743,324 @@ std::string Brain::interact(const std::string& input_text) {
         // Heuristic: Append "Sir" sometimes
         if (rand() % 5 == 0) response_text += ", Sir.";
     }
+    return response_text;
+}
 
-    // Continuous Learning: Save interesting interactions
-    if (input_text.length() > 20 && response_text.length() > 10 && response_text.find("...") == std::string::npos) {
-         // Only save if it's a "good" interaction (heuristic)
-         // Append to a learning file
-         std::ofstream learn_file("state/learned_interactions.txt", std::ios::app);
-         if (learn_file) {
-             learn_file << input_text << "|" << response_text << "\n";
-             safe_print("[Persistence]: Saved interaction to state/learned_interactions.txt");
-         } else {
-             safe_print("[Persistence]: Failed to open file for writing!");
-         }
-    } else {
-        // Debug why not saved (comment out in production)
-         // safe_print("[Persistence]: Skipped. InLen=" + std::to_string(input_text.length()) + 
-         //           " ResLen=" + std::to_string(response_text.length()) + " Res=" + response_text);
-    }
-    
-    // Save Brain's response to context
-    conversation_context.push_back("Brain: " + response_text);
+void Brain::push_context(std::string line) {
+    conversation_context.push_back(std::move(line));
     while (conversation_context.size() > MAX_CONTEXT_TURNS) conversation_context.pop_front();
-
-    return response_text;
 }
 
-std::string Brain::get_associative_memory(const std::string& input) {
-    if (!memory_store) return "";
-    
-    // Redis Cache Check
-#ifdef USE_REDIS
-    if (redis_cache) {
-        auto cached = redis_cache->get("assoc:" + input);
-        if (cached) {
-            emit_log("[Memory]: Cache HIT for context match.");
-            return *cached;
+std::vector<std::string> Brain::interact_batch(std::span<const std::string> inputs) {
+    const size_t n = inputs.size();
+    std::vector<std::string> responses(n);
+    if (n == 0) return responses;
+    std::lock_guard<std::recursive_mutex> lock(brain_mutex);
+
+    // Too tired to think: every utterance gets the sleepy reply, nothing to batch
+    if (emotions.energy < 0.2) {
+        for (size_t i = 0; i < n; ++i) responses[i] = interact(inputs[i]);
+        return responses;
+    }
+
+    const std::deque<std::string> context = conversation_context; // What every utterance sees
+    last_interaction_time = std::chrono::system_clock::now();
+    for (auto& unit : sensory_inputs) {
+        if (unit->name().find("Clock") != std::string::npos) {
+            static_cast<dnn::ClockUnit*>(unit.get())->record_interaction();
         }
     }
-#endif
+    update_focus();
+
+    // 1. In input order: commands, mood, reflex feedback, cached and reflex replies
+    enum class Route { Interact, Replied, Neural };
+    std::vector<Route> route(n, Route::Neural);
+    std::vector<std::string> cache_keys(n);
+    std::vector<size_t> pending;
+    for (size_t i = 0; i < n; ++i) {
+        const std::string& input_text = inputs[i];
+        if ((input_text.find("Learn:") == 0 || input_text.find("Do:") == 0) && get_skill_manager()) {
+            route[i] = Route::Interact;
+            responses[i] = interact(input_text);
+            continue;
+        }
+        emit_neural_event("input", [&] { return input_text; });
+        apply_input_mood(input_text);
+
+        cache_keys[i] = response_cache_key(input_text, context, context.size());
+        if (!cache_keys[i].empty()) {
+            if (auto cached = response_cache.lookup(cache_keys[i], response_epoch(), clock->now())) {
+                emit_thought([&] { return "Recalled reply for: " + input_text; });
+                route[i] = Route::Replied;
+                responses[i] = std::move(*cached);
+                continue;
+            }
+        }
+        std::string instinct = reflex_reply(input_text);
+        if (!instinct.empty()) {
+            route[i] = Route::Replied;
+            responses[i] = std::move(instinct);
+            continue;
+        }
+        pending.push_back(i);
+    }
+
+    // 2. Tokenise serially, then vectorise in parallel. History is the shared context
+    //    plus the utterance's own "User:" turn, hashed exactly as interact() does.
+    std::string context_text;
+    for (const auto& line : context) context_text += line + " | ";
+    const std::vector<std::string> context_tokens = tokenize(context_text);
+    auto learn_and_map = [&](std::vector<std::string>& tokens) {
+        for (auto& t : tokens) {
+            bool is_word = std::all_of(t.begin(), t.end(), [](unsigned char c) { return std::isalpha(c); });
+            if (!word_embeddings.contains(t) && t.length() > 2 && is_word) learn_word(t);
+            if (synonyms.count(t)) t = synonyms[t];
+        }
+    };
 
-    // 1. Try Entity Extraction first (High Precision)
-    auto entities = extract_entities(input);
-    for (const auto& entity : entities) {
-        auto results = memory_store->query(entity);
-        if (!results.empty()) {
-             const auto& mem = results[0];
-             std::string snippet = mem.content.substr(0, 300);
-             if (mem.content.length() > 300) snippet += "...";
-             std::string result = "I recall knowledge about " + entity + ". " + snippet;
-             
-#ifdef USE_REDIS
-             if (redis_cache) redis_cache->set("assoc:" + input, result, 300); // Cache for 5 mins
-#endif
-             return result;
+    struct Encoded {
+        std::vector<std::string> tokens;                          // Current utterance, synonyms applied
+        std::vector<std::pair<size_t, double>> input;             // Sparse, max-normalised
+        std::vector<std::pair<size_t, std::string>> words;        // For vocab_decode
+        std::vector<MemoryQueryTerm> memory_terms;                // Entities, then keywords
+        size_t entity_count = 0;
+    };
+    std::vector<Encoded> encoded(pending.size());
+    for (size_t k = 0; k < pending.size(); ++k) encoded[k].tokens = tokenize(inputs[pending[k]]);
+    std::vector<std::string> history_prefix = context_tokens;
+    learn_and_map(history_prefix); // One-shot learning is serial: it writes the embeddings
+    history_prefix.push_back("user");
+    for (auto& e : encoded) learn_and_map(e.tokens);
+
+    std::string recent_context; // interact() queries memory with the last two turns and the utterance
+    for (size_t i = context.size() > 2 ? context.size() - 2 : 0; i < context.size(); ++i) recent_context += context[i] + " ";
+    const bool focused = focus_level > 0.1;
+    const std::vector<std::string> focus_tokens = tokenize(focus_topic);
+    const bool query_memory = memory_store != nullptr;
+
+    std::vector<size_t> order(pending.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::for_each(std::execution::par, order.begin(), order.end(), [&](size_t k) {
+        Encoded& e = encoded[k];
+        const std::string& input_text = inputs[pending[k]];
+        std::map<size_t, double> counts;
+        auto add = [&](const std::vector<std::string>& tokens, double weight) {
+            auto put = [&](const std::string& word) {
+                size_t idx = std::hash<std::string>{}(word) % VOCAB_SIZE;
+                counts[idx] += weight;
+                std::string clean = word;
+                std::replace(clean.begin(), clean.end(), '_', ' ');
+                e.words.emplace_back(idx, std::move(clean));
+            };
+            for (const auto& t : tokens) put(t);
+            for (size_t i = 0; i + 1 < tokens.size(); ++i) put(tokens[i] + "_" + tokens[i + 1]);
+        };
+        std::vector<std::string> history = history_prefix;
+        history.insert(history.end(), e.tokens.begin(), e.tokens.end());
+        add(history, 1.0);
+        add(e.tokens, 3.0);
+        if (focused && input_text.find(focus_topic) != std::string::npos) add(focus_tokens, focus_level * 2.0);
+
+        double max_val = 1.0;
+        for (const auto& [idx, v] : counts) max_val = std::max(max_val, v);
+        e.input.reserve(counts.size());
+        for (const auto& [idx, v] : counts) e.input.emplace_back(idx, v / max_val);
+
+        if (query_memory) {
+            const std::string contextual_query = recent_context + "User: " + input_text + " ";
+            e.memory_terms = recall_terms(contextual_query, e.entity_count);
+        }
+    });
+    for (const auto& e : encoded) {
+        for (const auto& [idx, word] : e.words) vocab_decode.try_emplace(idx, word);
+    }
+
+    // 3. Memory: one ranked multi-query search serves both the recalled-fact
+    //    replies and the neural injection (two queries per utterance).
+    //    Utterances answered from memory skip the network.
+    std::vector<std::vector<double>> injections(pending.size());
+    if (query_memory) {
+        std::vector<std::vector<MemoryQueryTerm>> queries;
+        queries.reserve(encoded.size() * 2);
+        for (const auto& e : encoded) {
+            queries.push_back(e.memory_terms);
+            auto& triggers = queries.emplace_back();
+            for (const auto& t : e.tokens) if (t.length() > 3) triggers.push_back({t});
+        }
+        const auto found = memory_store->search_many(queries, 1);
+
+        for (size_t k = 0; k < pending.size(); ++k) {
+            const size_t i = pending[k];
+            const auto& recalled = found[2 * k];
+            if (!recalled.empty()) {
+                responses[i] = recall_reply(encoded[k].memory_terms, encoded[k].entity_count, recalled[0]);
+                route[i] = Route::Replied;
+                emit_log("[Memory]: Recalled fact for '" + inputs[i] + "'");
+                for (const auto& t : tokenize(responses[i])) vocab_decode[std::hash<std::string>{}(t) % VOCAB_SIZE] = t;
+                if (!cache_keys[i].empty()) response_cache.insert(cache_keys[i], inputs[i], responses[i], response_epoch(), clock->now());
+            }
+            const auto& injected = found[2 * k + 1];
+            if (route[i] != Route::Neural || injected.empty()) continue;
+            injections[k].assign(VECTOR_DIM, 0.0); // Only the top memory, to avoid noise
+            for (const auto& mt : tokenize(injected[0].content)) injections[k][std::hash<std::string>{}(mt) % VECTOR_DIM] += 0.5;
         }
     }
 
-    // 2. Fallback to basic keywords
-    auto tokens = tokenize(input);
-    for (const auto& word : tokens) {
-        if (word.length() <= 3) continue; // Skip "the", "is", etc.
-        
-        auto results = memory_store->query(word);
-        if (!results.empty()) {
-            const auto& mem = results[0];
-            std::string snippet = mem.content.substr(0, 300);
-            if (mem.content.length() > 300) snippet += "...";
-            std::string result = "I recall learning about " + word + ". " + snippet;
+    // 4. Batched forward passes, one chunk at a time to bound the dense inputs
+    std::vector<size_t> neural;
+    for (size_t k = 0; k < pending.size(); ++k) {
+        if (route[pending[k]] == Route::Neural) neural.push_back(k);
+    }
+    const std::vector<double> sensory_raw = get_aggregate_sensory_input();
+    constexpr size_t kChunk = 64;
+    std::vector<std::pair<std::string, std::string>> journal;
+    for (size_t b = 0; b < neural.size(); b += kChunk) {
+        const size_t e = std::min(neural.size(), b + kChunk);
+        std::vector<std::vector<double>> X;
+        X.reserve(e - b);
+        for (size_t c = b; c < e; ++c) {
+            std::vector<double> dense(VOCAB_SIZE, 0.0);
+            for (const auto& [idx, v] : encoded[neural[c]].input) dense[idx] = v;
+            X.push_back(std::move(dense));
+        }
+        auto thoughts = language_encoder->network.predict_batch(X);
+        auto memories = memory_center->network.predict_batch(thoughts);
+        std::vector<std::vector<double>> cognitive_inputs;
+        cognitive_inputs.reserve(e - b);
+        for (size_t r = 0; r < thoughts.size(); ++r) {
+            std::vector<double> cog;
+            cog.reserve(thoughts[r].size() + memories[r].size() + sensory_raw.size());
+            cog.insert(cog.end(), thoughts[r].begin(), thoughts[r].end());
+            const size_t memory_at = cog.size();
+            cog.insert(cog.end(), memories[r].begin(), memories[r].end());
+            const auto& injection = injections[neural[b + r]];
+            for (size_t d = 0; d < std::min(injection.size(), memories[r].size()); ++d) cog[memory_at + d] += injection[d];
+            cog.insert(cog.end(), sensory_raw.begin(), sensory_raw.end());
+            cognitive_inputs.push_back(std::move(cog));
+        }
+        auto response_thoughts = cognitive_center->network.predict_batch(cognitive_inputs);
+        auto logits = language_decoder->network.predict_batch(response_thoughts);
+
+        // Plasticity: one averaged Hebbian step per region for the chunk
+        struct Path { Region* region; const std::vector<std::vector<double>>& in; const std::vector<std::vector<double>>& out; };
+        const Path paths[] = {{language_encoder.get(), X, thoughts},
+                              {memory_center.get(), thoughts, memories},
+                              {cognitive_center.get(), cognitive_inputs, response_thoughts},
+                              {language_decoder.get(), response_thoughts, logits}};
+        for (const auto& path : paths) {
+            if (learner) {
+                for (size_t r = 0; r < path.in.size(); ++r) learner->submit(&path.region->network, path.in[r], path.out[r], 0.01);
+            } else {
+                path.region->network.train(path.in, path.out, 1, static_cast<int>(path.in.size()), 0.01);
+            }
+            path.region->current_activity = path.out.back(); // Dashboard shows the last utterance
+        }
 
-#ifdef USE_REDIS
-            if (redis_cache) redis_cache->set("assoc:" + input, result, 300);
-#endif
-            return result;
+        for (size_t r = 0; r < logits.size(); ++r) {
+            const size_t i = pending[neural[b + r]];
+            const std::string& input_text = inputs[i];
+            std::string response_text = decode_output(logits[r]);
+            emit_thought([&] { return "Thinking about: " + input_text + " => " + response_text; });
+            response_text = modulate_personality(std::move(response_text));
+            if (input_text.length() > 20 && response_text.length() > 10 && response_text.find("...") == std::string::npos) {
+                journal.emplace_back(input_text, response_text);
+            }
+            if (!cache_keys[i].empty()) response_cache.insert(cache_keys[i], input_text, response_text, response_epoch(), clock->now());
+            responses[i] = std::move(response_text);
+        }
+    }
+
+    // 5. Continuous learning journal, one open for the batch
+    if (!journal.empty() && !is_headless()) {
+        std::ofstream learn_file("state/learned_interactions.txt", std::ios::app);
+        if (learn_file) {
+            for (const auto& [in, out] : journal) learn_file << in << "|" << out << "\n";
+            safe_print("[Persistence]: Saved " + std::to_string(journal.size()) + " interactions to state/learned_interactions.txt");
+        } else {
+            safe_print("[Persistence]: Failed to open file for writing!");
         }
     }
-    // 3. Semantic Similarity (Word2Vec Phase 1)
-    for (const auto& word : tokens) {
-        if (word_embeddings.count(word)) {
-#ifdef USE_REDIS
-            // Check Semantic Cache (e.g., sim:robot -> ai)
-            std::string sim_cache_key = "sim:" + word;
-            if (redis_cache) {
-                auto cached_match = redis_cache->get(sim_cache_key);
-                if (cached_match) {
-                    // ... (Simplification: just comment out inner logic if redis not available)
-                }
-            }
-#endif
 
-            // Find most similar base word
+    // 6. The batch joins the conversation in input order
+    for (size_t i = 0; i < n; ++i) {
+        if (route[i] == Route::Interact) continue; // interact() recorded its own turns
+        push_context("User: " + inputs[i]);
+        push_context("Brain: " + responses[i]);
+    }
+    return responses;
+}
+
+std::vector<MemoryQueryTerm> Brain::recall_terms(const std::string& text, size_t& entity_count) {
+    std::vector<MemoryQueryTerm> terms;
+    for (auto& entity : extract_entities(text)) terms.push_back({std::move(entity), 2.0});
+    entity_count = terms.size();
+    for (auto& word : tokenize(text)) {
+        if (word.length() > 3) terms.push_back({std::move(word)}); // Skip "the", "is", etc.
+    }
+    return terms;
+}
+
+std::string Brain::recall_reply(const std::vector<MemoryQueryTerm>& terms, size_t entity_count, const Memory& mem) const {
+    // Name the first term (entities first) that the recalled memory mentions
+    std::string content = mem.content;
+    std::transform(content.begin(), content.end(), content.begin(), [](unsigned char c) { return std::tolower(c); });
+    size_t named = terms.size();
+    for (size_t t = 0; t < terms.size() && named == terms.size(); ++t) {
+        std::string term = terms[t].text;
+        std::transform(term.begin(), term.end(), term.begin(), [](unsigned char c) { return std::tolower(c); });
+        if (content.find(term) != std::string::npos) named = t;
+    }
+    if (named == terms.size()) named = std::min(entity_count, terms.size() - 1);
+
+    std::string snippet = mem.content.substr(0, 300);
+    if (mem.content.length() > 300) snippet += "...";
+    return (named < entity_count ? "I recall knowledge about " : "I recall learning about ") + terms[named].text + ". " + snippet;
+}
+
+std::string Brain::get_associative_memory(const std::string& input) {
+    if (!memory_store) return "";
+
+    // 1+2. Entities (high precision) and keywords, ranked together by BM25 in
+    // one search; a repeated input is answered from the recall cache
+    bool searched = false;
+    auto recalled = recall_cache->get_or_load("assoc:" + input, [&]() -> std::optional<std::string> {
+        searched = true;
+        size_t entity_count = 0;
+        const auto terms = recall_terms(input, entity_count);
+        if (terms.empty()) return std::nullopt;
+        auto results = memory_store->search(terms, 1);
+        if (results.empty()) return std::nullopt;
+        return recall_reply(terms, entity_count, results[0]);
+    });
+    if (recalled) {
+        if (!searched) emit_log("[Memory]: Cache HIT for context match.");
+        return *recalled;
+    }
+
+    auto tokens = tokenize(input);
+    // 3. Semantic Similarity (Word2Vec Phase 1): the most similar base word, cached per word
+    for (const auto& word : tokens) {
+        const float* w_vec = word_embeddings.find(word);
+        if (!w_vec) continue;
+        recall_cache->get_or_load("sim:" + word, [&]() -> std::optional<std::string> {
             std::string best_match = "";
             double max_sim = -1.0;
-            
-            for (const auto& [base, vec] : word_embeddings) {
+
+            for (size_t idx = 0; idx < word_embeddings.size(); ++idx) {
+                std::string_view base = word_embeddings.word(idx);
                 if (base == word) continue;
+                const float* vec = word_embeddings.row(idx);
                 double sim = 0;
-                auto& w_vec = word_embeddings.at(word);
-                for (size_t i = 0; i < VECTOR_DIM; ++i) sim += w_vec[i] * vec[i];
-                
+                for (size_t i = 0; i < VECTOR_DIM; ++i) sim += static_cast<double>(w_vec[i]) * vec[i];
+
                 if (sim > max_sim) {
                     max_sim = sim;
-                    best_match = base;
+                    best_match = std::string(base);
                 }
             }
-            
-            if (max_sim > 0.8) { // Similarity threshold
-#ifdef USE_REDIS
-                if (redis_cache) redis_cache->set("sim:" + word, best_match, 3600); 
-                if (redis_cache) redis_cache->set("assoc:" + input, "Connecting...", 300);
-#endif
-            }
-        }
+            if (max_sim > 0.8) return best_match; // Similarity threshold
+            return std::nullopt;
+        });
     }
 
     return "";
@@ -802,19 +1233,28 @@ bool Brain::CheckPrintable(char c) {
     return (c >= 32 && c <= 126);
 }
 
-void Brain::sleep() {
+void Brain::sleep() {
+    {
+        std::lock_guard<std::recursive_mutex> lock(brain_mutex);
+        safe_print("[Brain is consolidating memories... zzz...]");
+
+        // MEGA-BATCH 8: Enhanced Consolidation
+        consolidate_memories();
+    }
+
+    // Feature 6: REM replay. Takes brain_mutex per mini-batch so interaction
+    // can continue between batches.
+    perform_rem_cycle();
+
     std::lock_guard<std::recursive_mutex> lock(brain_mutex);
-    safe_print("[Brain is consolidating memories... zzz...]");
-    
-    // MEGA-BATCH 8: Enhanced Consolidation
-    consolidate_memories();
-    
     // Original Network Consolidation
     memory_center->network.consolidate_memories(memory_center->current_activity);
     cognitive_center->network.consolidate_memories(cognitive_center->current_activity);
+    bump_response_epoch(); // Consolidation rescales the weights cached answers came from
     
-    // Auto-save state
-    save("state/brain_autosave.bin");
+    // Auto-save state: delta of the rows touched since the last sleep, or a full
+    // compaction, serialised on the snapshot writer thread
+    if (!is_headless()) checkpoint("state/brain_autosave.bin");
     
     // Restore stats
     emotions.energy = 1.0;
@@ -823,6 +1263,7 @@ void Brain::sleep() {
 }
 
 void Brain::update_reflex_learning(const std::string& trigger, double reward) {
+    bump_response_epoch();
     // Find key in reflex map that matches trigger (fuzzy or exact)
     // For simplicity, we assume we tracked the key, but we tracked the full input.
     // We'll rely on Reflex::reinforce checking containment/fuzzy again inside, 
@@ -845,7 +1286,10 @@ void Brain::update_reflex_learning(const std::string& trigger, double reward) {
 void Brain::consolidate_memories() {
     if (!memory_store) return;
     
-    // Move high-importance short-term memories to long-term SQL
+    // Move high-importance short-term memories to long-term SQL. Everything
+    // (memories, their embeddings, the journal entry) goes out as one batch.
+    std::vector<MemoryRecord> batch;
+    std::vector<ContextItem*> pending;
     for (auto& item : conversation_history) {
         if (item.consolidated) continue;
 
@@ -858,8 +1302,8 @@ void Brain::consolidate_memories() {
                  auto tokens = tokenize(item.text);
                  int count = 0;
                  for(const auto& t : tokens) {
-                     if (word_embeddings.count(t)) {
-                         dnn::add_vectors(embedding, word_embeddings[t]);
+                     if (const float* vec = word_embeddings.find(t)) {
+                         for (size_t i = 0; i < VECTOR_DIM; ++i) embedding[i] += vec[i];
                          count++;
                      }
                  }
@@ -867,13 +1311,15 @@ void Brain::consolidate_memories() {
                      for(auto& v : embedding) v /= count;
                  }
                  
-                 // Store with embedding
-                 // Using item.intent as key/category? Or just "Consolidated_Timestamp"
-                 std::string key = "mem_" + std::to_string(item.timestamp) + "_" + std::to_string(rand() % 1000);
-                 memory_store->store("Consolidated", item.text, "Sleep"); // Standard KV
-                 memory_store->store_embedding(key, embedding); // Vector
-                 
-                 emit_log("[Memory]: Consolidated '" + item.text.substr(0, std::min((size_t)20, item.text.length())) + "...'");
+                 MemoryRecord record;
+                 record.type = "Consolidated";
+                 record.content = item.text;
+                 record.tags = "Sleep";
+                 record.embedding_key = "mem_" + std::to_string(item.timestamp) + "_" + std::to_string(rand() % 1000);
+                 record.embedding = std::move(embedding);
+                 batch.push_back(std::move(record));
+                 pending.push_back(&item);
+                 continue;
             }
         }
         item.consolidated = true;
@@ -885,15 +1331,26 @@ void Brain::consolidate_memories() {
         summary += item.role + ": " + item.text + ". ";
     }
     if (!summary.empty()) {
-        std::string key = "journal_" + std::to_string(std::time(nullptr));
         // In a real system, we'd use an LLM to summarize 'summary' here
         // For now, we store the raw log as a "Journal Entry"
-        memory_store->store("Journal", summary, "Narrative");
-        emit_log("[Memory]: Created Episodic Journal Entry.");
+        batch.push_back(MemoryRecord{.type = "Journal", .content = summary, .tags = "Narrative"});
+    }
+
+    if (!batch.empty()) {
+        if (memory_store->store_batch(batch)) {
+            recall_cache->clear(); // Any stored memory may change what an input recalls
+            bump_response_epoch();  // ...and so what it is answered with
+            for (auto* item : pending) {
+                item->consolidated = true;
+                emit_log("[Memory]: Consolidated '" + item->text.substr(0, std::min((size_t)20, item->text.length())) + "...'");
+            }
+            if (!summary.empty()) emit_log("[Memory]: Created Episodic Journal Entry.");
+        } else {
+            // Nothing was written; unconsolidated items are retried next sleep
+            emit_log("[Memory]: Consolidation batch of " + std::to_string(batch.size()) + " failed.");
+        }
     }
     
-    // Feature 6: REM Logic Trigger
-    perform_rem_cycle();
 }
 
 std::string Brain::research(const std::string& topic) {
@@ -902,7 +1359,7 @@ std::string Brain::research(const std::string& topic) {
         std::lock_guard<std::recursive_mutex> lock(brain_mutex);
         current_research_topic = topic;
         log_activity("[Background]: Researching " + topic + "...");
-        if (on_research_update) on_research_update("Starting research on: " + topic);
+        events.emit(dnn::EventTopic::Research, "research", [&] { return "Starting research on: " + topic; });
     }
     
     // Fetch with links (network bound)
@@ -948,14 +1405,17 @@ std::string Brain::research(const std::string& topic) {
     // Save to Explicit Memory
     if (memory_store) {
         memory_store->store("Research", content, topic);
+        recall_cache->clear();
+        bump_response_epoch();
     }
     
-    if (on_research_update) on_research_update("Completed research on: " + topic);
+    events.emit(dnn::EventTopic::Research, "research", [&] { return "Completed research on: " + topic; });
     return "I learned about " + topic + "! " + content.substr(0, 50) + "... (Found " + std::to_string(result.related_topics.size()) + " related topics)";
 }
 
 void Brain::teach(const std::string& input_text, const std::string& target_text) {
     std::lock_guard<std::recursive_mutex> lock(brain_mutex);
+    bump_response_epoch();
     
     // 1. Sensual Perception (Encoding) - Same as interact
     std::vector<double> input_vec(VOCAB_SIZE, 0.0);
@@ -1013,6 +1473,189 @@ void Brain::teach(const std::string& input_text, const std::string& target_text)
     // safe_print("Learned: " + input_text + " -> " + target_text);
 }
 
+std::string TeachReport::to_string() const {
+    std::ostringstream ss;
+    ss << std::fixed << std::setprecision(1);
+    ss << "Taught " << pairs << " pairs x " << epochs << " epochs in " << total_ms << " ms"
+       << " (vectorise " << vectorise_ms << " ms, forward " << forward_ms << " ms, train " << train_ms << " ms)"
+       << ", " << pairs_per_sec << " pairs/s, loss " << std::setprecision(5) << final_loss;
+    if (budget_exhausted) ss << " (time budget reached)";
+    return ss.str();
+}
+
+std::string ReplayReport::to_string() const {
+    std::ostringstream ss;
+    ss << "Replayed " << teach.pairs << " of " << (journal_pairs + conversation_pairs + cache_hit_pairs + memory_pairs)
+       << " candidates (journal " << journal_pairs << ", conversation " << conversation_pairs
+       << ", cache hits " << cache_hit_pairs
+       << ", memories " << memory_pairs << "): " << teach.to_string();
+    return ss.str();
+}
+
+TeachReport Brain::teach_batch(const std::vector<std::pair<std::string, std::string>>& pairs,
+                               const TeachOptions& options) {
+    using clock = std::chrono::steady_clock;
+    auto ms_since = [](clock::time_point t) { return std::chrono::duration<double, std::milli>(clock::now() - t).count(); };
+    TeachReport report;
+    report.pairs = pairs.size();
+    report.epochs = std::max(0, options.epochs);
+    if (pairs.empty()) return report;
+    const auto start = clock::now();
+    const size_t batch = static_cast<size_t>(std::max(1, options.batch_size));
+    const size_t n = pairs.size();
+
+    // 1. Vectorise: same bag-of-words hashing and max-normalisation as teach(),
+    //    kept sparse (a dense target is VOCAB_SIZE doubles per pair)
+    using Sparse = std::vector<std::pair<size_t, double>>;
+    struct Encoded { Sparse input, target; std::vector<std::pair<size_t, std::string>> words; };
+    std::vector<Encoded> encoded(n);
+    std::vector<size_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::for_each(std::execution::par, order.begin(), order.end(), [&](size_t i) {
+        auto encode = [&](const std::string& text, Sparse& out) {
+            std::map<size_t, double> counts;
+            for (const auto& word : tokenize(text)) {
+                size_t idx = std::hash<std::string>{}(word) % VOCAB_SIZE;
+                counts[idx] += 1.0;
+                encoded[i].words.emplace_back(idx, word);
+            }
+            double max_val = 1.0;
+            for (const auto& [idx, c] : counts) max_val = std::max(max_val, c);
+            out.reserve(counts.size());
+            for (const auto& [idx, c] : counts) out.emplace_back(idx, c / max_val);
+        };
+        encode(pairs[i].first, encoded[i].input);
+        encode(pairs[i].second, encoded[i].target);
+    });
+    auto densify = [](const Sparse& sparse) {
+        std::vector<double> dense(VOCAB_SIZE, 0.0);
+        for (const auto& [idx, v] : sparse) dense[idx] = v;
+        return dense;
+    };
+    {
+        std::lock_guard<std::recursive_mutex> lock(brain_mutex);
+        for (const auto& e : encoded) {
+            for (const auto& [idx, word] : e.words) vocab_decode.try_emplace(idx, word);
+        }
+    }
+    report.vectorise_ms = ms_since(start);
+
+    // 2. Batched forward passes (encoder -> memory -> cognitive), each followed by
+    //    one Hebbian reinforcement of that path, as teach() does per pair.
+    //    Sensory context is sampled once for the whole curriculum.
+    const auto forward_start = clock::now();
+    std::vector<std::vector<double>> responses;
+    responses.reserve(n);
+    const std::vector<double> sensory_raw = get_aggregate_sensory_input();
+    auto over_budget = [&] { return options.time_budget_ms > 0.0 && ms_since(start) >= options.time_budget_ms; };
+    for (size_t b = 0; b < n; b += batch) {
+        if (over_budget()) {
+            report.budget_exhausted = true;
+            break;
+        }
+        const size_t e = std::min(n, b + batch);
+        std::vector<std::vector<double>> inputs, cognitive_inputs;
+        inputs.reserve(e - b);
+        for (size_t i = b; i < e; ++i) inputs.push_back(densify(encoded[i].input));
+
+        std::lock_guard<std::recursive_mutex> lock(brain_mutex);
+        auto thoughts = language_encoder->network.predict_batch(inputs);
+        auto memories = memory_center->network.predict_batch(thoughts);
+        cognitive_inputs.reserve(e - b);
+        for (size_t k = 0; k < thoughts.size(); ++k) {
+            std::vector<double> cog;
+            cog.reserve(thoughts[k].size() + memories[k].size() + sensory_raw.size());
+            cog.insert(cog.end(), thoughts[k].begin(), thoughts[k].end());
+            cog.insert(cog.end(), memories[k].begin(), memories[k].end());
+            cog.insert(cog.end(), sensory_raw.begin(), sensory_raw.end());
+            cognitive_inputs.push_back(std::move(cog));
+        }
+        auto batch_responses = cognitive_center->network.predict_batch(cognitive_inputs);
+
+        if (options.reinforce_rate > 0.0) {
+            language_encoder->network.train(inputs, thoughts, 1, static_cast<int>(batch), options.reinforce_rate);
+            memory_center->network.train(thoughts, memories, 1, static_cast<int>(batch), options.reinforce_rate);
+            cognitive_center->network.train(cognitive_inputs, batch_responses, 1, static_cast<int>(batch), options.reinforce_rate);
+        }
+        for (auto& r : batch_responses) responses.push_back(std::move(r));
+    }
+    report.forward_ms = ms_since(forward_start);
+
+    // 3. Decoder: response thought -> target words, mini-batch SGD over epochs.
+    //    Out of budget, only the pairs that made it through the forward pass
+    //    train, and only whole epochs count.
+    const auto train_start = clock::now();
+    const size_t trained = responses.size();
+    order.resize(trained);
+    report.pairs = trained;
+    std::mt19937 rng(std::random_device{}());
+    const int epochs = report.epochs;
+    report.epochs = 0;
+    for (int epoch = 1; epoch <= epochs && trained > 0; ++epoch) {
+        std::shuffle(order.begin(), order.end(), rng);
+        double loss_sum = 0.0;
+        bool complete = true;
+        for (size_t b = 0; b < trained; b += batch) {
+            if (over_budget()) {
+                complete = false;
+                break;
+            }
+            const size_t e = std::min(trained, b + batch);
+            std::vector<std::vector<double>> X, Y;
+            X.reserve(e - b);
+            Y.reserve(e - b);
+            for (size_t k = b; k < e; ++k) {
+                X.push_back(responses[order[k]]);
+                Y.push_back(densify(encoded[order[k]].target));
+            }
+            std::lock_guard<std::recursive_mutex> lock(brain_mutex);
+            loss_sum += language_decoder->network.train(X, Y, 1, static_cast<int>(batch), options.learning_rate) * static_cast<double>(e - b);
+        }
+        if (!complete) {
+            report.budget_exhausted = true;
+            break;
+        }
+
+        TeachProgress progress;
+        progress.epoch = epoch;
+        progress.epochs = epochs;
+        progress.pairs = trained;
+        progress.loss = loss_sum / static_cast<double>(trained);
+        progress.elapsed_ms = ms_since(start);
+        progress.pairs_per_sec = static_cast<double>(trained) * epoch / std::max(1e-3, ms_since(train_start) / 1000.0);
+        report.epochs = epoch;
+        report.final_loss = progress.loss;
+        if (options.on_progress) {
+            options.on_progress(progress);
+        } else {
+            std::ostringstream ss;
+            ss << std::fixed << std::setprecision(5) << "[Teach]: epoch " << epoch << "/" << epochs
+               << " loss " << progress.loss << std::setprecision(0) << ", " << progress.pairs_per_sec << " pairs/s";
+            emit_log(ss.str());
+        }
+    }
+    report.train_ms = ms_since(train_start);
+    report.total_ms = ms_since(start);
+    report.pairs_per_sec = report.train_ms > 0.0 ? static_cast<double>(trained) * report.epochs / (report.train_ms / 1000.0) : 0.0;
+    if (trained > 0) bump_response_epoch();
+    return report;
+}
+
+TeachReport Brain::teach_curriculum(const std::string& path, const TeachOptions& options) {
+    std::ifstream in(path);
+    if (!in) {
+        emit_log("[Teach]: Curriculum not found: " + path);
+        return {};
+    }
+    std::vector<std::pair<std::string, std::string>> pairs;
+    std::string line;
+    while (std::getline(in, line)) {
+        size_t delimiter = line.find('|');
+        if (delimiter != std::string::npos) pairs.emplace_back(line.substr(0, delimiter), line.substr(delimiter + 1));
+    }
+    return teach_batch(pairs, options);
+}
+
 
 
 std::string Brain::deep_research(const std::string& topic) {
@@ -1031,135 +1674,181 @@ long long Brain::get_knowledge_size() {
     return 0;
 }
 
-void Brain::automata_loop() {
-    while (running) {
-        std::this_thread::sleep_for(std::chrono::seconds(2)); // Tick every 2s
+void Brain::start_autonomy() {
+    if (virtual_clock) {
+        scheduler = std::make_unique<dnn::Scheduler>(virtual_clock);
+    } else {
+        size_t workers = static_cast<size_t>(std::max(1, dnn::infra::Config::get_int("BRAIN_SCHEDULER_WORKERS", 2)));
+        scheduler = std::make_unique<dnn::Scheduler>(workers);
+    }
 
-        // 0. RL COGNITIVE LOOP (The "Will")
-        if (cognitive_engine) {
-            std::lock_guard<std::recursive_mutex> lock(brain_mutex);
-            // Construct State (64-dim)
-            std::vector<double> state(64, 0.0);
-            state[0] = metabolism.hunger;
-            state[1] = emotions.energy;
-            state[2] = emotions.boredom;
-            state[3] = hormones.dopamine;
-            // Fill rest with sensory noise / context hash
-            for(size_t i=4; i<64; ++i) state[i] = ((double)rand() / RAND_MAX) * 0.1;
-
-            int action = cognitive_engine->decide_action(state);
-            
-            // Execute RL Action
-            double reward = 0.0;
-            if (action == (int)dnn::ActionType::USE_TOOL) {
-                 auto avail = tools->valailable_tools();
-                 if (!avail.empty()) {
-                     std::string tname = avail[rand() % avail.size()];
-                     std::string arg = (tname == "SHELL") ? "ls -la" : "README.md";
-                     std::string res = tools->use_tool(tname, arg);
-                     safe_print("[RL-DECISION]: Uses " + tname + " -> " + res.substr(0, 50) + "...");
-                     
-                     if (res.find("ERROR") == std::string::npos) reward = 0.5; // Good job
-                     else reward = -0.1;
-                 }
-            } else if (action == (int)dnn::ActionType::SPEAK_BABBLE) {
-                 // Pick random word from vocab
-                 if (!word_embeddings.empty()) {
-                     auto it = word_embeddings.begin();
-                     std::advance(it, rand() % word_embeddings.size());
-                     std::string word = it->first;
-                     safe_print("[RL-DECISION]: Babbles word '" + word + "'");
-                     
-                     // Internal reward for practice (Playfulness)
-                     if (personality.playfulness > 0.5) reward = 0.3;
-                 } else {
-                     safe_print("[RL-DECISION]: Tries to babble but knows no words.");
-                     reward = -0.1; 
-                 }
-            } else if (action == (int)dnn::ActionType::SLEEP) {
-                 if (emotions.energy < 0.3) reward = 0.8; // Wise choice
-                 else reward = -0.1; // Lazy
-            }
+    auto period = [](const std::string& job, int default_ms) {
+        std::string key = "BRAIN_" + job + "_PERIOD_MS";
+        std::transform(key.begin(), key.end(), key.begin(), ::toupper);
+        return std::chrono::milliseconds(std::max(1, dnn::infra::Config::get_int(key, default_ms)));
+    };
 
-            // Train immediately (Short-term loop)
-            cognitive_engine->train(state, action, reward, state); 
-        }
+    // 0. RL cognitive loop (the "Will")
+    scheduler->add_job("rl_step", period("rl_step", 2000), [this] { rl_step(); });
+    // 1. Sensory focus (Task #39)
+    scheduler->add_job("sensory_focus", period("sensory_focus", 2000), [this] { update_sensory_focus(); });
+    // 2. Task execution; the task itself runs on the async pool
+    scheduler->add_job("tasks", period("tasks", 2000), [this] { run_next_task(); });
+    // 3. Biological pulse
+    scheduler->add_job("metabolism", period("metabolism", 2000), [this] { metabolize_step(); });
+    // 4. State regulation
+    scheduler->add_job("regulation", period("regulation", 2000), [this] { regulate_state(); });
+
+    scheduler->start();
+}
 
-        // 1. Evaluate Needs & Generate Goals
-        
-        // 1b. Update Sensory Focus (Task #39)
-        update_sensory_focus();
-
-        // 2. Execute Tasks
-        Task* current = task_manager.get_next_task();
-        if (current) {
-            std::string desc = current->description;
-            emit_log("[Cognition]: Executing #" + std::to_string(current->id) + ": " + desc);
-            
-            if (current->type == TaskType::RESEARCH) {
-                std::string topic = desc.length() > 9 ? desc.substr(9) : "unknown";
-                research(topic);
-            } 
-            else if (current->type == TaskType::SLEEP) {
-                sleep();
-                std::lock_guard<std::recursive_mutex> lock(brain_mutex);
-                emotions.energy = 1.0;
-                hormones.melatonin = 0.0;
-            }
-            else if (current->type == TaskType::EAT) {
-                std::this_thread::sleep_for(std::chrono::seconds(1));
-                std::lock_guard<std::recursive_mutex> lock(brain_mutex);
-                metabolism.hunger = 0.0;
-                metabolism.glucose = 1.0;
-                hormones.dopamine = std::min(1.0, hormones.dopamine + 0.3);
-            }
-            else if (current->type == TaskType::DRINK) {
-                std::this_thread::sleep_for(std::chrono::seconds(1));
-                std::lock_guard<std::recursive_mutex> lock(brain_mutex);
-                metabolism.thirst = 0.0;
-                hormones.serotonin = std::min(1.0, hormones.serotonin + 0.2);
-            }
-            else if (current->type == TaskType::MOTORS) {
-                if (ros_bridge) {
-                    dnn::infra::JointState js;
-                    js.name = {"arm_joint_1", "arm_joint_2"};
-                    js.position = {0.5, -0.2};
-                    ros_bridge->publish_joint_command(js);
-                }
-            }
-            
+void Brain::rl_step() {
+    if (!cognitive_engine) return;
+    std::lock_guard<std::recursive_mutex> lock(brain_mutex);
+
+    // Construct State (64-dim)
+    std::vector<double> state(64, 0.0);
+    state[0] = metabolism.hunger;
+    state[1] = emotions.energy;
+    state[2] = emotions.boredom;
+    state[3] = hormones.dopamine;
+    // Fill rest with sensory noise / context hash
+    for(size_t i=4; i<64; ++i) state[i] = ((double)rand() / RAND_MAX) * 0.1;
+
+    int action = cognitive_engine->decide_action(state);
+    
+    // Execute RL Action
+    double reward = 0.0;
+    if (action == (int)dnn::ActionType::USE_TOOL) {
+         auto avail = tools->valailable_tools();
+         if (!avail.empty()) {
+             std::string tname = avail[rand() % avail.size()];
+             std::string arg = (tname == "SHELL") ? "ls -la" : "README.md";
+             if (is_headless()) {
+                 // Simulations never touch the host; the attempt is neutral
+                 cognitive_engine->train(state, action, 0.0, state);
+                 return;
+             }
+             // Tools block (shell, file I/O): run off the tick and train when the result is in
+             scheduler->submit_async("tool:" + tname, [this, tname, arg, state, action] {
+                 std::string res = tools->use_tool(tname, arg);
+                 safe_print("[RL-DECISION]: Uses " + tname + " -> " + res.substr(0, 50) + "...");
+                 double tool_reward = (res.find("ERROR") == std::string::npos) ? 0.5 : -0.1;
+                 std::lock_guard<std::recursive_mutex> lock(brain_mutex);
+                 cognitive_engine->train(state, action, tool_reward, state);
+             });
+             return;
+         }
+    } else if (action == (int)dnn::ActionType::SPEAK_BABBLE) {
+         // Pick random word from vocab
+         if (!word_embeddings.empty()) {
+             std::string word(word_embeddings.word(rand() % word_embeddings.size()));
+             safe_print("[RL-DECISION]: Babbles word '" + word + "'");
+             
+             // Internal reward for practice (Playfulness)
+             if (personality.playfulness > 0.5) reward = 0.3;
+         } else {
+             safe_print("[RL-DECISION]: Tries to babble but knows no words.");
+             reward = -0.1; 
+         }
+    } else if (action == (int)dnn::ActionType::SLEEP) {
+         if (emotions.energy < 0.3) reward = 0.8; // Wise choice
+         else reward = -0.1; // Lazy
+    }
+
+    // Train immediately (Short-term loop)
+    cognitive_engine->train(state, action, reward, state); 
+}
+
+void Brain::run_next_task() {
+    if (task_in_flight_) return;
+    Task* current = task_manager.get_next_task();
+    if (!current) return;
+
+    Task task = *current;
+    emit_log("[Cognition]: Executing #" + std::to_string(task.id) + ": " + task.description);
+    task_in_flight_ = true;
+    scheduler->submit_async("task#" + std::to_string(task.id), [this, task] {
+        try {
+            execute_task(task);
+        } catch (...) {
             task_manager.complete_active_task();
+            task_in_flight_ = false;
+            throw;
         }
-
-        // 3. Biological Pulse
-        metabolize_step();
-        
-        // 4. State Regulation
         {
-             std::lock_guard<std::recursive_mutex> lock(brain_mutex);
-             
-             // Serotonin stabilizes emotions
-             double stab = 0.01 + (hormones.serotonin * 0.02);
-             if (emotions.happiness > 0.5) emotions.happiness -= stab;
-             else if (emotions.happiness < 0.5) emotions.happiness += stab;
-             
-             // Cortisol increases anger/fear
-             if (hormones.cortisol > 0.5) {
-                 emotions.anger = std::min(1.0, emotions.anger + 0.05);
-                 emotions.fear = std::min(1.0, emotions.fear + 0.03);
-             }
+            std::lock_guard<std::recursive_mutex> lock(brain_mutex);
+            completed_tasks[task.type]++;
+        }
+        task_manager.complete_active_task();
+        task_in_flight_ = false;
+    });
+}
 
-             if (on_emotion_update) {
-                std::string status = "Env: " + std::to_string(int(environment.time_of_day)) + "h | ";
-                status += "Energy: " + std::to_string(int(emotions.energy*100)) + "% | ";
-                status += "Hunger: " + std::to_string(int(metabolism.hunger*100)) + "% | ";
-                status += "Dopamine: " + std::to_string(int(hormones.dopamine*100)) + "%";
-                on_emotion_update(status);
-             }
+void Brain::execute_task(const Task& task) {
+    const std::string& desc = task.description;
+    if (task.type == TaskType::RESEARCH) {
+        std::string topic = desc.length() > 9 ? desc.substr(9) : "unknown";
+        if (is_headless()) {
+            // Offline: the goal is satisfied without fetching anything
+            std::lock_guard<std::recursive_mutex> lock(brain_mutex);
+            learned_topics.push_back(topic);
+        } else {
+            research(topic);
+        }
+    } 
+    else if (task.type == TaskType::SLEEP) {
+        sleep();
+        std::lock_guard<std::recursive_mutex> lock(brain_mutex);
+        emotions.energy = 1.0;
+        hormones.melatonin = 0.0;
+    }
+    else if (task.type == TaskType::EAT) {
+        clock->sleep_for(std::chrono::seconds(1));
+        std::lock_guard<std::recursive_mutex> lock(brain_mutex);
+        metabolism.hunger = 0.0;
+        metabolism.glucose = 1.0;
+        hormones.dopamine = std::min(1.0, hormones.dopamine + 0.3);
+    }
+    else if (task.type == TaskType::DRINK) {
+        clock->sleep_for(std::chrono::seconds(1));
+        std::lock_guard<std::recursive_mutex> lock(brain_mutex);
+        metabolism.thirst = 0.0;
+        hormones.serotonin = std::min(1.0, hormones.serotonin + 0.2);
+    }
+    else if (task.type == TaskType::MOTORS) {
+        if (ros_bridge) {
+            dnn::infra::JointState js;
+            js.name = {"arm_joint_1", "arm_joint_2"};
+            js.position = {0.5, -0.2};
+            ros_bridge->publish_joint_command(js);
         }
     }
 }
 
+void Brain::regulate_state() {
+     std::lock_guard<std::recursive_mutex> lock(brain_mutex);
+     
+     // Serotonin stabilizes emotions
+     double stab = 0.01 + (hormones.serotonin * 0.02);
+     if (emotions.happiness > 0.5) emotions.happiness -= stab;
+     else if (emotions.happiness < 0.5) emotions.happiness += stab;
+     
+     // Cortisol increases anger/fear
+     if (hormones.cortisol > 0.5) {
+         emotions.anger = std::min(1.0, emotions.anger + 0.05);
+         emotions.fear = std::min(1.0, emotions.fear + 0.03);
+     }
+
+     events.emit(dnn::EventTopic::Emotion, "status", [&] {
+        std::string status = "Env: " + std::to_string(int(environment.time_of_day)) + "h | ";
+        status += "Energy: " + std::to_string(int(emotions.energy*100)) + "% | ";
+        status += "Hunger: " + std::to_string(int(metabolism.hunger*100)) + "% | ";
+        status += "Dopamine: " + std::to_string(int(hormones.dopamine*100)) + "%";
+        return status;
+     });
+}
+
 std::string Brain::get_status() {
     std::stringstream ss;
     ss << "--- Brain Status ---\n";
@@ -1171,79 +1860,187 @@ std::string Brain::get_status() {
     return ss.str();
 }
 
+void Brain::refresh_state() {
+    using dnn::StatePublisher;
+    enum Section { PERSONALITY, EMOTIONS, SENSORY, THOUGHT, LEARNING, METADATA };
+    // Values are quantised to what the dashboard shows, so sub-display jitter is not a change
+    auto q = [](double v) { return std::isfinite(v) ? static_cast<int64_t>(std::llround(v * 1000.0)) : int64_t{0}; };
+    auto fields = [](std::initializer_list<const char*> names, const int64_t* values) {
+        std::string out = "{";
+        size_t i = 0;
+        for (const char* name : names) {
+            if (i) out += ',';
+            StatePublisher::append_string(out, name);
+            out += ':';
+            StatePublisher::append_number(out, values[i++] / 1000.0);
+        }
+        out += '}';
+        return out;
+    };
+
+    struct SensoryState { std::string name; int type; int64_t focus; std::vector<int64_t> activity; };
+    std::array<int64_t, 5> pers;
+    std::array<int64_t, 6> emo;
+    std::vector<SensoryState> sensory;
+    std::string thought, topic;
+    int64_t topic_focus;
+    int64_t learned;
+    {
+        // Copy under the lock, serialise outside it
+        std::lock_guard<std::recursive_mutex> lock(brain_mutex);
+        pers = {q(personality.curiosity), q(personality.playfulness), q(personality.friendliness),
+                q(personality.formality), q(personality.positivity)};
+        emo = {q(emotions.happiness), q(emotions.sadness), q(emotions.anger),
+               q(emotions.fear), q(emotions.energy), q(emotions.boredom)};
+        sensory.reserve(sensory_inputs.size());
+        for (const auto& unit : sensory_inputs) {
+            SensoryState st{unit->name(), static_cast<int>(unit->type()), q(unit->get_focus()), {}};
+            auto act = StatePublisher::downsample(unit->get_current_activity(), state_activity_bins);
+            st.activity.reserve(act.size());
+            for (double v : act) st.activity.push_back(q(v));
+            sensory.push_back(std::move(st));
+        }
+        thought = current_thought;
+        topic = focus_topic;
+        topic_focus = q(focus_level);
+        learned = static_cast<int64_t>(learned_topics.size());
+    }
+    // Running count kept by the memory store; no database round trip
+    const int64_t knowledge = get_knowledge_size();
+    const int64_t uptime = std::chrono::duration_cast<std::chrono::seconds>(clock->now().time_since_epoch()).count();
+
+    state_publisher_.update(PERSONALITY, StatePublisher::fingerprint(pers.data(), sizeof(pers)), [&] {
+        return fields({"curiosity", "playfulness", "friendliness", "formality", "positivity"}, pers.data());
+    });
+    state_publisher_.update(EMOTIONS, StatePublisher::fingerprint(emo.data(), sizeof(emo)), [&] {
+        return fields({"happiness", "sadness", "anger", "fear", "energy", "boredom"}, emo.data());
+    });
+
+    uint64_t sensory_fp = StatePublisher::fingerprint(nullptr, 0);
+    for (const auto& st : sensory) {
+        sensory_fp = StatePublisher::fingerprint(st.name.data(), st.name.size(), sensory_fp);
+        sensory_fp = StatePublisher::fingerprint(&st.type, sizeof(st.type), sensory_fp);
+        sensory_fp = StatePublisher::fingerprint(&st.focus, sizeof(st.focus), sensory_fp);
+        sensory_fp = StatePublisher::fingerprint(st.activity.data(), st.activity.size() * sizeof(int64_t), sensory_fp);
+    }
+    state_publisher_.update(SENSORY, sensory_fp, [&] {
+        std::string out = "[";
+        for (size_t i = 0; i < sensory.size(); ++i) {
+            const auto& st = sensory[i];
+            if (i) out += ',';
+            out += "{\"name\":";
+            StatePublisher::append_string(out, st.name);
+            out += ",\"type\":" + std::to_string(st.type) + ",\"focus\":";
+            StatePublisher::append_number(out, st.focus / 1000.0);
+            out += ",\"activity\":[";
+            for (size_t j = 0; j < st.activity.size(); ++j) {
+                if (j) out += ',';
+                StatePublisher::append_number(out, st.activity[j] / 1000.0);
+            }
+            out += "]}";
+        }
+        out += ']';
+        return out;
+    });
+
+    state_publisher_.update(THOUGHT, StatePublisher::fingerprint(thought.data(), thought.size()), [&] {
+        std::string out;
+        StatePublisher::append_string(out, thought);
+        return out;
+    });
+
+    uint64_t learning_fp = StatePublisher::fingerprint(topic.data(), topic.size());
+    learning_fp = StatePublisher::fingerprint(&topic_focus, sizeof(topic_focus), learning_fp);
+    learning_fp = StatePublisher::fingerprint(&learned, sizeof(learned), learning_fp);
+    state_publisher_.update(LEARNING, learning_fp, [&] {
+        std::string out = "{\"focus_topic\":";
+        StatePublisher::append_string(out, topic);
+        out += ",\"focus_level\":";
+        StatePublisher::append_number(out, topic_focus / 1000.0);
+        out += ",\"learned_count\":" + std::to_string(learned) + "}";
+        return out;
+    });
+
+    // Uptime only counts as a change once a minute (the dashboard shows hours)
+    const std::array<int64_t, 2> meta = {knowledge, uptime / 60};
+    state_publisher_.update(METADATA, StatePublisher::fingerprint(meta.data(), sizeof(meta)), [&] {
+        return "{\"knowledge_size\":" + std::to_string(knowledge) + ",\"uptime\":" + std::to_string(uptime) +
+               ",\"version\":\"2.1.0-alpha\"}";
+    });
+}
+
 std::string Brain::get_json_state() {
-    std::lock_guard<std::recursive_mutex> lock(brain_mutex);
-    std::stringstream ss;
-    ss << "{";
-    ss << "\"personality\": {";
-    ss << "\"curiosity\": " << personality.curiosity << ",";
-    ss << "\"playfulness\": " << personality.playfulness << ",";
-    ss << "\"friendliness\": " << personality.friendliness << ",";
-    ss << "\"formality\": " << personality.formality << ",";
-    ss << "\"positivity\": " << personality.positivity;
-    ss << "},";
-    ss << "\"emotions\": {";
-    ss << "\"happiness\": " << emotions.happiness << ",";
-    ss << "\"sadness\": " << emotions.sadness << ",";
-    ss << "\"anger\": " << emotions.anger << ",";
-    ss << "\"fear\": " << emotions.fear << ",";
-    ss << "\"energy\": " << emotions.energy << ",";
-    ss << "\"boredom\": " << emotions.boredom;
-    ss << "},";
-    ss << "\"sensory_activity\": [";
-    for (size_t i = 0; i < sensory_inputs.size(); ++i) {
-        ss << "{";
-        ss << "\"name\": \"" << sensory_inputs[i]->name() << "\",";
-        ss << "\"type\": " << (int)sensory_inputs[i]->type() << ",";
-        ss << "\"focus\": " << sensory_inputs[i]->get_focus() << ",";
-        ss << "\"activity\": [";
-        auto act = sensory_inputs[i]->get_current_activity();
-        for (size_t j = 0; j < act.size(); ++j) {
-            ss << act[j] << (j < act.size() - 1 ? "," : "");
-        }
-        ss << "]";
-        ss << "}" << (i < sensory_inputs.size() - 1 ? "," : "");
-    }
-    ss << "],";
-    ss << "\"thought\": \"" << current_thought << "\",";
-    ss << "\"learning\": {";
-    ss << "\"focus_topic\": \"" << focus_topic << "\",";
-    ss << "\"focus_level\": " << focus_level << ",";
-    ss << "\"learned_count\": " << learned_topics.size();
-    ss << "},";
-    ss << "\"metadata\": {";
-    ss << "\"knowledge_size\": " << get_knowledge_size() << ",";
-    ss << "\"uptime\": " << (std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now().time_since_epoch()).count()) << ",";
-    ss << "\"version\": \"2.1.0-alpha\"";
-    ss << "}";
-    ss << "}";
-    return ss.str();
+    refresh_state();
+    return state_publisher_.full();
 }
 
-void Brain::perform_rem_cycle() {
-    safe_print("[Brain]: Entering REM Cycle (Dreaming)...");
-    
-    // Feature 6: Replay memories with high emotional weight
-    // For now, randomly selecting words from 'learned_topics' as triggers
-    if (learned_topics.empty()) return;
-    
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(0, learned_topics.size() - 1);
-    
-    for (int i = 0; i < 5; ++i) { // 5 Dream Sequences
-        // Simulate random neural activation
-        std::string dream_trigger = learned_topics[dis(gen)];
-        std::string dream = get_associative_memory(dream_trigger);
-        
-        // Reinforce connections (Hebbian Learning Stub)
-        // In a full implementation, we would train the neural net with this input
-        if (memory_center) {
-            // Need vector conversion helpers, assuming generic train for now
-            // memory_center->train(...) 
+std::string Brain::get_json_state_delta(uint64_t& version) {
+    refresh_state();
+    uint64_t current = state_publisher_.version();
+    std::string delta = state_publisher_.delta(version);
+    version = current;
+    return delta;
+}
+
+ReplayReport Brain::perform_rem_cycle() {
+    ReplayReport report;
+    ReplayOptions options;
+    std::vector<std::pair<std::string, std::string>> sample;
+    std::mt19937_64 rng(std::random_device{}());
+    size_t seen = 0;
+    // Reservoir sampling across all sources: the journal is streamed, not loaded
+    auto offer = [&](std::string input, std::string target) {
+        if (input.empty() || target.empty()) return;
+        ++seen;
+        if (sample.size() < options.samples) {
+            sample.emplace_back(std::move(input), std::move(target));
+        } else if (options.samples > 0) {
+            size_t slot = std::uniform_int_distribution<size_t>(0, seen - 1)(rng);
+            if (slot < options.samples) sample[slot] = {std::move(input), std::move(target)};
+        }
+    };
+
+    {
+        std::lock_guard<std::recursive_mutex> lock(brain_mutex);
+        safe_print("[Brain]: Entering REM Cycle (Dreaming)...");
+        options = replay_options;
+        for (size_t i = 0; i + 1 < conversation_history.size(); ++i) {
+            if (conversation_history[i].role == "User" && conversation_history[i + 1].role == "Brain") {
+                offer(conversation_history[i].text, conversation_history[i + 1].text);
+                ++report.conversation_pairs;
+            }
         }
-        safe_print("[Dreaming]: " + dream_trigger + " -> " + dream.substr(0, 30) + "...");
+        for (auto& [input, response] : response_cache.take_hit_pairs()) {
+            offer(std::move(input), std::move(response));
+            ++report.cache_hit_pairs;
+        }
+        if (memory_store && options.recent_memories > 0) {
+            for (const auto& memory : memory_store->get_recent(options.recent_memories)) {
+                offer(memory.content, memory.content);
+                ++report.memory_pairs;
+            }
+        }
+    }
+
+    if (!is_headless() && !options.journal_path.empty()) {
+        std::ifstream journal(options.journal_path);
+        std::string line;
+        while (std::getline(journal, line)) {
+            size_t delimiter = line.find('|');
+            if (delimiter == std::string::npos) continue;
+            offer(line.substr(0, delimiter), line.substr(delimiter + 1));
+            ++report.journal_pairs;
+        }
+    }
+
+    if (sample.empty()) return report;
+    for (size_t i = 0; i < std::min<size_t>(3, sample.size()); ++i) {
+        safe_print("[Dreaming]: " + sample[i].first.substr(0, 30) + " -> " + sample[i].second.substr(0, 30) + "...");
     }
+    if (!options.teach.on_progress) options.teach.on_progress = [](const TeachProgress&) {};
+    report.teach = teach_batch(sample, options.teach);
+    emit_log("[REM]: " + report.to_string());
+    return report;
 }
 
 void Brain::metabolize_step() {
@@ -1300,6 +2097,7 @@ void Brain::metabolize_step() {
 
 void Brain::update_from_json(const std::string& json) {
     std::lock_guard<std::recursive_mutex> lock(brain_mutex);
+    bump_response_epoch();
     // Extremely basic parser for "key": value
     auto parse_val = [&](const std::string& key) -> double {
         size_t pos = json.find("\"" + key + "\"");
@@ -1329,55 +2127,351 @@ void Brain::update_from_json(const std::string& json) {
 }
 
 
-void Brain::save(const std::string& filename) {
-    std::lock_guard<std::recursive_mutex> lock(brain_mutex);
-    safe_print("[Brain]: Saving memory state to " + filename + "...");
+namespace {
 
-    std::ofstream os(filename, std::ios::binary);
-    if (!os) return;
+// Trailer after the reflex table: marks a full snapshot as the base of a delta chain.
+// Readers that predate it simply stop before these bytes.
+constexpr uint32_t kCheckpointTrailerMagic = 0x504B4342; // "BCKP"
+constexpr uint32_t kDeltaLogMagic = 0x544C4442;          // "BDLT"
+constexpr uint32_t kDeltaLogVersion = 2;
 
-    os.write(reinterpret_cast<char*>(&personality), sizeof(Personality));
-    os.write(reinterpret_cast<char*>(&emotions), sizeof(Emotions));
-    
-    // Save Vocab
-    size_t vocab_count = vocab_decode.size();
-    os.write(reinterpret_cast<char*>(&vocab_count), sizeof(size_t));
-    for (const auto& [idx, word] : vocab_decode) {
+using Instincts = std::map<std::string, std::vector<Reflex::WeightedResponse>>;
+
+uint64_t fnv1a(const char* data, size_t len, uint64_t h = 1469598103934665603ULL) {
+    for (size_t i = 0; i < len; ++i) {
+        h ^= static_cast<unsigned char>(data[i]);
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+uint64_t hash_vocab(const std::map<size_t, std::string>& vocab) {
+    uint64_t h = fnv1a(nullptr, 0);
+    for (const auto& [idx, word] : vocab) {
+        h = fnv1a(reinterpret_cast<const char*>(&idx), sizeof(idx), h);
+        h = fnv1a(word.data(), word.size() + 1, h);
+    }
+    return h;
+}
+
+uint64_t hash_instincts(const Instincts& instincts) {
+    uint64_t h = fnv1a(nullptr, 0);
+    for (const auto& [key, choices] : instincts) {
+        h = fnv1a(key.data(), key.size() + 1, h);
+        for (const auto& choice : choices) {
+            h = fnv1a(choice.text.data(), choice.text.size() + 1, h);
+            h = fnv1a(reinterpret_cast<const char*>(&choice.weight), sizeof(double), h);
+        }
+    }
+    return h;
+}
+
+void write_vocab(std::ostream& os, const std::map<size_t, std::string>& vocab) {
+    size_t vocab_count = vocab.size();
+    os.write(reinterpret_cast<const char*>(&vocab_count), sizeof(size_t));
+    for (const auto& [idx, word] : vocab) {
         os.write(reinterpret_cast<const char*>(&idx), sizeof(size_t));
         size_t len = word.length();
         os.write(reinterpret_cast<const char*>(&len), sizeof(size_t));
         os.write(word.c_str(), len);
     }
-    
-    language_encoder->network.save(os);
-    language_decoder->network.save(os);
-    memory_center->network.save(os);
-    cognitive_center->network.save(os);
-    
-    // Save Reflex weights
-    auto& instincts = reflex.get_instincts();
+}
+
+void read_vocab(std::istream& is, std::map<size_t, std::string>& vocab) {
+    size_t vocab_count = 0;
+    if (!is.read(reinterpret_cast<char*>(&vocab_count), sizeof(size_t))) return;
+    for (size_t i = 0; i < vocab_count && is; ++i) {
+        size_t idx, len;
+        is.read(reinterpret_cast<char*>(&idx), sizeof(size_t));
+        is.read(reinterpret_cast<char*>(&len), sizeof(size_t));
+        if (!is) break;
+        std::string word(len, ' ');
+        is.read(&word[0], len);
+        vocab[idx] = word;
+    }
+}
+
+void write_instincts(std::ostream& os, const Instincts& instincts) {
     size_t reflex_count = instincts.size();
-    os.write(reinterpret_cast<char*>(&reflex_count), sizeof(size_t));
+    os.write(reinterpret_cast<const char*>(&reflex_count), sizeof(size_t));
     for (const auto& [key, choices] : instincts) {
         size_t klen = key.length();
-        os.write(reinterpret_cast<char*>(&klen), sizeof(size_t));
+        os.write(reinterpret_cast<const char*>(&klen), sizeof(size_t));
         os.write(key.c_str(), klen);
-        
+
         size_t clen = choices.size();
-        os.write(reinterpret_cast<char*>(&clen), sizeof(size_t));
+        os.write(reinterpret_cast<const char*>(&clen), sizeof(size_t));
         for (const auto& choice : choices) {
             size_t tlen = choice.text.length();
-            os.write(reinterpret_cast<char*>(&tlen), sizeof(size_t));
+            os.write(reinterpret_cast<const char*>(&tlen), sizeof(size_t));
             os.write(choice.text.c_str(), tlen);
             os.write(reinterpret_cast<const char*>(&choice.weight), sizeof(double));
         }
     }
-    
-    safe_print("[Brain]: Saved.");
+}
+
+bool read_instincts(std::istream& is, Instincts& instincts) {
+    size_t reflex_count = 0;
+    if (!is.read(reinterpret_cast<char*>(&reflex_count), sizeof(size_t))) return false;
+    for (size_t i = 0; i < reflex_count && is; ++i) {
+        size_t klen;
+        is.read(reinterpret_cast<char*>(&klen), sizeof(size_t));
+        if (!is) break;
+        std::string key(klen, ' ');
+        is.read(&key[0], klen);
+
+        size_t clen;
+        is.read(reinterpret_cast<char*>(&clen), sizeof(size_t));
+        std::vector<Reflex::WeightedResponse> choices;
+        for (size_t j = 0; j < clen && is; ++j) {
+            size_t tlen;
+            is.read(reinterpret_cast<char*>(&tlen), sizeof(size_t));
+            if (!is) break;
+            std::string text(tlen, ' ');
+            is.read(&text[0], tlen);
+            double weight;
+            is.read(reinterpret_cast<char*>(&weight), sizeof(double));
+            choices.push_back({text, weight});
+        }
+        instincts[key] = choices;
+    }
+    return static_cast<bool>(is);
+}
+
+uint64_t new_checkpoint_epoch() {
+    std::random_device rd;
+    uint64_t epoch = (static_cast<uint64_t>(rd()) << 32) ^ rd() ^
+                     static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+    return epoch ? epoch : 1;
+}
+
+} // namespace
+
+std::array<dnn::NeuralNetwork*, 4> Brain::region_networks() {
+    return {&language_encoder->network, &language_decoder->network,
+            &memory_center->network, &cognitive_center->network};
+}
+
+BrainSnapshot Brain::capture_snapshot() {
+    std::lock_guard<std::recursive_mutex> lock(brain_mutex);
+    BrainSnapshot snap;
+    snap.personality = personality;
+    snap.emotions = emotions;
+    snap.vocab_decode = vocab_decode;
+    snap.regions.reserve(4);
+    for (auto* net : region_networks()) snap.regions.push_back(*net);
+    snap.instincts = reflex.get_instincts();
+    return snap;
+}
+
+bool Brain::write_snapshot(const BrainSnapshot& snap, std::ostream& os) {
+    os.write(reinterpret_cast<const char*>(&snap.personality), sizeof(Personality));
+    os.write(reinterpret_cast<const char*>(&snap.emotions), sizeof(Emotions));
+    write_vocab(os, snap.vocab_decode);
+    for (const auto& net : snap.regions) net.save(os);
+    write_instincts(os, snap.instincts);
+
+    if (snap.checkpoint_epoch != 0) {
+        os.write(reinterpret_cast<const char*>(&kCheckpointTrailerMagic), sizeof(uint32_t));
+        os.write(reinterpret_cast<const char*>(&snap.checkpoint_epoch), sizeof(uint64_t));
+    }
+    return static_cast<bool>(os);
+}
+
+void Brain::save(const std::string& filename) {
+    safe_print("[Brain]: Saving memory state to " + filename + "...");
+    auto snap = std::make_shared<BrainSnapshot>(capture_snapshot());
+    if (snapshot_writer->write_now(filename, [snap](std::ostream& os) { return write_snapshot(*snap, os); })) {
+        safe_print("[Brain]: Saved.");
+    }
+}
+
+std::future<bool> Brain::save_async(const std::string& filename) {
+    auto snap = std::make_shared<BrainSnapshot>(capture_snapshot());
+    safe_print("[Brain]: Snapshot captured, writing " + filename + " in background...");
+    return snapshot_writer->submit(filename, [snap](std::ostream& os) { return write_snapshot(*snap, os); });
+}
+
+void Brain::checkpoint(const std::string& filename) {
+    std::lock_guard<std::recursive_mutex> lock(brain_mutex);
+    auto nets = region_networks();
+    const std::string delta_path = filename + ".delta";
+
+    size_t full_bytes = 0, dirty_bytes = 0;
+    for (auto* net : nets) {
+        for (const auto& layer : net->layers()) {
+            full_bytes += layer.snapshot_bytes();
+            dirty_bytes += layer.delta_bytes();
+        }
+    }
+
+    // Dirty flags are cleared when a checkpoint is queued. If a queued write then
+    // fails, the rows it carried are only on disk again after a full checkpoint
+    // (a failed base also orphans its delta log), so the next one compacts.
+    bool compact = checkpoint_write_failed_.exchange(false) || checkpoint_epoch_ == 0 || checkpoint_path_ != filename ||
+                   (snapshot_writer->pending() == 0 && !std::filesystem::exists(filename)) ||
+                   checkpoint_deltas_ >= checkpoint_max_deltas ||
+                   dirty_bytes > checkpoint_compaction_ratio * static_cast<double>(full_bytes);
+
+    if (compact) {
+        auto snap = std::make_shared<BrainSnapshot>(capture_snapshot());
+        snap->checkpoint_epoch = new_checkpoint_epoch();
+        for (auto* net : nets) for (auto& layer : net->layers()) layer.clear_dirty();
+
+        checkpoint_path_ = filename;
+        checkpoint_epoch_ = snap->checkpoint_epoch;
+        checkpoint_deltas_ = 0;
+        checkpoint_vocab_hash_ = hash_vocab(snap->vocab_decode);
+        checkpoint_instinct_hash_ = hash_instincts(snap->instincts);
+
+        // Base first, then a fresh log bound to its epoch; the writer runs them in order
+        // so a crash in between leaves a stale log that load() will ignore.
+        auto on_done = [this](bool ok) { if (!ok) checkpoint_write_failed_ = true; };
+        snapshot_writer->submit(filename, [snap](std::ostream& os) { return write_snapshot(*snap, os); }, on_done);
+        uint64_t epoch = checkpoint_epoch_;
+        snapshot_writer->submit(delta_path, [epoch](std::ostream& os) {
+            os.write(reinterpret_cast<const char*>(&kDeltaLogMagic), sizeof(uint32_t));
+            os.write(reinterpret_cast<const char*>(&kDeltaLogVersion), sizeof(uint32_t));
+            os.write(reinterpret_cast<const char*>(&epoch), sizeof(uint64_t));
+            return static_cast<bool>(os);
+        }, on_done);
+        safe_print("[Brain]: Full checkpoint queued (" + std::to_string(full_bytes / 1024) + " KiB of weights).");
+        return;
+    }
+
+    // Delta record payload: scalars, optional vocab/instincts, then each changed layer
+    std::ostringstream payload(std::ios::binary);
+    payload.write(reinterpret_cast<const char*>(&personality), sizeof(Personality));
+    payload.write(reinterpret_cast<const char*>(&emotions), sizeof(Emotions));
+
+    uint64_t vocab_hash = hash_vocab(vocab_decode);
+    uint8_t has_vocab = vocab_hash != checkpoint_vocab_hash_;
+    payload.write(reinterpret_cast<const char*>(&has_vocab), 1);
+    if (has_vocab) write_vocab(payload, vocab_decode);
+
+    const auto& instincts = reflex.get_instincts();
+    uint64_t instinct_hash = hash_instincts(instincts);
+    uint8_t has_instincts = instinct_hash != checkpoint_instinct_hash_;
+    payload.write(reinterpret_cast<const char*>(&has_instincts), 1);
+    if (has_instincts) write_instincts(payload, instincts);
+
+    for (uint32_t r = 0; r < nets.size(); ++r) {
+        auto& layers = nets[r]->layers();
+        for (uint32_t l = 0; l < layers.size(); ++l) {
+            if (layers[l].has_delta()) {
+                payload.write(reinterpret_cast<const char*>(&r), sizeof(uint32_t));
+                payload.write(reinterpret_cast<const char*>(&l), sizeof(uint32_t));
+                layers[l].save_delta(payload);
+            }
+            layers[l].clear_dirty();
+        }
+    }
+
+    checkpoint_vocab_hash_ = vocab_hash;
+    checkpoint_instinct_hash_ = instinct_hash;
+    ++checkpoint_deltas_;
+
+    auto record = std::make_shared<std::string>(payload.str());
+    snapshot_writer->submit_append(delta_path, [record](std::ostream& os) {
+        uint64_t len = record->size();
+        uint64_t sum = fnv1a(record->data(), record->size());
+        os.write(reinterpret_cast<const char*>(&len), sizeof(uint64_t));
+        os.write(reinterpret_cast<const char*>(&sum), sizeof(uint64_t));
+        os.write(record->data(), static_cast<std::streamsize>(record->size()));
+        return static_cast<bool>(os);
+    }, [this](bool ok) { if (!ok) checkpoint_write_failed_ = true; });
+    safe_print("[Brain]: Delta checkpoint queued (" + std::to_string(record->size() / 1024) + " KiB).");
+}
+
+void Brain::replay_checkpoint_deltas(const std::string& delta_path, uint64_t epoch) {
+    std::ifstream ds(delta_path, std::ios::binary);
+    uint32_t magic = 0, version = 0;
+    uint64_t log_epoch = 0;
+    ds.read(reinterpret_cast<char*>(&magic), sizeof(uint32_t));
+    ds.read(reinterpret_cast<char*>(&version), sizeof(uint32_t));
+    ds.read(reinterpret_cast<char*>(&log_epoch), sizeof(uint64_t));
+    if (!ds || magic != kDeltaLogMagic || version != kDeltaLogVersion || log_epoch != epoch) {
+        // Missing, foreign or stale log: the base snapshot stands alone, and
+        // deltas appended to that log would be ignored too, so start a new one
+        checkpoint_write_failed_ = true;
+        return;
+    }
+    std::error_code ec;
+    const uint64_t file_size = std::filesystem::file_size(delta_path, ec);
+    if (ec) {
+        checkpoint_write_failed_ = true;
+        return;
+    }
+
+    struct LayerDelta { uint32_t r, l; std::streamoff at; };
+    auto nets = region_networks();
+    size_t applied = 0;
+    bool clean = false;
+    while (true) {
+        uint64_t len = 0, sum = 0;
+        if (ds.peek() == std::char_traits<char>::eof()) { clean = true; break; }
+        if (!ds.read(reinterpret_cast<char*>(&len), sizeof(uint64_t))) break;
+        if (!ds.read(reinterpret_cast<char*>(&sum), sizeof(uint64_t))) break;
+        const auto at = ds.tellg();
+        if (at < 0 || len > file_size - static_cast<uint64_t>(at)) break; // Torn tail or a corrupt length
+        std::string record(len, '\0');
+        if (!ds.read(&record[0], static_cast<std::streamsize>(len))) break;
+        if (fnv1a(record.data(), record.size()) != sum) break;
+
+        // Decode the whole record before applying any of it
+        std::istringstream rs(record, std::ios::binary);
+        Personality p;
+        Emotions e;
+        std::map<size_t, std::string> vocab;
+        Instincts instincts;
+        uint8_t has_vocab = 0, has_instincts = 0;
+        rs.read(reinterpret_cast<char*>(&p), sizeof(Personality));
+        rs.read(reinterpret_cast<char*>(&e), sizeof(Emotions));
+        rs.read(reinterpret_cast<char*>(&has_vocab), 1);
+        if (has_vocab) read_vocab(rs, vocab);
+        rs.read(reinterpret_cast<char*>(&has_instincts), 1);
+        if (has_instincts) read_instincts(rs, instincts);
+
+        std::vector<LayerDelta> deltas;
+        bool valid = static_cast<bool>(rs);
+        uint32_t r, l;
+        while (valid && rs.read(reinterpret_cast<char*>(&r), sizeof(uint32_t))) {
+            rs.read(reinterpret_cast<char*>(&l), sizeof(uint32_t));
+            const auto pos = rs.tellg();
+            valid = rs && pos >= 0 && r < nets.size() && l < nets[r]->layers().size() &&
+                    nets[r]->layers()[l].skip_delta(rs) && rs.tellg() <= static_cast<std::streamoff>(record.size());
+            if (!valid) break;
+            deltas.push_back({r, l, pos});
+        }
+        if (!valid) {
+            safe_print("[Brain]: Corrupt checkpoint delta in " + delta_path);
+            break;
+        }
+
+        personality = p;
+        emotions = e;
+        if (has_vocab) vocab_decode = std::move(vocab);
+        if (has_instincts) reflex.get_instincts() = std::move(instincts);
+        for (const auto& d : deltas) {
+            rs.clear();
+            rs.seekg(d.at);
+            nets[d.r]->layers()[d.l].load_delta(rs);
+        }
+        ++applied;
+    }
+    checkpoint_deltas_ = applied;
+    // Anything appended after a torn or corrupt record would never be replayed;
+    // the next checkpoint rewrites the base and starts a fresh log instead
+    if (!clean) {
+        checkpoint_write_failed_ = true;
+        safe_print("[Brain]: Checkpoint delta log " + delta_path + " ends early; next checkpoint will be full.");
+    }
+    if (applied > 0) safe_print("[Brain]: Replayed " + std::to_string(applied) + " checkpoint deltas.");
 }
 
 void Brain::load(const std::string& filename) {
     std::lock_guard<std::recursive_mutex> lock(brain_mutex);
+    bump_response_epoch();
     std::ifstream is(filename, std::ios::binary);
     if (!is) {
         safe_print("[Brain]: Could not load file: " + filename);
@@ -1388,57 +2482,31 @@ void Brain::load(const std::string& filename) {
 
     is.read(reinterpret_cast<char*>(&personality), sizeof(Personality));
     is.read(reinterpret_cast<char*>(&emotions), sizeof(Emotions));
-    
-    // Load Vocab
-    size_t vocab_count = 0;
-    if (is.read(reinterpret_cast<char*>(&vocab_count), sizeof(size_t))) {
-        for (size_t i = 0; i < vocab_count; ++i) {
-            size_t idx, len;
-            is.read(reinterpret_cast<char*>(&idx), sizeof(size_t));
-            is.read(reinterpret_cast<char*>(&len), sizeof(size_t));
-            std::string word(len, ' ');
-            is.read(&word[0], len);
-            vocab_decode[idx] = word;
-        }
-    }
-    
-    language_encoder->network.load(is);
-    language_decoder->network.load(is);
-    memory_center->network.load(is);
-    cognitive_center->network.load(is);
-    
-    // Load Reflex weights
-    size_t reflex_count = 0;
-    if (is.read(reinterpret_cast<char*>(&reflex_count), sizeof(size_t))) {
-        auto& instincts = reflex.get_instincts();
-        for (size_t i = 0; i < reflex_count; ++i) {
-            size_t klen;
-            is.read(reinterpret_cast<char*>(&klen), sizeof(size_t));
-            std::string key(klen, ' ');
-            is.read(&key[0], klen);
-            
-            size_t clen;
-            is.read(reinterpret_cast<char*>(&clen), sizeof(size_t));
-            std::vector<Reflex::WeightedResponse> choices;
-            for (size_t j = 0; j < clen; ++j) {
-                size_t tlen;
-                is.read(reinterpret_cast<char*>(&tlen), sizeof(size_t));
-                std::string text(tlen, ' ');
-                is.read(&text[0], tlen);
-                double weight;
-                is.read(reinterpret_cast<char*>(&weight), sizeof(double));
-                choices.push_back({text, weight});
-            }
-            instincts[key] = choices;
+    read_vocab(is, vocab_decode);
+
+    for (auto* net : region_networks()) net->load(is);
+
+    uint64_t epoch = 0;
+    if (read_instincts(is, reflex.get_instincts())) {
+        uint32_t magic = 0;
+        if (is.read(reinterpret_cast<char*>(&magic), sizeof(uint32_t)) && magic == kCheckpointTrailerMagic) {
+            if (!is.read(reinterpret_cast<char*>(&epoch), sizeof(uint64_t))) epoch = 0;
         }
     }
-    
+
+    checkpoint_path_ = filename;
+    checkpoint_epoch_ = epoch;
+    checkpoint_deltas_ = 0;
+    if (epoch != 0) replay_checkpoint_deltas(filename + ".delta", epoch);
+    checkpoint_vocab_hash_ = hash_vocab(vocab_decode);
+    checkpoint_instinct_hash_ = hash_instincts(reflex.get_instincts());
+
     safe_print("[Brain]: Memories restored.");
 }
 
 // Helpers
 void Brain::log_activity(const std::string& msg) {
-    Logger::instance().log(msg);
+    if (!is_headless()) Logger::instance().log(msg); // Another brain may have opened the log file
     emit_log(msg); // Send to Server/Dashboard!
 }
 
@@ -1472,7 +2540,7 @@ std::string Brain::find_curiosity_topic() {
     for (const auto& topic : learned_topics) {
         // Query memory store for related items
         // Low results = High Entropy (Unknown)
-        auto results = memory_store->query(topic);
+        auto results = memory_store ? memory_store->query(topic) : std::vector<Memory>{}; // None when headless
         double entropy = 1.0 / (1.0 + results.size());
         
         if (entropy > max_entropy) {
@@ -1542,10 +2610,10 @@ void Brain::evaluate_goals() {
     if (winner.name == "RESEARCH") {
          std::string topic = find_curiosity_topic();
          task_manager.add_task("Research " + topic, TaskType::RESEARCH, TaskPriority::LOW);
-         emit_thought("Goal: Researching " + topic + " (Score: " + std::to_string(winner.score) + ")");
+         emit_thought([&] { return "Goal: Researching " + topic + " (Score: " + std::to_string(winner.score) + ")"; });
     } else if (winner.name == "SLEEP") {
          task_manager.add_task("Sleep Cycle", TaskType::SLEEP, TaskPriority::MEDIUM);
-         emit_thought("Goal: Sleeping (Score: " + std::to_string(winner.score) + ")");
+         emit_thought([&] { return "Goal: Sleeping (Score: " + std::to_string(winner.score) + ")"; });
     } else if (winner.name == "EAT") {
          task_manager.add_task("Foraging/Feeding", TaskType::EAT, TaskPriority::HIGH);
          emit_thought("Goal: Eating (Cortisol high, hunger high)");
@@ -1554,7 +2622,7 @@ void Brain::evaluate_goals() {
          emit_thought("Goal: Drinking (Thirst critical)");
     } else if (winner.name == "INTERACTION") {
          task_manager.add_task("Engagement: " + winner.param, TaskType::INTERACTION, TaskPriority::LOW);
-         emit_thought("Goal: Interaction (Score: " + std::to_string(winner.score) + ")");
+         emit_thought([&] { return "Goal: Interaction (Score: " + std::to_string(winner.score) + ")"; });
     }
 }
 
@@ -1669,10 +2737,10 @@ void Brain::update_sensory_focus() {
         
         if (unit->type() == dnn::SensoryType::Vision) {
             if (intent == "SCENE_ANALYSIS" || focus_topic != "None") target_focus = 0.9;
-            emit_neural_event("sensory_focus", "Vision focus adjusted to " + std::to_string(target_focus));
+            emit_neural_event("sensory_focus", [&] { return "Vision focus adjusted to " + std::to_string(target_focus); });
         } else if (unit->type() == dnn::SensoryType::Audio) {
             if (intent == "LISTENING" || intent == "CHAT") target_focus = 0.9;
-            emit_neural_event("sensory_focus", "Audio focus adjusted to " + std::to_string(target_focus));
+            emit_neural_event("sensory_focus", [&] { return "Audio focus adjusted to " + std::to_string(target_focus); });
         } else if (unit->type() == dnn::SensoryType::Internal) {
             // Clock/Internal usually have constant focus unless we are "Meditating"
             target_focus = 0.7;
@@ -1684,95 +2752,96 @@ void Brain::update_sensory_focus() {
     }
 }
 
-void Brain::emit_neural_event(const std::string& type, const std::string& data) {
-    if (bypass_enabled && on_neural_event) {
-        on_neural_event(type, data);
-    }
-}
-
 std::vector<double> Brain::get_aggregate_sensory_input() {
+    // brain_mutex only guards the unit list. Features are read in place from
+    // each unit's published buffer, without the unit's lock or a copy.
     std::lock_guard<std::recursive_mutex> lock(brain_mutex);
     std::vector<double> aggregate(VECTOR_DIM, 0.0);
-    
-    double total_weight = 0.0;
-    for (const auto& unit : sensory_inputs) {
-        if (!unit->is_active()) continue;
-        
-        std::vector<double> act = unit->get_current_activity();
-        if (act.size() != VECTOR_DIM) continue;
-        
-        double focus = unit->get_focus();
-        for (size_t i = 0; i < VECTOR_DIM; ++i) {
-            aggregate[i] += act[i] * focus;
+
+    // A producer that publishes twice while we read invalidates the pass; it is
+    // redone, and after a few lapped passes built from consistent copies instead
+    constexpr int kLockFreeAttempts = 4;
+    for (int attempt = 0;; ++attempt) {
+        std::fill(aggregate.begin(), aggregate.end(), 0.0);
+        double total_weight = 0.0;
+        bool consistent = true;
+        for (const auto& unit : sensory_inputs) {
+            if (!unit->is_active()) continue;
+            const double focus = unit->get_focus();
+            if (attempt < kLockFreeAttempts) {
+                auto view = unit->read_begin();
+                if (view.size == VECTOR_DIM) {
+                    dnn::simd::add_scaled(aggregate.data(), view.data, focus, VECTOR_DIM);
+                    total_weight += focus;
+                }
+                consistent = unit->read_valid(view) && consistent;
+            } else {
+                auto features = unit->snapshot();
+                if (features.size() != VECTOR_DIM) continue;
+                dnn::simd::add_scaled(aggregate.data(), features.data(), focus, VECTOR_DIM);
+                total_weight += focus;
+            }
         }
-        total_weight += focus;
-    }
-    
-    if (total_weight > 0.0) {
-        for (double& val : aggregate) val /= total_weight;
+        if (!consistent) continue;
+
+        if (total_weight > 0.0) dnn::simd::scale(aggregate.data(), 1.0 / total_weight, VECTOR_DIM);
+        return aggregate;
     }
-    
-    return aggregate;
 }
 
 // ========== COGNITIVE CORE METHOD IMPLEMENTATIONS ==========
 void Brain::save_vocab(const std::string& filename) {
-    std::ofstream file(filename);
-    if (!file.is_open()) return;
-    
-    for (const auto& [word, vec] : word_embeddings) {
-        file << word << " ";
-        for (double v : vec) file << v << " ";
-        file << "\n";
-    }
+    auto dir = std::filesystem::path(filename).parent_path();
+    if (!dir.empty() && !std::filesystem::exists(dir)) return;
+    snapshot_writer->write_now(filename, [this](std::ostream& os) { return word_embeddings.write(os); });
 }
 
 void Brain::load_vocab(const std::string& filename) {
-    std::ifstream file(filename);
-    if (!file.is_open()) return;
-    
-    word_embeddings.clear();
-    std::string line;
-    while (std::getline(file, line)) {
-        std::stringstream ss(line);
-        std::string word;
-        ss >> word;
-        
-        std::vector<double> vec;
-        double v;
-        while (ss >> v) vec.push_back(v);
-        
-        if (vec.size() == VECTOR_DIM) {
-            word_embeddings[word] = vec;
+    if (!std::filesystem::exists(filename)) {
+        std::string legacy = std::filesystem::path(filename).replace_extension(".txt").string();
+        if (!std::filesystem::exists(legacy)) return;
+
+        size_t converted = 0;
+        if (!dnn::EmbeddingStore::convert_text(legacy, filename, VECTOR_DIM, &converted)) {
+            safe_print("[Brain]: Failed to convert " + legacy + " to " + filename);
+            return;
         }
+        safe_print("[Brain]: Converted " + legacy + " -> " + filename + " (" + std::to_string(converted) + " words).");
+    }
+
+    if (!word_embeddings.map_file(filename)) {
+        safe_print("[Brain]: Could not map vocabulary file: " + filename);
+        return;
     }
     safe_print("[Brain]: Loaded " + std::to_string(word_embeddings.size()) + " words into vocabulary.");
 }
 
 void Brain::learn_word(const std::string& word) {
-    if (word_embeddings.count(word)) return; // Already known
+    if (word_embeddings.contains(word)) return; // Already known
+    bump_response_epoch();
     
     // One-Shot Learning: Assign a random high-dimensional vector
     // This gives the word a unique "neural signature" instantly
     std::vector<double> vec(VECTOR_DIM);
     for (auto& v : vec) v = static_cast<double>(rand()) / RAND_MAX * 2.0 - 1.0;
     
-    word_embeddings[word] = vec;
+    word_embeddings.set(word, vec);
     emit_log("[Language]: Learned new word '" + word + "' (One-Shot).");
     
     // Auto-save to ensure persistence
-    save_vocab();
+    if (!is_headless()) save_vocab();
 }
 std::string Brain::deep_reason(const std::string& query, const std::vector<std::string>& context) {
     std::lock_guard<std::recursive_mutex> lock(brain_mutex);
     
-    if (!cognitive_core) {
+    auto* core = get_cognitive_core();
+    if (!core) {
         return "Cognitive core not initialized";
     }
     
     emit_thought("Deep reasoning about: " + query);
     
-    auto result = cognitive_core->reason(query, context);
+    auto result = core->reason(query, context);
     
     std::string response = result.conclusion;
     if (!result.explanation.empty()) {
@@ -1786,49 +2855,53 @@ std::string Brain::deep_reason(const std::string& query, const std::vector<std::
 float Brain::analyze_causality(const std::string& cause, const std::string& effect) {
     std::lock_guard<std::recursive_mutex> lock(brain_mutex);
     
-    if (!cognitive_core) {
+    auto* core = get_cognitive_core();
+    if (!core) {
         return 0.0f;
     }
     
     emit_thought("Analyzing causal relationship: " + cause + " → " + effect);
     
-    return cognitive_core->compute_causal_effect(cause, effect);
+    return core->compute_causal_effect(cause, effect);
 }
 
 std::string Brain::what_if(const std::string& variable, float new_value, const std::string& target) {
     std::lock_guard<std::recursive_mutex> lock(brain_mutex);
     
-    if (!cognitive_core) {
+    auto* core = get_cognitive_core();
+    if (!core) {
         return "Cognitive core not initialized";
     }
     
     emit_thought("Counterfactual reasoning: What if " + variable + " = " + std::to_string(new_value) + "?");
     
-    return cognitive_core->counterfactual_reasoning(variable, new_value, target);
+    return core->counterfactual_reasoning(variable, new_value, target);
 }
 
 std::vector<std::string> Brain::query_commonsense(const std::string& subject, const std::string& relation) {
     std::lock_guard<std::recursive_mutex> lock(brain_mutex);
     
-    if (!cognitive_core) {
+    auto* core = get_cognitive_core();
+    if (!core) {
         return {};
     }
     
     emit_thought("Querying commonsense knowledge about: " + subject);
     
-    return cognitive_core->query_commonsense(subject, relation);
+    return core->query_commonsense(subject, relation);
 }
 
 void Brain::adapt_from_examples(const std::vector<std::pair<std::vector<float>, std::vector<float>>>& examples) {
     std::lock_guard<std::recursive_mutex> lock(brain_mutex);
     
-    if (!cognitive_core) {
+    auto* core = get_cognitive_core();
+    if (!core) {
         return;
     }
     
     emit_thought("Meta-learning from " + std::to_string(examples.size()) + " examples");
     
-    cognitive_core->meta_learn(examples);
+    core->meta_learn(examples);
     
     safe_print("[Brain]: Adapted from " + std::to_string(examples.size()) + " examples via meta-learning");
 }
@@ -1836,11 +2909,12 @@ void Brain::adapt_from_examples(const std::vector<std::pair<std::vector<float>,
 std::string Brain::get_cognitive_status() {
     std::lock_guard<std::recursive_mutex> lock(brain_mutex);
     
-    if (!cognitive_core) {
+    auto* core = get_cognitive_core();
+    if (!core) {
         return "Cognitive core: Not initialized";
     }
     
-    auto status = cognitive_core->get_status();
+    auto status = core->get_status();
     
     std::string report = "=== Cognitive Core Status ===\n";
     report += "Memories: " + std::to_string(status.total_memories) + "\n";
@@ -0,0 +1,67 @@
+#include "brain_simulation.hpp"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+SimulationResult BrainSimulation::run(const SimulationConfig& config) {
+    using namespace std::chrono;
+    SimulationResult result;
+    result.name = config.name;
+
+    try {
+        auto setup_start = steady_clock::now();
+        BrainOptions options;
+        options.headless = true;
+        Brain brain(options);
+
+        for (const auto& [job, period] : config.job_periods) brain.scheduler->set_period(job, period);
+        if (config.goal_period.count() > 0) {
+            brain.scheduler->add_job("goals", config.goal_period, [&brain] { brain.evaluate_goals(); });
+        }
+        if (config.setup) config.setup(brain);
+        result.setup_ms = duration<double, std::milli>(steady_clock::now() - setup_start).count();
+
+        auto run_start = steady_clock::now();
+        const milliseconds step = std::max(config.step, milliseconds(1));
+        milliseconds elapsed{0};
+        while (elapsed < config.duration) {
+            milliseconds dt = std::min(step, config.duration - elapsed);
+            result.job_runs += brain.scheduler->advance(dt);
+            elapsed += dt;
+            if (config.on_step) config.on_step(brain, elapsed);
+        }
+        result.run_ms = duration<double, std::milli>(steady_clock::now() - run_start).count();
+        result.simulated = elapsed;
+        result.speedup = result.run_ms > 0.0 ? static_cast<double>(elapsed.count()) / result.run_ms : 0.0;
+
+        std::lock_guard<std::recursive_mutex> lock(brain.brain_mutex);
+        result.completed_tasks = brain.completed_tasks;
+        result.emotions = brain.emotions;
+        result.hormones = brain.hormones;
+        result.metabolism = brain.metabolism;
+        result.job_stats = brain.scheduler->stats();
+    } catch (const std::exception& e) {
+        result.error = e.what();
+    }
+    return result;
+}
+
+std::vector<SimulationResult> BrainSimulation::run_batch(const std::vector<SimulationConfig>& configs,
+                                                         std::size_t threads) {
+    std::vector<SimulationResult> results(configs.size());
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = std::min(threads, configs.size());
+
+    std::atomic<std::size_t> next{0};
+    std::vector<std::thread> pool;
+    pool.reserve(threads);
+    for (std::size_t t = 0; t < threads; ++t) {
+        pool.emplace_back([&] {
+            for (std::size_t i = next++; i < configs.size(); i = next++) {
+                results[i] = run(configs[i]);
+            }
+        });
+    }
+    for (auto& th : pool) th.join();
+    return results;
+}
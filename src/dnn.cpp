@@ -67,16 +67,29 @@ namespace dnn {
         : in_size(in), out_size(out), weights(in * out), biases(out),
           eligibility_traces(in * out, 0.0), homeostatic_targets(out, 0.0),
           plasticity_rates(in * out, 0.01), synaptic_pruning_mask(in * out, true),
-          z_cache(out), a_cache(out), indices(out) {
+          z_cache(out), a_cache(out), indices(out), dirty_rows(out, 1), dirty_cols(in, 0), row_shifts(out) {
         
-        std::normal_distribution<double> dist(0.0, std::sqrt(2.0 / static_cast<double>(in_size)));
-        for (auto &w : weights) w = dist(rng);
+        // Draw weights and rates in row blocks on the parallel policy. Every block has
+        // its own engine seeded from rng, so a given seed still yields the same layer.
+        constexpr std::size_t kInitBlockRows = 16;
+        const double stddev = std::sqrt(2.0 / static_cast<double>(in_size));
+        std::vector<std::uint64_t> block_seeds((out + kInitBlockRows - 1) / kInitBlockRows);
+        for (auto &seed : block_seeds) seed = rng();
+        std::vector<std::size_t> blocks(block_seeds.size());
+        std::iota(blocks.begin(), blocks.end(), std::size_t{0});
+
+        std::for_each(std::execution::par, blocks.begin(), blocks.end(), [&](std::size_t b) {
+            std::mt19937_64 block_rng(block_seeds[b]);
+            std::normal_distribution<double> dist(0.0, stddev);
+            std::uniform_real_distribution<double> rate_dist(0.001, 0.02);
+            std::size_t first = b * kInitBlockRows * in_size;
+            std::size_t last = std::min(out, (b + 1) * kInitBlockRows) * in_size;
+            for (std::size_t k = first; k < last; ++k) weights[k] = dist(block_rng);
+            for (std::size_t k = first; k < last; ++k) plasticity_rates[k] = rate_dist(block_rng);
+        });
         std::fill(biases.begin(), biases.end(), 0.0);
         std::fill(homeostatic_targets.begin(), homeostatic_targets.end(), 0.0);
 
-        std::uniform_real_distribution<double> rate_dist(0.001, 0.02);
-        for (auto &rate : plasticity_rates) rate = rate_dist(rng);
-
         std::iota(indices.begin(), indices.end(), std::size_t{0});
     }
 
@@ -141,24 +154,87 @@ namespace dnn {
             delta[j] = dptr[j] * dz;
         });
 
+        // No pruning-mask checks here: pruned weights are zero (no input-gradient
+        // contribution) and apply_gradients() ignores their gradient entries.
         std::for_each(std::execution::par_unseq, indices.begin(), indices.end(), [&](std::size_t j) {
             double d = delta[j];
+            if (d == 0.0) return;
             gbptr[j] += d;
+            simd::add_scaled(gwptr + j * in_size, inptr, d, in_size);
+        });
+
+        for (std::size_t j = 0; j < out_size; ++j) {
+            const double d = delta[j];
+            if (d == 0.0) continue;
+            simd::add_scaled(dinptr, wptr + j * in_size, d, in_size);
+        }
+    }
+
+    void PlasticLayer::forward_batch(const Batch &inputs, Batch &z_out, Batch &a_out, Activation act) const {
+        const std::size_t B = inputs.size();
+        z_out.resize(B);
+        a_out.resize(B);
+        for (std::size_t s = 0; s < B; ++s) {
+            assert(inputs[s].size() == in_size);
+            z_out[s].resize(out_size);
+            a_out[s].resize(out_size);
+        }
+
+        const double *wptr = weights.data();
+        std::for_each(std::execution::par_unseq, indices.begin(), indices.end(), [&](std::size_t j) {
+            const double *row = wptr + j * in_size;
+            for (std::size_t s = 0; s < B; ++s) {
+                double z = biases[j] + simd::dot_product(row, inputs[s].data(), in_size);
+                z_out[s][j] = z;
+                a_out[s][j] = detail::activate(z, act);
+            }
+        });
+    }
+
+    void PlasticLayer::backward_batch(const Batch &inputs,
+                                      const Batch &z,
+                                      const Batch &a,
+                                      const Batch &dL_dout,
+                                      Batch &dL_dinput,
+                                      std::vector<double> &grad_w,
+                                      std::vector<double> &grad_b,
+                                      Activation act,
+                                      bool input_grad) const {
+        const std::size_t B = inputs.size();
+        assert(grad_w.size() == weights.size());
+        assert(grad_b.size() == biases.size());
+
+        Batch delta(B, std::vector<double>(out_size));
+        for (std::size_t s = 0; s < B; ++s) {
+            for (std::size_t j = 0; j < out_size; ++j) {
+                delta[s][j] = dL_dout[s][j] * detail::activate_deriv(z[s][j], a[s][j], act);
+            }
+        }
+
+        // Gradient rows summed over the batch; as in backward(), pruned entries
+        // are computed but never applied.
+        double *gwptr = grad_w.data();
+        std::for_each(std::execution::par_unseq, indices.begin(), indices.end(), [&](std::size_t j) {
             double *row_gw = gwptr + j * in_size;
-            for (std::size_t i = 0; i < in_size; ++i) {
-                if (synaptic_pruning_mask[j * in_size + i]) {
-                    row_gw[i] += d * inptr[i];
-                }
+            std::fill(row_gw, row_gw + in_size, 0.0);
+            double gb = 0.0;
+            for (std::size_t s = 0; s < B; ++s) {
+                const double d = delta[s][j];
+                if (d == 0.0) continue;
+                gb += d;
+                simd::add_scaled(row_gw, inputs[s].data(), d, in_size);
             }
+            grad_b[j] = gb;
         });
 
+        if (!input_grad) return;
+        dL_dinput.assign(B, std::vector<double>(in_size, 0.0));
+        const double *wptr = weights.data();
         for (std::size_t j = 0; j < out_size; ++j) {
-            const double d = delta[j];
             const double *row_w = wptr + j * in_size;
-            for (std::size_t i = 0; i < in_size; ++i) {
-                if (synaptic_pruning_mask[j * in_size + i]) {
-                    dinptr[i] += row_w[i] * d;
-                }
+            for (std::size_t s = 0; s < B; ++s) {
+                const double d = delta[s][j];
+                if (d != 0.0) simd::add_scaled(dL_dinput[s].data(), row_w, d, in_size);
             }
         }
     }
@@ -174,14 +250,41 @@ namespace dnn {
         assert(output.size() == out_size);
 
         for (std::size_t j = 0; j < out_size; ++j) {
+            double homeostatic_adjustment = homeostatic_strength * (homeostatic_targets[j] - output[j]);
+
+            // A silent row (no error, no activity, at its homeostatic target) keeps its
+            // weights; only the trace decays, and traces are not checkpointed per step.
+            if (grad_b[j] == 0.0 && output[j] == 0.0 && homeostatic_adjustment == 0.0) {
+                for (std::size_t i = 0; i < in_size; ++i) {
+                    if (synaptic_pruning_mask[j * in_size + i]) eligibility_traces[j * in_size + i] *= decay_rate;
+                }
+                continue;
+            }
+            // Column-tracked rows stay clean: the columns this step reaches are
+            // marked instead, and the rest only take the homeostatic shift. A row
+            // whose shift log outgrows the row itself is written whole.
+            const bool by_column = tracks_columns() && !dirty_rows[j];
+            if (by_column) {
+                dirty_scalars = true;
+                if (homeostatic_adjustment != 0.0) {
+                    row_shifts[j].push_back(homeostatic_adjustment);
+                    if (row_shifts[j].size() * sizeof(double) >= row_bytes()) {
+                        dirty_rows[j] = 1;
+                        std::vector<double>().swap(row_shifts[j]);
+                    }
+                }
+            } else {
+                dirty_rows[j] = 1;
+            }
+
             for (std::size_t i = 0; i < in_size; ++i) {
                 if (synaptic_pruning_mask[j * in_size + i]) {
                     std::size_t idx = j * in_size + i;
+                    if (by_column && (input[i] != 0.0 || grad_w[idx] != 0.0)) dirty_cols[i] = 1;
                     weights[idx] -= lr * grad_w[idx];
                     weights[idx] += hebbian_learning_rate * input[i] * output[j] * plasticity_rates[idx];
                     eligibility_traces[idx] *= decay_rate;
                     eligibility_traces[idx] += input[i] * output[j];
-                    double homeostatic_adjustment = homeostatic_strength * (homeostatic_targets[j] - output[j]);
                     weights[idx] += homeostatic_adjustment;
                 }
             }
@@ -192,6 +295,7 @@ namespace dnn {
     }
 
     void PlasticLayer::consolidate_memory(const std::vector<double> &importance_scores) {
+        mark_all_dirty();
         for (std::size_t j = 0; j < out_size; ++j) {
             for (std::size_t i = 0; i < in_size; ++i) {
                 std::size_t idx = j * in_size + i;
@@ -208,6 +312,7 @@ namespace dnn {
             for (std::size_t i = 0; i < in_size; ++i) {
                 std::size_t idx = j * in_size + i;
                 if (std::abs(weights[idx]) < pruning_threshold) {
+                    if (synaptic_pruning_mask[idx] || weights[idx] != 0.0) dirty_rows[j] = 1;
                     synaptic_pruning_mask[idx] = false;
                     weights[idx] = 0.0;
                 }
@@ -269,6 +374,239 @@ namespace dnn {
         a_cache.resize(out_size);
         indices.resize(out_size);
         std::iota(indices.begin(), indices.end(), std::size_t{0});
+        // In sync with what was just read
+        dirty_rows.assign(out_size, 0);
+        dirty_cols.assign(in_size, 0);
+        row_shifts.assign(out_size, {});
+        dirty_scalars = false;
+    }
+
+    void PlasticLayer::mark_all_dirty() {
+        std::fill(dirty_rows.begin(), dirty_rows.end(), std::uint8_t{1});
+    }
+
+    void PlasticLayer::clear_dirty() {
+        std::fill(dirty_rows.begin(), dirty_rows.end(), std::uint8_t{0});
+        std::fill(dirty_cols.begin(), dirty_cols.end(), std::uint8_t{0});
+        for (auto &shifts : row_shifts) std::vector<double>().swap(shifts);
+        dirty_scalars = false;
+    }
+
+    std::size_t PlasticLayer::dirty_row_count() const {
+        return static_cast<std::size_t>(std::count(dirty_rows.begin(), dirty_rows.end(), std::uint8_t{1}));
+    }
+
+    namespace {
+        std::vector<std::pair<std::size_t, std::size_t>> runs(const std::vector<std::uint8_t> &flags) {
+            std::vector<std::pair<std::size_t, std::size_t>> ranges;
+            std::size_t j = 0;
+            while (j < flags.size()) {
+                if (!flags[j]) { ++j; continue; }
+                std::size_t begin = j;
+                while (j < flags.size() && flags[j]) ++j;
+                ranges.emplace_back(begin, j);
+            }
+            return ranges;
+        }
+
+        void write_u64(std::ostream &os, std::uint64_t v) { os.write(reinterpret_cast<const char*>(&v), sizeof(v)); }
+        std::uint64_t read_u64(std::istream &is) {
+            std::uint64_t v = 0;
+            is.read(reinterpret_cast<char*>(&v), sizeof(v));
+            return v;
+        }
+    } // namespace
+
+    std::vector<std::pair<std::size_t, std::size_t>> PlasticLayer::dirty_ranges() const {
+        return runs(dirty_rows);
+    }
+
+    std::vector<std::pair<std::size_t, std::size_t>> PlasticLayer::dirty_column_ranges() const {
+        return runs(dirty_cols);
+    }
+
+    std::size_t PlasticLayer::row_bytes() const {
+        return in_size * (sizeof(double) + 1) + 2 * sizeof(double);
+    }
+
+    std::size_t PlasticLayer::snapshot_bytes() const {
+        return weights.size() * (3 * sizeof(double) + 1) + 2 * out_size * sizeof(double);
+    }
+
+    bool PlasticLayer::has_delta() const {
+        return dirty_scalars || std::find(dirty_rows.begin(), dirty_rows.end(), std::uint8_t{1}) != dirty_rows.end();
+    }
+
+    // Delta layout: row ranges, column ranges, per-row shift logs, then the biases
+    // and homeostatic targets of every row when column tracking touched them.
+    // Each section is prefixed by its entry count.
+    std::size_t PlasticLayer::delta_bytes() const {
+        std::size_t bytes = 3 * sizeof(std::uint64_t) + 1;
+        for (auto [begin, end] : dirty_ranges()) bytes += 2 * sizeof(std::uint64_t) + (end - begin) * row_bytes();
+        for (auto [begin, end] : dirty_column_ranges())
+            bytes += 2 * sizeof(std::uint64_t) + (end - begin) * out_size * sizeof(double);
+        for (std::size_t j = 0; j < row_shifts.size(); ++j) {
+            if (!row_shifts[j].empty() && !dirty_rows[j])
+                bytes += 2 * sizeof(std::uint64_t) + row_shifts[j].size() * sizeof(double);
+        }
+        if (dirty_scalars) bytes += 2 * out_size * sizeof(double);
+        return bytes;
+    }
+
+    void PlasticLayer::save_delta(std::ostream &os) const {
+        auto rows = dirty_ranges();
+        write_u64(os, rows.size());
+        for (auto [begin, end] : rows) {
+            write_u64(os, begin);
+            write_u64(os, end);
+            save_rows(os, begin, end);
+        }
+
+        auto cols = dirty_column_ranges();
+        write_u64(os, cols.size());
+        for (auto [begin, end] : cols) {
+            write_u64(os, begin);
+            write_u64(os, end);
+            for (std::size_t j = 0; j < out_size; ++j) {
+                os.write(reinterpret_cast<const char*>(weights.data() + j * in_size + begin),
+                         static_cast<std::streamsize>((end - begin) * sizeof(double)));
+            }
+        }
+
+        // Rows written whole above need no shifts
+        std::uint64_t shifted = 0;
+        for (std::size_t j = 0; j < row_shifts.size(); ++j) shifted += !row_shifts[j].empty() && !dirty_rows[j];
+        write_u64(os, shifted);
+        for (std::size_t j = 0; j < row_shifts.size(); ++j) {
+            if (row_shifts[j].empty() || dirty_rows[j]) continue;
+            write_u64(os, j);
+            write_u64(os, row_shifts[j].size());
+            os.write(reinterpret_cast<const char*>(row_shifts[j].data()),
+                     static_cast<std::streamsize>(row_shifts[j].size() * sizeof(double)));
+        }
+
+        char scalars = dirty_scalars ? 1 : 0;
+        os.write(&scalars, 1);
+        if (scalars) {
+            auto m = static_cast<std::streamsize>(out_size * sizeof(double));
+            os.write(reinterpret_cast<const char*>(biases.data()), m);
+            os.write(reinterpret_cast<const char*>(homeostatic_targets.data()), m);
+        }
+    }
+
+    bool PlasticLayer::skip_delta(std::istream &is) const {
+        // Every length is checked against the layer before seeking past it
+        auto skip = [&](std::uint64_t bytes) {
+            is.seekg(static_cast<std::streamoff>(bytes), std::ios::cur);
+            return static_cast<bool>(is);
+        };
+        std::uint64_t n = read_u64(is);
+        if (!is || n > out_size) return false;
+        for (std::uint64_t k = 0; k < n; ++k) {
+            std::uint64_t begin = read_u64(is), end = read_u64(is);
+            if (!is || begin > end || end > out_size || !skip((end - begin) * row_bytes())) return false;
+        }
+        n = read_u64(is);
+        if (!is || n > in_size) return false;
+        for (std::uint64_t k = 0; k < n; ++k) {
+            std::uint64_t begin = read_u64(is), end = read_u64(is);
+            if (!is || begin > end || end > in_size || !skip((end - begin) * out_size * sizeof(double))) return false;
+        }
+        n = read_u64(is);
+        if (!is || n > out_size) return false;
+        for (std::uint64_t k = 0; k < n; ++k) {
+            std::uint64_t row = read_u64(is), count = read_u64(is);
+            if (!is || row >= out_size || count * sizeof(double) > row_bytes() || !skip(count * sizeof(double)))
+                return false;
+        }
+        char scalars = 0;
+        is.read(&scalars, 1);
+        return is && (!scalars || skip(2 * out_size * sizeof(double)));
+    }
+
+    void PlasticLayer::load_delta(std::istream &is) {
+        // Shifts first: they replay what the untouched columns saw, and the
+        // column and row sections then overwrite everything else
+        std::streamoff rows_at = is.tellg();
+        std::uint64_t n = read_u64(is);
+        for (std::uint64_t k = 0; k < n; ++k) {
+            std::uint64_t begin = read_u64(is), end = read_u64(is);
+            is.seekg(static_cast<std::streamoff>((end - begin) * row_bytes()), std::ios::cur);
+        }
+        std::streamoff cols_at = is.tellg();
+        n = read_u64(is);
+        for (std::uint64_t k = 0; k < n; ++k) {
+            std::uint64_t begin = read_u64(is), end = read_u64(is);
+            is.seekg(static_cast<std::streamoff>((end - begin) * out_size * sizeof(double)), std::ios::cur);
+        }
+
+        n = read_u64(is);
+        std::vector<double> shifts;
+        for (std::uint64_t k = 0; k < n; ++k) {
+            std::uint64_t row = read_u64(is), count = read_u64(is);
+            shifts.resize(count);
+            is.read(reinterpret_cast<char*>(shifts.data()), static_cast<std::streamsize>(count * sizeof(double)));
+            for (double shift : shifts) {
+                for (std::size_t i = 0; i < in_size; ++i) {
+                    if (synaptic_pruning_mask[row * in_size + i]) weights[row * in_size + i] += shift;
+                }
+            }
+        }
+        char scalars = 0;
+        is.read(&scalars, 1);
+        if (scalars) {
+            auto m = static_cast<std::streamsize>(out_size * sizeof(double));
+            is.read(reinterpret_cast<char*>(biases.data()), m);
+            is.read(reinterpret_cast<char*>(homeostatic_targets.data()), m);
+        }
+        std::streamoff end_at = is.tellg();
+
+        is.seekg(cols_at);
+        n = read_u64(is);
+        for (std::uint64_t k = 0; k < n; ++k) {
+            std::uint64_t begin = read_u64(is), end = read_u64(is);
+            for (std::size_t j = 0; j < out_size; ++j) {
+                is.read(reinterpret_cast<char*>(weights.data() + j * in_size + begin),
+                        static_cast<std::streamsize>((end - begin) * sizeof(double)));
+            }
+        }
+        is.seekg(rows_at);
+        n = read_u64(is);
+        for (std::uint64_t k = 0; k < n; ++k) {
+            std::uint64_t begin = read_u64(is), end = read_u64(is);
+            load_rows(is, begin, end);
+        }
+        is.seekg(end_at);
+    }
+
+    void PlasticLayer::save_rows(std::ostream &os, std::size_t begin, std::size_t end) const {
+        std::size_t first = begin * in_size;
+        auto n = static_cast<std::streamsize>((end - begin) * in_size * sizeof(double));
+        os.write(reinterpret_cast<const char*>(weights.data() + first), n);
+
+        std::vector<char> mask((end - begin) * in_size);
+        for (std::size_t k = 0; k < mask.size(); ++k) mask[k] = synaptic_pruning_mask[first + k] ? 1 : 0;
+        os.write(mask.data(), static_cast<std::streamsize>(mask.size()));
+
+        auto m = static_cast<std::streamsize>((end - begin) * sizeof(double));
+        os.write(reinterpret_cast<const char*>(biases.data() + begin), m);
+        os.write(reinterpret_cast<const char*>(homeostatic_targets.data() + begin), m);
+    }
+
+    bool PlasticLayer::load_rows(std::istream &is, std::size_t begin, std::size_t end) {
+        if (begin > end || end > out_size) return false;
+        std::size_t first = begin * in_size;
+        auto n = static_cast<std::streamsize>((end - begin) * in_size * sizeof(double));
+        is.read(reinterpret_cast<char*>(weights.data() + first), n);
+
+        std::vector<char> mask((end - begin) * in_size);
+        is.read(mask.data(), static_cast<std::streamsize>(mask.size()));
+        for (std::size_t k = 0; k < mask.size(); ++k) synaptic_pruning_mask[first + k] = (mask[k] != 0);
+
+        auto m = static_cast<std::streamsize>((end - begin) * sizeof(double));
+        is.read(reinterpret_cast<char*>(biases.data() + begin), m);
+        is.read(reinterpret_cast<char*>(homeostatic_targets.data() + begin), m);
+        return static_cast<bool>(is);
     }
 
     // --- NeuralNetwork Implementation ---
@@ -337,68 +675,97 @@ namespace dnn {
         return a;
     }
 
-    void NeuralNetwork::train(const std::vector<std::vector<double>> &X,
-                              const std::vector<std::vector<double>> &Y,
-                              int epochs,
-                              int /*batch_size*/,
-                              double learning_rate) {
-        if (plastic_layers_.empty()) return;
-        
-        size_t num_samples = X.size();
+    std::vector<std::vector<double>> NeuralNetwork::predict_batch(const std::vector<std::vector<double>> &inputs) const {
+        if (plastic_layers_.empty() || inputs.empty()) return {};
+        PlasticLayer::Batch a = inputs, z, next_a;
+        for (std::size_t idx = 0; idx < plastic_layers_.size(); ++idx) {
+            Activation act = (idx + 1 == plastic_layers_.size()) ? output_activation_ : hidden_activation_;
+            plastic_layers_[idx].forward_batch(a, z, next_a, act);
+            std::swap(a, next_a);
+        }
+        return a;
+    }
+
+    double NeuralNetwork::train(const std::vector<std::vector<double>> &X,
+                                const std::vector<std::vector<double>> &Y,
+                                int epochs,
+                                int batch_size,
+                                double learning_rate) {
+        if (plastic_layers_.empty() || X.empty()) return 0.0;
+
+        const size_t num_samples = X.size();
+        const size_t batch = static_cast<size_t>(std::max(1, batch_size));
+        const size_t L = plastic_layers_.size();
         std::vector<size_t> indices(num_samples);
         std::iota(indices.begin(), indices.end(), 0);
 
         std::random_device rd;
         std::mt19937 g(rd());
 
+        // Per-layer buffers, allocated once per call and reused across batches
+        std::vector<std::vector<double>> grad_w(L), grad_b(L), mean_in(L), mean_out(L);
+        for (size_t l = 0; l < L; ++l) {
+            grad_w[l].resize(plastic_layers_[l].weights.size());
+            grad_b[l].resize(plastic_layers_[l].biases.size());
+        }
+        std::vector<PlasticLayer::Batch> acts(L + 1), zs(L);
+        PlasticLayer::Batch error, d_input;
+        double epoch_loss = 0.0;
+
         for (int ep = 0; ep < epochs; ++ep) {
             std::shuffle(indices.begin(), indices.end(), g);
-            
-            // Simple SGD (batch size 1 effectively if we don't implement full mini-batch logic here)
-            // Implementation of backprop for PlasticLayer needed here...
-            
-            // Wait, the original header had the full train loop. I should copy it.
-            // Rather than rewriting the entire train loop which is complex, 
-            // I'll keep the templated code or valid parts in header if possible, 
-            // OR move everything. Implementing the train loop in CPP is better.
-            
-            for (size_t i : indices) {
-                const auto& input = X[i];
-                const auto& target = Y[i];
-                
+            epoch_loss = 0.0;
+
+            for (size_t begin = 0; begin < num_samples; begin += batch) {
+                const size_t end = std::min(num_samples, begin + batch);
+                const size_t B = end - begin;
+                const double scale = 1.0 / static_cast<double>(B);
+
                 // Forward pass
-                std::vector<double> a = input;
-                std::vector<std::vector<double>> activations;
-                activations.push_back(a);
-                
-                for (size_t l = 0; l < plastic_layers_.size(); ++l) {
-                    plastic_layers_[l].forward_cache(a, (l + 1 == plastic_layers_.size() ? output_activation_ : hidden_activation_));
-                    a = plastic_layers_[l].a_cache;
-                    activations.push_back(a);
+                acts[0].resize(B);
+                for (size_t s = 0; s < B; ++s) acts[0][s] = X[indices[begin + s]];
+                for (size_t l = 0; l < L; ++l) {
+                    plastic_layers_[l].forward_batch(acts[l], zs[l], acts[l + 1], (l + 1 == L ? output_activation_ : hidden_activation_));
                 }
-                
-                // Backward
-                std::vector<double> error;
+
                 // MSE Derivative: (Out - Target)
-                for (size_t k = 0; k < a.size(); ++k) {
-                    error.push_back(a[k] - target[k]);
+                error.resize(B);
+                for (size_t s = 0; s < B; ++s) {
+                    const auto& out = acts[L][s];
+                    const auto& target = Y[indices[begin + s]];
+                    error[s].resize(out.size());
+                    for (size_t k = 0; k < out.size(); ++k) {
+                        error[s][k] = out[k] - target[k];
+                        epoch_loss += error[s][k] * error[s][k] / static_cast<double>(out.size());
+                    }
+                }
+
+                // Backward with batch-averaged gradients, then update each layer once.
+                // Hebbian/homeostatic terms see the batch-mean activity.
+                for (size_t l = L; l-- > 0;) {
+                    auto& layer = plastic_layers_[l];
+                    Activation act = (l + 1 == L ? output_activation_ : hidden_activation_);
+                    layer.backward_batch(acts[l], zs[l], acts[l + 1], error, d_input, grad_w[l], grad_b[l], act, l > 0);
+                    std::swap(error, d_input);
+
+                    mean_in[l].assign(layer.in_size, 0.0);
+                    mean_out[l].assign(layer.out_size, 0.0);
+                    for (size_t s = 0; s < B; ++s) {
+                        simd::add_scaled(mean_in[l].data(), acts[l][s].data(), scale, layer.in_size);
+                        simd::add_scaled(mean_out[l].data(), acts[l + 1][s].data(), scale, layer.out_size);
+                    }
+                    if (B > 1) {
+                        for (double& v : grad_w[l]) v *= scale;
+                        for (double& v : grad_b[l]) v *= scale;
+                    }
                 }
-                
-                for (int l = (int)plastic_layers_.size() - 1; l >= 0; --l) {
-                    auto& layer = plastic_layers_[static_cast<size_t>(l)];
-                    Activation act = (static_cast<size_t>(l) + 1 == plastic_layers_.size() ? output_activation_ : hidden_activation_);
-                    
-                    std::vector<double> d_input(layer.in_size);
-                    std::vector<double> grad_w(layer.weights.size());
-                    std::vector<double> grad_b(layer.biases.size());
-                    
-                    layer.backward(activations[static_cast<size_t>(l)], error, d_input, grad_w, grad_b, act);
-                    layer.apply_gradients(grad_w, grad_b, learning_rate, activations[static_cast<size_t>(l)], activations[static_cast<size_t>(l)+1]); // Note: hebbian needs input/output
-                    
-                    error = d_input;
+                for (size_t l = 0; l < L; ++l) {
+                    plastic_layers_[l].apply_gradients(grad_w[l], grad_b[l], learning_rate, mean_in[l], mean_out[l]);
                 }
             }
+            epoch_loss /= static_cast<double>(num_samples);
         }
+        return epoch_loss;
     }
     
     void NeuralNetwork::save(std::ostream &os) const {
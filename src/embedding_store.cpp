@@ -0,0 +1,227 @@
+#include "embedding_store.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace dnn {
+
+    namespace {
+
+        struct FileHeader {
+            char magic[4];
+            std::uint32_t version;
+            std::uint32_t dim;
+            std::uint32_t reserved;
+            std::uint64_t count;
+            std::uint64_t offsets_offset;
+            std::uint64_t strings_offset;
+            std::uint64_t strings_bytes;
+            std::uint64_t matrix_offset;
+            std::uint64_t reserved2;
+        };
+        static_assert(sizeof(FileHeader) == 64, "embedding header must stay 64 bytes");
+
+        constexpr std::uint64_t kMatrixAlign = 64;
+
+        std::uint64_t align_up(std::uint64_t v, std::uint64_t a) { return (v + a - 1) / a * a; }
+
+    } // namespace
+
+    EmbeddingStore::EmbeddingStore(std::size_t dim) : dim_(dim) {}
+
+    EmbeddingStore::~EmbeddingStore() {
+        unmap();
+    }
+
+    void EmbeddingStore::unmap() {
+        if (map_base_) ::munmap(map_base_, map_bytes_);
+        map_base_ = nullptr;
+        map_bytes_ = 0;
+        base_count_ = 0;
+        base_offsets_ = nullptr;
+        base_strings_ = nullptr;
+        base_matrix_ = nullptr;
+    }
+
+    void EmbeddingStore::clear() {
+        unmap();
+        overlay_words_.clear();
+        overlay_rows_.clear();
+        overlay_index_.clear();
+    }
+
+    bool EmbeddingStore::map_file(const std::string& path) {
+        clear();
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return false;
+
+        struct stat st {};
+        if (::fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(FileHeader)) {
+            ::close(fd);
+            return false;
+        }
+        std::size_t bytes = static_cast<std::size_t>(st.st_size);
+
+        // MAP_PRIVATE + PROT_WRITE: set() on a mapped word copies just that page
+        void* base = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (base == MAP_FAILED) return false;
+
+        FileHeader h;
+        std::memcpy(&h, base, sizeof(h));
+        // Bound count by the file size first so the offset arithmetic below cannot overflow
+        bool ok = std::memcmp(h.magic, kMagic, sizeof(kMagic)) == 0 && h.version == kVersion &&
+                  dim_ > 0 && h.dim == dim_ && h.offsets_offset == sizeof(FileHeader) &&
+                  h.matrix_offset % kMatrixAlign == 0 && h.matrix_offset <= bytes &&
+                  h.count <= (bytes - h.matrix_offset) / (sizeof(float) * dim_) &&
+                  h.strings_offset == h.offsets_offset + (h.count + 1) * sizeof(std::uint64_t) &&
+                  h.strings_bytes <= bytes &&
+                  h.strings_offset + h.strings_bytes <= h.matrix_offset;
+
+        const char* bytes_base = static_cast<const char*>(base);
+        const auto* offsets = reinterpret_cast<const std::uint64_t*>(bytes_base + h.offsets_offset);
+        if (ok) {
+            ok = offsets[0] == 0 && offsets[h.count] == h.strings_bytes;
+            for (std::uint64_t i = 0; ok && i < h.count; ++i) ok = offsets[i] <= offsets[i + 1];
+        }
+        if (!ok) {
+            ::munmap(base, bytes);
+            return false;
+        }
+
+        ::madvise(base, bytes, MADV_RANDOM);
+        map_base_ = base;
+        map_bytes_ = bytes;
+        base_count_ = static_cast<std::size_t>(h.count);
+        base_offsets_ = offsets;
+        base_strings_ = bytes_base + h.strings_offset;
+        base_matrix_ = reinterpret_cast<float*>(static_cast<char*>(base) + h.matrix_offset);
+        return true;
+    }
+
+    std::string_view EmbeddingStore::word(std::size_t i) const {
+        if (i < base_count_) {
+            return {base_strings_ + base_offsets_[i], static_cast<std::size_t>(base_offsets_[i + 1] - base_offsets_[i])};
+        }
+        return overlay_words_[i - base_count_];
+    }
+
+    const float* EmbeddingStore::row(std::size_t i) const {
+        if (i < base_count_) return base_matrix_ + i * dim_;
+        return overlay_rows_.data() + (i - base_count_) * dim_;
+    }
+
+    std::size_t EmbeddingStore::base_index(std::string_view w) const {
+        std::size_t lo = 0, hi = base_count_;
+        while (lo < hi) {
+            std::size_t mid = lo + (hi - lo) / 2;
+            if (word(mid) < w) lo = mid + 1;
+            else hi = mid;
+        }
+        return (lo < base_count_ && word(lo) == w) ? lo : base_count_;
+    }
+
+    const float* EmbeddingStore::find(std::string_view w) const {
+        std::size_t i = base_index(w);
+        if (i < base_count_) return row(i);
+        auto it = overlay_index_.find(w);
+        return it == overlay_index_.end() ? nullptr : row(base_count_ + it->second);
+    }
+
+    void EmbeddingStore::set(const std::string& w, const std::vector<double>& vec) {
+        float* dst;
+        std::size_t i = base_index(w);
+        if (i < base_count_) {
+            dst = base_matrix_ + i * dim_;
+        } else if (auto it = overlay_index_.find(w); it != overlay_index_.end()) {
+            dst = overlay_rows_.data() + it->second * dim_;
+        } else {
+            overlay_index_.emplace(w, overlay_words_.size());
+            overlay_words_.push_back(w);
+            overlay_rows_.resize(overlay_rows_.size() + dim_, 0.0f);
+            dst = overlay_rows_.data() + overlay_rows_.size() - dim_;
+        }
+        std::size_t n = std::min(dim_, vec.size());
+        for (std::size_t k = 0; k < n; ++k) dst[k] = static_cast<float>(vec[k]);
+        std::fill(dst + n, dst + dim_, 0.0f);
+    }
+
+    bool EmbeddingStore::write(std::ostream& os) const {
+        std::vector<std::size_t> order(size());
+        for (std::size_t i = 0; i < order.size(); ++i) order[i] = i;
+        // Mapped words are already sorted; only the overlay needs merging in
+        std::sort(order.begin() + static_cast<std::ptrdiff_t>(base_count_), order.end(),
+                  [this](std::size_t a, std::size_t b) { return word(a) < word(b); });
+        std::inplace_merge(order.begin(), order.begin() + static_cast<std::ptrdiff_t>(base_count_), order.end(),
+                           [this](std::size_t a, std::size_t b) { return word(a) < word(b); });
+
+        FileHeader h{};
+        std::memcpy(h.magic, kMagic, sizeof(kMagic));
+        h.version = kVersion;
+        h.dim = static_cast<std::uint32_t>(dim_);
+        h.count = order.size();
+        h.offsets_offset = sizeof(FileHeader);
+        h.strings_offset = h.offsets_offset + (h.count + 1) * sizeof(std::uint64_t);
+
+        std::vector<std::uint64_t> offsets(order.size() + 1);
+        for (std::size_t k = 0; k < order.size(); ++k) offsets[k + 1] = offsets[k] + word(order[k]).size();
+        h.strings_bytes = offsets.back();
+        h.matrix_offset = align_up(h.strings_offset + h.strings_bytes, kMatrixAlign);
+
+        os.write(reinterpret_cast<const char*>(&h), sizeof(h));
+        os.write(reinterpret_cast<const char*>(offsets.data()),
+                 static_cast<std::streamsize>(offsets.size() * sizeof(std::uint64_t)));
+        for (std::size_t i : order) {
+            auto w = word(i);
+            os.write(w.data(), static_cast<std::streamsize>(w.size()));
+        }
+        static const char zeros[kMatrixAlign] = {};
+        os.write(zeros, static_cast<std::streamsize>(h.matrix_offset - h.strings_offset - h.strings_bytes));
+        for (std::size_t i : order) {
+            os.write(reinterpret_cast<const char*>(row(i)), static_cast<std::streamsize>(dim_ * sizeof(float)));
+        }
+        return static_cast<bool>(os);
+    }
+
+    bool EmbeddingStore::convert_text(const std::string& text_path, const std::string& bin_path,
+                                      std::size_t dim, std::size_t* words_out) {
+        std::ifstream in(text_path);
+        if (!in.is_open()) return false;
+
+        EmbeddingStore store(dim);
+        std::string line;
+        std::vector<double> vec;
+        vec.reserve(dim);
+        while (std::getline(in, line)) {
+            std::stringstream ss(line);
+            std::string w;
+            ss >> w;
+            vec.clear();
+            double v;
+            while (ss >> v) vec.push_back(v);
+            if (!w.empty() && vec.size() == dim) store.set(w, vec);
+        }
+
+        std::string tmp_path = bin_path + ".tmp";
+        {
+            std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+            if (!out || !store.write(out)) {
+                std::remove(tmp_path.c_str());
+                return false;
+            }
+        }
+        if (std::rename(tmp_path.c_str(), bin_path.c_str()) != 0) {
+            std::remove(tmp_path.c_str());
+            return false;
+        }
+        if (words_out) *words_out = store.size();
+        return true;
+    }
+
+} // namespace dnn
@@ -0,0 +1,190 @@
+#include "event_bus.hpp"
+#include <unordered_map>
+#include <algorithm>
+#include <iostream>
+
+namespace dnn {
+
+    namespace {
+        std::atomic<std::uint64_t> next_bus_id{1};
+    }
+
+    EventBus::EventBus(Options options) : options_(options), id_(next_bus_id.fetch_add(1)) {
+        options_.ring_capacity = std::max<std::size_t>(2, options_.ring_capacity);
+        for (auto& count : subscriber_counts_) count.store(0, std::memory_order_relaxed);
+        rate_limits_.fill(std::chrono::milliseconds(0));
+        thread_ = std::thread(&EventBus::run, this);
+    }
+
+    EventBus::~EventBus() {
+        stop();
+    }
+
+    EventBus::SubscriptionId EventBus::subscribe(EventTopic topic, Callback callback) {
+        std::lock_guard<std::mutex> lock(dispatch_mutex_);
+        SubscriptionId id = next_subscription_++;
+        subscribers_.push_back({id, topic, std::move(callback)});
+        subscriber_counts_[index(topic)].fetch_add(1, std::memory_order_relaxed);
+        return id;
+    }
+
+    void EventBus::unsubscribe(SubscriptionId id) {
+        std::lock_guard<std::mutex> lock(dispatch_mutex_);
+        auto it = std::find_if(subscribers_.begin(), subscribers_.end(), [id](const Subscriber& s) { return s.id == id; });
+        if (it == subscribers_.end()) return;
+        subscriber_counts_[index(it->topic)].fetch_sub(1, std::memory_order_relaxed);
+        subscribers_.erase(it);
+    }
+
+    void EventBus::set_rate_limit(EventTopic topic, std::chrono::milliseconds interval) {
+        std::lock_guard<std::mutex> lock(dispatch_mutex_);
+        rate_limits_[index(topic)] = interval;
+    }
+
+    EventBus::Ring& EventBus::local_ring() {
+        // Keyed by bus id rather than address, so a new bus at a dead bus's
+        // address never picks up its ring. The thread co-owns each of its rings
+        // with the bus, so the dispatcher frees a ring only once the thread has
+        // exited (see dispatch()); entries for destroyed buses are swept when
+        // the thread next misses, so a long-lived thread does not keep a ring
+        // alive for every bus it ever emitted to.
+        struct LocalRing {
+            std::weak_ptr<const void> bus;
+            std::shared_ptr<Ring> ring;
+        };
+        thread_local std::unordered_map<std::uint64_t, LocalRing> rings;
+        thread_local std::uint64_t cached_id = 0;
+        thread_local Ring* cached = nullptr;
+        if (cached_id == id_) return *cached;
+
+        auto& local = rings[id_];
+        if (!local.ring) {
+            std::erase_if(rings, [](const auto& entry) { return entry.second.ring && entry.second.bus.expired(); });
+            local.bus = alive_;
+            local.ring = std::make_shared<Ring>(options_.ring_capacity);
+            std::lock_guard<std::mutex> lock(rings_mutex_);
+            rings_.push_back(local.ring);
+        }
+        cached_id = id_;
+        cached = local.ring.get();
+        return *cached;
+    }
+
+    bool EventBus::push(EventTopic topic, const char* type, std::string payload) {
+        Ring& ring = local_ring();
+        const std::size_t head = ring.head.load(std::memory_order_relaxed);
+        if (head - ring.tail.load(std::memory_order_acquire) >= ring.slots.size()) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        Event& event = ring.slots[head % ring.slots.size()];
+        event.topic = topic;
+        event.type.assign(type);
+        event.payload = std::move(payload);
+        event.time = std::chrono::steady_clock::now();
+        event.coalesced = 0;
+        ring.head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    void EventBus::deliver(const Event& event) {
+        ++stats_.delivered;
+        for (const auto& subscriber : subscribers_) {
+            if (subscriber.topic != event.topic) continue;
+            try {
+                subscriber.callback(event);
+            } catch (const std::exception& e) {
+                std::cerr << "[EventBus] Subscriber failed: " << e.what() << std::endl;
+            }
+        }
+    }
+
+    void EventBus::dispatch(bool force) {
+        std::vector<std::shared_ptr<Ring>> rings;
+        {
+            std::lock_guard<std::mutex> lock(rings_mutex_);
+            // A ring only the bus still references belongs to an exited thread
+            rings_.erase(std::remove_if(rings_.begin(), rings_.end(), [](const std::shared_ptr<Ring>& r) {
+                return r.use_count() == 1 && r->head.load(std::memory_order_acquire) == r->tail.load(std::memory_order_relaxed);
+            }), rings_.end());
+            rings = rings_;
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        for (auto& ring : rings) {
+            std::size_t tail = ring->tail.load(std::memory_order_relaxed);
+            const std::size_t head = ring->head.load(std::memory_order_acquire);
+            for (; tail != head; ++tail) {
+                Event& event = ring->slots[tail % ring->slots.size()];
+                ++stats_.published;
+                const auto limit = rate_limits_[index(event.topic)];
+                if (limit.count() == 0) {
+                    deliver(event);
+                    continue;
+                }
+                Pending& pending = pending_[{event.topic, event.type}];
+                if (pending.waiting) {
+                    event.coalesced = pending.event.coalesced + 1;
+                    ++stats_.coalesced;
+                }
+                pending.event = std::move(event);
+                pending.waiting = true;
+                if (!pending.delivered || now - pending.last_delivery >= limit) {
+                    deliver(pending.event);
+                    pending.waiting = false;
+                    pending.delivered = true;
+                    pending.last_delivery = now;
+                }
+            }
+            ring->tail.store(tail, std::memory_order_release);
+        }
+
+        for (auto& [key, pending] : pending_) {
+            if (!pending.waiting) continue;
+            if (force || now - pending.last_delivery >= rate_limits_[index(key.first)]) {
+                deliver(pending.event);
+                pending.waiting = false;
+                pending.delivered = true;
+                pending.last_delivery = now;
+            }
+        }
+    }
+
+    void EventBus::flush() {
+        std::lock_guard<std::mutex> lock(dispatch_mutex_);
+        dispatch(true);
+    }
+
+    void EventBus::run() {
+        std::unique_lock<std::mutex> wake(wake_mutex_);
+        while (!stopping_) {
+            wake_cv_.wait_for(wake, options_.dispatch_interval, [this] { return stopping_; });
+            wake.unlock();
+            {
+                std::lock_guard<std::mutex> lock(dispatch_mutex_);
+                dispatch(false);
+            }
+            wake.lock();
+        }
+    }
+
+    void EventBus::stop() {
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex_);
+            stopping_ = true;
+        }
+        wake_cv_.notify_all();
+        if (thread_.joinable()) {
+            thread_.join();
+            flush(); // Last events out before subscribers go away
+        }
+    }
+
+    EventBus::Stats EventBus::stats() const {
+        std::lock_guard<std::mutex> lock(dispatch_mutex_);
+        Stats s = stats_;
+        s.dropped = dropped_.load(std::memory_order_relaxed);
+        return s;
+    }
+
+} // namespace dnn
@@ -0,0 +1,415 @@
+#include "hnsw_index.hpp"
+#include "simd_utils.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <queue>
+
+namespace dnn {
+
+    namespace {
+        // Per-thread visit marks: each search bumps the epoch instead of clearing
+        struct VisitedSet {
+            std::vector<std::uint32_t> marks;
+            std::uint32_t epoch = 0;
+
+            void reset(std::size_t nodes) {
+                if (marks.size() < nodes) marks.resize(nodes, 0);
+                if (++epoch == 0) {
+                    std::fill(marks.begin(), marks.end(), 0);
+                    epoch = 1;
+                }
+            }
+            bool insert(std::uint32_t node) {
+                if (marks[node] == epoch) return false;
+                marks[node] = epoch;
+                return true;
+            }
+        };
+
+        VisitedSet& visited_set() {
+            thread_local VisitedSet visited;
+            return visited;
+        }
+
+        constexpr int kMaxLevel = 32;
+
+        struct FileHeader {
+            char magic[4];
+            std::uint32_t version;
+            std::uint32_t dim;
+            std::uint32_t m;
+            std::uint64_t nodes;
+            std::uint32_t entry;
+            std::int32_t max_level;
+            std::uint64_t ef_construction;
+            std::uint64_t ef_search;
+            std::uint64_t reserved[2];
+        };
+        static_assert(sizeof(FileHeader) == 64, "hnsw header must stay 64 bytes");
+
+        template <typename T>
+        void put(std::ostream& os, const T* data, std::size_t n) {
+            os.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(n * sizeof(T)));
+        }
+
+        template <typename T>
+        bool get(std::istream& is, T* data, std::size_t n) {
+            is.read(reinterpret_cast<char*>(data), static_cast<std::streamsize>(n * sizeof(T)));
+            return static_cast<bool>(is);
+        }
+    } // namespace
+
+    HnswIndex::HnswIndex(std::size_t dim) : HnswIndex(dim, Options{}) {}
+
+    HnswIndex::HnswIndex(std::size_t dim, Options options) : dim_(dim), options_(options), rng_(options.seed) {
+        options_.m = std::max<std::size_t>(options_.m, 2);
+        options_.ef_construction = std::max<std::size_t>(options_.ef_construction, 1);
+        level_scale_ = 1.0 / std::log(static_cast<double>(options_.m));
+    }
+
+    float HnswIndex::distance(const float* a, const float* b) const {
+        return 1.0f - simd::dot_product(a, b, dim_);
+    }
+
+    std::uint32_t* HnswIndex::links(Node node, int level) {
+        if (level == 0) return links0_.data() + static_cast<std::size_t>(node) * (2 * options_.m + 1);
+        return upper_[node].data() + static_cast<std::size_t>(level - 1) * (options_.m + 1);
+    }
+
+    const std::uint32_t* HnswIndex::links(Node node, int level) const {
+        return const_cast<HnswIndex*>(this)->links(node, level);
+    }
+
+    int HnswIndex::random_level() {
+        const double u = std::uniform_real_distribution<double>(0.0, 1.0)(rng_);
+        return std::min(kMaxLevel, static_cast<int>(-std::log(std::max(u, 1e-12)) * level_scale_));
+    }
+
+    std::vector<float> HnswIndex::normalised(std::span<const float> vector, float* norm) const {
+        std::vector<float> unit(vector.begin(), vector.end());
+        const float length = std::sqrt(simd::dot_product(unit.data(), unit.data(), unit.size()));
+        if (length > 0.0f) {
+            for (float& x : unit) x /= length;
+        }
+        if (norm) *norm = length;
+        return unit;
+    }
+
+    HnswIndex::Node HnswIndex::greedy(const float* query, Node entry, int level) const {
+        Node current = entry;
+        float best = distance(query, data(current));
+        for (bool moved = true; moved;) {
+            moved = false;
+            const std::uint32_t* l = links(current, level);
+            for (std::uint32_t i = 1; i <= l[0]; ++i) {
+                const float d = distance(query, data(l[i]));
+                if (d < best) {
+                    best = d;
+                    current = l[i];
+                    moved = true;
+                }
+            }
+        }
+        return current;
+    }
+
+    std::vector<HnswIndex::Candidate> HnswIndex::search_level(const float* query, Node entry, std::size_t ef, int level) const {
+        VisitedSet& visited = visited_set();
+        visited.reset(keys_.size());
+        std::priority_queue<Candidate> nearest; // Furthest on top
+        std::priority_queue<Candidate, std::vector<Candidate>, std::greater<>> frontier;
+
+        const float d = distance(query, data(entry));
+        visited.insert(entry);
+        nearest.emplace(d, entry);
+        frontier.emplace(d, entry);
+        while (!frontier.empty()) {
+            const auto [dist, node] = frontier.top();
+            if (dist > nearest.top().first && nearest.size() >= ef) break; // Nothing closer left to expand
+            frontier.pop();
+            const std::uint32_t* l = links(node, level);
+            for (std::uint32_t i = 1; i <= l[0]; ++i) {
+                if (i < l[0]) __builtin_prefetch(data(l[i + 1]));
+                const Node n = l[i];
+                if (!visited.insert(n)) continue;
+                const float dn = distance(query, data(n));
+                if (nearest.size() < ef || dn < nearest.top().first) {
+                    frontier.emplace(dn, n);
+                    nearest.emplace(dn, n);
+                    if (nearest.size() > ef) nearest.pop();
+                }
+            }
+        }
+
+        std::vector<Candidate> out(nearest.size());
+        for (std::size_t i = out.size(); i-- > 0; nearest.pop()) out[i] = nearest.top();
+        return out;
+    }
+
+    std::vector<HnswIndex::Node> HnswIndex::select(const std::vector<Candidate>& candidates, std::size_t limit) const {
+        // Keep a candidate only if it is closer to the base than to every one
+        // already kept, so links point in different directions
+        std::vector<Node> chosen;
+        for (const auto& [d, c] : candidates) {
+            if (chosen.size() >= limit) break;
+            bool diverse = true;
+            for (Node s : chosen) {
+                if (distance(data(c), data(s)) < d) {
+                    diverse = false;
+                    break;
+                }
+            }
+            if (diverse) chosen.push_back(c);
+        }
+        return chosen;
+    }
+
+    void HnswIndex::link_back(Node from, Node to, int level) {
+        std::uint32_t* l = links(from, level);
+        for (std::uint32_t i = 1; i <= l[0]; ++i) {
+            if (l[i] == to) return;
+        }
+        const std::size_t cap = capacity(level);
+        if (l[0] < cap) {
+            l[++l[0]] = to;
+            return;
+        }
+        // Full: keep the most diverse of the old links plus the new one
+        const float* base = data(from);
+        std::vector<Candidate> candidates;
+        candidates.reserve(cap + 1);
+        candidates.emplace_back(distance(base, data(to)), to);
+        for (std::uint32_t i = 1; i <= l[0]; ++i) candidates.emplace_back(distance(base, data(l[i])), l[i]);
+        std::sort(candidates.begin(), candidates.end());
+        const auto chosen = select(candidates, cap);
+        l[0] = static_cast<std::uint32_t>(chosen.size());
+        std::copy(chosen.begin(), chosen.end(), l + 1);
+    }
+
+    void HnswIndex::connect(Node node, int top_level) {
+        const float* query = data(node);
+        Node entry = entry_;
+        for (int level = max_level_; level > top_level; --level) entry = greedy(query, entry, level);
+        for (int level = std::min(top_level, max_level_); level >= 0; --level) {
+            auto found = search_level(query, entry, options_.ef_construction, level);
+            // A moved node finds itself; it must not link to itself
+            found.erase(std::remove_if(found.begin(), found.end(), [node](const Candidate& c) { return c.second == node; }),
+                        found.end());
+            if (found.empty()) continue;
+            const auto chosen = select(found, options_.m);
+            std::uint32_t* own = links(node, level);
+            own[0] = static_cast<std::uint32_t>(chosen.size());
+            std::copy(chosen.begin(), chosen.end(), own + 1);
+            for (Node n : chosen) link_back(n, node, level);
+            entry = found.front().second;
+        }
+    }
+
+    bool HnswIndex::add(std::string_view key, std::span<const float> vector) {
+        if (vector.empty()) return false;
+        if (dim_ == 0) dim_ = vector.size();
+        if (vector.size() != dim_) return false;
+        float norm = 0.0f;
+        const auto unit = normalised(vector, &norm);
+
+        if (auto it = nodes_.find(key); it != nodes_.end()) {
+            const Node node = it->second;
+            std::copy(unit.begin(), unit.end(), vectors_.begin() + static_cast<std::ptrdiff_t>(node * dim_));
+            norms_[node] = norm;
+            if (keys_.size() > 1) connect(node, levels_[node]);
+            return true;
+        }
+
+        const Node node = static_cast<Node>(keys_.size());
+        const int level = random_level();
+        keys_.emplace_back(key);
+        nodes_.emplace(keys_.back(), node);
+        vectors_.insert(vectors_.end(), unit.begin(), unit.end());
+        norms_.push_back(norm);
+        levels_.push_back(static_cast<std::uint8_t>(level));
+        links0_.resize(links0_.size() + 2 * options_.m + 1, 0);
+        upper_.emplace_back(static_cast<std::size_t>(level) * (options_.m + 1), 0);
+        if (entry_ == kNoNode) {
+            entry_ = node;
+            max_level_ = level;
+            return true;
+        }
+        connect(node, level);
+        if (level > max_level_) {
+            entry_ = node;
+            max_level_ = level;
+        }
+        return true;
+    }
+
+    bool HnswIndex::add(std::string_view key, const std::vector<double>& vector) {
+        const std::vector<float> floats(vector.begin(), vector.end());
+        return add(key, std::span<const float>(floats));
+    }
+
+    HnswIndex::Node HnswIndex::find(std::string_view key) const {
+        auto it = nodes_.find(key);
+        return it == nodes_.end() ? kNoNode : it->second;
+    }
+
+    std::vector<double> HnswIndex::vector(std::string_view key) const {
+        const Node node = find(key);
+        if (node == kNoNode) return {};
+        std::vector<double> out(data(node), data(node) + dim_);
+        for (double& x : out) x *= norms_[node];
+        return out;
+    }
+
+    std::vector<HnswIndex::Hit> HnswIndex::search(std::span<const float> query, std::size_t k, std::size_t ef) const {
+        std::vector<Hit> hits;
+        if (entry_ == kNoNode || k == 0 || query.size() != dim_) return hits;
+        const auto unit = normalised(query, nullptr);
+        Node entry = entry_;
+        for (int level = max_level_; level > 0; --level) entry = greedy(unit.data(), entry, level);
+        auto found = search_level(unit.data(), entry, std::max(k, ef ? ef : options_.ef_search), 0);
+        if (found.size() > k) found.resize(k);
+        hits.reserve(found.size());
+        for (const auto& [d, node] : found) hits.push_back({node, d});
+        return hits;
+    }
+
+    std::vector<std::string> HnswIndex::search_keys(const std::vector<double>& query, std::size_t k) const {
+        const std::vector<float> floats(query.begin(), query.end());
+        std::vector<std::string> out;
+        for (const auto& hit : search(floats, k)) out.emplace_back(keys_[hit.node]);
+        return out;
+    }
+
+    std::vector<HnswIndex::Hit> HnswIndex::brute_force(std::span<const float> query, std::size_t k) const {
+        std::vector<Hit> hits;
+        if (query.size() != dim_ || k == 0) return hits;
+        const auto unit = normalised(query, nullptr);
+        hits.reserve(keys_.size());
+        for (Node node = 0; node < keys_.size(); ++node) hits.push_back({node, distance(unit.data(), data(node))});
+        const auto nearer = [](const Hit& a, const Hit& b) { return a.distance < b.distance || (a.distance == b.distance && a.node < b.node); };
+        const std::size_t n = std::min(k, hits.size());
+        std::partial_sort(hits.begin(), hits.begin() + static_cast<std::ptrdiff_t>(n), hits.end(), nearer);
+        hits.resize(n);
+        return hits;
+    }
+
+    void HnswIndex::clear() {
+        vectors_.clear();
+        norms_.clear();
+        levels_.clear();
+        links0_.clear();
+        upper_.clear();
+        keys_.clear();
+        nodes_.clear();
+        entry_ = kNoNode;
+        max_level_ = -1;
+        rng_.seed(options_.seed);
+    }
+
+    bool HnswIndex::write(std::ostream& os) const {
+        FileHeader h{};
+        std::memcpy(h.magic, kMagic, sizeof(kMagic));
+        h.version = kVersion;
+        h.dim = static_cast<std::uint32_t>(dim_);
+        h.m = static_cast<std::uint32_t>(options_.m);
+        h.nodes = keys_.size();
+        h.entry = entry_;
+        h.max_level = max_level_;
+        h.ef_construction = options_.ef_construction;
+        h.ef_search = options_.ef_search;
+        put(os, &h, 1);
+        for (const auto& key : keys_) {
+            const auto length = static_cast<std::uint32_t>(key.size());
+            put(os, &length, 1);
+            put(os, key.data(), key.size());
+        }
+        put(os, norms_.data(), norms_.size());
+        put(os, levels_.data(), levels_.size());
+        put(os, vectors_.data(), vectors_.size());
+        put(os, links0_.data(), links0_.size());
+        for (const auto& upper : upper_) put(os, upper.data(), upper.size());
+        return static_cast<bool>(os);
+    }
+
+    bool HnswIndex::read(std::istream& is) {
+        clear();
+        const auto start = is.tellg();
+        is.seekg(0, std::ios::end);
+        const auto end = is.tellg();
+        is.seekg(start);
+        if (start < 0 || end < start) return false;
+        const auto available = static_cast<std::uint64_t>(end - start);
+
+        FileHeader h;
+        if (available < sizeof(h) || !get(is, &h, 1)) return false;
+        const std::uint64_t m = h.m;
+        // Bound the node count by the bytes each node needs at least, before allocating
+        const std::uint64_t per_node = sizeof(std::uint32_t) + sizeof(float) + 1 + std::uint64_t{h.dim} * sizeof(float) +
+                                       (2 * m + 1) * sizeof(std::uint32_t);
+        if (std::memcmp(h.magic, kMagic, sizeof(kMagic)) != 0 || h.version != kVersion || m < 2 || m > 1024 ||
+            h.nodes > (available - sizeof(h)) / per_node || (h.nodes > 0 && h.dim == 0) ||
+            (h.nodes == 0 ? h.entry != kNoNode : h.entry >= h.nodes)) {
+            return false;
+        }
+
+        HnswIndex loaded(h.dim, Options{static_cast<std::size_t>(m), static_cast<std::size_t>(h.ef_construction),
+                                        static_cast<std::size_t>(h.ef_search), options_.seed});
+        const std::size_t nodes = static_cast<std::size_t>(h.nodes);
+        loaded.keys_.reserve(nodes);
+        for (std::size_t i = 0; i < nodes; ++i) {
+            std::uint32_t length = 0;
+            if (!get(is, &length, 1) || length > available) return false;
+            std::string key(length, '\0');
+            if (!get(is, key.data(), length)) return false;
+            loaded.keys_.push_back(std::move(key));
+            if (!loaded.nodes_.emplace(loaded.keys_.back(), static_cast<Node>(i)).second) return false;
+        }
+        loaded.norms_.resize(nodes);
+        loaded.levels_.resize(nodes);
+        loaded.vectors_.resize(nodes * loaded.dim_);
+        loaded.links0_.resize(nodes * (2 * loaded.options_.m + 1));
+        if (!get(is, loaded.norms_.data(), nodes) || !get(is, loaded.levels_.data(), nodes) ||
+            !get(is, loaded.vectors_.data(), loaded.vectors_.size()) || !get(is, loaded.links0_.data(), loaded.links0_.size())) {
+            return false;
+        }
+        loaded.upper_.resize(nodes);
+        for (std::size_t i = 0; i < nodes; ++i) {
+            if (loaded.levels_[i] > kMaxLevel) return false;
+            loaded.upper_[i].resize(static_cast<std::size_t>(loaded.levels_[i]) * (loaded.options_.m + 1));
+            if (!get(is, loaded.upper_[i].data(), loaded.upper_[i].size())) return false;
+        }
+        // Every link must name a node that exists on that level
+        for (Node node = 0; node < nodes; ++node) {
+            for (int level = 0; level <= loaded.levels_[node]; ++level) {
+                const std::uint32_t* l = loaded.links(node, level);
+                if (l[0] > loaded.capacity(level)) return false;
+                for (std::uint32_t i = 1; i <= l[0]; ++i) {
+                    if (l[i] >= nodes || loaded.levels_[l[i]] < level) return false;
+                }
+            }
+        }
+        if (nodes > 0 && loaded.levels_[h.entry] != h.max_level) return false;
+        loaded.entry_ = h.entry;
+        loaded.max_level_ = nodes > 0 ? h.max_level : -1;
+        *this = std::move(loaded);
+        return true;
+    }
+
+    HnswIndex::Stats HnswIndex::stats() const {
+        Stats s;
+        s.nodes = keys_.size();
+        s.levels = static_cast<std::size_t>(max_level_ + 1);
+        for (Node node = 0; node < keys_.size(); ++node) {
+            for (int level = 0; level <= levels_[node]; ++level) s.links += links(node, level)[0];
+        }
+        s.bytes = vectors_.capacity() * sizeof(float) + norms_.capacity() * sizeof(float) + levels_.capacity() +
+                  links0_.capacity() * sizeof(std::uint32_t);
+        for (const auto& upper : upper_) s.bytes += upper.capacity() * sizeof(std::uint32_t) + sizeof(upper);
+        for (const auto& key : keys_) s.bytes += key.capacity() + sizeof(key) + sizeof(std::pair<const std::string, Node>) + sizeof(void*);
+        return s;
+    }
+
+} // namespace dnn
@@ -29,16 +29,9 @@ int main() {
         std::thread([&brain]() {
             if (brain.get_knowledge_size() < 100) {
                  std::cout << "[System]: Brain appears empty. Initiating basic English download..." << std::endl;
-                 std::ifstream basics("data/english_basics.txt");
-                 if (basics) {
-                     std::string line;
-                     while(std::getline(basics, line)) {
-                         size_t delimiter = line.find("|");
-                         if (delimiter != std::string::npos) {
-                             brain.teach(line.substr(0, delimiter), line.substr(delimiter + 1));
-                         }
-                     }
-                     std::cout << "[System]: Basic English installed." << std::endl;
+                 TeachReport report = brain.teach_curriculum("data/english_basics.txt");
+                 if (report.pairs > 0) {
+                     std::cout << "[System]: Basic English installed. " << report.to_string() << std::endl;
                  }
             }
         }).detach();
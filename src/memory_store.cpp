@@ -1,23 +1,51 @@
 #ifdef USE_POSTGRES
 #include "memory_store.hpp"
 #include "redis_client.hpp"
+#include "snapshot_writer.hpp"
+#include "infra/config.hpp"
 #include <chrono>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
 #include <sstream>
 #include <algorithm>
 #include <cctype>
+#include <charconv>
+#include <unordered_set>
+#include <limits>
 
-MemoryStore::MemoryStore(const std::string& conn_str) : conn_str_(conn_str) {
-    pg_client = std::make_unique<PostgresClient>(conn_str);
-    kv_store = std::make_unique<PostgresStorage>(conn_str);
+namespace {
+dnn::RecallCache::Options query_cache_options() {
+    dnn::RecallCache::Options options;
+    options.capacity = static_cast<size_t>(std::max(1, dnn::infra::Config::get_int("BRAIN_RECALL_CACHE_SIZE", 4096)));
+    options.ttl = std::chrono::milliseconds(std::max(1, dnn::infra::Config::get_int("BRAIN_RECALL_CACHE_TTL_MS", 60000)));
+    options.l2_prefix = "memory:";
+    return options;
+}
+} // namespace
+
+MemoryStore::MemoryStore(const std::string& conn_str)
+    : conn_str_(conn_str), index_path_(dnn::infra::Config::get("BRAIN_MEMORY_INDEX", "state/memory_index.bin")),
+      vectors_(0, memory_vector_options()), vector_path_(dnn::infra::Config::get("BRAIN_MEMORY_VECTORS", "state/memory_vectors.bin")),
+      recall_cache_(query_cache_options(), std::make_shared<RedisClient>(dnn::infra::Config::get("REDIS_HOST", "redis"),
+                                                                         dnn::infra::Config::get_int("REDIS_PORT", 6379))) {
+    if (is_embedded(conn_str)) {
+        sqlite_ = std::make_unique<SqliteMemoryStore>(conn_str.substr(7));
+        return;
+    }
+    pool_ = PgConnectionPool::shared(conn_str);
+    pg_client = std::make_unique<PostgresClient>(pool_);
+    kv_store = std::make_unique<PostgresStorage>(pool_);
 }
 
 MemoryStore::~MemoryStore() {
+    if (index_dirty_) save_postings();
+    if (vectors_dirty_) save_vectors();
     // pg_client disconnects on destruction
 }
 
 bool MemoryStore::init() {
-    std::lock_guard<std::mutex> lock(db_mutex_);
+    if (sqlite_) return sqlite_->init();
     if (!pg_client->connect()) return false;
     if (kv_store && !kv_store->connect()) return false;
 
@@ -34,198 +62,708 @@ bool MemoryStore::init() {
     
     if (!pg_client->execute(sql)) return false;
     
-    build_index();
+    if (!load_index()) build_index();
+    if (dnn::infra::Config::get_int("BRAIN_MEMORY_INDEX_VERIFY", 0)) verify_index();
+    load_vectors();
+    if (index_dirty_) save_postings();
+    if (vectors_dirty_) save_vectors();
     return true;
 }
 
 bool MemoryStore::store(const std::string& type, const std::string& content, const std::string& tags, const std::string& acl) {
-    std::lock_guard<std::mutex> lock(db_mutex_);
+    if (sqlite_) return sqlite_->store(type, content, tags, acl);
     if (!pg_client->is_connected()) return false;
 
     long long timestamp = std::chrono::duration_cast<std::chrono::seconds>(
         std::chrono::system_clock::now().time_since_epoch()).count();
 
-    // WARNING: PostgresClient::store_memory stub needs update to handle ACL/Strength columns
-    // For now we just call it and assume DB schema migration is handled manually or by SQL above
-    int id = pg_client->store_memory(timestamp, type, content, tags);
+    // One round trip: ACL and decay fields (Feature 6) go in with the row
+    int id = pg_client->store_memory(timestamp, type, content, tags, acl);
     if (id == -1) return false;
     
-    // Feature 6: Update ACL (Manual SQL until client updated)
-    std::string update_sql = "UPDATE memories SET acl = '" + acl + "', strength = 1.0, last_recall = " + std::to_string(timestamp) + " WHERE id = " + std::to_string(id) + ";";
-    pg_client->execute(update_sql.c_str());
-    
-    index_memory(id, content);
+    {
+        std::unique_lock<std::shared_mutex> lock(index_mutex_);
+        index_memory(id, content);
+    }
+    add_to_count(1);
+    const std::string_view stored[] = {content};
+    invalidate_queries(stored);
     
     return true;
 }
 
-// Global or static instance to share connection across calls
-static RedisClient redis_cache_("redis");
+namespace {
+// Postgres text[] literal: {"a","b"} with quotes and backslashes escaped
+std::string to_text_array(const std::vector<std::string>& items) {
+    std::string out = "{";
+    for (size_t i = 0; i < items.size(); ++i) {
+        if (i) out += ',';
+        out += '"';
+        for (char c : items[i]) {
+            if (c == '"' || c == '\\') out += '\\';
+            out += c;
+        }
+        out += '"';
+    }
+    out += '}';
+    return out;
+}
 
-std::vector<Memory> MemoryStore::query(const std::string& keyword, const std::string& user_acl) {
-    std::lock_guard<std::mutex> lock(db_mutex_);
-    
-    std::string cache_key = "query:" + keyword;
-    std::vector<Memory> results;
+// pgvector text form: [x,y,...]
+std::string to_vector_literal(const std::vector<double>& v) {
+    std::string out = "[";
+    char buf[32];
+    for (size_t i = 0; i < v.size(); ++i) {
+        if (i) out += ',';
+        auto res = std::to_chars(buf, buf + sizeof(buf), static_cast<float>(v[i]));
+        out.append(buf, res.ptr);
+    }
+    out += ']';
+    return out;
+}
 
-    // 1. Check Redis
-    auto cached = redis_cache_.get(cache_key);
-    if (cached) {
-        std::stringstream ss(cached.value());
-        std::string line;
-        while (std::getline(ss, line)) {
-            if (line.empty()) continue;
-            std::stringstream line_ss(line);
-            std::string segment;
-            std::vector<std::string> parts;
-            while(std::getline(line_ss, segment, '|')) {
-                parts.push_back(segment);
-            }
-            if (parts.size() >= 5) {
-                Memory m;
-                m.id = std::stoi(parts[0]);
-                m.timestamp = std::stoll(parts[1]);
-                m.type = parts[2];
-                m.content = parts[3];
-                m.tags = parts[4];
-                results.push_back(m);
-            }
+std::vector<std::string> index_tokens(std::string_view content) {
+    std::vector<std::string> tokens;
+    for_each_memory_token(content, [&](const std::string& token) { tokens.push_back(token); });
+    return tokens;
+}
+
+// Columns: id, timestamp, type, content, tags[, acl]
+Memory memory_from_row(const PgResult::Row& row, bool with_acl) {
+    Memory m;
+    m.id = static_cast<int>(row.integer(0));
+    m.timestamp = row.integer(1);
+    m.type = row.text(2);
+    m.content = row.text(3);
+    m.tags = row.text(4);
+    if (with_acl && !row.is_null(5)) m.acl_label = row.text(5);
+    return m;
+}
+} // namespace
+
+bool MemoryStore::store_batch(const std::vector<MemoryRecord>& records) {
+    if (sqlite_) return sqlite_->store_batch(records);
+    if (records.empty()) return true;
+    if (!pg_client->is_connected()) return false;
+    // Past this size, binary COPY beats formatting and parsing array literals
+    if (records.size() >= kBulkLoadThreshold) return bulk_load(records) == records.size();
+
+    long long timestamp = std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+
+    std::vector<std::string> types, contents, tags, acls, keys, vectors;
+    std::unordered_map<std::string, size_t> key_slot; // ON CONFLICT may touch a key only once per statement
+    for (const auto& r : records) {
+        types.push_back(r.type);
+        contents.push_back(r.content);
+        tags.push_back(r.tags);
+        acls.push_back(r.acl);
+        if (r.embedding_key.empty() || r.embedding.empty()) continue;
+        auto [it, inserted] = key_slot.try_emplace(r.embedding_key, keys.size());
+        if (inserted) {
+            keys.push_back(r.embedding_key);
+            vectors.push_back(to_vector_literal(r.embedding));
+        } else {
+            vectors[it->second] = to_vector_literal(r.embedding);
         }
-        return results;
     }
-    
-    if (!pg_client->is_connected()) return results;
+
+    // One statement is one implicit transaction: rows and embeddings land together or not at all
+    static const char* sql =
+        "WITH m AS ("
+        "  INSERT INTO memories (timestamp, type, content, tags, acl, strength, last_recall)"
+        "  SELECT $1::bigint, r.type, r.content, r.tags, r.acl, 1.0, $1::bigint"
+        "  FROM unnest($2::text[], $3::text[], $4::text[], $5::text[]) WITH ORDINALITY AS r(type, content, tags, acl, ord)"
+        "  ORDER BY r.ord"
+        "  RETURNING id, content"
+        "), e AS ("
+        "  INSERT INTO brain_kv_store (key, value, embedding)"
+        "  SELECT u.k, '', u.v::vector FROM unnest($6::text[], $7::text[]) AS u(k, v)"
+        "  ON CONFLICT (key) DO UPDATE SET embedding = EXCLUDED.embedding"
+        ")"
+        " SELECT id, content FROM m;";
+
+    auto rows = pg_client->execute_prepared(sql, {PgParam::int8(timestamp), PgParam::literal(to_text_array(types)),
+                                                  PgParam::literal(to_text_array(contents)), PgParam::literal(to_text_array(tags)),
+                                                  PgParam::literal(to_text_array(acls)), PgParam::literal(to_text_array(keys)),
+                                                  PgParam::literal(to_text_array(vectors))});
+    if (!rows.ok()) return false;
+
+    {
+        std::unique_lock<std::shared_mutex> lock(index_mutex_);
+        for (int i = 0; i < rows.size(); ++i) index_memory(static_cast<int>(rows[i].integer(0)), rows[i].text(1));
+    }
+    add_to_count(rows.size());
+    invalidate_queries(std::vector<std::string_view>(contents.begin(), contents.end()));
+    std::vector<const MemoryRecord*> embedded;
+    for (const auto& r : records) embedded.push_back(&r);
+    index_embeddings(embedded);
+    return true;
+}
+
+size_t MemoryStore::store_many(const std::vector<MemoryRecord>& records) {
+    if (sqlite_) return sqlite_->store_many(records);
+    if (records.empty() || !pg_client->is_connected()) return 0;
+
+    long long timestamp = std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+
+    std::vector<PgStatement> statements;
+    std::vector<size_t> row_statement; // records[i] -> its INSERT in statements
+    std::vector<std::pair<const MemoryRecord*, size_t>> embedding_statement;
+    statements.reserve(records.size());
+    row_statement.reserve(records.size());
+    for (const auto& r : records) {
+        row_statement.push_back(statements.size());
+        statements.push_back({PostgresClient::kInsertMemorySql,
+                              {PgParam::int8(timestamp), PgParam::text(r.type), PgParam::text(r.content),
+                               PgParam::text(r.tags), PgParam::text(r.acl)}});
+        if (r.embedding_key.empty() || r.embedding.empty()) continue;
+        embedding_statement.emplace_back(&r, statements.size());
+        statements.push_back({"INSERT INTO brain_kv_store (key, value, embedding) VALUES ($1, '', $2::vector) "
+                              "ON CONFLICT (key) DO UPDATE SET embedding = EXCLUDED.embedding",
+                              {PgParam::text(r.embedding_key), PgParam::literal(to_vector_literal(r.embedding))}});
+    }
+
+    auto results = pg_client->execute_pipelined(statements);
+    size_t stored = 0;
+    std::unique_lock<std::shared_mutex> lock(index_mutex_);
+    for (size_t i = 0; i < records.size(); ++i) {
+        const PgResult& res = results[row_statement[i]];
+        if (res.empty()) continue;
+        index_memory(static_cast<int>(res[0].integer(0)), records[i].content);
+        ++stored;
+    }
+    lock.unlock();
+    add_to_count(static_cast<long long>(stored));
+    std::vector<std::string_view> contents;
+    for (const auto& r : records) contents.push_back(r.content);
+    invalidate_queries(contents);
+    std::vector<const MemoryRecord*> embedded;
+    for (const auto& [r, statement] : embedding_statement) {
+        if (results[statement].ok()) embedded.push_back(r);
+    }
+    index_embeddings(embedded);
+    return stored;
+}
+
+size_t MemoryStore::bulk_load(const std::vector<MemoryRecord>& records) {
+    if (sqlite_) return sqlite_->bulk_load(records);
+    if (records.empty() || !pg_client->is_connected()) return 0;
+    if (records.size() > static_cast<size_t>(std::numeric_limits<std::int32_t>::max())) return 0;
+    auto lease = pool_->checkout();
+    if (!lease) return 0;
+    PGconn* conn = lease.get();
+
+    long long timestamp = std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+
+    PgResult begin(PQexec(conn, "BEGIN"));
+    if (!begin.ok()) return 0;
+    auto fail = [conn] {
+        PgResult rollback(PQexec(conn, "ROLLBACK"));
+        return size_t{0};
+    };
+
+    // COPY cannot return generated ids and the index needs them, so take them
+    // from the sequence up front
+    const PgParam count[] = {PgParam::int4(static_cast<std::int32_t>(records.size()))};
+    auto ids = PostgresClient::execute_prepared(lease,
+        "SELECT nextval(pg_get_serial_sequence('memories', 'id')) FROM generate_series(1, $1)", count);
+    if (static_cast<size_t>(ids.size()) != records.size()) return fail();
+
+    PgCopyBuffer rows;
+    std::unordered_map<std::string_view, size_t> key_slot; // Last embedding per key wins
+    std::vector<const MemoryRecord*> embedded;
+    for (size_t i = 0; i < records.size(); ++i) {
+        const auto& r = records[i];
+        rows.begin_row(8);
+        rows.add_int4(static_cast<std::int32_t>(ids[static_cast<int>(i)].integer(0)));
+        rows.add_int8(timestamp);
+        rows.add_text(r.type);
+        rows.add_text(r.content);
+        rows.add_text(r.tags);
+        rows.add_text(r.acl);
+        rows.add_float8(1.0);
+        rows.add_int8(timestamp);
+        if (r.embedding_key.empty() || r.embedding.empty()) continue;
+        auto [it, inserted] = key_slot.try_emplace(r.embedding_key, embedded.size());
+        if (inserted) embedded.push_back(&r);
+        else embedded[it->second] = &r;
+    }
+    if (PostgresClient::copy_in(conn, "COPY memories (id, timestamp, type, content, tags, acl, strength, last_recall) "
+                                      "FROM STDIN (FORMAT binary)", rows.finish()) < 0) {
+        return fail();
+    }
+
+    if (!embedded.empty()) {
+        PgCopyBuffer vectors;
+        for (const auto* r : embedded) {
+            vectors.begin_row(3);
+            vectors.add_text(r->embedding_key);
+            vectors.add_null(); // Value: '' for a new key, as store_embedding() writes; kept otherwise
+            vectors.add_vector(r->embedding);
+        }
+        if (PostgresStorage::copy_upsert(conn, vectors) < 0) return fail();
+    }
+
+    PgResult commit(PQexec(conn, "COMMIT"));
+    if (!commit.ok()) {
+        std::cerr << "[MemoryStore] Bulk load commit failed: " << PQerrorMessage(conn) << std::endl;
+        return 0;
+    }
+    lease.release();
+
+    // Tokenise outside the lock, then index in one pass (ids ascend, so each
+    // posting list is appended in place)
+    std::vector<std::vector<std::string>> tokens(records.size());
+    for (size_t i = 0; i < records.size(); ++i) tokens[i] = index_tokens(records[i].content);
+    {
+        std::unique_lock<std::shared_mutex> lock(index_mutex_);
+        for (size_t i = 0; i < records.size(); ++i) index_memory(static_cast<int>(ids[static_cast<int>(i)].integer(0)), tokens[i]);
+    }
+    add_to_count(static_cast<long long>(records.size()));
+    invalidate_queries(tokens);
+    index_embeddings(embedded);
+    return records.size();
+}
+
+std::vector<Memory> MemoryStore::query(const std::string& keyword, const std::string& user_acl) {
+    if (sqlite_) return sqlite_->query(keyword, user_acl);
+    std::vector<Memory> results;
 
     std::string term = keyword;
     std::transform(term.begin(), term.end(), term.begin(), ::tolower);
-    
-    if (inverted_index_.find(term) == inverted_index_.end()) {
+
+    // The 20 newest rows of the term for every ACL, so one entry serves all
+    // callers; empty results are cached too, until a store adds the term
+    const std::string cache_key = "query:" + term;
+    auto cached = recall_cache_.get_or_load(cache_key, [&]() -> std::optional<std::string> {
+        if (!pg_client->is_connected()) return std::nullopt;
+        std::vector<int> newest;
+        {
+            std::shared_lock<std::shared_mutex> lock(index_mutex_);
+            newest = index_.newest(index_.find(term), 20);
+        }
+        std::vector<Memory> found;
+        if (!newest.empty()) {
+            auto rows = pg_client->execute_prepared(
+                "SELECT id, timestamp, type, content, tags, acl FROM memories WHERE id = ANY($1) ORDER BY timestamp DESC;",
+                {PgParam::int4_array(newest)});
+            if (!rows.ok()) return std::nullopt;
+            for (int i = 0; i < rows.size(); ++i) found.push_back(memory_from_row(rows[i], true));
+        }
+        return dnn::encode_memories(found);
+    });
+    if (!cached) return results;
+    auto memories = dnn::decode_memories(*cached);
+    if (!memories) { // Written by an incompatible version
+        recall_cache_.invalidate(cache_key);
         return results;
     }
 
-    const auto& ids = inverted_index_[term];
-    if (ids.empty()) return results;
+    for (auto& m : *memories) {
+        if (m.acl_label != "PUBLIC" && m.acl_label != user_acl) continue; // Basic ACL simulation
+        results.push_back(std::move(m));
+    }
+    return results;
+}
 
-    std::string id_list = "";
-    int count = 0;
-    for (auto it = ids.rbegin(); it != ids.rend(); ++it) {
-        if (!id_list.empty()) id_list += ",";
-        id_list += std::to_string(*it);
-        if (++count >= 20) break;
+std::unordered_map<std::string, std::vector<Memory>> MemoryStore::query_many(const std::vector<std::string>& keywords,
+                                                                          const std::string& user_acl) {
+    if (sqlite_) return sqlite_->query_many(keywords, user_acl);
+    std::unordered_map<std::string, std::vector<Memory>> results;
+    if (keywords.empty() || !pg_client->is_connected()) return results;
+
+    // Same candidates as query(): the 20 newest ids per term, fetched together
+    std::unordered_map<std::string, std::unordered_set<int>> term_ids;
+    std::unordered_set<int> all_ids;
+    std::shared_lock<std::shared_mutex> index_lock(index_mutex_);
+    for (const auto& keyword : keywords) {
+        if (term_ids.count(keyword)) continue;
+        std::string term = keyword;
+        std::transform(term.begin(), term.end(), term.begin(), ::tolower);
+        const auto newest = index_.newest(index_.find(term), 20);
+        if (newest.empty()) continue;
+        auto& ids = term_ids[keyword];
+        ids.insert(newest.begin(), newest.end());
+        all_ids.insert(newest.begin(), newest.end());
+    }
+    index_lock.unlock();
+    if (all_ids.empty()) return results;
+
+    const std::vector<int> id_list(all_ids.begin(), all_ids.end());
+    auto rows = pg_client->execute_prepared(
+        "SELECT id, timestamp, type, content, tags, acl FROM memories WHERE id = ANY($1) ORDER BY timestamp DESC;",
+        {PgParam::int4_array(id_list)});
+
+    for (int i = 0; i < rows.size(); ++i) {
+        Memory m = memory_from_row(rows[i], true);
+        if (m.acl_label != "PUBLIC" && m.acl_label != user_acl) continue;
+        for (const auto& [keyword, ids] : term_ids) {
+            if (ids.count(m.id)) results[keyword].push_back(m);
+        }
     }
+    return results;
+}
 
-    std::string sql_str = "SELECT id, timestamp, type, content, tags, acl FROM memories WHERE id IN (" + id_list + ") ORDER BY timestamp DESC;";
-    auto rows = pg_client->query(sql_str);
+std::vector<Memory> MemoryStore::search(const std::vector<MemoryQueryTerm>& terms, size_t k, const std::string& user_acl,
+                                        bool require_all) {
+    auto results = search_many({terms}, k, user_acl, require_all);
+    return std::move(results[0]);
+}
 
-    for (const auto& row : rows) {
-        // ACL Check
-        std::string acl = row.columns.size() > 5 ? row.columns[5] : "PUBLIC";
-        if (acl != "PUBLIC" && acl != user_acl) continue; // Basic ACL simulation
+std::vector<std::vector<Memory>> MemoryStore::search_many(const std::vector<std::vector<MemoryQueryTerm>>& queries, size_t k,
+                                                          const std::string& user_acl, bool require_all) {
+    if (sqlite_) return sqlite_->search_many(queries, k, user_acl, require_all);
+    std::vector<std::vector<Memory>> results(queries.size());
+    if (queries.empty() || k == 0 || !pg_client->is_connected()) return results;
 
-        Memory m;
-        m.id = std::stoi(row.columns[0]);
-        m.timestamp = std::stoll(row.columns[1]);
-        m.type = row.columns[2];
-        m.content = row.columns[3];
-        m.tags = row.columns[4];
-        m.acl_label = acl;
-        results.push_back(m);
+    // Rank every query against the index, then fetch all winners at once.
+    // Extra candidates leave room for rows the ACL hides.
+    const size_t candidates = k * 4;
+    std::vector<std::vector<dnn::PostingIndex::Hit>> hits(queries.size());
+    std::vector<int> ids;
+    {
+        std::shared_lock<std::shared_mutex> lock(index_mutex_);
+        std::vector<dnn::PostingIndex::QueryTerm> query;
+        for (size_t q = 0; q < queries.size(); ++q) {
+            query.clear();
+            bool unknown = false;
+            for (const auto& term : queries[q]) {
+                for_each_memory_token(term.text, [&](const std::string& token) {
+                    const auto id = index_.find(token);
+                    if (id == dnn::PostingIndex::kNoTerm) unknown = true;
+                    else query.push_back({id, term.weight});
+                });
+            }
+            if (require_all && unknown) continue;
+            hits[q] = index_.search(query, candidates, require_all);
+            for (const auto& hit : hits[q]) ids.push_back(hit.doc);
+        }
     }
-    
-    // Store in Redis
-    if (!results.empty()) {
-        std::string serialized = "";
-        for (const auto& m : results) {
-            serialized += std::to_string(m.id) + "|" + 
-                          std::to_string(m.timestamp) + "|" + 
-                          m.type + "|" + 
-                          m.content + "|" + 
-                          m.tags + "\n";
+    if (ids.empty()) return results;
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+
+    auto rows = pg_client->execute_prepared("SELECT id, timestamp, type, content, tags, acl FROM memories WHERE id = ANY($1);",
+                                            {PgParam::int4_array(ids)});
+    std::unordered_map<int, Memory> by_id;
+    for (int i = 0; i < rows.size(); ++i) {
+        Memory m = memory_from_row(rows[i], true);
+        if (m.acl_label != "PUBLIC" && m.acl_label != user_acl) continue;
+        by_id.emplace(m.id, std::move(m));
+    }
+    for (size_t q = 0; q < queries.size(); ++q) {
+        for (const auto& hit : hits[q]) {
+            if (results[q].size() == k) break;
+            auto it = by_id.find(hit.doc);
+            if (it == by_id.end()) continue;
+            results[q].push_back(it->second);
+            results[q].back().score = hit.score;
         }
-        redis_cache_.set(cache_key, serialized, 60);
     }
-    
     return results;
 }
 
+bool MemoryStore::load_index() {
+    if (index_path_.empty() || !pg_client->is_connected()) return false;
+
+    dnn::PostingIndex snapshot;
+    dnn::PostingIndex::SnapshotInfo info;
+    if (!snapshot.map_file(index_path_, info)) return false;
+    if (info.max_doc > std::numeric_limits<int>::max()) return false;
+    // clear() restarts ids, so the newest covered row must still be the one the snapshot saw
+    const int max_id = static_cast<int>(info.max_doc);
+    if (max_id >= 0 && row_fingerprint(max_id) != info.fingerprint) {
+        std::cout << "[MemoryStore] Index snapshot " << index_path_ << " is stale; rebuilding" << std::endl;
+        return false;
+    }
+    // Another writer can commit a row below max_id after the snapshot saw
+    // max_id (memory_ingest, or ids reserved by bulk_load before they commit);
+    // such a row is neither newer nor indexed, so the covered rows must tally
+    auto covered = pg_client->execute_prepared("SELECT count(*) FROM memories WHERE id <= $1;", {PgParam::int4(max_id)});
+    if (!covered.ok() || covered.empty()) return false;
+    if (static_cast<std::uint64_t>(covered[0].integer(0)) != info.rows) {
+        std::cout << "[MemoryStore] Index snapshot " << index_path_ << " covers " << info.rows << " rows, the table has "
+                  << covered[0].integer(0) << " up to id " << max_id << "; rebuilding" << std::endl;
+        return false;
+    }
+
+    // Catch up on rows stored since the snapshot was written
+    auto rows = pg_client->execute_prepared("SELECT id, content FROM memories WHERE id > $1 ORDER BY id ASC;",
+                                            {PgParam::int4(max_id)});
+    if (!rows.ok()) return false;
+    std::unique_lock<std::shared_mutex> lock(index_mutex_);
+    index_ = std::move(snapshot);
+    indexed_max_id_ = max_id;
+    indexed_rows_ = static_cast<long long>(info.rows);
+    index_dirty_ = false;
+    for (int i = 0; i < rows.size(); ++i) index_memory(static_cast<int>(rows[i].integer(0)), rows[i].text(1));
+    memory_count_ = indexed_rows_;
+    const auto stats = index_.stats();
+    std::cout << "[MemoryStore] Index loaded from " << index_path_ << ": " << info.rows << " rows, caught up " << rows.size()
+              << ". Tokens: " << stats.terms << ", postings: " << stats.postings << std::endl;
+    return true;
+}
+
 void MemoryStore::build_index() {
-    inverted_index_.clear();
     if (!pg_client->is_connected()) return;
 
-    auto rows = pg_client->query("SELECT id, content FROM memories ORDER BY id ASC;");
-    for (const auto& row : rows) {
-        int id = std::stoi(row.columns[0]);
-        index_memory(id, row.columns[1]);
+    auto rows = pg_client->execute_prepared("SELECT id, content FROM memories ORDER BY id ASC;");
+    std::unique_lock<std::shared_mutex> lock(index_mutex_);
+    index_.clear();
+    indexed_max_id_ = -1;
+    indexed_rows_ = 0;
+    for (int i = 0; i < rows.size(); ++i) {
+        index_memory(static_cast<int>(rows[i].integer(0)), rows[i].text(1));
     }
-    std::cout << "[MemoryStore] Index built from PostgreSQL. Tokens: " << inverted_index_.size() << std::endl;
+    index_.shrink_to_fit();
+    index_dirty_ = true;
+    memory_count_ = rows.size();
+    const auto stats = index_.stats();
+    std::cout << "[MemoryStore] Index built from PostgreSQL. Tokens: " << stats.terms << ", postings: " << stats.postings
+              << " (" << stats.bytes / 1024 << " KiB)" << std::endl;
 }
 
-void MemoryStore::index_memory(int id, const std::string& content) {
-    std::string local_content = content;
-    for (size_t i = 0; i < local_content.size(); ++i) {
-        if (std::isalpha(local_content[i])) {
-             local_content[i] = static_cast<char>(std::tolower(local_content[i]));
-        } else {
-             local_content[i] = ' ';
+bool MemoryStore::verify_index() {
+    if (sqlite_) return sqlite_->verify_index();
+    if (!pg_client->is_connected()) return false;
+
+    auto rows = pg_client->execute_prepared("SELECT id, content FROM memories ORDER BY id ASC;");
+    if (!rows.ok()) return false;
+    dnn::PostingIndex rebuilt;
+    for (int i = 0; i < rows.size(); ++i) rebuilt.add_document(static_cast<int>(rows[i].integer(0)), index_tokens(rows[i].text(1)));
+
+    std::unique_lock<std::shared_mutex> lock(index_mutex_);
+    if (index_.equivalent(rebuilt)) {
+        std::cout << "[MemoryStore] Index verified against " << rows.size() << " rows" << std::endl;
+        return true;
+    }
+    std::cerr << "[MemoryStore] Index disagreed with the memories table; replaced with a rebuild" << std::endl;
+    rebuilt.shrink_to_fit();
+    index_ = std::move(rebuilt);
+    indexed_max_id_ = rows.empty() ? -1 : static_cast<int>(rows[rows.size() - 1].integer(0));
+    indexed_rows_ = rows.size();
+    index_dirty_ = true;
+    memory_count_ = rows.size();
+    return false;
+}
+
+bool MemoryStore::save_index() {
+    if (sqlite_) return sqlite_->save_index();
+    const bool postings = save_postings();
+    return save_vectors() && postings;
+}
+
+bool MemoryStore::save_postings() {
+    if (index_path_.empty()) return true;
+    if (!pg_client->is_connected()) return false;
+    auto dir = std::filesystem::path(index_path_).parent_path();
+    if (!dir.empty() && !std::filesystem::exists(dir)) return false;
+
+    // Shared lock: stores wait, queries do not
+    std::shared_lock<std::shared_mutex> lock(index_mutex_);
+    dnn::PostingIndex::SnapshotInfo info{indexed_max_id_, static_cast<std::uint64_t>(indexed_rows_), 0};
+    if (indexed_max_id_ >= 0) info.fingerprint = row_fingerprint(indexed_max_id_);
+    dnn::SnapshotWriter writer;
+    if (!writer.write_now(index_path_, [&](std::ostream& os) { return index_.write(os, info); })) return false;
+    index_dirty_ = false;
+    return true;
+}
+
+std::uint64_t MemoryStore::row_fingerprint(int id) {
+    auto rows = pg_client->execute_prepared("SELECT timestamp, content FROM memories WHERE id = $1;", {PgParam::int4(id)});
+    if (rows.empty()) return 0;
+    // FNV-1a over the timestamp and content: stable across builds, unlike std::hash
+    std::uint64_t hash = 1469598103934665603ull;
+    auto mix = [&hash](const void* data, size_t len) {
+        for (size_t i = 0; i < len; ++i) {
+            hash ^= static_cast<const unsigned char*>(data)[i];
+            hash *= 1099511628211ull;
+        }
+    };
+    const long long timestamp = rows[0].integer(0);
+    const std::string_view content = rows[0].text(1);
+    mix(&timestamp, sizeof(timestamp));
+    mix(content.data(), content.size());
+    return hash;
+}
+
+void MemoryStore::load_vectors() {
+    if (!pg_client->is_connected()) return;
+    // Any insert or update stamps a higher embedding_version (see PostgresStorage::connect),
+    // whichever client wrote it, and a delete lowers the count. The version is
+    // drawn when a row is written, not when it commits, so a transaction in
+    // flight now may commit a version below this MAX later; the snapshot's xmin
+    // (every older transaction has finished) marks where such writers start.
+    auto fingerprint = pg_client->execute_prepared(
+        "SELECT COUNT(*), COALESCE(MAX(embedding_version), 0), pg_snapshot_xmin(pg_current_snapshot())::text::bigint "
+        "FROM brain_kv_store WHERE embedding IS NOT NULL;");
+    if (fingerprint.empty()) return; // No vector store (pgvector missing)
+    const long long stored = fingerprint[0].integer(0);
+    const long long version = fingerprint[0].integer(1);
+    const long long xmin = fingerprint[0].integer(2);
+    const auto options = memory_vector_options();
+
+    // BRAIN_MEMORY_INDEX_VERIFY=1 rebuilds regardless
+    if (!vector_path_.empty() && !dnn::infra::Config::get_int("BRAIN_MEMORY_INDEX_VERIFY", 0)) {
+        std::ifstream in(vector_path_, std::ios::binary);
+        dnn::HnswIndex snapshot;
+        long long covered = 0, covered_xmin = 0;
+        if (in && read_vector_header(in, covered, covered_xmin) && snapshot.read(in)) {
+            // Catch up on embeddings stamped since the snapshot, and on any row a
+            // transaction at or after its xmin wrote (in circular 32-bit xid order,
+            // as row xmin is stored); re-adding a key replaces its node. The xid
+            // test scans the table, still far cheaper than rebuilding the graph.
+            // Residual window: more than 2^31 transactions between the snapshot's
+            // read and this load wrap the comparison and can miss such a row.
+            auto rows = pg_client->execute_prepared(
+                "SELECT key, embedding FROM brain_kv_store WHERE embedding IS NOT NULL AND (embedding_version > $1 "
+                "OR ((xmin::text::bigint - $2) & 4294967295) < 2147483648);",
+                {PgParam::int8(covered), PgParam::int8(covered_xmin & 0xFFFFFFFFLL)});
+            if (rows.ok()) {
+                for (int i = 0; i < rows.size(); ++i) {
+                    const auto vector = rows[i].vector(1);
+                    snapshot.add(rows[i].text(0), std::span<const float>(vector));
+                }
+            }
+            // Extra nodes mean keys were deleted since; only a rebuild drops them
+            if (rows.ok() && static_cast<long long>(snapshot.size()) == stored) {
+                snapshot.set_ef_search(options.ef_search);
+                std::unique_lock<std::shared_mutex> lock(vector_mutex_);
+                vectors_ = std::move(snapshot);
+                vectors_version_ = version;
+                vectors_xmin_ = xmin;
+                vectors_dirty_ = rows.size() > 0;
+                std::cout << "[MemoryStore] Vector index loaded from " << vector_path_ << ": " << stored
+                          << " embeddings, caught up " << rows.size() << std::endl;
+                return;
+            }
+            std::cout << "[MemoryStore] Vector snapshot " << vector_path_ << " is stale; rebuilding" << std::endl;
         }
     }
-    
-    std::stringstream ss(local_content);
-    std::string token;
-    while (ss >> token) {
-        if (token.length() < 3) continue;
-        inverted_index_[token].push_back(id);
+
+    auto rows = pg_client->execute_prepared("SELECT key, embedding FROM brain_kv_store WHERE embedding IS NOT NULL;");
+    dnn::HnswIndex built(0, options);
+    for (int i = 0; i < rows.size(); ++i) {
+        const auto vector = rows[i].vector(1);
+        built.add(rows[i].text(0), std::span<const float>(vector));
     }
+    const auto stats = built.stats();
+    std::unique_lock<std::shared_mutex> lock(vector_mutex_);
+    vectors_ = std::move(built);
+    vectors_version_ = version; // Read first: rows written since are caught up again at the next load
+    vectors_xmin_ = xmin;
+    vectors_dirty_ = true;
+    std::cout << "[MemoryStore] Vector index built from PostgreSQL: " << stats.nodes << " embeddings, " << stats.levels
+              << " levels (" << stats.bytes / 1024 << " KiB)" << std::endl;
+}
+
+bool MemoryStore::save_vectors() {
+    if (vector_path_.empty()) return true;
+    auto dir = std::filesystem::path(vector_path_).parent_path();
+    if (!dir.empty() && !std::filesystem::exists(dir)) return false;
+
+    // Writers take vector_mutex_ exclusively, so nothing can dirty the index
+    // between the write and clearing the flag
+    std::shared_lock<std::shared_mutex> lock(vector_mutex_);
+    dnn::SnapshotWriter writer;
+    if (!writer.write_now(vector_path_, [this](std::ostream& os) {
+            return write_vector_header(os, vectors_version_, vectors_xmin_) && vectors_.write(os);
+        })) {
+        return false;
+    }
+    vectors_dirty_.store(false);
+    return true;
+}
+
+void MemoryStore::index_embeddings(const std::vector<const MemoryRecord*>& records) {
+    std::unique_lock<std::shared_mutex> lock(vector_mutex_);
+    for (const auto* r : records) {
+        if (r->embedding_key.empty() || r->embedding.empty()) continue;
+        vectors_.add(r->embedding_key, r->embedding);
+        vectors_dirty_ = true;
+    }
+}
+
+void MemoryStore::index_memory(int id, std::string_view content) {
+    index_memory(id, index_tokens(content));
+}
+
+void MemoryStore::invalidate_queries(std::span<const std::string_view> contents) {
+    std::unordered_set<std::string> keys;
+    for (auto content : contents) for_each_memory_token(content, [&](const std::string& token) { keys.insert("query:" + token); });
+    const std::vector<std::string> unique(keys.begin(), keys.end());
+    recall_cache_.invalidate(unique);
+}
+
+void MemoryStore::invalidate_queries(std::span<const std::vector<std::string>> tokens) {
+    std::unordered_set<std::string> keys;
+    for (const auto& row : tokens) for (const auto& token : row) keys.insert("query:" + token);
+    const std::vector<std::string> unique(keys.begin(), keys.end());
+    recall_cache_.invalidate(unique);
+}
+
+void MemoryStore::index_memory(int id, std::span<const std::string> tokens) {
+    index_.add_document(id, tokens);
+    indexed_max_id_ = std::max(indexed_max_id_, id);
+    ++indexed_rows_;
+    index_dirty_ = true;
 }
 
 std::vector<Memory> MemoryStore::get_recent(int limit) {
-    std::lock_guard<std::mutex> lock(db_mutex_);
+    if (sqlite_) return sqlite_->get_recent(limit);
     std::vector<Memory> results;
     if (!pg_client->is_connected()) return results;
 
-    std::string sql_str = "SELECT id, timestamp, type, content, tags FROM memories ORDER BY timestamp DESC LIMIT " + std::to_string(limit) + ";";
-    auto rows = pg_client->query(sql_str);
-
-    for (const auto& row : rows) {
-        Memory m;
-        m.id = std::stoi(row.columns[0]);
-        m.timestamp = std::stoll(row.columns[1]);
-        m.type = row.columns[2];
-        m.content = row.columns[3];
-        m.tags = row.columns[4];
-        results.push_back(m);
-    }
+    auto rows = pg_client->execute_prepared("SELECT id, timestamp, type, content, tags FROM memories ORDER BY timestamp DESC LIMIT $1;",
+                                            {PgParam::int4(limit)});
+    results.reserve(static_cast<size_t>(rows.size()));
+    for (int i = 0; i < rows.size(); ++i) results.push_back(memory_from_row(rows[i], false));
     return results;
 }
 
 long long MemoryStore::get_memory_count() {
-    std::lock_guard<std::mutex> lock(db_mutex_);
+    if (sqlite_) return sqlite_->get_memory_count();
     if (!pg_client->is_connected()) return 0;
+    long long count = memory_count_.load();
+    if (count >= 0) return count;
     
-    auto res = pg_client->query("SELECT COUNT(*) FROM memories;");
+    auto res = pg_client->execute_prepared("SELECT COUNT(*) FROM memories;");
     if (res.empty()) return 0;
-    return std::stoll(res[0].columns[0]);
+    count = res[0].integer(0);
+    memory_count_.store(count);
+    return count;
 }
 
 std::string MemoryStore::get_graph_json(int max_nodes) {
-    std::lock_guard<std::mutex> lock(db_mutex_);
+    if (sqlite_) return sqlite_->get_graph_json(max_nodes);
+    std::shared_lock<std::shared_mutex> lock(index_mutex_);
     
     // 1. Pick top N tokens by frequency
-    std::vector<std::pair<std::string, int>> frequencies;
-    for (const auto& [token, ids] : inverted_index_) {
-        frequencies.push_back({token, (int)ids.size()});
-    }
+    struct TermFrequency {
+        dnn::PostingIndex::TermId id;
+        std::string_view token;
+        size_t count;
+    };
+    std::vector<TermFrequency> frequencies;
+    index_.for_each_term([&](dnn::PostingIndex::TermId id, std::string_view token, size_t count) {
+        frequencies.push_back({id, token, count});
+    });
     
     std::sort(frequencies.begin(), frequencies.end(), [](const auto& a, const auto& b) {
-        return a.second > b.second;
+        return a.count > b.count;
     });
     
     int actual_nodes = std::min((int)frequencies.size(), max_nodes);
     std::vector<std::string> top_tokens;
-    std::unordered_map<std::string, int> token_to_freq;
+    std::vector<dnn::PostingIndex::TermId> top_ids;
+    std::unordered_map<std::string, size_t> token_to_freq;
     for (int i = 0; i < actual_nodes; i++) {
-        top_tokens.push_back(frequencies[i].first);
-        token_to_freq[frequencies[i].first] = frequencies[i].second;
+        top_tokens.emplace_back(frequencies[i].token);
+        top_ids.push_back(frequencies[i].id);
+        token_to_freq[top_tokens.back()] = frequencies[i].count;
     }
     
     // 2. Build adjacency (shared memory IDs)
@@ -244,20 +782,7 @@ std::string MemoryStore::get_graph_json(int max_nodes) {
         #pragma omp for schedule(dynamic)
         for (int i = 0; i < actual_nodes; i++) {
             for (int j = i + 1; j < actual_nodes; j++) {
-                const auto& ids1 = inverted_index_[top_tokens[i]];
-                const auto& ids2 = inverted_index_[top_tokens[j]];
-                
-                int weight = 0;
-                size_t p1 = 0, p2 = 0;
-                while(p1 < ids1.size() && p2 < ids2.size()) {
-                    if (ids1[p1] == ids2[p2]) {
-                        weight++; p1++; p2++;
-                    } else if (ids1[p1] < ids2[p2]) {
-                        p1++;
-                    } else {
-                        p2++;
-                    }
-                }
+                const size_t weight = index_.intersect_count(top_ids[i], top_ids[j]);
                 
                 if (weight > 0) {
                     std::string link = "{\"source\": \"" + top_tokens[i] + "\", \"target\": \"" + top_tokens[j] + "\", \"weight\": " + std::to_string(weight) + "}";
@@ -277,26 +802,51 @@ std::string MemoryStore::get_graph_json(int max_nodes) {
     return ss.str();
 }
 void MemoryStore::clear() {
-    std::lock_guard<std::mutex> lock(db_mutex_);
+    if (sqlite_) {
+        sqlite_->clear();
+        return;
+    }
     if (pg_client->is_connected()) {
         pg_client->execute("TRUNCATE memories RESTART IDENTITY;");
     }
-    inverted_index_.clear();
-    // Cache remains, but since we use TRUNCATE identity, new IDs will match old ones
-    // and might cause incorrect cache hits. We should probably flush Redis too.
+    std::unique_lock<std::shared_mutex> lock(index_mutex_);
+    index_.clear();
+    indexed_max_id_ = -1;
+    indexed_rows_ = 0;
+    index_dirty_ = true;
+    memory_count_ = 0;
+    lock.unlock();
+    recall_cache_.clear(); // Ids restart, so nothing cached may survive
 }
 
 void MemoryStore::store_embedding(const std::string& key, const std::vector<double>& embedding) {
-    if (kv_store) kv_store->store_embedding(key, embedding);
+    if (sqlite_) {
+        sqlite_->store_embedding(key, embedding);
+        return;
+    }
+    if (!kv_store) return;
+    kv_store->store_embedding(key, embedding);
+    if (!pg_client->is_connected()) return;
+    std::unique_lock<std::shared_mutex> lock(vector_mutex_);
+    vectors_.add(key, embedding);
+    vectors_dirty_ = true;
 }
 
 std::vector<double> MemoryStore::retrieve_embedding(const std::string& key) {
+    if (sqlite_) return sqlite_->retrieve_embedding(key);
+    {
+        std::shared_lock<std::shared_mutex> lock(vector_mutex_);
+        auto vector = vectors_.vector(key);
+        if (!vector.empty()) return vector;
+    }
     if (kv_store) return kv_store->retrieve_embedding(key);
     return {};
 }
 
 std::vector<std::string> MemoryStore::search_similar(const std::vector<double>& embedding, int limit) {
-    if (kv_store) return kv_store->search_similar(embedding, limit);
-    return {};
+    if (sqlite_) return sqlite_->search_similar(embedding, limit);
+    if (limit <= 0) return {};
+    std::shared_lock<std::shared_mutex> lock(vector_mutex_);
+    return vectors_.search_keys(embedding, static_cast<size_t>(limit));
 }
 #endif
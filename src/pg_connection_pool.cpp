@@ -0,0 +1,161 @@
+#ifdef USE_POSTGRES
+#include "pg_connection_pool.hpp"
+#include "infra/config.hpp"
+#include <algorithm>
+#include <iostream>
+
+PgConnectionPool::Lease& PgConnectionPool::Lease::operator=(Lease&& other) noexcept {
+    if (this != &other) {
+        release();
+        pool_ = other.pool_;
+        connection_ = other.connection_;
+        other.connection_ = nullptr;
+    }
+    return *this;
+}
+
+void PgConnectionPool::Lease::release() {
+    if (!connection_) return;
+    pool_->give_back(connection_);
+    connection_ = nullptr;
+}
+
+const char* PgConnectionPool::Lease::statement(const std::string& sql, const Oid* types, int n_types) {
+    if (!connection_) return nullptr;
+    auto it = connection_->prepared.find(sql);
+    if (it != connection_->prepared.end()) return it->second.c_str();
+
+    std::string name = "brain_stmt_" + std::to_string(connection_->prepared.size());
+    PGresult* res = PQprepare(connection_->conn, name.c_str(), sql.c_str(), n_types, types);
+    const bool ok = PQresultStatus(res) == PGRES_COMMAND_OK;
+    PQclear(res);
+    if (!ok) {
+        std::cerr << "PostgreSQL prepare failed: " << PQerrorMessage(connection_->conn) << std::endl;
+        return nullptr;
+    }
+    pool_->prepared_.fetch_add(1, std::memory_order_relaxed);
+    return connection_->prepared.emplace(sql, std::move(name)).first->second.c_str();
+}
+
+PgConnectionPool::PgConnectionPool(std::string conn_str, Options options)
+    : conn_str_(std::move(conn_str)), options_(options) {
+    stats_.capacity = std::max<size_t>(1, options_.max_connections);
+}
+
+PgConnectionPool::~PgConnectionPool() {
+    for (auto& connection : connections_) PQfinish(connection->conn);
+}
+
+std::shared_ptr<PgConnectionPool> PgConnectionPool::shared(const std::string& conn_str) {
+    static std::mutex registry_mutex;
+    static std::unordered_map<std::string, std::weak_ptr<PgConnectionPool>> registry;
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    if (auto pool = registry[conn_str].lock()) return pool;
+
+    Options options;
+    options.max_connections = static_cast<size_t>(std::max(1, dnn::infra::Config::get_int("BRAIN_PG_POOL_SIZE", 4)));
+    options.checkout_timeout = std::chrono::milliseconds(std::max(0, dnn::infra::Config::get_int("BRAIN_PG_CHECKOUT_MS", 2000)));
+    auto pool = std::make_shared<PgConnectionPool>(conn_str, options);
+    registry[conn_str] = pool;
+    return pool;
+}
+
+PgConnectionPool::Lease PgConnectionPool::checkout() {
+    using clock = std::chrono::steady_clock;
+    const auto start = clock::now();
+    const auto deadline = start + options_.checkout_timeout;
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    auto record_wait = [&] {
+        double waited = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+        stats_.total_wait_ms += waited;
+        stats_.max_wait_ms = std::max(stats_.max_wait_ms, waited);
+    };
+
+    Connection* connection = nullptr;
+    while (!connection) {
+        if (!idle_.empty()) {
+            connection = idle_.back();
+            idle_.pop_back();
+            break;
+        }
+        if (connections_.size() + opening_ < stats_.capacity) {
+            // Connect outside the lock; the slot is reserved meanwhile
+            ++opening_;
+            lock.unlock();
+            PGconn* conn = PQconnectdb(conn_str_.c_str());
+            lock.lock();
+            --opening_;
+            if (PQstatus(conn) != CONNECTION_OK) {
+                std::cerr << "PostgreSQL connection failed: " << PQerrorMessage(conn) << std::endl;
+                PQfinish(conn);
+                ++stats_.connect_failures;
+                record_wait();
+                available_.notify_one(); // The reserved slot is free again
+                return Lease();
+            }
+            connections_.push_back(std::make_unique<Connection>());
+            connection = connections_.back().get();
+            connection->conn = conn;
+            connection->last_used = clock::now();
+            break;
+        }
+        if (available_.wait_until(lock, deadline) == std::cv_status::timeout &&
+            idle_.empty() && connections_.size() + opening_ >= stats_.capacity) {
+            ++stats_.timeouts;
+            record_wait();
+            return Lease();
+        }
+    }
+
+    ++in_use_;
+    ++stats_.checkouts;
+    stats_.max_in_use = std::max(stats_.max_in_use, in_use_);
+    record_wait();
+    lock.unlock();
+
+    if (!healthy(*connection)) {
+        give_back(connection);
+        return Lease();
+    }
+    return Lease(this, connection);
+}
+
+bool PgConnectionPool::healthy(Connection& connection) {
+    bool ok = PQstatus(connection.conn) == CONNECTION_OK;
+    if (ok && std::chrono::steady_clock::now() - connection.last_used > options_.idle_check_after) {
+        PGresult* res = PQexec(connection.conn, "SELECT 1");
+        ok = PQresultStatus(res) == PGRES_TUPLES_OK;
+        PQclear(res);
+    }
+    if (ok) return true;
+
+    PQreset(connection.conn);
+    prepared_.fetch_sub(connection.prepared.size(), std::memory_order_relaxed);
+    connection.prepared.clear(); // The new session has none of them
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++stats_.reconnects;
+    if (PQstatus(connection.conn) == CONNECTION_OK) return true;
+    ++stats_.connect_failures;
+    return false;
+}
+
+void PgConnectionPool::give_back(Connection* connection) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        connection->last_used = std::chrono::steady_clock::now();
+        idle_.push_back(connection);
+        --in_use_;
+    }
+    available_.notify_one();
+}
+
+PgConnectionPool::Stats PgConnectionPool::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats s = stats_;
+    s.open = connections_.size();
+    s.in_use = in_use_;
+    s.prepared = prepared_.load(std::memory_order_relaxed);
+    return s;
+}
+#endif
@@ -1,111 +1,390 @@
 #ifdef USE_POSTGRES
 #include "postgres_client.hpp"
 #include <iostream>
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+
+namespace {
+// Built-in type OIDs (pg_type.dat); server headers are not needed for these
+constexpr Oid kInt2 = 21;
+constexpr Oid kInt4 = 23;
+constexpr Oid kInt8 = 20;
+constexpr Oid kText = 25;
+constexpr Oid kFloat8 = 701;
+constexpr Oid kInt4Array = 1007;
+
+void put_be(std::string& out, std::uint64_t v, int bytes) {
+    for (int i = bytes - 1; i >= 0; --i) out += static_cast<char>((v >> (8 * i)) & 0xFF);
+}
+
+std::uint64_t get_be(const char* p, int bytes) {
+    std::uint64_t v = 0;
+    for (int i = 0; i < bytes; ++i) v = (v << 8) | static_cast<unsigned char>(p[i]);
+    return v;
+}
+} // namespace
+
+PgParam PgParam::int4(std::int32_t v) {
+    PgParam p{{}, kInt4, 1};
+    put_be(p.value, static_cast<std::uint32_t>(v), 4);
+    return p;
+}
+
+PgParam PgParam::int8(std::int64_t v) {
+    PgParam p{{}, kInt8, 1};
+    put_be(p.value, static_cast<std::uint64_t>(v), 8);
+    return p;
+}
+
+PgParam PgParam::float8(double v) {
+    std::uint64_t bits;
+    std::memcpy(&bits, &v, sizeof bits);
+    PgParam p{{}, kFloat8, 1};
+    put_be(p.value, bits, 8);
+    return p;
+}
+
+PgParam PgParam::text(std::string_view v) {
+    return PgParam{std::string(v), kText, 1}; // Binary text is the raw bytes
+}
+
+PgParam PgParam::int4_array(std::span<const int> values) {
+    // Array wire format: ndim, has-nulls flag, element type, then per dimension
+    // (length, lower bound), then (byte length, value) per element
+    PgParam p{{}, kInt4Array, 1};
+    p.value.reserve(20 + values.size() * 8);
+    put_be(p.value, 1, 4);
+    put_be(p.value, 0, 4);
+    put_be(p.value, kInt4, 4);
+    put_be(p.value, values.size(), 4);
+    put_be(p.value, 1, 4);
+    for (int v : values) {
+        put_be(p.value, 4, 4);
+        put_be(p.value, static_cast<std::uint32_t>(v), 4);
+    }
+    return p;
+}
+
+PgParam PgParam::literal(std::string v) {
+    return PgParam{std::move(v), 0, 0};
+}
+
+std::int64_t PgResult::Row::integer(int col) const {
+    if (is_null(col)) return 0;
+    const char* p = PQgetvalue(res_, row_, col);
+    switch (PQgetlength(res_, row_, col)) {
+        case 2: return static_cast<std::int16_t>(get_be(p, 2));
+        case 4: return static_cast<std::int32_t>(get_be(p, 4));
+        case 8: return static_cast<std::int64_t>(get_be(p, 8));
+        default: return 0;
+    }
+}
+
+double PgResult::Row::float8(int col) const {
+    if (is_null(col) || PQgetlength(res_, row_, col) != 8) return 0.0;
+    std::uint64_t bits = get_be(PQgetvalue(res_, row_, col), 8);
+    double v;
+    std::memcpy(&v, &bits, sizeof v);
+    return v;
+}
+
+std::vector<float> PgResult::Row::vector(int col) const {
+    std::vector<float> v;
+    if (is_null(col)) return v;
+    // pgvector binary form: int16 dimensions, int16 unused, float4 values
+    const char* p = PQgetvalue(res_, row_, col);
+    const size_t length = static_cast<size_t>(PQgetlength(res_, row_, col));
+    if (length < 4) return v;
+    const size_t dim = static_cast<size_t>(get_be(p, 2));
+    if (length != 4 + 4 * dim) return v;
+    v.resize(dim);
+    for (size_t i = 0; i < dim; ++i) {
+        std::uint32_t bits = static_cast<std::uint32_t>(get_be(p + 4 + 4 * i, 4));
+        std::memcpy(&v[i], &bits, sizeof bits);
+    }
+    return v;
+}
+
+PgResult& PgResult::operator=(PgResult&& other) noexcept {
+    if (this != &other) {
+        if (res_) PQclear(res_);
+        res_ = other.res_;
+        other.res_ = nullptr;
+    }
+    return *this;
+}
+
+bool PgResult::ok() const {
+    if (!res_) return false;
+    ExecStatusType status = PQresultStatus(res_);
+    return status == PGRES_TUPLES_OK || status == PGRES_COMMAND_OK;
+}
+
+PgCopyBuffer::PgCopyBuffer() {
+    static constexpr char kSignature[] = "PGCOPY\n\377\r\n";
+    data_.append(kSignature, sizeof kSignature); // Includes the trailing NUL
+    put_be(data_, 0, 4); // Flags
+    put_be(data_, 0, 4); // Header extension length
+}
+
+void PgCopyBuffer::begin_row(std::int16_t fields) {
+    put_be(data_, static_cast<std::uint16_t>(fields), 2);
+    ++rows_;
+}
+
+void PgCopyBuffer::add_null() {
+    put_be(data_, 0xFFFFFFFFu, 4);
+}
+
+void PgCopyBuffer::add_int4(std::int32_t v) {
+    put_be(data_, 4, 4);
+    put_be(data_, static_cast<std::uint32_t>(v), 4);
+}
+
+void PgCopyBuffer::add_int8(std::int64_t v) {
+    put_be(data_, 8, 4);
+    put_be(data_, static_cast<std::uint64_t>(v), 8);
+}
+
+void PgCopyBuffer::add_float8(double v) {
+    std::uint64_t bits;
+    std::memcpy(&bits, &v, sizeof bits);
+    put_be(data_, 8, 4);
+    put_be(data_, bits, 8);
+}
+
+void PgCopyBuffer::add_text(std::string_view v) {
+    put_be(data_, v.size(), 4);
+    data_.append(v);
+}
+
+void PgCopyBuffer::add_vector(std::span<const double> v) {
+    put_be(data_, 4 + 4 * v.size(), 4);
+    put_be(data_, v.size(), 2);
+    put_be(data_, 0, 2);
+    for (double d : v) {
+        float f = static_cast<float>(d);
+        std::uint32_t bits;
+        std::memcpy(&bits, &f, sizeof bits);
+        put_be(data_, bits, 4);
+    }
+}
+
+const std::string& PgCopyBuffer::finish() {
+    if (!finished_) put_be(data_, 0xFFFF, 2);
+    finished_ = true;
+    return data_;
+}
 
 PostgresClient::PostgresClient(const std::string& conn_str) 
-    : connection_string(conn_str), conn(nullptr), connected(false) {}
+    : connection_string(conn_str) {}
+
+PostgresClient::PostgresClient(std::shared_ptr<PgConnectionPool> pool)
+    : connection_string(pool->connection_string()), pool_(std::move(pool)) {}
 
 PostgresClient::~PostgresClient() {
     disconnect();
 }
 
 bool PostgresClient::connect() {
-    std::lock_guard<std::mutex> lock(db_mutex);
-    if (connected) return true;
+    if (is_connected()) return true;
+    if (!pool_) pool_ = PgConnectionPool::shared(connection_string);
 
-    conn = PQconnectdb(connection_string.c_str());
+    // One checkout proves the database is reachable
+    if (!pool_->checkout()) return false;
 
-    if (PQstatus(conn) != CONNECTION_OK) {
-        std::cerr << "PostgreSQL connection failed: " << PQerrorMessage(conn) << std::endl;
-        PQfinish(conn);
-        conn = nullptr;
-        return false;
-    }
-
-    connected = true;
+    connected.store(true, std::memory_order_release);
     std::cout << "[PostgresClient] Connected successfully." << std::endl;
     return true;
 }
 
 void PostgresClient::disconnect() {
-    std::lock_guard<std::mutex> lock(db_mutex);
-    if (conn) {
-        PQfinish(conn);
-        conn = nullptr;
-    }
-    connected = false;
+    connected.store(false, std::memory_order_release);
 }
 
 bool PostgresClient::execute(const std::string& sql) {
-    std::lock_guard<std::mutex> lock(db_mutex);
-    if (!connected) return false;
+    if (!is_connected()) return false;
+    auto lease = pool_->checkout();
+    if (!lease) return false;
 
-    PGresult* res = PQexec(conn, sql.c_str());
-    if (PQresultStatus(res) != PGRES_COMMAND_OK && PQresultStatus(res) != PGRES_TUPLES_OK) {
-        std::cerr << "PostgreSQL execution failed: " << PQerrorMessage(conn) << std::endl;
-        PQclear(res);
+    PgResult res(PQexec(lease.get(), sql.c_str()));
+    if (!res.ok()) {
+        std::cerr << "PostgreSQL execution failed: " << PQerrorMessage(lease.get()) << std::endl;
         return false;
     }
-
-    PQclear(res);
     return true;
 }
 
 std::vector<PostgresRow> PostgresClient::query(const std::string& sql) {
-    std::lock_guard<std::mutex> lock(db_mutex);
+    bool ok = false;
+    return query_params(sql, {}, &ok);
+}
+
+std::vector<PostgresRow> PostgresClient::query_params(const std::string& sql, const std::vector<std::string>& params, bool* ok) {
     std::vector<PostgresRow> results;
-    if (!connected) return results;
+    if (ok) *ok = false;
+    if (!is_connected()) return results;
+    auto lease = pool_->checkout();
+    if (!lease) return results;
 
-    PGresult* res = PQexec(conn, sql.c_str());
-    if (PQresultStatus(res) != PGRES_TUPLES_OK) {
-        std::cerr << "PostgreSQL query failed: " << PQerrorMessage(conn) << std::endl;
-        PQclear(res);
+    std::vector<const char*> values;
+    values.reserve(params.size());
+    for (const auto& p : params) values.push_back(p.c_str());
+
+    PgResult res(PQexecParams(lease.get(), sql.c_str(), static_cast<int>(values.size()), NULL, values.data(), NULL, NULL, 0));
+    if (!res.ok()) {
+        std::cerr << "PostgreSQL query failed: " << PQerrorMessage(lease.get()) << std::endl;
         return results;
     }
 
-    int rows = PQntuples(res);
-    int cols = PQnfields(res);
-
-    for (int i = 0; i < rows; i++) {
+    results.reserve(static_cast<size_t>(res.size()));
+    for (int i = 0; i < res.size(); i++) {
         PostgresRow row;
-        for (int j = 0; j < cols; j++) {
-            row.columns.push_back(PQgetvalue(res, i, j));
-        }
-        results.push_back(row);
+        for (int j = 0; j < PQnfields(res.get()); j++) row.columns.emplace_back(res[i].text(j));
+        results.push_back(std::move(row));
     }
 
-    PQclear(res);
+    if (ok) *ok = true;
     return results;
 }
 
-int PostgresClient::store_memory(long long timestamp, const std::string& type, const std::string& content, const std::string& tags) {
-    std::lock_guard<std::mutex> lock(db_mutex);
-    if (!connected) return -1;
-
-    const char* paramValues[4];
-    std::string ts_str = std::to_string(timestamp);
-    paramValues[0] = ts_str.c_str();
-    paramValues[1] = type.c_str();
-    paramValues[2] = content.c_str();
-    paramValues[3] = tags.c_str();
-
-    PGresult* res = PQexecParams(conn,
-        "INSERT INTO memories (timestamp, type, content, tags) VALUES ($1, $2, $3, $4) RETURNING id",
-        4,       /* four parameters */
-        NULL,    /* let the backend deduce param types */
-        paramValues,
-        NULL,    /* text format */
-        NULL,    /* text format */
-        0);      /* text results */
-
-    if (PQresultStatus(res) != PGRES_TUPLES_OK) {
-        std::cerr << "PostgreSQL insert failed: " << PQerrorMessage(conn) << std::endl;
-        PQclear(res);
+PgResult PostgresClient::execute_prepared(const std::string& sql, std::span<const PgParam> params) {
+    if (!is_connected()) return PgResult();
+    auto lease = pool_->checkout();
+    if (!lease) return PgResult();
+    return execute_prepared(lease, sql, params);
+}
+
+PgResult PostgresClient::execute_prepared(PgConnectionPool::Lease& lease, const std::string& sql, std::span<const PgParam> params) {
+    std::vector<Oid> types;
+    std::vector<const char*> values;
+    std::vector<int> lengths, formats;
+    types.reserve(params.size());
+    values.reserve(params.size());
+    lengths.reserve(params.size());
+    formats.reserve(params.size());
+    for (const auto& p : params) {
+        types.push_back(p.type);
+        values.push_back(p.value.c_str());
+        lengths.push_back(static_cast<int>(p.value.size()));
+        formats.push_back(p.format);
+    }
+
+    const char* name = lease.statement(sql, types.data(), static_cast<int>(types.size()));
+    if (!name) return PgResult();
+    PgResult res(PQexecPrepared(lease.get(), name, static_cast<int>(values.size()), values.data(),
+                                lengths.data(), formats.data(), 1 /* binary results */));
+    if (!res.ok()) std::cerr << "PostgreSQL query failed: " << PQerrorMessage(lease.get()) << std::endl;
+    return res;
+}
+
+long long PostgresClient::copy_in(PGconn* conn, const std::string& copy_sql, std::string_view data) {
+    PgResult start(PQexec(conn, copy_sql.c_str()));
+    if (PQresultStatus(start.get()) != PGRES_COPY_IN) {
+        std::cerr << "PostgreSQL COPY failed to start: " << PQerrorMessage(conn) << std::endl;
         return -1;
     }
+    // libpq buffers and sends as it goes; chunks only bound each call
+    constexpr size_t kChunk = 1 << 20;
+    bool sent = true;
+    for (size_t offset = 0; offset < data.size() && sent; offset += kChunk) {
+        const size_t n = std::min(kChunk, data.size() - offset);
+        sent = PQputCopyData(conn, data.data() + offset, static_cast<int>(n)) == 1;
+    }
+    if (PQputCopyEnd(conn, sent ? nullptr : "client send failed") != 1) sent = false;
+
+    long long rows = -1;
+    while (PGresult* raw = PQgetResult(conn)) {
+        PgResult res(raw);
+        if (PQresultStatus(raw) == PGRES_COMMAND_OK) {
+            rows = std::strtoll(PQcmdTuples(raw), nullptr, 10);
+        } else {
+            std::cerr << "PostgreSQL COPY failed: " << PQerrorMessage(conn) << std::endl;
+        }
+    }
+    return sent ? rows : -1;
+}
+
+size_t PostgresClient::prepared_count() const {
+    return pool_ ? pool_->stats().prepared : 0;
+}
+
+std::vector<PgResult> PostgresClient::execute_pipelined(std::span<const PgStatement> statements) {
+    std::vector<PgResult> results(statements.size());
+    if (statements.empty() || !is_connected()) return results;
+    auto lease = pool_->checkout();
+    if (!lease) return results;
+    PGconn* conn = lease.get();
+
+    // Prepare outside pipeline mode: statement() waits for its reply
+    std::vector<const char*> names(statements.size());
+    for (size_t i = 0; i < statements.size(); ++i) {
+        std::vector<Oid> types;
+        for (const auto& p : statements[i].params) types.push_back(p.type);
+        names[i] = lease.statement(statements[i].sql, types.data(), static_cast<int>(types.size()));
+        if (!names[i]) return results;
+    }
+
+    if (!PQenterPipelineMode(conn)) {
+        std::cerr << "PostgreSQL pipeline mode failed: " << PQerrorMessage(conn) << std::endl;
+        return results;
+    }
+    // A sync after every statement closes its implicit transaction, so each
+    // commits (or fails) on its own. Replies are read every kPipelineDepth
+    // statements so neither side's socket buffer fills while nobody reads.
+    for (size_t begin = 0; begin < statements.size(); begin += kPipelineDepth) {
+        const size_t end = std::min(statements.size(), begin + kPipelineDepth);
+        size_t sent = begin;
+        for (; sent < end; ++sent) {
+            const auto& params = statements[sent].params;
+            std::vector<const char*> values;
+            std::vector<int> lengths, formats;
+            for (const auto& p : params) {
+                values.push_back(p.value.c_str());
+                lengths.push_back(static_cast<int>(p.value.size()));
+                formats.push_back(p.format);
+            }
+            if (!PQsendQueryPrepared(conn, names[sent], static_cast<int>(values.size()), values.data(),
+                                     lengths.data(), formats.data(), 1) ||
+                !PQpipelineSync(conn)) {
+                std::cerr << "PostgreSQL pipelined send failed: " << PQerrorMessage(conn) << std::endl;
+                break;
+            }
+        }
+
+        for (size_t i = begin; i < sent; ++i) {
+            // One result, a null separator, then the statement's sync marker
+            PgResult res(PQgetResult(conn));
+            while (PGresult* extra = PQgetResult(conn)) PQclear(extra);
+            if (!res.ok()) {
+                std::cerr << "PostgreSQL pipelined statement failed: " << PQerrorMessage(conn) << std::endl;
+            }
+            results[i] = std::move(res);
+            while (PGresult* marker = PQgetResult(conn)) {
+                const bool sync = PQresultStatus(marker) == PGRES_PIPELINE_SYNC;
+                PQclear(marker);
+                if (sync) break;
+            }
+        }
+        if (sent < end) break;
+    }
+    if (!PQexitPipelineMode(conn)) {
+        while (PGresult* res = PQgetResult(conn)) PQclear(res);
+        PQexitPipelineMode(conn);
+    }
+    return results;
+}
+
+const char* const PostgresClient::kInsertMemorySql =
+    "INSERT INTO memories (timestamp, type, content, tags, acl, strength, last_recall) "
+    "VALUES ($1, $2, $3, $4, $5, 1.0, $1) RETURNING id";
 
-    int id = std::stoi(PQgetvalue(res, 0, 0));
-    PQclear(res);
-    return id;
+int PostgresClient::store_memory(long long timestamp, const std::string& type, const std::string& content, const std::string& tags,
+                                 const std::string& acl) {
+    auto res = execute_prepared(kInsertMemorySql, {PgParam::int8(timestamp), PgParam::text(type), PgParam::text(content),
+                                                   PgParam::text(tags), PgParam::text(acl)});
+    if (res.empty()) return -1;
+    return static_cast<int>(res[0].integer(0));
 }
 #endif
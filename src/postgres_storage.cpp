@@ -4,34 +4,29 @@
 #include <stdexcept>
 #include <sstream>
 #include <vector>
+#include <cstdlib>
 
 PostgresStorage::PostgresStorage(const std::string& conn_str) 
-    : connection_string(conn_str), conn(nullptr) {}
+    : connection_string(conn_str) {}
+
+PostgresStorage::PostgresStorage(std::shared_ptr<PgConnectionPool> pool)
+    : connection_string(pool->connection_string()), pool_(std::move(pool)) {}
 
 PostgresStorage::~PostgresStorage() {
     disconnect();
 }
 
 bool PostgresStorage::connect() {
-    std::lock_guard<std::mutex> lock(db_mutex);
-    if (conn) {
-        if (PQstatus(conn) == CONNECTION_OK) return true;
-        PQfinish(conn);
-    }
-    
-    conn = PQconnectdb(connection_string.c_str());
-    if (PQstatus(conn) != CONNECTION_OK) {
-        std::cerr << "[Postgres] Connection failed: " << PQerrorMessage(conn) << std::endl;
-        PQfinish(conn);
-        conn = nullptr;
-        return false;
-    }
+    if (connected_.load(std::memory_order_acquire)) return true;
+    if (!pool_) pool_ = PgConnectionPool::shared(connection_string);
+    auto lease = pool_->checkout();
+    if (!lease) return false;
 
     // Enable pgvector extension
-    execute_non_query("CREATE EXTENSION IF NOT EXISTS vector");
+    execute_non_query(lease.get(), "CREATE EXTENSION IF NOT EXISTS vector");
 
     // Ensure table exists
-    execute_non_query(
+    execute_non_query(lease.get(),
         "CREATE TABLE IF NOT EXISTS brain_kv_store ("
         "key TEXT PRIMARY KEY, "
         "value TEXT, "
@@ -39,73 +34,149 @@ bool PostgresStorage::connect() {
     );
 
     // Ensure embedding column exists (for migration)
-    execute_non_query(
+    execute_non_query(lease.get(),
         "ALTER TABLE brain_kv_store ADD COLUMN IF NOT EXISTS embedding vector(384)"
     );
 
     // Add HNSW index for high-scale vector search
-    execute_non_query(
+    execute_non_query(lease.get(),
         "CREATE INDEX IF NOT EXISTS brain_vector_idx ON brain_kv_store "
         "USING hnsw (embedding vector_cosine_ops) WITH (m = 16, ef_construction = 64)"
     );
 
+    // Every embedding write, by any client, takes a new version from a sequence;
+    // MemoryStore's vector snapshot records the newest version it covers
+    execute_non_query(lease.get(),
+        "ALTER TABLE brain_kv_store ADD COLUMN IF NOT EXISTS embedding_version BIGINT"
+    );
+    execute_non_query(lease.get(),
+        "CREATE SEQUENCE IF NOT EXISTS brain_kv_embedding_version"
+    );
+    execute_non_query(lease.get(),
+        "CREATE OR REPLACE FUNCTION brain_kv_stamp_embedding() RETURNS trigger AS $$ BEGIN "
+        "IF TG_OP = 'INSERT' OR NEW.embedding IS DISTINCT FROM OLD.embedding THEN "
+        "NEW.embedding_version := nextval('brain_kv_embedding_version'); "
+        "END IF; RETURN NEW; END $$ LANGUAGE plpgsql"
+    );
+    execute_non_query(lease.get(),
+        "DO $$ BEGIN "
+        "IF NOT EXISTS (SELECT 1 FROM pg_trigger WHERE tgname = 'brain_kv_embedding_version') THEN "
+        "CREATE TRIGGER brain_kv_embedding_version BEFORE INSERT OR UPDATE ON brain_kv_store "
+        "FOR EACH ROW EXECUTE FUNCTION brain_kv_stamp_embedding(); "
+        "END IF; END $$"
+    );
+    execute_non_query(lease.get(),
+        "CREATE INDEX IF NOT EXISTS brain_kv_embedding_version_idx ON brain_kv_store (embedding_version)"
+    );
+
+    connected_.store(true, std::memory_order_release);
     return true;
 }
 
 void PostgresStorage::disconnect() {
-    std::lock_guard<std::mutex> lock(db_mutex);
-    if (conn) {
-        PQfinish(conn);
-        conn = nullptr;
+    rollback(); // An open transaction must not go back to the pool
+    connected_.store(false, std::memory_order_release);
+}
+
+bool PostgresStorage::acquire(Handle& handle) {
+    if (!check_status()) return false;
+    handle.pinned = std::unique_lock<std::mutex>(transaction_mutex_);
+    if (transaction_) {
+        handle.lease = &transaction_;
+        return true;
     }
+    handle.pinned.unlock();
+    handle.owned = pool_->checkout();
+    handle.lease = &handle.owned;
+    return static_cast<bool>(handle);
+}
+
+PGresult* PostgresStorage::exec_prepared(Handle& handle, const char* sql, int n_params, const char* const* values) {
+    const char* name = handle.lease->statement(sql);
+    if (!name) return nullptr;
+    return PQexecPrepared(handle.get(), name, n_params, values, nullptr, nullptr, 0);
 }
 
 void PostgresStorage::store_memory(const std::string& key, const std::string& value) {
-    if (!check_status()) return;
-    std::lock_guard<std::mutex> lock(db_mutex);
+    Handle handle;
+    if (!acquire(handle)) return;
 
     const char* paramValues[2] = { key.c_str(), value.c_str() };
-    PGresult* res = PQexecParams(conn,
+    PGresult* res = exec_prepared(handle,
         "INSERT INTO brain_kv_store (key, value) VALUES ($1, $2) "
         "ON CONFLICT (key) DO UPDATE SET value = $2",
-        2, nullptr, paramValues, nullptr, nullptr, 0);
+        2, paramValues);
 
     if (PQresultStatus(res) != PGRES_COMMAND_OK) {
-        std::cerr << "[Postgres] Store failed: " << PQerrorMessage(conn) << std::endl;
+        std::cerr << "[Postgres] Store failed: " << PQerrorMessage(handle.get()) << std::endl;
     }
     PQclear(res);
 }
 
 void PostgresStorage::store_memories_bulk(const std::map<std::string, std::string>& memories) {
-    if (!check_status() || memories.empty()) return;
-    std::lock_guard<std::mutex> lock(db_mutex);
-
-    execute_non_query("BEGIN");
+    if (memories.empty()) return;
+    Handle handle;
+    if (!acquire(handle)) return;
 
+    PgCopyBuffer rows; // The map's keys are unique, as copy_upsert needs
     for (const auto& [key, value] : memories) {
-        const char* paramValues[2] = { key.c_str(), value.c_str() };
-        PGresult* res = PQexecParams(conn,
-            "INSERT INTO brain_kv_store (key, value) VALUES ($1, $2) "
-            "ON CONFLICT (key) DO UPDATE SET value = $2",
-            2, nullptr, paramValues, nullptr, nullptr, 0);
-        
-        if (PQresultStatus(res) != PGRES_COMMAND_OK) {
-            std::cerr << "[Postgres] Bulk Store failed for key " << key << ": " << PQerrorMessage(conn) << std::endl;
-        }
-        PQclear(res);
+        rows.begin_row(3);
+        rows.add_text(key);
+        rows.add_text(value);
+        rows.add_null();
     }
 
-    execute_non_query("COMMIT");
+    const bool own_transaction = handle.lease == &handle.owned;
+    if (own_transaction) execute_non_query(handle.get(), "BEGIN");
+    const bool ok = copy_upsert(handle.get(), rows) >= 0;
+    if (!ok) std::cerr << "[Postgres] Bulk Store of " << memories.size() << " keys failed" << std::endl;
+    if (own_transaction) execute_non_query(handle.get(), ok ? "COMMIT" : "ROLLBACK");
+}
+
+long long PostgresStorage::copy_upsert(PGconn* conn, PgCopyBuffer& rows) {
+    // Session-local staging table, emptied again before the caller commits
+    PgResult staging(PQexec(conn,
+        "SET LOCAL client_min_messages = warning;"
+        "CREATE TEMP TABLE IF NOT EXISTS brain_kv_staging (key TEXT, value TEXT, embedding vector) "
+        "ON COMMIT DELETE ROWS"));
+    if (!staging.ok()) {
+        std::cerr << "[Postgres] Staging table failed: " << PQerrorMessage(conn) << std::endl;
+        return -1;
+    }
+    if (PostgresClient::copy_in(conn, "COPY brain_kv_staging (key, value, embedding) FROM STDIN (FORMAT binary)",
+                                rows.finish()) < 0) {
+        return -1;
+    }
+
+    // New keys get '' for a NULL value, as store_embedding() writes; on existing
+    // keys NULL columns leave the stored value alone. EXCLUDED cannot tell a
+    // staged NULL from '', so existing keys are updated in a second statement
+    // (which skips the rows the first one just wrote).
+    PgResult insert(PQexec(conn,
+        "INSERT INTO brain_kv_store (key, value, embedding) "
+        "SELECT key, COALESCE(value, ''), embedding FROM brain_kv_staging "
+        "ON CONFLICT (key) DO NOTHING"));
+    PgResult update = insert.ok() ? PgResult(PQexec(conn,
+        "UPDATE brain_kv_store AS kv SET value = COALESCE(s.value, kv.value), "
+        "embedding = COALESCE(s.embedding, kv.embedding) FROM brain_kv_staging s "
+        "WHERE kv.key = s.key AND ((s.value IS NOT NULL AND s.value IS DISTINCT FROM kv.value) "
+        "OR (s.embedding IS NOT NULL AND s.embedding IS DISTINCT FROM kv.embedding))")) : PgResult();
+    if (!insert.ok() || !update.ok()) {
+        std::cerr << "[Postgres] Staged upsert failed: " << PQerrorMessage(conn) << std::endl;
+        return -1;
+    }
+    const long long written = std::strtoll(PQcmdTuples(const_cast<PGresult*>(insert.get())), nullptr, 10) +
+                              std::strtoll(PQcmdTuples(const_cast<PGresult*>(update.get())), nullptr, 10);
+    PgResult truncate(PQexec(conn, "TRUNCATE brain_kv_staging"));
+    return truncate.ok() ? written : -1;
 }
 
 std::string PostgresStorage::retrieve_memory(const std::string& key) {
-    if (!check_status()) return "";
-    std::lock_guard<std::mutex> lock(db_mutex);
+    Handle handle;
+    if (!acquire(handle)) return "";
 
     const char* paramValues[1] = { key.c_str() };
-    PGresult* res = PQexecParams(conn,
-        "SELECT value FROM brain_kv_store WHERE key = $1",
-        1, nullptr, paramValues, nullptr, nullptr, 0);
+    PGresult* res = exec_prepared(handle, "SELECT value FROM brain_kv_store WHERE key = $1", 1, paramValues);
 
     std::string value;
     if (PQresultStatus(res) == PGRES_TUPLES_OK && PQntuples(res) > 0) {
@@ -144,32 +215,30 @@ static std::vector<double> string_to_vector(const std::string& s) {
 }
 
 void PostgresStorage::store_embedding(const std::string& key, const std::vector<double>& embedding) {
-    if (!check_status()) return;
-    std::lock_guard<std::mutex> lock(db_mutex);
+    Handle handle;
+    if (!acquire(handle)) return;
 
     std::string embed_str = vector_to_string(embedding);
     const char* paramValues[2] = { key.c_str(), embed_str.c_str() };
 
     // Upsert: Insert if new (with empty value), or update embedding if exists
-    PGresult* res = PQexecParams(conn,
+    PGresult* res = exec_prepared(handle,
         "INSERT INTO brain_kv_store (key, value, embedding) VALUES ($1, '', $2) "
         "ON CONFLICT (key) DO UPDATE SET embedding = $2",
-        2, nullptr, paramValues, nullptr, nullptr, 0);
+        2, paramValues);
 
     if (PQresultStatus(res) != PGRES_COMMAND_OK) {
-        std::cerr << "[Postgres] Store Embedding failed: " << PQerrorMessage(conn) << std::endl;
+        std::cerr << "[Postgres] Store Embedding failed: " << PQerrorMessage(handle.get()) << std::endl;
     }
     PQclear(res);
 }
 
 std::vector<double> PostgresStorage::retrieve_embedding(const std::string& key) {
-    if (!check_status()) return {};
-    std::lock_guard<std::mutex> lock(db_mutex);
+    Handle handle;
+    if (!acquire(handle)) return {};
 
     const char* paramValues[1] = { key.c_str() };
-    PGresult* res = PQexecParams(conn,
-        "SELECT embedding FROM brain_kv_store WHERE key = $1",
-        1, nullptr, paramValues, nullptr, nullptr, 0);
+    PGresult* res = exec_prepared(handle, "SELECT embedding FROM brain_kv_store WHERE key = $1", 1, paramValues);
 
     std::vector<double> vec;
     if (PQresultStatus(res) == PGRES_TUPLES_OK && PQntuples(res) > 0) {
@@ -181,17 +250,17 @@ std::vector<double> PostgresStorage::retrieve_embedding(const std::string& key)
 }
 
 std::vector<std::string> PostgresStorage::search_similar(const std::vector<double>& embedding, int limit) {
-    if (!check_status()) return {};
-    std::lock_guard<std::mutex> lock(db_mutex);
+    Handle handle;
+    if (!acquire(handle)) return {};
 
     std::string embed_str = vector_to_string(embedding);
     std::string limit_str = std::to_string(limit);
     const char* paramValues[2] = { embed_str.c_str(), limit_str.c_str() };
 
     // Cosine distance sort
-    PGresult* res = PQexecParams(conn,
+    PGresult* res = exec_prepared(handle,
         "SELECT key FROM brain_kv_store ORDER BY embedding <=> $1 LIMIT $2",
-        2, nullptr, paramValues, nullptr, nullptr, 0);
+        2, paramValues);
 
     std::vector<std::string> results;
     if (PQresultStatus(res) == PGRES_TUPLES_OK) {
@@ -200,7 +269,7 @@ std::vector<std::string> PostgresStorage::search_similar(const std::vector<doubl
             results.push_back(PQgetvalue(res, i, 0));
         }
     } else {
-        std::cerr << "[Postgres] Search failed: " << PQerrorMessage(conn) << std::endl;
+        std::cerr << "[Postgres] Search failed: " << PQerrorMessage(handle.get()) << std::endl;
     }
     PQclear(res);
     return results;
@@ -208,30 +277,35 @@ std::vector<std::string> PostgresStorage::search_similar(const std::vector<doubl
 
 bool PostgresStorage::begin_transaction() {
     if (!check_status()) return false;
-    execute_non_query("BEGIN");
+    std::lock_guard<std::mutex> lock(transaction_mutex_);
+    if (transaction_) return true; // Already inside one
+    transaction_ = pool_->checkout();
+    if (!transaction_) return false;
+    execute_non_query(transaction_.get(), "BEGIN");
     return true;
 }
 
 bool PostgresStorage::commit() {
-    if (!check_status()) return false;
-    execute_non_query("COMMIT");
+    std::lock_guard<std::mutex> lock(transaction_mutex_);
+    if (!transaction_) return false;
+    execute_non_query(transaction_.get(), "COMMIT");
+    transaction_.release();
     return true;
 }
 
 bool PostgresStorage::rollback() {
-    if (!check_status()) return false;
-    execute_non_query("ROLLBACK");
+    std::lock_guard<std::mutex> lock(transaction_mutex_);
+    if (!transaction_) return false;
+    execute_non_query(transaction_.get(), "ROLLBACK");
+    transaction_.release();
     return true;
 }
 
 bool PostgresStorage::check_status() {
-    if (!conn || PQstatus(conn) != CONNECTION_OK) {
-        return connect();
-    }
-    return true;
+    return connected_.load(std::memory_order_acquire) || connect();
 }
 
-void PostgresStorage::execute_non_query(const std::string& sql) {
+void PostgresStorage::execute_non_query(PGconn* conn, const std::string& sql) {
     PGresult* res = PQexec(conn, sql.c_str());
     if (PQresultStatus(res) != PGRES_COMMAND_OK) {
         std::cerr << "[Postgres] Query failed: " << PQerrorMessage(conn) << std::endl;
@@ -0,0 +1,534 @@
+#include "posting_index.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <ostream>
+#include <queue>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace dnn {
+
+    namespace {
+        void put_varint(std::vector<std::uint8_t>& out, std::uint32_t v) {
+            while (v >= 0x80) {
+                out.push_back(static_cast<std::uint8_t>(v | 0x80));
+                v >>= 7;
+            }
+            out.push_back(static_cast<std::uint8_t>(v));
+        }
+
+        // (gap - 1) << 1 | (tf > 1), then tf - 2 only when tf > 1: most terms
+        // occur once per memory, so a posting is usually a single byte
+        void put_posting(std::vector<std::uint8_t>& out, std::uint32_t gap, std::uint32_t tf) {
+            put_varint(out, (gap - 1) << 1 | (tf > 1 ? 1u : 0u));
+            if (tf > 1) put_varint(out, tf - 2);
+        }
+
+        std::uint32_t get_varint(const std::uint8_t*& p) {
+            std::uint32_t v = 0;
+            for (int shift = 0;; shift += 7) {
+                const std::uint8_t byte = *p++;
+                v |= static_cast<std::uint32_t>(byte & 0x7F) << shift;
+                if (!(byte & 0x80)) return v;
+            }
+        }
+
+        std::uint32_t get_posting(const std::uint8_t*& p, std::uint32_t& tf) {
+            const std::uint32_t v = get_varint(p);
+            tf = (v & 1) ? get_varint(p) + 2 : 1;
+            return (v >> 1) + 1;
+        }
+
+        // Snapshot layout: header, ListEntry per term, every Skip, document
+        // lengths, term strings, posting bytes. Sections are sized by the
+        // header and follow each other without padding (all stay aligned).
+        struct FileHeader {
+            char magic[4];
+            std::uint32_t version;
+            std::uint32_t term_count;
+            std::uint32_t reserved;
+            std::uint64_t documents;
+            std::uint64_t total_length;
+            std::int64_t max_doc;
+            std::uint64_t rows;
+            std::uint64_t fingerprint;
+            std::uint64_t skip_count;
+            std::uint64_t lengths_count;
+            std::uint64_t strings_bytes;
+            std::uint64_t postings_bytes;
+            std::uint64_t reserved2[5];
+        };
+        static_assert(sizeof(FileHeader) == 128, "posting index header must stay 128 bytes");
+
+        struct ListEntry {
+            std::uint64_t term_offset;  // Into the strings section
+            std::uint64_t bytes_offset; // Into the postings section
+            std::uint64_t skip_index;   // First skip of the list
+            std::uint32_t term_length;
+            std::uint32_t byte_count;
+            std::uint32_t count;
+            std::int32_t last;
+        };
+        static_assert(sizeof(ListEntry) == 40, "posting index entries must stay 40 bytes");
+    } // namespace
+
+    PostingIndex::Cursor::Cursor(const List* list) : list_(list) {
+        if (list_ && list_->count > 0) load(0);
+    }
+
+    void PostingIndex::Cursor::load(std::size_t block) {
+        block_index_ = block;
+        pos_ = 0;
+        size_ = 0;
+        const auto skips = list_->skip_list();
+        if (block >= skips.size()) return;
+        const Skip& skip = skips[block];
+        const std::uint8_t* p = list_->encoded().data() + skip.offset;
+        const std::size_t n = std::min<std::size_t>(kBlockSize, list_->count - block * kBlockSize);
+        int prev = skip.base;
+        for (std::size_t i = 0; i < n; ++i) {
+            prev += static_cast<int>(get_posting(p, freq_[i]));
+            block_[i] = prev;
+        }
+        size_ = n;
+    }
+
+    void PostingIndex::Cursor::next() {
+        if (++pos_ < size_) return;
+        load(block_index_ + 1);
+    }
+
+    void PostingIndex::Cursor::seek(int target) {
+        if (!valid() || doc() >= target) return;
+        if (block_[size_ - 1] < target) {
+            // Last block whose base is below target holds the first id >= target
+            const auto skips = list_->skip_list();
+            auto it = std::partition_point(skips.begin() + static_cast<std::ptrdiff_t>(block_index_) + 1, skips.end(),
+                                           [target](const Skip& s) { return s.base < target; });
+            const std::size_t block = static_cast<std::size_t>(it - skips.begin()) - 1;
+            if (block == block_index_) { // Target is past the last id
+                pos_ = size_;
+                return;
+            }
+            load(block);
+        }
+        // Gallop: probe 1, 2, 4, ... ahead, then binary search the last step
+        std::size_t lo = pos_, step = 1;
+        while (lo + step < size_ && block_[lo + step] < target) {
+            lo += step;
+            step <<= 1;
+        }
+        const std::size_t hi = std::min(size_, lo + step + 1);
+        pos_ = static_cast<std::size_t>(std::lower_bound(block_.begin() + static_cast<std::ptrdiff_t>(lo),
+                                                         block_.begin() + static_cast<std::ptrdiff_t>(hi), target) -
+                                        block_.begin());
+    }
+
+    PostingIndex::TermId PostingIndex::intern(std::string_view term) {
+        auto it = ids_.find(term);
+        if (it != ids_.end()) return it->second;
+        const TermId id = static_cast<TermId>(terms_.size());
+        it = ids_.emplace(std::string(term), id).first;
+        terms_.push_back(it->first);
+        lists_.emplace_back();
+        return id;
+    }
+
+    PostingIndex::TermId PostingIndex::find(std::string_view term) const {
+        auto it = ids_.find(term);
+        return it == ids_.end() ? kNoTerm : it->second;
+    }
+
+    void PostingIndex::unmap(List& list) {
+        if (!list.mapped) return;
+        list.bytes.assign(list.mapped_bytes.begin(), list.mapped_bytes.end());
+        list.skips.assign(list.mapped_skips.begin(), list.mapped_skips.end());
+        list.mapped = false;
+        list.mapped_bytes = {};
+        list.mapped_skips = {};
+    }
+
+    void PostingIndex::append(List& list, int doc, std::uint32_t tf) {
+        if (list.count % kBlockSize == 0) {
+            list.skips.push_back({list.last, static_cast<std::uint32_t>(list.bytes.size())});
+        }
+        put_posting(list.bytes, static_cast<std::uint32_t>(doc - list.last), std::max<std::uint32_t>(tf, 1));
+        list.last = doc;
+        ++list.count;
+    }
+
+    std::vector<std::pair<int, std::uint32_t>> PostingIndex::decode(const List& list) {
+        std::vector<std::pair<int, std::uint32_t>> postings;
+        postings.reserve(list.count);
+        const std::uint8_t* p = list.encoded().data();
+        int prev = -1;
+        for (std::uint32_t i = 0; i < list.count; ++i) {
+            std::uint32_t tf = 1;
+            prev += static_cast<int>(get_posting(p, tf));
+            postings.emplace_back(prev, tf);
+        }
+        return postings;
+    }
+
+    void PostingIndex::add(TermId term, int doc, std::uint32_t tf) {
+        if (doc < 0) return;
+        List& list = lists_[term];
+        if (doc > list.last) {
+            unmap(list);
+            append(list, doc, tf);
+            return;
+        }
+        // Out of order (a concurrent writer committed later): re-encode
+        auto postings = decode(list);
+        auto pos = std::lower_bound(postings.begin(), postings.end(), doc,
+                                    [](const auto& p, int id) { return p.first < id; });
+        if (pos != postings.end() && pos->first == doc) return;
+        postings.insert(pos, {doc, tf});
+        list = List{};
+        for (const auto& [id, f] : postings) append(list, id, f);
+    }
+
+    void PostingIndex::add_document(int doc, std::span<const std::string> tokens) {
+        if (doc < 0 || tokens.empty()) return;
+        if (static_cast<std::size_t>(doc) >= doc_lengths_.size()) doc_lengths_.resize(static_cast<std::size_t>(doc) + 1, 0);
+        if (doc_lengths_[static_cast<std::size_t>(doc)] != 0) return; // Indexed already
+        doc_lengths_[static_cast<std::size_t>(doc)] = static_cast<std::uint32_t>(tokens.size());
+        ++documents_;
+        total_length_ += tokens.size();
+
+        std::vector<std::pair<TermId, std::uint32_t>> counts; // Few distinct terms per memory
+        for (const auto& token : tokens) {
+            const TermId term = intern(token);
+            auto it = std::find_if(counts.begin(), counts.end(), [term](const auto& c) { return c.first == term; });
+            if (it == counts.end()) counts.emplace_back(term, 1);
+            else ++it->second;
+        }
+        for (const auto& [term, tf] : counts) add(term, doc, tf);
+    }
+
+    std::uint32_t PostingIndex::document_length(int doc) const {
+        return doc >= 0 && static_cast<std::size_t>(doc) < doc_lengths_.size() ? doc_lengths_[static_cast<std::size_t>(doc)] : 0;
+    }
+
+    std::size_t PostingIndex::doc_frequency(TermId term) const {
+        return term < lists_.size() ? lists_[term].count : 0;
+    }
+
+    PostingIndex::Cursor PostingIndex::cursor(TermId term) const {
+        return Cursor(term < lists_.size() ? &lists_[term] : nullptr);
+    }
+
+    std::vector<int> PostingIndex::postings(TermId term) const {
+        std::vector<int> ids;
+        if (term >= lists_.size()) return ids;
+        ids.reserve(lists_[term].count);
+        for (Cursor c(&lists_[term]); c.valid(); c.next()) ids.push_back(c.doc());
+        return ids;
+    }
+
+    std::vector<int> PostingIndex::newest(TermId term, std::size_t n) const {
+        std::vector<int> out;
+        if (term >= lists_.size() || n == 0) return out;
+        // Walk blocks from the end; each decodes independently from its skip
+        Cursor c(&lists_[term]);
+        for (std::size_t block = c.list_->skip_list().size(); block-- > 0 && out.size() < n;) {
+            c.load(block);
+            for (std::size_t i = c.size_; i-- > 0 && out.size() < n;) out.push_back(c.block_[i]);
+        }
+        return out;
+    }
+
+    std::size_t PostingIndex::intersect_count(TermId a, TermId b) const {
+        if (doc_frequency(a) > doc_frequency(b)) std::swap(a, b);
+        Cursor small = cursor(a), large = cursor(b);
+        std::size_t count = 0;
+        while (small.valid() && large.valid()) {
+            large.seek(small.doc());
+            if (!large.valid()) break;
+            if (large.doc() == small.doc()) {
+                ++count;
+                small.next();
+            } else {
+                small.seek(large.doc());
+            }
+        }
+        return count;
+    }
+
+    std::vector<PostingIndex::Hit> PostingIndex::search(std::span<const QueryTerm> terms, std::size_t k, bool require_all,
+                                                        Bm25 params) const {
+        std::vector<Hit> hits;
+        if (k == 0) return hits;
+
+        struct Scorer {
+            Cursor cursor;
+            double weight; // Query weight times IDF
+            std::size_t df;
+        };
+        std::vector<Scorer> scorers;
+        const double n = static_cast<double>(std::max<std::size_t>(documents_, 1));
+        for (const auto& q : terms) {
+            const std::size_t df = doc_frequency(q.term);
+            if (df == 0) {
+                if (require_all) return hits;
+                continue;
+            }
+            auto same = std::find_if(scorers.begin(), scorers.end(), [&](const Scorer& s) { return s.cursor.list_ == &lists_[q.term]; });
+            const double idf = std::log(1.0 + (std::max(n, static_cast<double>(df)) - static_cast<double>(df) + 0.5) /
+                                                  (static_cast<double>(df) + 0.5));
+            if (same != scorers.end()) same->weight += q.weight * idf; // Repeated query term
+            else scorers.push_back({cursor(q.term), q.weight * idf, df});
+        }
+        if (scorers.empty()) return hits;
+
+        const double avg_length = documents_ ? static_cast<double>(total_length_) / static_cast<double>(documents_) : 1.0;
+        auto score = [&](const Scorer& s, int doc) {
+            const double tf = s.cursor.freq();
+            const std::uint32_t length = document_length(doc);
+            const double norm = length ? static_cast<double>(length) / avg_length : 1.0;
+            return s.weight * tf * (params.k1 + 1.0) / (tf + params.k1 * (1.0 - params.b + params.b * norm));
+        };
+
+        // Min-heap of the best k so far: weakest (lowest score, then oldest) on top
+        auto weaker = [](const Hit& a, const Hit& b) { return a.score > b.score || (a.score == b.score && a.doc > b.doc); };
+        std::priority_queue<Hit, std::vector<Hit>, decltype(weaker)> best(weaker);
+        auto offer = [&](int doc, double s) {
+            if (best.size() < k) {
+                best.push({doc, s});
+            } else if (weaker(Hit{doc, s}, best.top())) {
+                best.pop();
+                best.push({doc, s});
+            }
+        };
+
+        if (require_all) {
+            // Rarest list leads; the others gallop to its candidates
+            std::sort(scorers.begin(), scorers.end(), [](const Scorer& a, const Scorer& b) { return a.df < b.df; });
+            Cursor& lead = scorers[0].cursor;
+            while (lead.valid()) {
+                const int candidate = lead.doc();
+                int next = candidate;
+                for (std::size_t i = 1; i < scorers.size() && next == candidate; ++i) {
+                    Cursor& c = scorers[i].cursor;
+                    c.seek(candidate);
+                    next = c.valid() ? c.doc() : -1;
+                }
+                if (next == -1) break; // A list ran out
+                if (next != candidate) {
+                    lead.seek(next);
+                    continue;
+                }
+                double s = 0.0;
+                for (const auto& scorer : scorers) s += score(scorer, candidate);
+                offer(candidate, s);
+                lead.next();
+            }
+        } else {
+            // Document at a time over the union
+            while (true) {
+                int doc = -1;
+                for (const auto& scorer : scorers) {
+                    if (scorer.cursor.valid() && (doc == -1 || scorer.cursor.doc() < doc)) doc = scorer.cursor.doc();
+                }
+                if (doc == -1) break;
+                double s = 0.0;
+                for (auto& scorer : scorers) {
+                    if (!scorer.cursor.valid() || scorer.cursor.doc() != doc) continue;
+                    s += score(scorer, doc);
+                    scorer.cursor.next();
+                }
+                offer(doc, s);
+            }
+        }
+
+        hits.resize(best.size());
+        for (std::size_t i = hits.size(); i-- > 0; best.pop()) hits[i] = best.top();
+        return hits;
+    }
+
+    void PostingIndex::for_each_term(const std::function<void(TermId, std::string_view, std::size_t)>& fn) const {
+        for (TermId id = 0; id < lists_.size(); ++id) {
+            if (lists_[id].count > 0) fn(id, terms_[id], lists_[id].count);
+        }
+    }
+
+    bool PostingIndex::equivalent(const PostingIndex& other) const {
+        if (documents_ != other.documents_ || total_length_ != other.total_length_) return false;
+        const std::size_t lengths = std::max(doc_lengths_.size(), other.doc_lengths_.size());
+        for (std::size_t doc = 0; doc < lengths; ++doc) {
+            if (document_length(static_cast<int>(doc)) != other.document_length(static_cast<int>(doc))) return false;
+        }
+        std::size_t terms = 0, other_terms = 0;
+        for (TermId id = 0; id < lists_.size(); ++id) {
+            if (lists_[id].count == 0) continue;
+            ++terms;
+            const TermId match = other.find(terms_[id]);
+            if (match == kNoTerm || decode(lists_[id]) != decode(other.lists_[match])) return false;
+        }
+        for (const auto& list : other.lists_) other_terms += list.count > 0;
+        return terms == other_terms;
+    }
+
+    bool PostingIndex::write(std::ostream& os, const SnapshotInfo& info) const {
+        FileHeader h{};
+        std::memcpy(h.magic, kMagic, sizeof(kMagic));
+        h.version = kVersion;
+        h.term_count = static_cast<std::uint32_t>(lists_.size());
+        h.documents = documents_;
+        h.total_length = total_length_;
+        h.max_doc = info.max_doc;
+        h.rows = info.rows;
+        h.fingerprint = info.fingerprint;
+        h.lengths_count = doc_lengths_.size();
+
+        std::vector<ListEntry> entries(lists_.size());
+        for (TermId id = 0; id < lists_.size(); ++id) {
+            const List& list = lists_[id];
+            entries[id] = {h.strings_bytes, h.postings_bytes, h.skip_count, static_cast<std::uint32_t>(terms_[id].size()),
+                           static_cast<std::uint32_t>(list.encoded().size()), list.count, list.last};
+            h.strings_bytes += terms_[id].size();
+            h.postings_bytes += list.encoded().size();
+            h.skip_count += list.skip_list().size();
+        }
+
+        os.write(reinterpret_cast<const char*>(&h), sizeof(h));
+        os.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(ListEntry)));
+        for (const auto& list : lists_) {
+            const auto skips = list.skip_list();
+            os.write(reinterpret_cast<const char*>(skips.data()), static_cast<std::streamsize>(skips.size_bytes()));
+        }
+        os.write(reinterpret_cast<const char*>(doc_lengths_.data()),
+                 static_cast<std::streamsize>(doc_lengths_.size() * sizeof(std::uint32_t)));
+        for (const auto& term : terms_) os.write(term.data(), static_cast<std::streamsize>(term.size()));
+        for (const auto& list : lists_) {
+            const auto bytes = list.encoded();
+            os.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        }
+        return static_cast<bool>(os);
+    }
+
+    bool PostingIndex::map_file(const std::string& path, SnapshotInfo& info) {
+        clear();
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return false;
+
+        struct stat st {};
+        if (::fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(FileHeader)) {
+            ::close(fd);
+            return false;
+        }
+        const std::size_t size = static_cast<std::size_t>(st.st_size);
+        void* base = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (base == MAP_FAILED) return false;
+        std::shared_ptr<const void> mapping(base, [size](const void* p) { ::munmap(const_cast<void*>(p), size); });
+
+        FileHeader h;
+        std::memcpy(&h, base, sizeof(h));
+        if (std::memcmp(h.magic, kMagic, sizeof(kMagic)) != 0 || h.version != kVersion) return false;
+
+        // Bound each count by the bytes left before multiplying, so offsets cannot overflow
+        std::size_t offset = sizeof(FileHeader);
+        auto section = [&](std::uint64_t count, std::size_t unit) {
+            if (count > (size - offset) / unit) return false;
+            offset += static_cast<std::size_t>(count) * unit;
+            return true;
+        };
+        const std::size_t entries_offset = offset;
+        if (!section(h.term_count, sizeof(ListEntry))) return false;
+        const std::size_t skips_offset = offset;
+        if (!section(h.skip_count, sizeof(Skip))) return false;
+        const std::size_t lengths_offset = offset;
+        if (!section(h.lengths_count, sizeof(std::uint32_t))) return false;
+        const std::size_t strings_offset = offset;
+        if (!section(h.strings_bytes, 1)) return false;
+        const std::size_t postings_offset = offset;
+        if (!section(h.postings_bytes, 1) || offset != size) return false;
+
+        const char* bytes = static_cast<const char*>(base);
+        const auto* entries = reinterpret_cast<const ListEntry*>(bytes + entries_offset);
+        const auto* skips = reinterpret_cast<const Skip*>(bytes + skips_offset);
+        const auto* lengths = reinterpret_cast<const std::uint32_t*>(bytes + lengths_offset);
+        const auto* postings = reinterpret_cast<const std::uint8_t*>(bytes + postings_offset);
+
+        ids_.reserve(h.term_count);
+        terms_.reserve(h.term_count);
+        lists_.resize(h.term_count);
+        for (TermId id = 0; id < h.term_count; ++id) {
+            const ListEntry& e = entries[id];
+            const std::uint64_t blocks = (std::uint64_t{e.count} + kBlockSize - 1) / kBlockSize;
+            // Layout only: postings are trusted (snapshots are replaced atomically; verify by rebuilding)
+            bool ok = e.term_offset <= h.strings_bytes && e.term_length <= h.strings_bytes - e.term_offset &&
+                      e.bytes_offset <= h.postings_bytes && e.byte_count <= h.postings_bytes - e.bytes_offset &&
+                      e.skip_index <= h.skip_count && blocks <= h.skip_count - e.skip_index;
+            if (ok && e.count > 0) {
+                ok = e.last >= 0 && skips[e.skip_index].base == -1 && skips[e.skip_index].offset == 0 &&
+                     skips[e.skip_index + blocks - 1].offset < e.byte_count;
+            }
+            if (!ok) {
+                clear();
+                return false;
+            }
+            auto [it, inserted] = ids_.emplace(std::string(bytes + strings_offset + e.term_offset, e.term_length), id);
+            if (!inserted) { // Duplicate term
+                clear();
+                return false;
+            }
+            terms_.push_back(it->first);
+            List& list = lists_[id];
+            list.count = e.count;
+            list.last = e.last;
+            list.mapped = true;
+            list.mapped_bytes = {postings + e.bytes_offset, e.byte_count};
+            list.mapped_skips = {skips + e.skip_index, static_cast<std::size_t>(blocks)};
+        }
+        doc_lengths_.assign(lengths, lengths + h.lengths_count);
+        documents_ = static_cast<std::size_t>(h.documents);
+        total_length_ = h.total_length;
+        mapping_ = std::move(mapping);
+        mapping_bytes_ = size;
+        info = {h.max_doc, h.rows, h.fingerprint};
+        return true;
+    }
+
+    void PostingIndex::clear() {
+        ids_.clear();
+        terms_.clear();
+        lists_.clear();
+        doc_lengths_.clear();
+        documents_ = 0;
+        total_length_ = 0;
+        mapping_.reset();
+        mapping_bytes_ = 0;
+    }
+
+    void PostingIndex::shrink_to_fit() {
+        for (auto& list : lists_) {
+            list.bytes.shrink_to_fit();
+            list.skips.shrink_to_fit();
+        }
+        lists_.shrink_to_fit();
+        terms_.shrink_to_fit();
+        doc_lengths_.shrink_to_fit();
+    }
+
+    PostingIndex::Stats PostingIndex::stats() const {
+        Stats s;
+        s.terms = terms_.size();
+        s.documents = documents_;
+        for (const auto& list : lists_) {
+            s.postings += list.count;
+            s.posting_bytes += list.mapped ? list.mapped_bytes.size() + list.mapped_skips.size_bytes()
+                                           : list.bytes.capacity() + list.skips.capacity() * sizeof(Skip);
+        }
+        s.mapped_bytes = mapping_bytes_;
+        s.bytes = s.posting_bytes + lists_.capacity() * sizeof(List) + terms_.capacity() * sizeof(std::string_view) +
+                  doc_lengths_.capacity() * sizeof(std::uint32_t);
+        for (const auto& [term, id] : ids_) s.bytes += sizeof(std::pair<const std::string, TermId>) + sizeof(void*) + term.capacity();
+        return s;
+    }
+
+} // namespace dnn
@@ -0,0 +1,296 @@
+#include "recall_cache.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+namespace dnn {
+
+    RecallCache::RecallCache(Options options, std::shared_ptr<RedisClient> l2)
+        : options_(std::move(options)), shards_(std::bit_ceil(std::max<std::size_t>(options_.shards, 1))), l2_(std::move(l2)) {
+        options_.shards = shards_.size();
+        shard_capacity_ = std::max<std::size_t>((options_.capacity + shards_.size() - 1) / shards_.size(), 1);
+    }
+
+    void RecallCache::set_l2(std::shared_ptr<RedisClient> l2) {
+        std::lock_guard<std::mutex> lock(l2_mutex_);
+        l2_ = std::move(l2);
+    }
+
+    std::shared_ptr<RedisClient> RecallCache::l2() const {
+        std::lock_guard<std::mutex> lock(l2_mutex_);
+        return l2_;
+    }
+
+    RecallCache::Shard& RecallCache::shard_for(const std::string& key) {
+        return shards_[std::hash<std::string>{}(key) & (shards_.size() - 1)];
+    }
+
+    std::optional<std::string> RecallCache::lookup(Shard& shard, const std::string& key, Clock::time_point now) {
+        auto it = shard.index.find(key);
+        if (it == shard.index.end()) return std::nullopt;
+        if (now >= it->second->expires) {
+            ++shard.stats.expired;
+            shard.lru.erase(it->second);
+            shard.index.erase(it);
+            return std::nullopt;
+        }
+        shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+        return it->second->value;
+    }
+
+    void RecallCache::insert(Shard& shard, const std::string& key, std::string value, Clock::time_point now) {
+        const auto expires = now + options_.ttl;
+        auto it = shard.index.find(key);
+        if (it != shard.index.end()) {
+            it->second->value = std::move(value);
+            it->second->expires = expires;
+            shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+            return;
+        }
+        shard.lru.push_front({key, std::move(value), expires});
+        shard.index.emplace(key, shard.lru.begin());
+        while (shard.lru.size() > shard_capacity_) {
+            shard.index.erase(shard.lru.back().key);
+            shard.lru.pop_back();
+            ++shard.stats.evictions;
+        }
+    }
+
+    std::optional<std::string> RecallCache::get(const std::string& key) {
+        Shard& shard = shard_for(key);
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            if (auto value = lookup(shard, key, Clock::now())) {
+                ++shard.stats.hits;
+                return value;
+            }
+        }
+        std::optional<std::string> value;
+        if (auto redis = l2()) value = redis->get(options_.l2_prefix + key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (!value) {
+            ++shard.stats.misses;
+            return std::nullopt;
+        }
+        ++shard.stats.l2_hits;
+        insert(shard, key, *value, Clock::now());
+        return value;
+    }
+
+    void RecallCache::put(const std::string& key, std::string value) {
+        if (auto redis = l2()) redis->set(options_.l2_prefix + key, value, l2_ttl_seconds());
+        Shard& shard = shard_for(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        insert(shard, key, std::move(value), Clock::now());
+    }
+
+    std::optional<std::string> RecallCache::get_or_load(const std::string& key, const Loader& load) {
+        Shard& shard = shard_for(key);
+        std::promise<std::optional<std::string>> promise;
+        std::shared_ptr<Flight> flight;
+        bool leader = false;
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            if (auto value = lookup(shard, key, Clock::now())) {
+                ++shard.stats.hits;
+                return value;
+            }
+            auto it = shard.loading.find(key);
+            if (it != shard.loading.end()) {
+                ++shard.stats.coalesced;
+                flight = it->second;
+            } else {
+                flight = std::make_shared<Flight>();
+                flight->result = promise.get_future().share();
+                shard.loading.emplace(key, flight);
+                leader = true;
+            }
+        }
+        if (!leader) return flight->result.get(); // Rethrows the leader's exception
+
+        // This caller loads: L2 first, then the loader, both without the shard lock
+        std::optional<std::string> value;
+        bool from_l2 = false;
+        // Retires the flight; true if the value may stay cached
+        auto finish = [&] {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            auto it = shard.loading.find(key);
+            if (it != shard.loading.end() && it->second == flight) shard.loading.erase(it);
+            ++(from_l2 ? shard.stats.l2_hits : shard.stats.misses);
+            if (value && flight->cacheable) insert(shard, key, *value, Clock::now());
+            return flight->cacheable;
+        };
+        auto redis = l2();
+        try {
+            if (redis) value = redis->get(options_.l2_prefix + key);
+            from_l2 = value.has_value();
+            if (!value) value = load();
+        } catch (...) {
+            value.reset();
+            finish();
+            promise.set_exception(std::current_exception());
+            throw;
+        }
+
+        // Written to L2 before the final check: an invalidation overlapping the
+        // load marks the flight before its DEL, so a stale SET is deleted again
+        const bool wrote_l2 = value && !from_l2 && redis;
+        if (wrote_l2) redis->set(options_.l2_prefix + key, *value, l2_ttl_seconds());
+        if (!finish() && wrote_l2) redis->del({options_.l2_prefix + key});
+        promise.set_value(value);
+        return value;
+    }
+
+    void RecallCache::invalidate(std::span<const std::string> keys) {
+        if (keys.empty()) return;
+        for (const auto& key : keys) {
+            Shard& shard = shard_for(key);
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            auto it = shard.index.find(key);
+            if (it != shard.index.end()) {
+                shard.lru.erase(it->second);
+                shard.index.erase(it);
+                ++shard.stats.invalidations;
+            }
+            // Retire an overlapping load: its caller still gets its result, but
+            // later callers start a fresh load instead of joining a stale one
+            auto flight = shard.loading.find(key);
+            if (flight != shard.loading.end()) {
+                flight->second->cacheable = false;
+                shard.loading.erase(flight);
+            }
+        }
+        if (auto redis = l2()) {
+            std::vector<std::string> prefixed;
+            prefixed.reserve(keys.size());
+            for (const auto& key : keys) prefixed.push_back(options_.l2_prefix + key);
+            redis->del(prefixed);
+        }
+    }
+
+    void RecallCache::clear() {
+        for (auto& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.stats.invalidations += shard.lru.size();
+            shard.lru.clear();
+            shard.index.clear();
+            for (auto& [key, flight] : shard.loading) flight->cacheable = false;
+            shard.loading.clear();
+        }
+        if (auto redis = l2()) redis->del_matching(options_.l2_prefix + "*");
+    }
+
+    RecallCache::Stats RecallCache::stats() const {
+        Stats total;
+        for (const auto& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            total.hits += shard.stats.hits;
+            total.l2_hits += shard.stats.l2_hits;
+            total.misses += shard.stats.misses;
+            total.coalesced += shard.stats.coalesced;
+            total.evictions += shard.stats.evictions;
+            total.expired += shard.stats.expired;
+            total.invalidations += shard.stats.invalidations;
+            total.entries += shard.lru.size();
+        }
+        return total;
+    }
+
+    int RecallCache::l2_ttl_seconds() const {
+        return static_cast<int>(std::max<std::chrono::seconds::rep>(
+            std::chrono::ceil<std::chrono::seconds>(options_.ttl).count(), 1));
+    }
+
+    namespace {
+        void put_u32(std::string& out, std::uint32_t v) {
+            for (int i = 0; i < 4; ++i) out += static_cast<char>((v >> (8 * i)) & 0xFF);
+        }
+        void put_u64(std::string& out, std::uint64_t v) {
+            for (int i = 0; i < 8; ++i) out += static_cast<char>((v >> (8 * i)) & 0xFF);
+        }
+        void put_f64(std::string& out, double v) {
+            std::uint64_t bits;
+            std::memcpy(&bits, &v, sizeof(bits));
+            put_u64(out, bits);
+        }
+        void put_bytes(std::string& out, const std::string& v) {
+            put_u32(out, static_cast<std::uint32_t>(v.size()));
+            out += v;
+        }
+
+        // Reads fields in order; any short read leaves it failed
+        struct Reader {
+            std::string_view in;
+            bool ok = true;
+
+            std::uint64_t fixed(int bytes) {
+                if (!ok || in.size() < static_cast<std::size_t>(bytes)) {
+                    ok = false;
+                    return 0;
+                }
+                std::uint64_t v = 0;
+                for (int i = 0; i < bytes; ++i) v |= static_cast<std::uint64_t>(static_cast<unsigned char>(in[i])) << (8 * i);
+                in.remove_prefix(bytes);
+                return v;
+            }
+            double f64() {
+                const std::uint64_t bits = fixed(8);
+                double v;
+                std::memcpy(&v, &bits, sizeof(v));
+                return v;
+            }
+            std::string bytes() {
+                const auto size = fixed(4);
+                if (!ok || in.size() < size) {
+                    ok = false;
+                    return {};
+                }
+                std::string v(in.substr(0, size));
+                in.remove_prefix(size);
+                return v;
+            }
+        };
+    }
+
+    std::string encode_memories(std::span<const Memory> memories) {
+        std::string out;
+        std::size_t size = 4;
+        for (const auto& m : memories) size += 52 + m.type.size() + m.content.size() + m.tags.size() + m.acl_label.size();
+        out.reserve(size);
+        put_u32(out, static_cast<std::uint32_t>(memories.size()));
+        for (const auto& m : memories) {
+            put_u32(out, static_cast<std::uint32_t>(m.id));
+            put_u64(out, static_cast<std::uint64_t>(m.timestamp));
+            put_f64(out, m.strength);
+            put_u64(out, static_cast<std::uint64_t>(m.last_recall_time));
+            put_f64(out, m.score);
+            put_bytes(out, m.type);
+            put_bytes(out, m.content);
+            put_bytes(out, m.tags);
+            put_bytes(out, m.acl_label);
+        }
+        return out;
+    }
+
+    std::optional<std::vector<Memory>> decode_memories(std::string_view bytes) {
+        Reader reader{bytes};
+        const auto count = reader.fixed(4);
+        // Each memory takes at least 52 bytes, which bounds a corrupt count
+        if (!reader.ok || count > reader.in.size() / 52) return std::nullopt;
+        std::vector<Memory> memories(count);
+        for (auto& m : memories) {
+            m.id = static_cast<int>(static_cast<std::uint32_t>(reader.fixed(4)));
+            m.timestamp = static_cast<long long>(reader.fixed(8));
+            m.strength = reader.f64();
+            m.last_recall_time = static_cast<long long>(reader.fixed(8));
+            m.score = reader.f64();
+            m.type = reader.bytes();
+            m.content = reader.bytes();
+            m.tags = reader.bytes();
+            m.acl_label = reader.bytes();
+        }
+        if (!reader.ok || !reader.in.empty()) return std::nullopt;
+        return memories;
+    }
+
+} // namespace dnn
@@ -0,0 +1,112 @@
+#include "response_cache.hpp"
+#include <algorithm>
+#include <cctype>
+
+namespace dnn {
+
+    void ResponseCache::configure(Options options) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        options_ = options;
+        if (!options_.enabled) {
+            for (auto& entry : lru_) retire(entry);
+            lru_.clear();
+            index_.clear();
+        } else {
+            evict_to(options_.capacity);
+        }
+    }
+
+    std::string ResponseCache::normalise(const std::string& input) {
+        std::string out;
+        out.reserve(input.size());
+        bool space = false;
+        for (unsigned char c : input) {
+            if (std::isspace(c)) {
+                space = !out.empty();
+                continue;
+            }
+            if (space) out += ' ';
+            space = false;
+            out += static_cast<char>(std::tolower(c));
+        }
+        while (!out.empty() && (out.back() == '.' || out.back() == '!' || out.back() == '?')) out.pop_back();
+        return out;
+    }
+
+    std::optional<std::string> ResponseCache::lookup(const std::string& key, std::uint64_t epoch, Clock::time_point now) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!options_.enabled) return std::nullopt;
+        auto it = index_.find(key);
+        if (it == index_.end()) {
+            ++stats_.misses;
+            return std::nullopt;
+        }
+        Entry& entry = *it->second;
+        if (entry.epoch != epoch || now - entry.stored > options_.ttl) {
+            ++stats_.misses;
+            ++stats_.stale;
+            retire(entry);
+            lru_.erase(it->second);
+            index_.erase(it);
+            return std::nullopt;
+        }
+        ++stats_.hits;
+        if (options_.learn_on_hit) ++entry.unlearned_hits;
+        lru_.splice(lru_.begin(), lru_, it->second);
+        return entry.response;
+    }
+
+    void ResponseCache::insert(const std::string& key, std::string input, std::string response, std::uint64_t epoch, Clock::time_point now) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!options_.enabled || options_.capacity == 0) return;
+        auto it = index_.find(key);
+        if (it != index_.end()) {
+            retire(*it->second);
+            lru_.erase(it->second);
+            index_.erase(it);
+        }
+        lru_.push_front(Entry{key, std::move(input), std::move(response), epoch, now, 0});
+        index_[key] = lru_.begin();
+        evict_to(options_.capacity);
+    }
+
+    void ResponseCache::evict_to(std::size_t size) {
+        while (lru_.size() > size) {
+            retire(lru_.back());
+            index_.erase(lru_.back().key);
+            lru_.pop_back();
+            ++stats_.evictions;
+        }
+    }
+
+    void ResponseCache::retire(Entry& entry) {
+        for (; entry.unlearned_hits > 0 && retired_hits_.size() < kMaxRetiredHits; --entry.unlearned_hits) {
+            retired_hits_.emplace_back(entry.input, entry.response);
+        }
+    }
+
+    void ResponseCache::clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& entry : lru_) retire(entry);
+        lru_.clear();
+        index_.clear();
+    }
+
+    std::vector<std::pair<std::string, std::string>> ResponseCache::take_hit_pairs() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<std::pair<std::string, std::string>> pairs = std::move(retired_hits_);
+        retired_hits_.clear();
+        for (auto& entry : lru_) {
+            for (; entry.unlearned_hits > 0; --entry.unlearned_hits) pairs.emplace_back(entry.input, entry.response);
+        }
+        return pairs;
+    }
+
+    ResponseCache::Stats ResponseCache::stats() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Stats s = stats_;
+        s.entries = lru_.size();
+        return s;
+    }
+
+} // namespace dnn
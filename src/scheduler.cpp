@@ -0,0 +1,277 @@
+#include "scheduler.hpp"
+#include <algorithm>
+#include <iostream>
+
+namespace dnn {
+
+    Scheduler::Scheduler(std::size_t workers, std::size_t async_workers)
+        : worker_count_(std::max<std::size_t>(1, workers)),
+          async_worker_count_(std::max<std::size_t>(1, async_workers)) {}
+
+
+    Scheduler::Scheduler(std::shared_ptr<VirtualClock> clock)
+        : worker_count_(0), async_worker_count_(0), clock_(std::move(clock)) {}
+
+    Scheduler::~Scheduler() {
+        stop();
+    }
+
+    void Scheduler::push_due(const std::string& name, Job& job) {
+        heap_.push_back({job.next_due, name, job.generation});
+        std::push_heap(heap_.begin(), heap_.end(), std::greater<>());
+    }
+
+    void Scheduler::add_job(const std::string& name, Duration period, JobFn fn,
+                            Duration deadline, bool run_immediately) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            Job& job = jobs_[name];
+            job.fn = std::move(fn);
+            job.stats.name = name;
+            job.stats.period = std::max(period, Duration{1});
+            job.stats.deadline = deadline.count() > 0 ? deadline : job.stats.period;
+            job.next_due = now() + (run_immediately ? Duration{0} : job.stats.period);
+            ++job.generation;
+            push_due(name, job);
+        }
+        dispatch_cv_.notify_one();
+    }
+
+    bool Scheduler::remove_job(const std::string& name) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        // Stale heap entries are discarded by the dispatcher on lookup
+        return jobs_.erase(name) > 0;
+    }
+
+    bool Scheduler::set_period(const std::string& name, Duration period) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = jobs_.find(name);
+            if (it == jobs_.end()) return false;
+            Job& job = it->second;
+            bool deadline_follows = job.stats.deadline == job.stats.period;
+            job.stats.period = std::max(period, Duration{1});
+            if (deadline_follows) job.stats.deadline = job.stats.period;
+            job.next_due = now() + job.stats.period;
+            ++job.generation;
+            push_due(name, job);
+        }
+        dispatch_cv_.notify_one();
+        return true;
+    }
+
+    std::future<void> Scheduler::submit_async(const std::string& name, JobFn fn) {
+        if (is_manual()) {
+            // Deterministic: long work completes within the current virtual instant
+            std::promise<void> done;
+            try {
+                fn();
+                done.set_value();
+            } catch (...) {
+                done.set_exception(std::current_exception());
+            }
+            return done.get_future();
+        }
+
+        AsyncWork work{name, std::move(fn), std::promise<void>()};
+        std::future<void> result = work.done.get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            async_work_.push_back(std::move(work));
+        }
+        async_cv_.notify_one();
+        return result;
+    }
+
+    std::size_t Scheduler::async_pending() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return async_work_.size() + async_busy_;
+    }
+
+    void Scheduler::start() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (running_) return;
+        running_ = true;
+        stopping_ = false;
+        if (is_manual()) return; // Driven by advance()
+        dispatcher_ = std::thread(&Scheduler::dispatcher_loop, this);
+        for (std::size_t i = 0; i < worker_count_; ++i) workers_.emplace_back(&Scheduler::worker_loop, this);
+        for (std::size_t i = 0; i < async_worker_count_; ++i) async_workers_.emplace_back(&Scheduler::async_worker_loop, this);
+    }
+
+    void Scheduler::stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!running_) return;
+            stopping_ = true;
+        }
+        dispatch_cv_.notify_all();
+        work_cv_.notify_all();
+        async_cv_.notify_all();
+
+        if (dispatcher_.joinable()) dispatcher_.join();
+        for (auto& t : workers_) if (t.joinable()) t.join();
+        for (auto& t : async_workers_) if (t.joinable()) t.join();
+        workers_.clear();
+        async_workers_.clear();
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        work_.clear();
+        for (auto& [name, job] : jobs_) job.running = false;
+        running_ = false;
+    }
+
+    bool Scheduler::is_running() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return running_ && !stopping_;
+    }
+
+    std::vector<Scheduler::JobStats> Scheduler::stats() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<JobStats> out;
+        out.reserve(jobs_.size());
+        for (const auto& [name, job] : jobs_) out.push_back(job.stats);
+        return out;
+    }
+
+    void Scheduler::dispatcher_loop() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!stopping_) {
+            if (heap_.empty()) {
+                dispatch_cv_.wait(lock);
+                continue;
+            }
+            auto due = heap_.front().due;
+            if (Clock::now() < due) {
+                dispatch_cv_.wait_until(lock, due);
+                continue;
+            }
+
+            std::pop_heap(heap_.begin(), heap_.end(), std::greater<>());
+            DueEntry entry = std::move(heap_.back());
+            heap_.pop_back();
+
+            auto it = jobs_.find(entry.name);
+            if (it == jobs_.end() || it->second.generation != entry.generation) continue; // Removed or rescheduled
+            Job& job = it->second;
+
+            if (job.running) {
+                ++job.stats.skipped_overlaps;
+            } else {
+                job.running = true;
+                work_.push_back({entry.name, entry.due, entry.generation});
+                work_cv_.notify_one();
+            }
+
+            // Fixed-rate schedule; if we fell more than a period behind, skip the missed ticks
+            auto now = Clock::now();
+            job.next_due = entry.due + job.stats.period;
+            if (job.next_due <= now) job.next_due = now + job.stats.period;
+            push_due(entry.name, job);
+        }
+    }
+
+    void Scheduler::worker_loop() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            work_cv_.wait(lock, [this] { return stopping_ || !work_.empty(); });
+            if (stopping_) return;
+
+            Work work = std::move(work_.front());
+            work_.pop_front();
+            auto it = jobs_.find(work.name);
+            if (it == jobs_.end()) continue;
+            JobFn fn = it->second.fn; // Copy: the job may be replaced while we run
+
+            lock.unlock();
+            auto start = Clock::now();
+            try {
+                fn();
+            } catch (const std::exception& e) {
+                std::cerr << "[Scheduler] Job '" << work.name << "' threw: " << e.what() << std::endl;
+            }
+            auto end = Clock::now();
+            lock.lock();
+
+            finish_run(work.name, work.due, start, end);
+        }
+    }
+
+    void Scheduler::finish_run(const std::string& name, Clock::time_point due,
+                               Clock::time_point start, Clock::time_point end) {
+        auto it = jobs_.find(name);
+        if (it == jobs_.end()) return;
+        Job& job = it->second;
+        job.running = false;
+        job.stats.runs++;
+        job.stats.last_ms = std::chrono::duration<double, std::milli>(end - start).count();
+        job.stats.max_ms = std::max(job.stats.max_ms, job.stats.last_ms);
+        if (end - due > job.stats.deadline) job.stats.deadline_misses++;
+    }
+
+    std::size_t Scheduler::advance(Duration dt) {
+        if (!is_manual()) return 0;
+        std::unique_lock<std::mutex> lock(mutex_);
+        const Clock::time_point target = clock_->now() + dt;
+        std::size_t ran = 0;
+
+        while (!heap_.empty() && heap_.front().due <= target) {
+            std::pop_heap(heap_.begin(), heap_.end(), std::greater<>());
+            DueEntry entry = std::move(heap_.back());
+            heap_.pop_back();
+
+            auto it = jobs_.find(entry.name);
+            if (it == jobs_.end() || it->second.generation != entry.generation) continue;
+            Job& job = it->second;
+
+            clock_->advance_to(entry.due);
+            job.running = true;
+            job.next_due = entry.due + job.stats.period;
+            if (job.next_due <= clock_->now()) job.next_due = clock_->now() + job.stats.period;
+            push_due(entry.name, job);
+            JobFn fn = job.fn;
+
+            lock.unlock();
+            auto start = clock_->now();
+            try {
+                fn();
+            } catch (const std::exception& e) {
+                std::cerr << "[Scheduler] Job '" << entry.name << "' threw: " << e.what() << std::endl;
+            }
+            auto end = clock_->now();
+            lock.lock();
+
+            finish_run(entry.name, entry.due, start, end);
+            ++ran;
+        }
+        clock_->advance_to(target);
+        return ran;
+    }
+
+    void Scheduler::async_worker_loop() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            async_cv_.wait(lock, [this] { return stopping_ || !async_work_.empty(); });
+            if (async_work_.empty()) return; // Stopping and drained
+
+            AsyncWork work = std::move(async_work_.front());
+            async_work_.pop_front();
+            ++async_busy_;
+            lock.unlock();
+
+            try {
+                work.fn();
+                work.done.set_value();
+            } catch (const std::exception& e) {
+                std::cerr << "[Scheduler] Async job '" << work.name << "' threw: " << e.what() << std::endl;
+                work.done.set_exception(std::current_exception());
+            } catch (...) {
+                work.done.set_exception(std::current_exception());
+            }
+
+            lock.lock();
+            --async_busy_;
+        }
+    }
+
+} // namespace dnn
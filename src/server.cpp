@@ -82,6 +82,11 @@ void TcpServer::broadcast(const std::string& message) {
     }
 }
 
+std::size_t TcpServer::client_count() {
+    std::lock_guard<std::mutex> lock(clients_mutex_);
+    return token_.empty() ? client_sockets_.size() : authenticated_sockets_.size();
+}
+
 void TcpServer::on_input(MessageCallback cb) {
     input_callback_ = cb;
 }
@@ -111,6 +116,7 @@ void TcpServer::accept_loop() {
 
         std::lock_guard<std::mutex> lock(clients_mutex_);
         client_sockets_.push_back(new_socket);
+        if (token_.empty()) joins_.fetch_add(1, std::memory_order_release);
         
         // Spawn a handler for this client (needed for input)
         // For output-only ports, this thread stays idle or handling basic heartbeat? 
@@ -177,6 +183,7 @@ void TcpServer::client_handler(int socket_fd) {
                     {
                         std::lock_guard<std::mutex> lock(clients_mutex_);
                         authenticated_sockets_.push_back(socket_fd);
+                        joins_.fetch_add(1, std::memory_order_release);
                     }
                     std::string success = "AUTH_OK\n";
                     send(socket_fd, success.c_str(), success.length(), MSG_NOSIGNAL);
@@ -0,0 +1,188 @@
+#include "snapshot_writer.hpp"
+#include <iostream>
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace dnn {
+
+    // --- FdStreamBuf ---
+
+    FdStreamBuf::FdStreamBuf(int fd, std::size_t buffer_bytes)
+        : fd_(fd), buffer_(buffer_bytes > 0 ? buffer_bytes : 1) {
+        setp(buffer_.data(), buffer_.data() + buffer_.size());
+    }
+
+    FdStreamBuf::~FdStreamBuf() {
+        flush_buffer();
+    }
+
+    bool FdStreamBuf::write_all(const char* data, std::size_t len) {
+        while (len > 0) {
+            ssize_t n = ::write(fd_, data, len);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                failed_ = true;
+                return false;
+            }
+            data += n;
+            len -= static_cast<std::size_t>(n);
+        }
+        return true;
+    }
+
+    bool FdStreamBuf::flush_buffer() {
+        std::size_t len = static_cast<std::size_t>(pptr() - pbase());
+        if (len > 0 && !write_all(pbase(), len)) return false;
+        setp(buffer_.data(), buffer_.data() + buffer_.size());
+        return true;
+    }
+
+    FdStreamBuf::int_type FdStreamBuf::overflow(int_type ch) {
+        if (!flush_buffer()) return traits_type::eof();
+        if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+            *pptr() = traits_type::to_char_type(ch);
+            pbump(1);
+        }
+        return traits_type::not_eof(ch);
+    }
+
+    std::streamsize FdStreamBuf::xsputn(const char* s, std::streamsize n) {
+        std::size_t len = static_cast<std::size_t>(n);
+        std::size_t room = static_cast<std::size_t>(epptr() - pptr());
+        if (len <= room) {
+            std::copy(s, s + len, pptr());
+            pbump(static_cast<int>(len));
+            return n;
+        }
+        // Large payload: flush what is staged and hand the block to the kernel directly
+        if (!flush_buffer()) return 0;
+        if (len >= buffer_.size()) {
+            return write_all(s, len) ? n : 0;
+        }
+        std::copy(s, s + len, pptr());
+        pbump(static_cast<int>(len));
+        return n;
+    }
+
+    int FdStreamBuf::sync() {
+        return flush_buffer() ? 0 : -1;
+    }
+
+    // --- SnapshotWriter ---
+
+    SnapshotWriter::SnapshotWriter(std::size_t buffer_bytes) : buffer_bytes_(buffer_bytes) {
+        worker_ = std::thread(&SnapshotWriter::worker_loop, this);
+    }
+
+    SnapshotWriter::~SnapshotWriter() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        cv_.notify_all();
+        if (worker_.joinable()) worker_.join();
+    }
+
+    std::future<bool> SnapshotWriter::enqueue(Job job) {
+        std::future<bool> result = job.done.get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queue_.push_back(std::move(job));
+        }
+        cv_.notify_one();
+        return result;
+    }
+
+    std::future<bool> SnapshotWriter::submit(const std::string& path, WriteFn fn, DoneFn on_done) {
+        return enqueue(Job{path, std::move(fn), std::promise<bool>(), false, std::move(on_done)});
+    }
+
+    std::future<bool> SnapshotWriter::submit_append(const std::string& path, WriteFn fn, DoneFn on_done) {
+        return enqueue(Job{path, std::move(fn), std::promise<bool>(), true, std::move(on_done)});
+    }
+
+    bool SnapshotWriter::stream_to_fd(int fd, const WriteFn& fn) {
+        bool ok;
+        {
+            FdStreamBuf buf(fd, buffer_bytes_);
+            std::ostream os(&buf);
+            ok = fn(os);
+            os.flush();
+            ok = ok && os.good() && !buf.failed();
+        }
+        ok = ok && ::fsync(fd) == 0;
+        ::close(fd);
+        return ok;
+    }
+
+    bool SnapshotWriter::write_now(const std::string& path, const WriteFn& fn) {
+        std::string tmp_path = path + ".tmp";
+        int fd = ::open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            std::cerr << "[SnapshotWriter] Cannot open " << tmp_path << std::endl;
+            return false;
+        }
+
+        if (!stream_to_fd(fd, fn) || std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+            std::cerr << "[SnapshotWriter] Failed to write " << path << std::endl;
+            ::unlink(tmp_path.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    bool SnapshotWriter::append_now(const std::string& path, const WriteFn& fn) {
+        int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            std::cerr << "[SnapshotWriter] Cannot open " << path << " for append" << std::endl;
+            return false;
+        }
+        if (!stream_to_fd(fd, fn)) {
+            std::cerr << "[SnapshotWriter] Failed to append to " << path << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    void SnapshotWriter::wait_idle() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        idle_cv_.wait(lock, [this] { return queue_.empty() && !busy_; });
+    }
+
+    std::size_t SnapshotWriter::pending() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return queue_.size() + (busy_ ? 1 : 0);
+    }
+
+    void SnapshotWriter::worker_loop() {
+        while (true) {
+            Job job;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+                if (queue_.empty()) return; // stopping and drained
+                job = std::move(queue_.front());
+                queue_.pop_front();
+                busy_ = true;
+            }
+
+            bool ok = false;
+            try {
+                ok = job.append ? append_now(job.path, job.fn) : write_now(job.path, job.fn);
+            } catch (const std::exception& e) {
+                std::cerr << "[SnapshotWriter] " << job.path << ": " << e.what() << std::endl;
+            }
+            if (job.on_done) job.on_done(ok);
+            job.done.set_value(ok);
+
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                busy_ = false;
+            }
+            idle_cv_.notify_all();
+        }
+    }
+
+} // namespace dnn
@@ -0,0 +1,156 @@
+#include "sqlite_client.hpp"
+#include <filesystem>
+#include <iostream>
+
+SqliteStatement::~SqliteStatement() {
+    if (!stmt_) return;
+    sqlite3_reset(stmt_);
+    sqlite3_clear_bindings(stmt_);
+}
+
+SqliteStatement& SqliteStatement::bind_text(int index, std::string_view v) {
+    if (stmt_ && sqlite3_bind_text(stmt_, index, v.data(), static_cast<int>(v.size()), SQLITE_TRANSIENT) != SQLITE_OK) failed_ = true;
+    return *this;
+}
+
+SqliteStatement& SqliteStatement::bind_int(int index, std::int64_t v) {
+    if (stmt_ && sqlite3_bind_int64(stmt_, index, v) != SQLITE_OK) failed_ = true;
+    return *this;
+}
+
+SqliteStatement& SqliteStatement::bind_double(int index, double v) {
+    if (stmt_ && sqlite3_bind_double(stmt_, index, v) != SQLITE_OK) failed_ = true;
+    return *this;
+}
+
+SqliteStatement& SqliteStatement::bind_blob(int index, std::span<const std::uint8_t> v) {
+    if (stmt_ && sqlite3_bind_blob(stmt_, index, v.data(), static_cast<int>(v.size()), SQLITE_TRANSIENT) != SQLITE_OK) failed_ = true;
+    return *this;
+}
+
+SqliteStatement& SqliteStatement::bind_null(int index) {
+    if (stmt_ && sqlite3_bind_null(stmt_, index) != SQLITE_OK) failed_ = true;
+    return *this;
+}
+
+bool SqliteStatement::step() {
+    if (!ok()) return false;
+    const int rc = sqlite3_step(stmt_);
+    if (rc == SQLITE_ROW) return true;
+    if (rc != SQLITE_DONE) {
+        failed_ = true;
+        std::cerr << "[SQLite] " << sqlite3_errmsg(sqlite3_db_handle(stmt_)) << std::endl;
+    }
+    return false;
+}
+
+bool SqliteStatement::run() {
+    while (step()) {}
+    return ok();
+}
+
+void SqliteStatement::reset() {
+    if (!stmt_) return;
+    sqlite3_reset(stmt_);
+    sqlite3_clear_bindings(stmt_);
+    failed_ = false;
+}
+
+std::string_view SqliteStatement::text(int col) const {
+    const auto* p = reinterpret_cast<const char*>(sqlite3_column_text(stmt_, col));
+    return p ? std::string_view(p, static_cast<size_t>(sqlite3_column_bytes(stmt_, col))) : std::string_view();
+}
+
+std::span<const std::uint8_t> SqliteStatement::blob(int col) const {
+    const auto* p = static_cast<const std::uint8_t*>(sqlite3_column_blob(stmt_, col));
+    return p ? std::span<const std::uint8_t>(p, static_cast<size_t>(sqlite3_column_bytes(stmt_, col))) : std::span<const std::uint8_t>();
+}
+
+SqliteClient::SqliteClient(std::string path) : path_(std::move(path)) {}
+
+SqliteClient::~SqliteClient() {
+    close();
+}
+
+bool SqliteClient::open() {
+    auto guard = lock();
+    if (db_) return true;
+
+    if (path_ != ":memory:") {
+        const auto dir = std::filesystem::path(path_).parent_path();
+        std::error_code ec;
+        if (!dir.empty()) std::filesystem::create_directories(dir, ec);
+    }
+    // The lock serialises use of the connection, so SQLite's own mutex is not needed
+    if (sqlite3_open_v2(path_.c_str(), &db_, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_NOMUTEX, nullptr) != SQLITE_OK) {
+        std::cerr << "[SQLite] Cannot open " << path_ << ": " << error() << std::endl;
+        sqlite3_close(db_);
+        db_ = nullptr;
+        return false;
+    }
+    sqlite3_busy_timeout(db_, 5000);
+    if (!execute("PRAGMA journal_mode=WAL; PRAGMA synchronous=NORMAL; PRAGMA temp_store=MEMORY;")) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void SqliteClient::close() {
+    auto guard = lock();
+    for (auto& [sql, stmt] : statements_) sqlite3_finalize(stmt);
+    statements_.clear();
+    if (db_) sqlite3_close(db_);
+    db_ = nullptr;
+}
+
+bool SqliteClient::execute(const char* sql) {
+    auto guard = lock();
+    if (!db_) return false;
+    char* message = nullptr;
+    if (sqlite3_exec(db_, sql, nullptr, nullptr, &message) != SQLITE_OK) {
+        std::cerr << "[SQLite] " << (message ? message : "error") << std::endl;
+        sqlite3_free(message);
+        return false;
+    }
+    return true;
+}
+
+SqliteStatement SqliteClient::prepare(const std::string& sql) {
+    auto guard = lock();
+    if (!db_) return SqliteStatement();
+    auto it = statements_.find(sql);
+    if (it != statements_.end()) return SqliteStatement(it->second);
+
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v3(db_, sql.c_str(), static_cast<int>(sql.size()), SQLITE_PREPARE_PERSISTENT, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "[SQLite] Prepare failed: " << error() << std::endl;
+        sqlite3_finalize(stmt);
+        return SqliteStatement();
+    }
+    statements_.emplace(sql, stmt);
+    return SqliteStatement(stmt);
+}
+
+SqliteTransaction::SqliteTransaction(SqliteClient& client) : client_(client), lock_(client.lock()) {
+    nested_ = client_.in_transaction();
+    active_ = client_.execute(nested_ ? "SAVEPOINT brain_tx;" : "BEGIN IMMEDIATE;");
+}
+
+SqliteTransaction::~SqliteTransaction() {
+    rollback();
+}
+
+bool SqliteTransaction::commit() {
+    if (!active_) return false;
+    active_ = false;
+    if (client_.execute(nested_ ? "RELEASE brain_tx;" : "COMMIT;")) return true;
+    client_.execute(nested_ ? "ROLLBACK TO brain_tx; RELEASE brain_tx;" : "ROLLBACK;");
+    return false;
+}
+
+void SqliteTransaction::rollback() {
+    if (!active_) return;
+    active_ = false;
+    client_.execute(nested_ ? "ROLLBACK TO brain_tx; RELEASE brain_tx;" : "ROLLBACK;");
+}
@@ -0,0 +1,410 @@
+#include "sqlite_memory_store.hpp"
+#include "snapshot_writer.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <unordered_set>
+
+namespace {
+// The content table mirrors PostgreSQL's; memories_fts indexes its content
+// (external content, so the text is stored once) and the two fts5vocab tables
+// expose its terms for get_graph_json()
+const char* const kSchema =
+    "CREATE TABLE IF NOT EXISTS memories ("
+    "id INTEGER PRIMARY KEY,"
+    "timestamp INTEGER,"
+    "type TEXT,"
+    "content TEXT,"
+    "tags TEXT,"
+    "acl TEXT DEFAULT 'PUBLIC',"
+    "strength REAL DEFAULT 1.0,"
+    "last_recall INTEGER DEFAULT 0);"
+    "CREATE INDEX IF NOT EXISTS memories_timestamp ON memories (timestamp);"
+    "CREATE VIRTUAL TABLE IF NOT EXISTS memories_fts USING fts5("
+    "content, content='memories', content_rowid='id',"
+    "tokenize=\"unicode61 remove_diacritics 0 separators '0123456789'\");"
+    "CREATE TRIGGER IF NOT EXISTS memories_fts_insert AFTER INSERT ON memories BEGIN "
+    "INSERT INTO memories_fts (rowid, content) VALUES (new.id, new.content); END;"
+    "CREATE TRIGGER IF NOT EXISTS memories_fts_delete AFTER DELETE ON memories BEGIN "
+    "INSERT INTO memories_fts (memories_fts, rowid, content) VALUES ('delete', old.id, old.content); END;"
+    "CREATE TRIGGER IF NOT EXISTS memories_fts_update AFTER UPDATE OF content ON memories BEGIN "
+    "INSERT INTO memories_fts (memories_fts, rowid, content) VALUES ('delete', old.id, old.content);"
+    "INSERT INTO memories_fts (rowid, content) VALUES (new.id, new.content); END;"
+    "CREATE VIRTUAL TABLE IF NOT EXISTS memories_terms USING fts5vocab(memories_fts, 'row');"
+    "CREATE VIRTUAL TABLE IF NOT EXISTS memories_term_docs USING fts5vocab(memories_fts, 'instance');";
+
+long long now_seconds() {
+    return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// Columns: id, timestamp, type, content, tags[, acl[, score]]
+std::vector<Memory> fetch(SqliteStatement& stmt) {
+    std::vector<Memory> results;
+    const int columns = stmt.columns();
+    while (stmt.step()) {
+        Memory m;
+        m.id = static_cast<int>(stmt.integer(0));
+        m.timestamp = stmt.integer(1);
+        m.type = stmt.text(2);
+        m.content = stmt.text(3);
+        m.tags = stmt.text(4);
+        if (columns > 5) m.acl_label = stmt.text(5);
+        if (columns > 6) m.score = stmt.real(6);
+        results.push_back(std::move(m));
+    }
+    return results;
+}
+
+// FTS5 query of memory tokens; they are alphabetic, so quoting needs no escapes.
+// One phrase per token (repeated `repeat` times), or all tokens as one phrase.
+void append_phrases(std::string& expr, std::string_view text, int repeat, const char* op) {
+    for_each_memory_token(text, [&](const std::string& token) {
+        for (int i = 0; i < repeat; ++i) {
+            if (!expr.empty()) expr += op;
+            expr += '"';
+            expr += token;
+            expr += '"';
+        }
+    });
+}
+
+std::string phrase(std::string_view text) {
+    std::string expr;
+    for_each_memory_token(text, [&](const std::string& token) {
+        expr += expr.empty() ? "\"" : " ";
+        expr += token;
+    });
+    if (!expr.empty()) expr += '"';
+    return expr;
+}
+} // namespace
+
+SqliteMemoryStore::SqliteMemoryStore(const std::string& path)
+    : client_(std::make_shared<SqliteClient>(path)), kv_store_(client_), vectors_(0, memory_vector_options()),
+      vector_path_(dnn::infra::Config::get("BRAIN_MEMORY_VECTORS", path == ":memory:" ? "" : path + ".vectors")) {}
+
+SqliteMemoryStore::~SqliteMemoryStore() {
+    if (vectors_dirty_) save_index();
+}
+
+bool SqliteMemoryStore::init() {
+    if (!kv_store_.connect()) return false;
+    if (!client_->execute(kSchema)) return false;
+    load_vectors();
+    if (vectors_dirty_) save_index();
+    ready_ = true;
+    return true;
+}
+
+bool SqliteMemoryStore::insert(const MemoryRecord& record, long long timestamp) {
+    auto stmt = client_->prepare("INSERT INTO memories (timestamp, type, content, tags, acl, strength, last_recall) "
+                                 "VALUES (?1, ?2, ?3, ?4, ?5, 1.0, ?1)");
+    if (!stmt.bind_int(1, timestamp).bind_text(2, record.type).bind_text(3, record.content)
+             .bind_text(4, record.tags).bind_text(5, record.acl).run()) {
+        return false;
+    }
+    if (record.embedding_key.empty() || record.embedding.empty()) return true;
+    return kv_store_.write_embedding(record.embedding_key, record.embedding);
+}
+
+bool SqliteMemoryStore::store(const std::string& type, const std::string& content, const std::string& tags, const std::string& acl) {
+    if (!ready_) return false;
+    {
+        auto lock = client_->lock();
+        if (!insert(MemoryRecord{type, content, tags, acl, {}, {}}, now_seconds())) return false;
+    }
+    add_to_count(1);
+    return true;
+}
+
+size_t SqliteMemoryStore::write_records(const std::vector<MemoryRecord>& records, bool independent) {
+    if (records.empty() || !ready_) return 0;
+    const long long timestamp = now_seconds();
+
+    std::vector<const MemoryRecord*> written;
+    {
+        SqliteTransaction transaction(*client_);
+        if (!transaction) return 0;
+        for (const auto& r : records) {
+            if (independent) {
+                SqliteTransaction savepoint(*client_);
+                if (savepoint && insert(r, timestamp) && savepoint.commit()) written.push_back(&r);
+            } else if (insert(r, timestamp)) {
+                written.push_back(&r);
+            } else {
+                return 0; // Rolled back
+            }
+        }
+        if (!transaction.commit()) return 0;
+    }
+    add_to_count(static_cast<long long>(written.size()));
+    index_embeddings(written);
+    return written.size();
+}
+
+bool SqliteMemoryStore::store_batch(const std::vector<MemoryRecord>& records) {
+    if (records.empty()) return true;
+    return write_records(records, false) == records.size();
+}
+
+size_t SqliteMemoryStore::store_many(const std::vector<MemoryRecord>& records) {
+    return write_records(records, true);
+}
+
+size_t SqliteMemoryStore::bulk_load(const std::vector<MemoryRecord>& records) {
+    return write_records(records, false);
+}
+
+std::vector<Memory> SqliteMemoryStore::query(const std::string& keyword, const std::string& user_acl) {
+    std::vector<Memory> results;
+    const std::string expr = phrase(keyword);
+    if (!ready_ || expr.empty()) return results;
+
+    // The 20 newest matches (FTS5 walks rowids backwards), then the ACL
+    auto lock = client_->lock();
+    auto stmt = client_->prepare(
+        "SELECT id, timestamp, type, content, tags, acl FROM memories "
+        "WHERE id IN (SELECT rowid FROM memories_fts WHERE memories_fts MATCH ?1 ORDER BY rowid DESC LIMIT 20) "
+        "AND (acl = 'PUBLIC' OR acl = ?2) ORDER BY timestamp DESC, id DESC");
+    stmt.bind_text(1, expr).bind_text(2, user_acl);
+    return fetch(stmt);
+}
+
+std::unordered_map<std::string, std::vector<Memory>> SqliteMemoryStore::query_many(const std::vector<std::string>& keywords,
+                                                                                const std::string& user_acl) {
+    std::unordered_map<std::string, std::vector<Memory>> results;
+    std::unordered_set<std::string> seen;
+    for (const auto& keyword : keywords) {
+        if (!seen.insert(keyword).second) continue;
+        auto found = query(keyword, user_acl);
+        if (!found.empty()) results.emplace(keyword, std::move(found));
+    }
+    return results;
+}
+
+std::vector<Memory> SqliteMemoryStore::search(const std::vector<MemoryQueryTerm>& terms, size_t k, const std::string& user_acl,
+                                              bool require_all) {
+    auto results = search_many({terms}, k, user_acl, require_all);
+    return std::move(results[0]);
+}
+
+std::vector<std::vector<Memory>> SqliteMemoryStore::search_many(const std::vector<std::vector<MemoryQueryTerm>>& queries, size_t k,
+                                                                const std::string& user_acl, bool require_all) {
+    std::vector<std::vector<Memory>> results(queries.size());
+    if (queries.empty() || k == 0 || !ready_) return results;
+
+    // bm25() is negative (lower is better); newer rows first on ties, like PostingIndex
+    auto lock = client_->lock();
+    auto stmt = client_->prepare(
+        "SELECT m.id, m.timestamp, m.type, m.content, m.tags, m.acl, -bm25(memories_fts) "
+        "FROM memories_fts JOIN memories m ON m.id = memories_fts.rowid "
+        "WHERE memories_fts MATCH ?1 AND (m.acl = 'PUBLIC' OR m.acl = ?2) "
+        "ORDER BY bm25(memories_fts), m.id DESC LIMIT ?3");
+    for (size_t q = 0; q < queries.size(); ++q) {
+        std::string expr;
+        for (const auto& term : queries[q]) {
+            const long repeat = std::clamp(std::lround(term.weight), 1L, static_cast<long>(kMaxTermRepeat));
+            append_phrases(expr, term.text, static_cast<int>(repeat), require_all ? " AND " : " OR ");
+        }
+        if (expr.empty()) continue;
+        stmt.bind_text(1, expr).bind_text(2, user_acl).bind_int(3, static_cast<std::int64_t>(k));
+        results[q] = fetch(stmt);
+        stmt.reset();
+    }
+    return results;
+}
+
+std::vector<Memory> SqliteMemoryStore::get_recent(int limit) {
+    if (!ready_) return {};
+    auto lock = client_->lock();
+    auto stmt = client_->prepare("SELECT id, timestamp, type, content, tags FROM memories ORDER BY timestamp DESC, id DESC LIMIT ?1");
+    stmt.bind_int(1, limit);
+    return fetch(stmt);
+}
+
+long long SqliteMemoryStore::get_memory_count() {
+    if (!ready_) return 0;
+    long long count = memory_count_.load();
+    if (count >= 0) return count;
+
+    auto lock = client_->lock();
+    auto stmt = client_->prepare("SELECT COUNT(*) FROM memories");
+    if (!stmt.step()) return 0;
+    count = stmt.integer(0);
+    memory_count_.store(count);
+    return count;
+}
+
+std::string SqliteMemoryStore::get_graph_json(int max_nodes) {
+    // 1. Top N tokens by document frequency, as the PostgreSQL store counts
+    //    them (FTS5 also indexes shorter words)
+    std::vector<std::pair<std::string, long long>> top;
+    std::vector<std::vector<std::int64_t>> docs;
+    if (ready_ && max_nodes > 0) {
+        auto lock = client_->lock();
+        auto terms = client_->prepare("SELECT term, doc FROM memories_terms ORDER BY doc DESC");
+        while (static_cast<int>(top.size()) < max_nodes && terms.step()) {
+            const std::string_view term = terms.text(0);
+            bool token = term.size() >= 3;
+            for_each_memory_token(term, [&](const std::string& t) { token = token && t == term; });
+            if (token) top.emplace_back(std::string(term), terms.integer(1));
+        }
+        terms.reset();
+
+        auto postings = client_->prepare("SELECT DISTINCT doc FROM memories_term_docs WHERE term = ?1 ORDER BY doc");
+        for (const auto& [term, count] : top) {
+            auto& ids = docs.emplace_back();
+            postings.bind_text(1, term);
+            while (postings.step()) ids.push_back(postings.integer(0));
+            postings.reset();
+        }
+    }
+
+    // 2. Links weighted by shared memories
+    std::stringstream ss;
+    ss << "{\"type\": \"graph\", \"nodes\": [";
+    for (size_t i = 0; i < top.size(); i++) {
+        ss << "{\"id\": \"" << top[i].first << "\", \"val\": " << top[i].second << "}";
+        if (i + 1 < top.size()) ss << ",";
+    }
+    ss << "], \"links\": [";
+    bool first = true;
+    for (size_t i = 0; i < top.size(); i++) {
+        for (size_t j = i + 1; j < top.size(); j++) {
+            size_t weight = 0;
+            auto a = docs[i].begin(), b = docs[j].begin();
+            while (a != docs[i].end() && b != docs[j].end()) {
+                if (*a < *b) ++a;
+                else if (*b < *a) ++b;
+                else { ++weight; ++a; ++b; }
+            }
+            if (weight == 0) continue;
+            if (!first) ss << ",";
+            first = false;
+            ss << "{\"source\": \"" << top[i].first << "\", \"target\": \"" << top[j].first << "\", \"weight\": " << weight << "}";
+        }
+    }
+    ss << "]}";
+    return ss.str();
+}
+
+void SqliteMemoryStore::clear() {
+    if (!ready_) return;
+    {
+        SqliteTransaction transaction(*client_);
+        if (!transaction || !client_->execute("DELETE FROM memories;") || !transaction.commit()) return;
+    }
+    memory_count_ = 0;
+}
+
+bool SqliteMemoryStore::verify_index() {
+    if (!ready_) return false;
+    auto lock = client_->lock();
+    // rank 1 compares the index with the memories table, not just with itself
+    if (client_->execute("INSERT INTO memories_fts (memories_fts, rank) VALUES ('integrity-check', 1);")) return true;
+    std::cerr << "[MemoryStore] FTS5 index disagrees with the memories table; rebuilding" << std::endl;
+    client_->execute("INSERT INTO memories_fts (memories_fts) VALUES ('rebuild');");
+    return false;
+}
+
+void SqliteMemoryStore::store_embedding(const std::string& key, const std::vector<double>& embedding) {
+    if (!kv_store_.write_embedding(key, embedding)) return;
+    std::unique_lock<std::shared_mutex> lock(vector_mutex_);
+    vectors_.add(key, embedding);
+    vectors_dirty_ = true;
+}
+
+std::vector<double> SqliteMemoryStore::retrieve_embedding(const std::string& key) {
+    {
+        std::shared_lock<std::shared_mutex> lock(vector_mutex_);
+        auto vector = vectors_.vector(key);
+        if (!vector.empty()) return vector;
+    }
+    return kv_store_.retrieve_embedding(key);
+}
+
+std::vector<std::string> SqliteMemoryStore::search_similar(const std::vector<double>& embedding, int limit) {
+    if (limit <= 0) return {};
+    std::shared_lock<std::shared_mutex> lock(vector_mutex_);
+    return vectors_.search_keys(embedding, static_cast<size_t>(limit));
+}
+
+void SqliteMemoryStore::load_vectors() {
+    long long stored = 0, version = 0;
+    {
+        // As in the PostgreSQL store: writes stamp a higher embedding_version
+        // (see SqliteStorage::connect) and deletes lower the count
+        auto lock = client_->lock();
+        auto fingerprint = client_->prepare(
+            "SELECT COUNT(*), COALESCE(MAX(embedding_version), 0) FROM brain_kv_store WHERE embedding IS NOT NULL");
+        if (!fingerprint.step()) return;
+        stored = fingerprint.integer(0);
+        version = fingerprint.integer(1);
+    }
+    const auto options = memory_vector_options();
+
+    if (!vector_path_.empty() && !dnn::infra::Config::get_int("BRAIN_MEMORY_INDEX_VERIFY", 0)) {
+        std::ifstream in(vector_path_, std::ios::binary);
+        dnn::HnswIndex snapshot;
+        long long covered = 0, xmin = 0; // SQLite commits one writer at a time: versions commit in order
+        if (in && read_vector_header(in, covered, xmin) && snapshot.read(in)) {
+            size_t caught_up = 0;
+            {
+                auto lock = client_->lock();
+                auto rows = client_->prepare(
+                    "SELECT key, embedding FROM brain_kv_store WHERE embedding_version > ?1 AND embedding IS NOT NULL");
+                rows.bind_int(1, covered);
+                // Re-adding a key replaces its node
+                for (; rows.step(); ++caught_up) snapshot.add(rows.text(0), SqliteStorage::decode_embedding(rows.blob(1)));
+            }
+            if (static_cast<long long>(snapshot.size()) == stored) {
+                snapshot.set_ef_search(options.ef_search);
+                std::unique_lock<std::shared_mutex> lock(vector_mutex_);
+                vectors_ = std::move(snapshot);
+                vectors_version_ = version;
+                vectors_dirty_ = caught_up > 0;
+                return;
+            }
+        }
+    }
+
+    dnn::HnswIndex built(0, options);
+    {
+        auto lock = client_->lock();
+        auto rows = client_->prepare("SELECT key, embedding FROM brain_kv_store WHERE embedding IS NOT NULL");
+        while (rows.step()) built.add(rows.text(0), SqliteStorage::decode_embedding(rows.blob(1)));
+    }
+    std::unique_lock<std::shared_mutex> lock(vector_mutex_);
+    vectors_ = std::move(built);
+    vectors_version_ = version;
+    vectors_dirty_ = stored > 0;
+}
+
+bool SqliteMemoryStore::save_index() {
+    if (vector_path_.empty()) return true;
+    auto dir = std::filesystem::path(vector_path_).parent_path();
+    if (!dir.empty() && !std::filesystem::exists(dir)) return false;
+
+    std::shared_lock<std::shared_mutex> lock(vector_mutex_);
+    dnn::SnapshotWriter writer;
+    if (!writer.write_now(vector_path_, [this](std::ostream& os) {
+            return write_vector_header(os, vectors_version_, 0) && vectors_.write(os);
+        })) {
+        return false;
+    }
+    vectors_dirty_ = false;
+    return true;
+}
+
+void SqliteMemoryStore::index_embeddings(const std::vector<const MemoryRecord*>& records) {
+    std::unique_lock<std::shared_mutex> lock(vector_mutex_);
+    for (const auto* r : records) {
+        if (r->embedding_key.empty() || r->embedding.empty()) continue;
+        vectors_.add(r->embedding_key, r->embedding);
+        vectors_dirty_ = true;
+    }
+}
@@ -0,0 +1,187 @@
+#include "sqlite_storage.hpp"
+#include "simd_utils.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <queue>
+
+SqliteStorage::SqliteStorage(const std::string& path) : client_(std::make_shared<SqliteClient>(path)) {}
+
+SqliteStorage::SqliteStorage(std::shared_ptr<SqliteClient> client) : client_(std::move(client)) {}
+
+SqliteStorage::~SqliteStorage() {
+    disconnect();
+}
+
+bool SqliteStorage::connect() {
+    if (connected_.load(std::memory_order_acquire)) return true;
+    if (!client_->open()) return false;
+    if (!client_->execute("CREATE TABLE IF NOT EXISTS brain_kv_store ("
+                          "key TEXT PRIMARY KEY, "
+                          "value TEXT, "
+                          "embedding BLOB, "
+                          "embedding_version INTEGER);")) {
+        return false;
+    }
+    {
+        // Tables created before embedding_version existed
+        auto lock = client_->lock();
+        auto column = client_->prepare("SELECT 1 FROM pragma_table_info('brain_kv_store') WHERE name = 'embedding_version'");
+        const bool missing = !column.step();
+        column.reset();
+        if (missing && !client_->execute("ALTER TABLE brain_kv_store ADD COLUMN embedding_version INTEGER;")) return false;
+    }
+    // Every embedding write, by any connection, takes the next version from a
+    // counter row; SqliteMemoryStore's vector snapshot records the newest one it covers
+    if (!client_->execute("CREATE TABLE IF NOT EXISTS brain_kv_embedding_version ("
+                          "id INTEGER PRIMARY KEY CHECK (id = 1), version INTEGER NOT NULL);"
+                          "INSERT OR IGNORE INTO brain_kv_embedding_version (id, version) VALUES (1, 0);"
+                          "CREATE TRIGGER IF NOT EXISTS brain_kv_embedding_inserted AFTER INSERT ON brain_kv_store "
+                          "WHEN NEW.embedding IS NOT NULL BEGIN "
+                          "UPDATE brain_kv_embedding_version SET version = version + 1; "
+                          "UPDATE brain_kv_store SET embedding_version = (SELECT version FROM brain_kv_embedding_version) "
+                          "WHERE key = NEW.key; END;"
+                          "CREATE TRIGGER IF NOT EXISTS brain_kv_embedding_updated AFTER UPDATE OF embedding ON brain_kv_store "
+                          "WHEN NEW.embedding IS NOT OLD.embedding BEGIN "
+                          "UPDATE brain_kv_embedding_version SET version = version + 1; "
+                          "UPDATE brain_kv_store SET embedding_version = (SELECT version FROM brain_kv_embedding_version) "
+                          "WHERE key = NEW.key; END;"
+                          "CREATE INDEX IF NOT EXISTS brain_kv_embedding_version_idx ON brain_kv_store (embedding_version);")) {
+        return false;
+    }
+    connected_.store(true, std::memory_order_release);
+    return true;
+}
+
+void SqliteStorage::disconnect() {
+    rollback(); // The shared connection must not be left inside our transaction
+    connected_.store(false, std::memory_order_release);
+}
+
+std::vector<std::uint8_t> SqliteStorage::encode_embedding(const std::vector<double>& embedding) {
+    std::vector<std::uint8_t> blob(embedding.size() * sizeof(float));
+    for (size_t i = 0; i < embedding.size(); ++i) {
+        const float v = static_cast<float>(embedding[i]);
+        std::memcpy(blob.data() + i * sizeof(float), &v, sizeof(float));
+    }
+    return blob;
+}
+
+std::vector<float> SqliteStorage::decode_embedding(std::span<const std::uint8_t> blob) {
+    std::vector<float> v(blob.size() / sizeof(float));
+    if (!v.empty()) std::memcpy(v.data(), blob.data(), v.size() * sizeof(float));
+    return v;
+}
+
+void SqliteStorage::store_memory(const std::string& key, const std::string& value) {
+    if (!connect()) return;
+    auto lock = client_->lock();
+    auto stmt = client_->prepare("INSERT INTO brain_kv_store (key, value) VALUES (?1, ?2) "
+                                 "ON CONFLICT (key) DO UPDATE SET value = excluded.value");
+    if (!stmt.bind_text(1, key).bind_text(2, value).run()) {
+        std::cerr << "[SQLite] Store failed: " << client_->error() << std::endl;
+    }
+}
+
+void SqliteStorage::store_memories_bulk(const std::map<std::string, std::string>& memories) {
+    if (memories.empty() || !connect()) return;
+    SqliteTransaction transaction(*client_);
+    if (!transaction) return;
+    auto stmt = client_->prepare("INSERT INTO brain_kv_store (key, value) VALUES (?1, ?2) "
+                                 "ON CONFLICT (key) DO UPDATE SET value = excluded.value");
+    for (const auto& [key, value] : memories) {
+        if (!stmt.bind_text(1, key).bind_text(2, value).run()) {
+            std::cerr << "[SQLite] Bulk Store of " << memories.size() << " keys failed: " << client_->error() << std::endl;
+            return; // Rolled back
+        }
+        stmt.reset();
+    }
+    transaction.commit();
+}
+
+std::string SqliteStorage::retrieve_memory(const std::string& key) {
+    if (!connect()) return "";
+    auto lock = client_->lock();
+    auto stmt = client_->prepare("SELECT value FROM brain_kv_store WHERE key = ?1");
+    stmt.bind_text(1, key);
+    return stmt.step() ? std::string(stmt.text(0)) : std::string();
+}
+
+void SqliteStorage::store_embedding(const std::string& key, const std::vector<double>& embedding) {
+    if (!write_embedding(key, embedding)) std::cerr << "[SQLite] Store Embedding failed: " << client_->error() << std::endl;
+}
+
+bool SqliteStorage::write_embedding(const std::string& key, const std::vector<double>& embedding) {
+    if (!connect()) return false;
+    auto lock = client_->lock();
+    auto stmt = client_->prepare("INSERT INTO brain_kv_store (key, value, embedding) VALUES (?1, '', ?2) "
+                                 "ON CONFLICT (key) DO UPDATE SET embedding = excluded.embedding");
+    return stmt.bind_text(1, key).bind_blob(2, encode_embedding(embedding)).run();
+}
+
+std::vector<double> SqliteStorage::retrieve_embedding(const std::string& key) {
+    if (!connect()) return {};
+    auto lock = client_->lock();
+    auto stmt = client_->prepare("SELECT embedding FROM brain_kv_store WHERE key = ?1 AND embedding IS NOT NULL");
+    stmt.bind_text(1, key);
+    if (!stmt.step()) return {};
+    const auto v = decode_embedding(stmt.blob(0));
+    return std::vector<double>(v.begin(), v.end());
+}
+
+std::vector<std::string> SqliteStorage::search_similar(const std::vector<double>& embedding, int limit) {
+    if (limit <= 0 || embedding.empty() || !connect()) return {};
+    std::vector<float> query(embedding.begin(), embedding.end());
+    const float query_norm = std::sqrt(dnn::simd::dot_product(query.data(), query.data(), query.size()));
+    if (query_norm == 0.0f) return {};
+
+    // Exact cosine scan, keeping the `limit` most similar in a min-heap
+    using Scored = std::pair<float, std::string>;
+    std::priority_queue<Scored, std::vector<Scored>, std::greater<>> best;
+    auto lock = client_->lock();
+    auto stmt = client_->prepare("SELECT key, embedding FROM brain_kv_store WHERE embedding IS NOT NULL");
+    std::vector<float> v;
+    while (stmt.step()) {
+        const auto blob = stmt.blob(1);
+        if (blob.size() != query.size() * sizeof(float)) continue;
+        v.resize(query.size());
+        std::memcpy(v.data(), blob.data(), blob.size());
+        const float norm = std::sqrt(dnn::simd::dot_product(v.data(), v.data(), v.size()));
+        if (norm == 0.0f) continue;
+        const float similarity = dnn::simd::dot_product(query.data(), v.data(), v.size()) / (norm * query_norm);
+        if (best.size() < static_cast<size_t>(limit)) {
+            best.emplace(similarity, std::string(stmt.text(0)));
+        } else if (similarity > best.top().first) {
+            best.pop();
+            best.emplace(similarity, std::string(stmt.text(0)));
+        }
+    }
+
+    std::vector<std::string> results(best.size());
+    for (size_t i = results.size(); i-- > 0; best.pop()) results[i] = best.top().second;
+    return results;
+}
+
+bool SqliteStorage::begin_transaction() {
+    if (!connect()) return false;
+    if (transaction_) return true; // Already inside one
+    transaction_ = std::make_unique<SqliteTransaction>(*client_);
+    if (*transaction_) return true;
+    transaction_.reset();
+    return false;
+}
+
+bool SqliteStorage::commit() {
+    if (!transaction_) return false;
+    const bool ok = transaction_->commit();
+    transaction_.reset();
+    return ok;
+}
+
+bool SqliteStorage::rollback() {
+    if (!transaction_) return false;
+    transaction_->rollback();
+    transaction_.reset();
+    return true;
+}
@@ -0,0 +1,134 @@
+#include "state_publisher.hpp"
+#include <charconv>
+#include <cmath>
+
+namespace dnn {
+
+    StatePublisher::StatePublisher(std::vector<std::string> sections) {
+        sections_.reserve(sections.size());
+        for (auto& key : sections) sections_.push_back(Section{std::move(key), "null", 0, 0, true});
+    }
+
+    bool StatePublisher::update(std::size_t section, std::uint64_t fingerprint, const std::function<std::string()>& serialise) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (section >= sections_.size()) return false;
+        ++stats_.updates;
+        Section& s = sections_[section];
+        if (!s.stale && s.fingerprint == fingerprint) return false;
+
+        ++stats_.serialised;
+        std::string json = serialise();
+        s.fingerprint = fingerprint;
+        s.stale = false;
+        if (s.version != 0 && json == s.json) return false; // Forced refresh, same output
+        s.json = std::move(json);
+        s.version = ++version_;
+        return true;
+    }
+
+    void StatePublisher::invalidate() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& s : sections_) s.stale = true;
+    }
+
+    std::uint64_t StatePublisher::version() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return version_;
+    }
+
+    std::string StatePublisher::full() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (full_.empty() || full_version_ != version_) {
+            full_.clear();
+            full_ += '{';
+            for (std::size_t i = 0; i < sections_.size(); ++i) {
+                if (i) full_ += ',';
+                append_string(full_, sections_[i].key);
+                full_ += ':';
+                full_ += sections_[i].json;
+            }
+            full_ += '}';
+            full_version_ = version_;
+            ++stats_.full_builds;
+        }
+        return full_;
+    }
+
+    std::string StatePublisher::delta(std::uint64_t since) const {
+        if (since == 0) return full();
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (since >= version_) return "";
+        std::string out = "{";
+        for (const auto& s : sections_) {
+            if (s.version <= since) continue;
+            if (out.size() > 1) out += ',';
+            append_string(out, s.key);
+            out += ':';
+            out += s.json;
+        }
+        out += '}';
+        return out;
+    }
+
+    StatePublisher::Stats StatePublisher::stats() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return stats_;
+    }
+
+    std::uint64_t StatePublisher::fingerprint(const void* data, std::size_t bytes, std::uint64_t seed) {
+        const auto* p = static_cast<const unsigned char*>(data);
+        std::uint64_t h = seed;
+        for (std::size_t i = 0; i < bytes; ++i) {
+            h ^= p[i];
+            h *= 1099511628211ULL;
+        }
+        return h;
+    }
+
+    std::vector<double> StatePublisher::downsample(const std::vector<double>& values, std::size_t bins) {
+        if (bins == 0 || values.size() <= bins) return values;
+        std::vector<double> out(bins, 0.0);
+        for (std::size_t b = 0; b < bins; ++b) {
+            std::size_t begin = b * values.size() / bins;
+            std::size_t end = (b + 1) * values.size() / bins;
+            double sum = 0.0;
+            for (std::size_t i = begin; i < end; ++i) sum += values[i];
+            out[b] = sum / static_cast<double>(end - begin);
+        }
+        return out;
+    }
+
+    void StatePublisher::append_number(std::string& out, double v) {
+        if (!std::isfinite(v)) {
+            out += '0'; // JSON has no NaN/Inf
+            return;
+        }
+        char buf[32];
+        auto res = std::to_chars(buf, buf + sizeof(buf), v, std::chars_format::general, 4);
+        out.append(buf, res.ptr);
+    }
+
+    void StatePublisher::append_string(std::string& out, const std::string& s) {
+        out += '"';
+        for (char c : s) {
+            switch (c) {
+                case '"': out += "\\\""; break;
+                case '\\': out += "\\\\"; break;
+                case '\n': out += "\\n"; break;
+                case '\r': out += "\\r"; break;
+                case '\t': out += "\\t"; break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        static const char hex[] = "0123456789abcdef";
+                        out += "\\u00";
+                        out += hex[(c >> 4) & 0xF];
+                        out += hex[c & 0xF];
+                    } else {
+                        out += c;
+                    }
+            }
+        }
+        out += '"';
+    }
+
+} // namespace dnn
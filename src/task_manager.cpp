@@ -37,7 +37,6 @@ Task* TaskManager::get_next_task() {
     // or better, move to a separate member. For simplicity, let's say active_task points to a heap object or specific slot)
     // Actually, safest is to pop from pending and store in a dedicated active_task object.
     
-    static Task current_execution; 
     current_execution = pending_queue.front();
     pending_queue.pop_front();
     
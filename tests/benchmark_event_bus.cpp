@@ -0,0 +1,42 @@
+// EventBus emit cost: unobserved topics (the payload is never built) and
+// observed ones (payload built and queued on the thread's ring).
+//
+// Usage: benchmark_event_bus [emits]
+#include <iostream>
+#include <chrono>
+#include <string>
+#include "event_bus.hpp"
+
+namespace {
+    double ns_per(std::chrono::steady_clock::time_point start, std::size_t n) {
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / static_cast<double>(n);
+    }
+}
+
+int main(int argc, char** argv) {
+    const std::size_t n = argc > 1 ? std::stoul(argv[1]) : 1000000;
+
+    dnn::EventBus::Options options;
+    options.ring_capacity = 1024;
+    dnn::EventBus bus(options);
+
+    std::size_t built = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < n; ++i) {
+        bus.emit(dnn::EventTopic::Neural, "tick", [&] { ++built; return std::to_string(i); });
+    }
+    std::cout << "Unobserved: " << ns_per(start, n) << " ns/emit (" << built << " payloads built)" << std::endl;
+
+    std::size_t delivered = 0;
+    bus.subscribe(dnn::EventTopic::Neural, [&](const dnn::Event&) { ++delivered; });
+    start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < n; ++i) {
+        bus.emit(dnn::EventTopic::Neural, "tick", [&] { return std::to_string(i); });
+    }
+    const double observed = ns_per(start, n);
+    bus.flush();
+    const auto stats = bus.stats();
+    std::cout << "Observed:   " << observed << " ns/emit (" << stats.published << " published, " << stats.dropped
+              << " dropped, " << delivered << " delivered)" << std::endl;
+    return 0;
+}
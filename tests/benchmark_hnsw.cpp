@@ -0,0 +1,75 @@
+// HNSW vs brute force on clustered vectors: build rate, then QPS and
+// recall@10 for a range of efSearch values.
+//
+// Usage: benchmark_hnsw [points] [dim] [queries] [m]
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <random>
+#include <set>
+#include <string>
+#include "hnsw_index.hpp"
+
+namespace {
+    std::vector<std::vector<float>> clustered(std::size_t n, std::size_t dim, std::mt19937& rng) {
+        std::normal_distribution<float> noise(0.0f, 0.3f);
+        static std::vector<std::vector<float>> centres;
+        if (centres.empty() || centres[0].size() != dim) {
+            centres.assign(64, std::vector<float>(dim));
+            for (auto& c : centres) {
+                for (auto& x : c) x = noise(rng) * 4.0f;
+            }
+        }
+        std::vector<std::vector<float>> points(n, std::vector<float>(dim));
+        for (auto& p : points) {
+            const auto& c = centres[rng() % centres.size()];
+            for (std::size_t d = 0; d < dim; ++d) p[d] = c[d] + noise(rng);
+        }
+        return points;
+    }
+
+    double seconds_since(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+int main(int argc, char** argv) {
+    const std::size_t n = argc > 1 ? std::stoul(argv[1]) : 20000;
+    const std::size_t dim = argc > 2 ? std::stoul(argv[2]) : 384;
+    const std::size_t queries = argc > 3 ? std::stoul(argv[3]) : 200;
+    const std::size_t m = argc > 4 ? std::stoul(argv[4]) : 16;
+    const std::size_t k = 10;
+
+    std::mt19937 rng(42);
+    const auto points = clustered(n, dim, rng);
+    const auto probes = clustered(queries, dim, rng);
+
+    dnn::HnswIndex index(dim, dnn::HnswIndex::Options{m, 200, 64, 42});
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < n; ++i) index.add(std::to_string(i), points[i]);
+    double elapsed = seconds_since(start);
+    const auto stats = index.stats();
+    std::cout << "Build: " << n << " x " << dim << " (M=" << m << ") in " << elapsed << " s, "
+              << static_cast<double>(n) / elapsed << " inserts/s, " << stats.levels << " levels, "
+              << stats.bytes / (1024 * 1024) << " MiB" << std::endl;
+
+    std::vector<std::set<dnn::HnswIndex::Node>> truth(queries);
+    start = std::chrono::steady_clock::now();
+    for (std::size_t q = 0; q < queries; ++q) {
+        for (const auto& hit : index.brute_force(probes[q], k)) truth[q].insert(hit.node);
+    }
+    elapsed = seconds_since(start);
+    std::cout << "Brute force: " << static_cast<double>(queries) / elapsed << " QPS, recall@" << k << " 1.000" << std::endl;
+
+    for (std::size_t ef : {16, 32, 64, 128, 256}) {
+        std::size_t found = 0;
+        start = std::chrono::steady_clock::now();
+        for (std::size_t q = 0; q < queries; ++q) {
+            for (const auto& hit : index.search(probes[q], k, ef)) found += truth[q].count(hit.node);
+        }
+        elapsed = seconds_since(start);
+        std::cout << "HNSW efSearch=" << ef << ": " << static_cast<double>(queries) / elapsed << " QPS, recall@" << k << " "
+                  << static_cast<double>(found) / static_cast<double>(queries * k) << std::endl;
+    }
+    return 0;
+}
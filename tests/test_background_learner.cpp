@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+#include "brain.hpp"
+#include "background_learner.hpp"
+
+namespace {
+    // Holding the model lock parks the learner inside apply() with whatever it drained
+    void wait_until_drained(const dnn::BackgroundLearner& learner) {
+        while (learner.stats().queue_depth > 0) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+}
+
+TEST(BackgroundLearnerTest, TrainsQueuedRecordsInBatches) {
+    std::recursive_mutex model_mutex;
+    dnn::NeuralNetwork net({4, 8, 4});
+    dnn::BackgroundLearner::Options options;
+    options.max_batch = 4;
+    dnn::BackgroundLearner learner(model_mutex, options);
+
+    std::vector<double> x = {1, 0, 0.5, 0}, y = {0, 1, 0, 1};
+    auto before = net.predict(x);
+    {
+        std::lock_guard<std::recursive_mutex> hold(model_mutex);
+        ASSERT_TRUE(learner.submit(&net, x, y, 0.1));
+        wait_until_drained(learner);
+        for (int i = 0; i < 10; ++i) ASSERT_TRUE(learner.submit(&net, x, y, 0.1));
+    }
+    learner.flush();
+
+    auto s = learner.stats();
+    EXPECT_EQ(s.submitted, 11u);
+    EXPECT_EQ(s.applied, 11u);
+    EXPECT_EQ(s.batches, 4u); // 1, then 10 as 4 + 4 + 2
+    EXPECT_EQ(s.queue_depth, 0u);
+    EXPECT_NE(net.predict(x), before);
+}
+
+TEST(BackgroundLearnerTest, GroupsByNetwork) {
+    std::recursive_mutex model_mutex;
+    dnn::NeuralNetwork a({3, 3}), b({3, 3});
+    dnn::BackgroundLearner learner(model_mutex, {});
+    {
+        std::lock_guard<std::recursive_mutex> hold(model_mutex);
+        learner.submit(&a, {1, 0, 0}, {0, 1, 0}, 0.05);
+        wait_until_drained(learner);
+        for (int i = 0; i < 3; ++i) {
+            learner.submit(&a, {1, 0, 0}, {0, 1, 0}, 0.05);
+            learner.submit(&b, {0, 1, 0}, {1, 0, 0}, 0.05);
+        }
+    }
+    learner.flush();
+    EXPECT_EQ(learner.stats().applied, 7u);
+    EXPECT_EQ(learner.stats().batches, 3u); // 1, then one per network
+}
+
+TEST(BackgroundLearnerTest, SkipsStaleRecords) {
+    std::recursive_mutex model_mutex;
+    dnn::NeuralNetwork net({2, 2});
+    dnn::BackgroundLearner::Options options;
+    options.max_staleness = std::chrono::milliseconds(20);
+    dnn::BackgroundLearner learner(model_mutex, options);
+    {
+        std::lock_guard<std::recursive_mutex> hold(model_mutex);
+        learner.submit(&net, {1, 0}, {0, 1}, 0.1);
+        wait_until_drained(learner);
+        learner.submit(&net, {1, 0}, {0, 1}, 0.1);
+        learner.submit(&net, {0, 1}, {1, 0}, 0.1);
+        std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    }
+    learner.flush();
+    auto s = learner.stats();
+    EXPECT_EQ(s.applied, 1u);
+    EXPECT_EQ(s.dropped_stale, 2u);
+}
+
+TEST(BackgroundLearnerTest, DropsOldestUnderOverload) {
+    std::recursive_mutex model_mutex;
+    dnn::NeuralNetwork net({2, 2});
+    dnn::BackgroundLearner::Options options;
+    options.capacity = 2;
+    dnn::BackgroundLearner learner(model_mutex, options);
+    {
+        std::lock_guard<std::recursive_mutex> hold(model_mutex);
+        learner.submit(&net, {1, 0}, {0, 1}, 0.1);
+        wait_until_drained(learner);
+        for (int i = 0; i < 5; ++i) EXPECT_TRUE(learner.submit(&net, {1, 0}, {0, 1}, 0.1));
+        EXPECT_EQ(learner.stats().queue_depth, 2u);
+    }
+    learner.flush();
+    auto s = learner.stats();
+    EXPECT_EQ(s.dropped_overload, 3u);
+    EXPECT_EQ(s.applied, 3u);
+    EXPECT_EQ(s.max_queue_depth, 2u);
+}
+
+TEST(BackgroundLearnerTest, BlocksWhenDroppingDisabled) {
+    std::recursive_mutex model_mutex;
+    dnn::NeuralNetwork net({2, 2});
+    dnn::BackgroundLearner::Options options;
+    options.capacity = 1;
+    options.drop_when_full = false;
+    dnn::BackgroundLearner learner(model_mutex, options);
+
+    std::atomic<int> done{0};
+    std::thread producer;
+    {
+        std::lock_guard<std::recursive_mutex> hold(model_mutex);
+        learner.submit(&net, {1, 0}, {0, 1}, 0.1);
+        wait_until_drained(learner);
+        learner.submit(&net, {1, 0}, {0, 1}, 0.1); // Fills the queue
+        producer = std::thread([&] {
+            learner.submit(&net, {0, 1}, {1, 0}, 0.1);
+            done = 1;
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        EXPECT_EQ(done.load(), 0);
+    }
+    producer.join();
+    learner.flush();
+    auto s = learner.stats();
+    EXPECT_EQ(s.dropped_overload, 0u);
+    EXPECT_EQ(s.applied, 3u);
+}
+
+TEST(BackgroundLearnerTest, StopRejectsFurtherWork) {
+    std::recursive_mutex model_mutex;
+    dnn::NeuralNetwork net({2, 2});
+    dnn::BackgroundLearner learner(model_mutex, {});
+    learner.submit(&net, {1, 0}, {0, 1}, 0.1);
+    learner.stop();
+    EXPECT_EQ(learner.stats().applied, 1u); // Drained on stop
+    EXPECT_FALSE(learner.submit(&net, {1, 0}, {0, 1}, 0.1));
+    learner.stop();
+}
+
+TEST(BackgroundLearnerTest, InteractQueuesRegionUpdates) {
+    Brain brain;
+    ASSERT_TRUE(brain.learner);
+    brain.interact("describe purple zebras quietly"); // No reflex for this phrase
+    brain.learner->flush();
+    auto s = brain.learner->stats();
+    EXPECT_GE(s.submitted, 4u); // Encoder, memory, cognitive, decoder
+    EXPECT_EQ(s.applied + s.dropped_overload + s.dropped_stale, s.submitted);
+}
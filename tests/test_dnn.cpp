@@ -27,3 +27,30 @@ TEST(DNNTest, Plasticity) {
     net.train(X, Y, 1, 1, 0.1);
     SUCCEED();
 }
+
+TEST(DNNTest, PredictBatchMatchesPredict) {
+    dnn::NeuralNetwork net({6, 8, 3});
+    std::vector<std::vector<double>> X = {{1, 0, 0, 0.5, 0, 0}, {0, 1, 0, 0, 0.25, 0}, {0, 0, 1, 0, 0, -1}};
+    auto batch = net.predict_batch(X);
+    ASSERT_EQ(batch.size(), X.size());
+    for (size_t s = 0; s < X.size(); ++s) {
+        auto single = net.predict(X[s]);
+        ASSERT_EQ(batch[s].size(), single.size());
+        for (size_t k = 0; k < single.size(); ++k) EXPECT_NEAR(batch[s][k], single[k], 1e-12);
+    }
+}
+
+TEST(DNNTest, MiniBatchTrainingReducesLoss) {
+    dnn::NeuralNetwork net({4, 16, 2});
+    std::vector<std::vector<double>> X, Y;
+    for (int i = 0; i < 64; ++i) {
+        double a = (i % 8) / 8.0, b = (i / 8) / 8.0;
+        X.push_back({a, b, a * b, 1.0});
+        Y.push_back({0.5 * a + 0.25 * b, 0.3 - 0.2 * b});
+    }
+    double first = net.train(X, Y, 1, 16, 0.05);
+    double last = first;
+    for (int i = 0; i < 30; ++i) last = net.train(X, Y, 1, 16, 0.05);
+    EXPECT_GT(first, 0.0);
+    EXPECT_LT(last, first);
+}
@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+#include "embedding_store.hpp"
+#include "brain.hpp"
+#include <filesystem>
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+class EmbeddingStoreTest : public ::testing::Test {
+protected:
+    fs::path dir;
+
+    void SetUp() override {
+        dir = fs::temp_directory_path() / ("brain_embedding_test_" + std::to_string(::getpid()));
+        fs::create_directories(dir);
+    }
+
+    void TearDown() override {
+        fs::remove_all(dir);
+    }
+
+    static bool write_store(const dnn::EmbeddingStore& store, const fs::path& p) {
+        std::ofstream out(p, std::ios::binary);
+        return store.write(out);
+    }
+};
+
+TEST_F(EmbeddingStoreTest, MapsWrittenFileAndFindsWords) {
+    dnn::EmbeddingStore store(4);
+    store.set("zebra", {1, 2, 3, 4});
+    store.set("apple", {0.5, -0.5, 0.25, -0.25});
+    store.set("mango", {9, 9, 9, 9});
+    auto path = dir / "vocab.bin";
+    ASSERT_TRUE(write_store(store, path));
+
+    dnn::EmbeddingStore mapped(4);
+    ASSERT_TRUE(mapped.map_file(path.string()));
+    EXPECT_TRUE(mapped.is_mapped());
+    ASSERT_EQ(mapped.size(), 3u);
+    EXPECT_EQ(mapped.word(0), "apple"); // Written sorted for binary search
+    EXPECT_EQ(mapped.word(2), "zebra");
+
+    const float* row = mapped.find("zebra");
+    ASSERT_NE(row, nullptr);
+    EXPECT_FLOAT_EQ(row[3], 4.0f);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(mapped.row(0)) % 64, 0u);
+    EXPECT_EQ(mapped.find("kiwi"), nullptr);
+}
+
+TEST_F(EmbeddingStoreTest, LearnedWordsOverlayTheMappedFile) {
+    dnn::EmbeddingStore store(2);
+    store.set("b", {1, 1});
+    store.set("d", {2, 2});
+    auto path = dir / "base.bin";
+    ASSERT_TRUE(write_store(store, path));
+
+    dnn::EmbeddingStore mapped(2);
+    ASSERT_TRUE(mapped.map_file(path.string()));
+    mapped.set("c", {3, 3});
+    mapped.set("a", {4, 4});
+    mapped.set("b", {5, 5}); // Copy-on-write update of a mapped row
+    EXPECT_EQ(mapped.size(), 4u);
+    EXPECT_FLOAT_EQ(mapped.find("b")[0], 5.0f);
+
+    auto merged_path = dir / "merged.bin";
+    ASSERT_TRUE(write_store(mapped, merged_path));
+
+    dnn::EmbeddingStore merged(2);
+    ASSERT_TRUE(merged.map_file(merged_path.string()));
+    ASSERT_EQ(merged.size(), 4u);
+    for (size_t i = 0; i < 4; ++i) EXPECT_EQ(merged.word(i), std::string(1, static_cast<char>('a' + i)));
+    EXPECT_FLOAT_EQ(merged.find("a")[1], 4.0f);
+    EXPECT_FLOAT_EQ(merged.find("b")[1], 5.0f);
+
+    // The original file is untouched by the private mapping
+    dnn::EmbeddingStore original(2);
+    ASSERT_TRUE(original.map_file(path.string()));
+    EXPECT_FLOAT_EQ(original.find("b")[0], 1.0f);
+}
+
+TEST_F(EmbeddingStoreTest, RejectsMalformedOrMismatchedFiles) {
+    dnn::EmbeddingStore store(3);
+    store.set("word", {1, 2, 3});
+    auto path = dir / "vocab.bin";
+    ASSERT_TRUE(write_store(store, path));
+
+    dnn::EmbeddingStore wrong_dim(4);
+    EXPECT_FALSE(wrong_dim.map_file(path.string()));
+
+    fs::resize_file(path, fs::file_size(path) - 4); // Truncated matrix
+    dnn::EmbeddingStore truncated(3);
+    EXPECT_FALSE(truncated.map_file(path.string()));
+    EXPECT_TRUE(truncated.empty());
+
+    std::ofstream(dir / "garbage.bin") << "not an embedding file at all, but long enough for a header......";
+    EXPECT_FALSE(truncated.map_file((dir / "garbage.bin").string()));
+}
+
+TEST_F(EmbeddingStoreTest, BrainConvertsLegacyTextVocabOnce) {
+    {
+        std::ofstream txt(dir / "vocab.txt");
+        txt << "hello";
+        for (size_t i = 0; i < Brain::VECTOR_DIM; ++i) txt << " " << (i == 0 ? 0.75 : 0.0);
+        txt << "\nshort 1 2 3\n"; // Wrong dimension: skipped, as the text loader did
+    }
+
+    Brain brain;
+    auto bin = (dir / "vocab.bin").string();
+    brain.load_vocab(bin);
+    ASSERT_TRUE(fs::exists(bin));
+    EXPECT_EQ(brain.word_embeddings.size(), 1u);
+    ASSERT_TRUE(brain.word_embeddings.contains("hello"));
+    EXPECT_FLOAT_EQ(brain.word_embeddings.find("hello")[0], 0.75f);
+
+    brain.learn_word("novel");
+    brain.save_vocab(bin);
+
+    Brain reloaded;
+    reloaded.load_vocab(bin);
+    EXPECT_EQ(reloaded.word_embeddings.size(), 2u);
+    EXPECT_TRUE(reloaded.word_embeddings.contains("novel"));
+}
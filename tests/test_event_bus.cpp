@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+#include "brain.hpp"
+#include "event_bus.hpp"
+#include <thread>
+
+namespace {
+    // Only flush() dispatches, so tests see exactly what they emitted
+    dnn::EventBus::Options manual_dispatch(size_t ring_capacity = 1024) {
+        dnn::EventBus::Options options;
+        options.ring_capacity = ring_capacity;
+        options.dispatch_interval = std::chrono::hours(1);
+        return options;
+    }
+}
+
+TEST(EventBusTest, UnobservedTopicsBuildNothing) {
+    dnn::EventBus bus(manual_dispatch());
+    int built = 0;
+    EXPECT_FALSE(bus.emit(dnn::EventTopic::Neural, "tick", [&] { ++built; return std::string("x"); }));
+    EXPECT_EQ(built, 0);
+
+    // Timing lives in benchmark_event_bus; here only that nothing is built
+    for (int i = 0; i < 1000; ++i) {
+        bus.emit(dnn::EventTopic::Neural, "tick", [&] { ++built; return std::to_string(i); });
+    }
+    EXPECT_EQ(built, 0);
+    bus.flush();
+    EXPECT_EQ(bus.stats().published, 0u);
+}
+
+TEST(EventBusTest, DeliversPerTopicInEmitOrder) {
+    dnn::EventBus bus(manual_dispatch());
+    std::vector<std::string> thoughts, logs;
+    auto t = bus.subscribe(dnn::EventTopic::Thought, [&](const dnn::Event& e) { thoughts.push_back(e.payload); });
+    bus.subscribe(dnn::EventTopic::Log, [&](const dnn::Event& e) { logs.push_back(e.type + ":" + e.payload); });
+
+    EXPECT_TRUE(bus.emit(dnn::EventTopic::Thought, "thought", "a"));
+    EXPECT_TRUE(bus.emit(dnn::EventTopic::Log, "log", [] { return std::string("l1"); }));
+    EXPECT_TRUE(bus.emit(dnn::EventTopic::Thought, "thought", "b"));
+    EXPECT_FALSE(bus.emit(dnn::EventTopic::Emotion, "status", "nobody"));
+    bus.flush();
+    EXPECT_EQ(thoughts, (std::vector<std::string>{"a", "b"}));
+    EXPECT_EQ(logs, (std::vector<std::string>{"log:l1"}));
+
+    bus.unsubscribe(t);
+    EXPECT_FALSE(bus.has_subscribers(dnn::EventTopic::Thought));
+    EXPECT_FALSE(bus.emit(dnn::EventTopic::Thought, "thought", "c"));
+    EXPECT_EQ(bus.stats().delivered, 3u);
+}
+
+TEST(EventBusTest, EmitsAgainAfterTheDispatcherDrains) {
+    dnn::EventBus bus(dnn::EventBus::Options{.ring_capacity = 16, .dispatch_interval = std::chrono::milliseconds(1)});
+    std::atomic<int> received{0};
+    bus.subscribe(dnn::EventTopic::Log, [&](const dnn::Event&) { ++received; });
+    auto wait_for = [&](int n) {
+        for (int i = 0; i < 2000 && received < n; ++i) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        return received.load();
+    };
+
+    // The drained ring must stay this thread's: a freed one would swallow (or
+    // corrupt) what is emitted next
+    for (int n = 1; n <= 5; ++n) {
+        ASSERT_TRUE(bus.emit(dnn::EventTopic::Log, "log", "x"));
+        EXPECT_EQ(wait_for(n), n);
+        std::this_thread::sleep_for(std::chrono::milliseconds(5)); // More dispatches over the empty ring
+    }
+}
+
+TEST(EventBusTest, CollectsFromEveryEmittingThread) {
+    dnn::EventBus bus; // Background dispatcher
+    std::atomic<int> received{0};
+    bus.subscribe(dnn::EventTopic::Neural, [&](const dnn::Event&) { ++received; });
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < 200; ++i) {
+                while (!bus.emit(dnn::EventTopic::Neural, "spike", "x")) std::this_thread::yield(); // Ring full: wait for the dispatcher
+            }
+        });
+    }
+    for (auto& t : threads) t.join();
+    bus.flush();
+    EXPECT_EQ(received.load(), 800);
+    EXPECT_EQ(bus.stats().published, 800u);
+}
+
+TEST(EventBusTest, FullRingDropsNewEvents) {
+    dnn::EventBus bus(manual_dispatch(4));
+    std::vector<std::string> got;
+    bus.subscribe(dnn::EventTopic::Log, [&](const dnn::Event& e) { got.push_back(e.payload); });
+    for (int i = 0; i < 10; ++i) bus.emit(dnn::EventTopic::Log, "log", std::to_string(i));
+    bus.flush();
+    EXPECT_EQ(got, (std::vector<std::string>{"0", "1", "2", "3"}));
+    EXPECT_EQ(bus.stats().dropped, 6u);
+}
+
+TEST(EventBusTest, RateLimitCoalescesPerType) {
+    dnn::EventBus bus(manual_dispatch());
+    bus.set_rate_limit(dnn::EventTopic::Neural, std::chrono::hours(1));
+    std::vector<std::pair<std::string, uint32_t>> got;
+    bus.subscribe(dnn::EventTopic::Neural, [&](const dnn::Event& e) { got.emplace_back(e.type + "=" + e.payload, e.coalesced); });
+
+    for (int i = 1; i <= 5; ++i) bus.emit(dnn::EventTopic::Neural, "focus", std::to_string(i));
+    bus.emit(dnn::EventTopic::Neural, "input", "hi");
+    bus.flush();
+
+    // First of each type goes straight out; the rest collapse into the latest
+    ASSERT_EQ(got.size(), 3u);
+    EXPECT_EQ(got[0], (std::pair<std::string, uint32_t>{"focus=1", 0}));
+    EXPECT_EQ(got[1], (std::pair<std::string, uint32_t>{"input=hi", 0}));
+    EXPECT_EQ(got[2], (std::pair<std::string, uint32_t>{"focus=5", 3}));
+    EXPECT_EQ(bus.stats().coalesced, 3u);
+}
+
+TEST(EventBusTest, BrainThoughtsReachSubscribers) {
+    BrainOptions options;
+    options.headless = true;
+    Brain brain(options);
+    std::vector<std::string> thoughts;
+    std::mutex mu;
+    auto id = brain.events.subscribe(dnn::EventTopic::Thought, [&](const dnn::Event& e) {
+        std::lock_guard<std::mutex> lock(mu);
+        thoughts.push_back(e.payload);
+    });
+    brain.interact("describe purple zebras quietly");
+    brain.events.flush();
+    brain.events.unsubscribe(id);
+    std::lock_guard<std::mutex> lock(mu);
+    ASSERT_FALSE(thoughts.empty());
+    EXPECT_NE(thoughts.back().find("Thinking about: describe purple zebras quietly"), std::string::npos);
+}
@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+#include "hnsw_index.hpp"
+#include <random>
+#include <set>
+#include <sstream>
+
+using dnn::HnswIndex;
+
+namespace {
+    // Points around a few centres, like word embeddings
+    std::vector<std::vector<float>> clustered(std::size_t n, std::size_t dim, std::uint32_t seed) {
+        std::mt19937 rng(seed);
+        std::normal_distribution<float> noise(0.0f, 0.3f);
+        std::vector<std::vector<float>> centres(16, std::vector<float>(dim));
+        for (auto& c : centres) {
+            for (auto& x : c) x = noise(rng) * 4.0f;
+        }
+        std::vector<std::vector<float>> points(n, std::vector<float>(dim));
+        for (std::size_t i = 0; i < n; ++i) {
+            const auto& c = centres[rng() % centres.size()];
+            for (std::size_t d = 0; d < dim; ++d) points[i][d] = c[d] + noise(rng);
+        }
+        return points;
+    }
+}
+
+TEST(HnswIndexTest, MatchesBruteForceOnSmallSets) {
+    HnswIndex index;
+    const auto points = clustered(60, 8, 1);
+    for (std::size_t i = 0; i < points.size(); ++i) ASSERT_TRUE(index.add("p" + std::to_string(i), points[i]));
+    EXPECT_EQ(index.size(), 60u);
+    EXPECT_EQ(index.dim(), 8u);
+    EXPECT_FALSE(index.add("wrong", std::vector<float>(3, 1.0f))); // Dimension is fixed by the first add
+
+    for (const auto& q : clustered(10, 8, 2)) {
+        auto approx = index.search(q, 5, 100);
+        auto exact = index.brute_force(q, 5);
+        ASSERT_EQ(approx.size(), exact.size());
+        for (std::size_t i = 0; i < exact.size(); ++i) EXPECT_EQ(approx[i].node, exact[i].node);
+    }
+}
+
+TEST(HnswIndexTest, RecallAgainstBruteForce) {
+    HnswIndex index(32, HnswIndex::Options{12, 100, 64, 7});
+    const auto points = clustered(4000, 32, 3);
+    for (std::size_t i = 0; i < points.size(); ++i) index.add(std::to_string(i), points[i]);
+
+    std::size_t found = 0, total = 0;
+    for (const auto& q : clustered(100, 32, 4)) {
+        std::set<HnswIndex::Node> exact;
+        for (const auto& hit : index.brute_force(q, 10)) exact.insert(hit.node);
+        for (const auto& hit : index.search(q, 10)) found += exact.count(hit.node);
+        total += exact.size();
+    }
+    EXPECT_GE(static_cast<double>(found) / static_cast<double>(total), 0.9);
+    EXPECT_GE(index.stats().levels, 2u);
+}
+
+TEST(HnswIndexTest, ReAddingAKeyMovesIt) {
+    HnswIndex index;
+    const auto points = clustered(200, 4, 5);
+    for (std::size_t i = 0; i < points.size(); ++i) index.add("p" + std::to_string(i), points[i]);
+    const std::vector<float> far = {-50.0f, 50.0f, -50.0f, 50.0f};
+    ASSERT_TRUE(index.add("p7", far));
+    EXPECT_EQ(index.size(), 200u);
+
+    auto hits = index.search(far, 1);
+    ASSERT_EQ(hits.size(), 1u);
+    EXPECT_EQ(index.key(hits[0].node), "p7");
+    EXPECT_NEAR(hits[0].distance, 0.0f, 1e-5f);
+    EXPECT_EQ(index.search_keys({-1.0, 1.0, -1.0, 1.0}, 1), std::vector<std::string>{"p7"}); // Cosine ignores length
+
+    auto v = index.vector("p7");
+    ASSERT_EQ(v.size(), 4u);
+    EXPECT_NEAR(v[1], 50.0, 1e-3); // Original length restored
+    EXPECT_TRUE(index.vector("missing").empty());
+}
+
+TEST(HnswIndexTest, WriteReadRoundTrip) {
+    HnswIndex index(16, HnswIndex::Options{8, 64, 32, 9});
+    const auto points = clustered(500, 16, 6);
+    for (std::size_t i = 0; i < points.size(); ++i) index.add("k" + std::to_string(i), points[i]);
+
+    std::stringstream buffer;
+    ASSERT_TRUE(index.write(buffer));
+    HnswIndex loaded;
+    ASSERT_TRUE(loaded.read(buffer));
+    EXPECT_EQ(loaded.size(), index.size());
+    EXPECT_EQ(loaded.options().m, 8u);
+    EXPECT_EQ(loaded.find("k42"), index.find("k42"));
+    for (const auto& q : clustered(20, 16, 7)) {
+        auto a = index.search(q, 5), b = loaded.search(q, 5);
+        ASSERT_EQ(a.size(), b.size());
+        for (std::size_t i = 0; i < a.size(); ++i) EXPECT_EQ(a[i].node, b[i].node);
+    }
+    EXPECT_TRUE(loaded.add("new", points[0])); // Still accepts inserts
+
+    std::string bytes = buffer.str();
+    std::stringstream truncated(bytes.substr(0, bytes.size() - 10));
+    EXPECT_FALSE(loaded.read(truncated));
+    EXPECT_EQ(loaded.size(), 0u);
+}
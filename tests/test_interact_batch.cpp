@@ -0,0 +1,56 @@
+#include <gtest/gtest.h>
+#include "brain.hpp"
+
+namespace {
+    BrainOptions headless() {
+        BrainOptions options;
+        options.headless = true;
+        return options;
+    }
+}
+
+TEST(InteractBatchTest, EmptyBatch) {
+    Brain brain(headless());
+    EXPECT_TRUE(brain.interact_batch({}).empty());
+    EXPECT_TRUE(brain.conversation_context.empty());
+}
+
+TEST(InteractBatchTest, RepliesInInputOrder) {
+    Brain brain(headless());
+    const std::vector<std::string> inputs = {"describe purple zebras quietly", "hello", "explain orange giraffes slowly"};
+    auto replies = brain.interact_batch(inputs);
+    ASSERT_EQ(replies.size(), inputs.size());
+    for (const auto& reply : replies) EXPECT_FALSE(reply.empty());
+
+    // Turns join the context in input order once the batch is done
+    ASSERT_EQ(brain.conversation_context.size(), 6u);
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        EXPECT_EQ(brain.conversation_context[2 * i], "User: " + inputs[i]);
+        EXPECT_EQ(brain.conversation_context[2 * i + 1], "Brain: " + replies[i]);
+    }
+}
+
+TEST(InteractBatchTest, LargeBatchSpansChunks) {
+    Brain brain(headless());
+    std::vector<std::string> inputs;
+    for (int i = 0; i < 150; ++i) inputs.push_back("summarise topic number " + std::to_string(i) + " carefully");
+    auto replies = brain.interact_batch(inputs);
+    ASSERT_EQ(replies.size(), inputs.size());
+    for (const auto& reply : replies) EXPECT_FALSE(reply.empty());
+    EXPECT_EQ(brain.conversation_context.size(), Brain::MAX_CONTEXT_TURNS);
+    EXPECT_EQ(brain.conversation_context.back(), "Brain: " + replies.back());
+}
+
+TEST(InteractBatchTest, FillsResponseCache) {
+    Brain brain(headless());
+    dnn::ResponseCache::Options cache_options;
+    cache_options.enabled = true;
+    brain.response_cache.configure(cache_options);
+
+    const std::vector<std::string> inputs = {"describe purple zebras quietly"};
+    auto replies = brain.interact_batch(inputs);
+    ASSERT_EQ(replies.size(), 1u);
+    brain.conversation_context.clear(); // The batch saw an empty conversation
+    EXPECT_EQ(brain.interact("Describe purple zebras quietly"), replies[0]);
+    EXPECT_EQ(brain.response_cache.stats().hits, 1u);
+}
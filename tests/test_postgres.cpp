@@ -1,5 +1,9 @@
 #include <gtest/gtest.h>
 #include "postgres_storage.hpp"
+#include "memory_store.hpp"
+#include <chrono>
+#include <filesystem>
+#include <unistd.h>
 
 class PostgresTest : public ::testing::Test {
 protected:
@@ -76,3 +80,346 @@ TEST_F(PostgresTest, VectorSimilarity) {
     ASSERT_FALSE(results.empty());
     EXPECT_EQ(results[0], k2);
 }
+
+TEST_F(PostgresTest, MemoryStoreBatchIsOneTransaction) {
+    MemoryStore store(conn_str);
+    if (!store.init()) {
+        SUCCEED() << "Skipping Postgres test: database not reachable";
+        return;
+    }
+
+    long long before = store.get_memory_count();
+    std::vector<MemoryRecord> batch;
+    for (int i = 0; i < 3; ++i) {
+        MemoryRecord r;
+        r.type = "Consolidated";
+        r.content = "batch \"quoted\" \\ memory " + std::to_string(i);
+        r.tags = "Sleep";
+        r.embedding_key = "batch_test_" + std::to_string(i);
+        r.embedding.assign(384, 0.0);
+        r.embedding[static_cast<size_t>(i)] = 1.0;
+        batch.push_back(r);
+    }
+    batch.push_back(MemoryRecord{.type = "Journal", .content = "User: hi. Brain: hello.", .tags = "Narrative"});
+
+    ASSERT_TRUE(store.store_batch(batch));
+    EXPECT_EQ(store.get_memory_count(), before + 4);
+    auto emb = store.retrieve_embedding("batch_test_2");
+    ASSERT_EQ(emb.size(), 384u);
+    EXPECT_DOUBLE_EQ(emb[2], 1.0);
+    EXPECT_FALSE(store.query("quoted").empty());
+}
+
+TEST(PostgresBinaryTest, EncodesParams) {
+    EXPECT_EQ(PgParam::int4(0x01020304).value, std::string("\x01\x02\x03\x04", 4));
+    EXPECT_EQ(PgParam::int8(-2).value, std::string("\xff\xff\xff\xff\xff\xff\xff\xfe", 8));
+    EXPECT_EQ(PgParam::text("x'; DROP TABLE memories; --").value, "x'; DROP TABLE memories; --");
+    EXPECT_EQ(PgParam::literal("{1,2}").format, 0);
+
+    const int ids[] = {7};
+    auto arr = PgParam::int4_array(ids);
+    ASSERT_EQ(arr.value.size(), 28u); // 20-byte header + (length, value)
+    EXPECT_EQ(arr.value.substr(20), std::string("\x00\x00\x00\x04\x00\x00\x00\x07", 8));
+}
+
+TEST(PostgresBinaryTest, DecodesRowViews) {
+    // A binary result built client-side: int4 id, int8 timestamp, text content
+    PGresult* res = PQmakeEmptyPGresult(nullptr, PGRES_TUPLES_OK);
+    PGresAttDesc attrs[3] = {};
+    char id[] = "id", ts[] = "timestamp", content[] = "content";
+    attrs[0] = {id, 0, 0, 1, 23, 4, -1};
+    attrs[1] = {ts, 0, 0, 1, 20, 8, -1};
+    attrs[2] = {content, 0, 0, 1, 25, -1, -1};
+    ASSERT_TRUE(PQsetResultAttrs(res, 3, attrs));
+    char id_bytes[] = {0, 0, 0x01, 0x2c};                       // 300
+    char ts_bytes[] = {0, 0, 0, 0x01, 0, 0, 0, 0x02};           // 2^32 + 2
+    char text_bytes[] = "hello";
+    ASSERT_TRUE(PQsetvalue(res, 0, 0, id_bytes, 4));
+    ASSERT_TRUE(PQsetvalue(res, 0, 1, ts_bytes, 8));
+    ASSERT_TRUE(PQsetvalue(res, 0, 2, text_bytes, 5));
+    ASSERT_TRUE(PQsetvalue(res, 1, 0, nullptr, -1));            // NULL
+
+    PgResult result(res);
+    ASSERT_TRUE(result.ok());
+    ASSERT_EQ(result.size(), 2);
+    EXPECT_EQ(result[0].integer(0), 300);
+    EXPECT_EQ(result[0].integer(1), (1LL << 32) + 2);
+    EXPECT_EQ(result[0].text(2), "hello");
+    EXPECT_TRUE(result[1].is_null(0));
+    EXPECT_EQ(result[1].integer(0), 0);
+}
+
+TEST_F(PostgresTest, PreparedStatementsAreReused) {
+    PostgresClient client(conn_str);
+    if (!client.connect()) {
+        SUCCEED() << "Skipping Postgres test: database not reachable";
+        return;
+    }
+    const std::string sql = "SELECT $1::int4 + 1, $2::text;";
+    for (int i = 0; i < 3; ++i) {
+        auto res = client.execute_prepared(sql, {PgParam::int4(i), PgParam::text("it's")});
+        ASSERT_TRUE(res.ok());
+        EXPECT_EQ(res[0].integer(0), i + 1);
+        EXPECT_EQ(res[0].text(1), "it's");
+    }
+    EXPECT_EQ(client.prepared_count(), 1u);
+}
+
+TEST(PgConnectionPoolTest, UnreachableDatabaseFailsFast) {
+    PgConnectionPool pool("host=127.0.0.1 port=1 connect_timeout=1");
+    auto lease = pool.checkout();
+    EXPECT_FALSE(lease);
+    auto s = pool.stats();
+    EXPECT_EQ(s.connect_failures, 1u);
+    EXPECT_EQ(s.open, 0u);
+    EXPECT_EQ(s.in_use, 0u);
+    EXPECT_EQ(s.timeouts, 0u); // Failed connects do not wait out the checkout timeout
+}
+
+TEST(PgConnectionPoolTest, SharedPerConnectionString) {
+    auto a = PgConnectionPool::shared("host=127.0.0.1 port=1 dbname=a");
+    EXPECT_EQ(a, PgConnectionPool::shared("host=127.0.0.1 port=1 dbname=a"));
+    EXPECT_NE(a, PgConnectionPool::shared("host=127.0.0.1 port=1 dbname=b"));
+}
+
+TEST_F(PostgresTest, PoolBoundsConcurrentCheckouts) {
+    PgConnectionPool::Options options;
+    options.max_connections = 2;
+    options.checkout_timeout = std::chrono::milliseconds(50);
+    PgConnectionPool pool(conn_str, options);
+    auto first = pool.checkout();
+    if (!first) {
+        SUCCEED() << "Skipping Postgres test: database not reachable";
+        return;
+    }
+    auto second = pool.checkout();
+    ASSERT_TRUE(second);
+    EXPECT_FALSE(pool.checkout()); // Exhausted: times out
+    second.release();
+    EXPECT_TRUE(pool.checkout());  // Reuses the returned connection
+
+    auto s = pool.stats();
+    EXPECT_EQ(s.open, 2u);
+    EXPECT_EQ(s.max_in_use, 2u);
+    EXPECT_EQ(s.timeouts, 1u);
+    EXPECT_GE(s.max_wait_ms, 40.0);
+}
+
+TEST_F(PostgresTest, PipelinedStatementsKeepOrder) {
+    PostgresClient client(conn_str);
+    if (!client.connect()) {
+        SUCCEED() << "Skipping Postgres test: database not reachable";
+        return;
+    }
+    std::vector<PgStatement> statements;
+    for (int i = 0; i < 300; ++i) statements.push_back({"SELECT $1::int4 * 2;", {PgParam::int4(i)}});
+    statements.push_back({"SELECT 1/0;", {}}); // Fails alone: the next statement still runs
+    statements.push_back({"SELECT $1::int4 * 2;", {PgParam::int4(7)}});
+
+    auto results = client.execute_pipelined(statements);
+    ASSERT_EQ(results.size(), statements.size());
+    for (int i = 0; i < 300; ++i) EXPECT_EQ(results[i][0].integer(0), 2 * i);
+    EXPECT_FALSE(results[300].ok());
+    EXPECT_EQ(results[301][0].integer(0), 14);
+}
+
+TEST(PostgresBinaryTest, EncodesCopyRows) {
+    PgCopyBuffer rows;
+    rows.begin_row(3);
+    rows.add_int4(7);
+    rows.add_text("hi");
+    rows.add_null();
+    const double v[] = {1.0, -2.0};
+    rows.begin_row(1);
+    rows.add_vector(v);
+    const std::string& data = rows.finish();
+    EXPECT_EQ(rows.finish().size(), data.size()); // The trailer goes on once
+    EXPECT_EQ(rows.rows(), 2u);
+
+    const std::string header("PGCOPY\n\377\r\n\0\0\0\0\0\0\0\0\0", 19);
+    const std::string row1("\0\3" "\0\0\0\4\0\0\0\7" "\0\0\0\2hi" "\xff\xff\xff\xff", 20);
+    // pgvector: dimension 2, unused, then float4 1.0 and -2.0
+    const std::string row2("\0\1" "\0\0\0\14" "\0\2\0\0" "\x3f\x80\0\0" "\xc0\0\0\0", 18);
+    EXPECT_EQ(data, header + row1 + row2 + std::string("\xff\xff", 2));
+}
+
+TEST_F(PostgresTest, BulkLoadIndexesAndEmbeds) {
+    MemoryStore store(conn_str);
+    if (!store.init()) {
+        SUCCEED() << "Skipping Postgres test: database not reachable";
+        return;
+    }
+    std::vector<MemoryRecord> records;
+    for (int i = 0; i < 300; ++i) records.push_back({"Bulk", "zebulon fact " + std::to_string(i), "Test"});
+    records[0].embedding_key = "bulk_vec";
+    records[0].embedding.assign(384, 0.5);
+
+    const long long before = store.get_memory_count();
+    ASSERT_EQ(store.bulk_load(records), records.size());
+    EXPECT_EQ(store.get_memory_count(), before + 300);
+    EXPECT_GE(store.query("zebulon").size(), 1u);
+    EXPECT_EQ(store.retrieve_embedding("bulk_vec").size(), 384u);
+}
+
+TEST_F(PostgresTest, SearchRanksAndFetchesOnce) {
+    MemoryStore store(conn_str);
+    if (!store.init()) {
+        SUCCEED() << "Skipping Postgres test: database not reachable";
+        return;
+    }
+    ASSERT_TRUE(store.store("Fact", "Quasarfish glow quasarfish glow in the quasarfish reef"));
+    ASSERT_TRUE(store.store("Fact", "A quasarfish was seen near the harbour among many other fish and boats"));
+    auto hits = store.search({{"quasarfish"}, {"reef", 0.5}}, 2);
+    ASSERT_EQ(hits.size(), 2u);
+    EXPECT_NE(hits[0].content.find("reef"), std::string::npos);
+    EXPECT_GT(hits[0].score, hits[1].score);
+    EXPECT_EQ(store.search({{"quasarfish"}, {"harbour"}}, 5, "PUBLIC", true).size(), 1u);
+}
+
+TEST_F(PostgresTest, IndexSnapshotCatchesUpOnLoad) {
+    const auto path = std::filesystem::temp_directory_path() / ("brain_memory_index_" + std::to_string(::getpid()) + ".bin");
+    // A word no earlier run has stored
+    std::string word = "snapshot";
+    for (auto n = std::chrono::steady_clock::now().time_since_epoch().count(); n > 0; n /= 26) word += static_cast<char>('a' + n % 26);
+    {
+        MemoryStore store(conn_str);
+        store.set_index_path(path.string());
+        store.set_vector_path("");
+        if (!store.init()) {
+            SUCCEED() << "Skipping Postgres test: database not reachable";
+            return;
+        }
+        ASSERT_TRUE(store.store("Fact", "First " + word + " memory"));
+        ASSERT_TRUE(store.save_index());
+    }
+    {
+        MemoryStore other(conn_str); // Stores behind the snapshot's back
+        other.set_index_path("");
+        ASSERT_TRUE(other.init());
+        ASSERT_TRUE(other.store("Fact", "Second " + word + " memory"));
+    }
+
+    MemoryStore store(conn_str);
+    store.set_index_path(path.string());
+    ASSERT_TRUE(store.init());
+    EXPECT_GT(store.index_stats().mapped_bytes, 0u);
+    EXPECT_EQ(store.search({{word}}, 5).size(), 2u);
+    EXPECT_TRUE(store.verify_index());
+    std::filesystem::remove(path);
+}
+
+TEST_F(PostgresTest, IndexSnapshotRebuildsWhenAnOlderIdCommitsLate) {
+    const auto path = std::filesystem::temp_directory_path() / ("brain_memory_index_late_" + std::to_string(::getpid()) + ".bin");
+    std::string word = "lateid";
+    for (auto n = std::chrono::steady_clock::now().time_since_epoch().count(); n > 0; n /= 26) word += static_cast<char>('a' + n % 26);
+    PostgresClient other(conn_str);
+    long long reserved = 0;
+    {
+        MemoryStore store(conn_str);
+        store.set_index_path(path.string());
+        store.set_vector_path("");
+        if (!store.init() || !other.connect()) {
+            SUCCEED() << "Skipping Postgres test: database not reachable";
+            return;
+        }
+        // Another writer reserves an id (as bulk_load does) but commits it only
+        // after a higher id is stored and the snapshot is written
+        auto id = other.execute_prepared("SELECT nextval(pg_get_serial_sequence('memories', 'id'));");
+        ASSERT_TRUE(id.ok());
+        reserved = id[0].integer(0);
+        ASSERT_TRUE(store.store("Fact", "Newer " + word + " memory"));
+        ASSERT_TRUE(store.save_index());
+    }
+    ASSERT_TRUE(other.execute_prepared("INSERT INTO memories (id, timestamp, type, content, tags) VALUES ($1, 0, 'Fact', $2, '');",
+                                       {PgParam::int4(static_cast<std::int32_t>(reserved)), PgParam::text("Older " + word + " memory")}).ok());
+
+    MemoryStore store(conn_str);
+    store.set_index_path(path.string());
+    store.set_vector_path("");
+    ASSERT_TRUE(store.init());
+    EXPECT_EQ(store.search({{word}}, 5).size(), 2u);
+    EXPECT_TRUE(store.verify_index());
+    std::filesystem::remove(path);
+}
+
+TEST_F(PostgresTest, SimilarEmbeddingsComeFromTheVectorIndex) {
+    const auto path = std::filesystem::temp_directory_path() / ("brain_memory_vectors_" + std::to_string(::getpid()) + ".bin");
+    const std::string prefix = "hnsw_test_" + std::to_string(::getpid()) + "_";
+    std::vector<double> north(384, 0.0), north_east(384, 0.0), south(384, 0.0);
+    north[0] = 1.0;
+    north_east[0] = 0.9;
+    north_east[1] = 0.1;
+    south[0] = -1.0;
+    {
+        MemoryStore store(conn_str);
+        store.set_index_path("");
+        store.set_vector_path(path.string());
+        if (!store.init()) {
+            SUCCEED() << "Skipping Postgres test: database not reachable";
+            return;
+        }
+        store.store_embedding(prefix + "north", north);
+        store.store_embedding(prefix + "north_east", north_east);
+        store.store_embedding(prefix + "south", south);
+        auto similar = store.search_similar(north, 2);
+        ASSERT_EQ(similar.size(), 2u);
+        EXPECT_EQ(similar[0], prefix + "north");
+        EXPECT_EQ(similar[1], prefix + "north_east");
+        ASSERT_TRUE(store.save_index());
+    }
+    {
+        // Another client moves an embedding behind the snapshot's back; the
+        // count is unchanged, the embedding version is not
+        PostgresStorage other(conn_str);
+        ASSERT_TRUE(other.connect());
+        other.store_embedding(prefix + "south", north);
+    }
+
+    MemoryStore store(conn_str);
+    store.set_index_path("");
+    store.set_vector_path(path.string());
+    ASSERT_TRUE(store.init());
+    EXPECT_GE(store.vector_stats().nodes, 3u);
+    auto v = store.retrieve_embedding(prefix + "north_east");
+    ASSERT_EQ(v.size(), 384u);
+    EXPECT_NEAR(v[1], 0.1, 1e-6);
+    EXPECT_NEAR(store.retrieve_embedding(prefix + "south")[0], 1.0, 1e-6);
+    EXPECT_NE(store.search_similar(south, 1), std::vector<std::string>{prefix + "south"});
+    std::filesystem::remove(path);
+}
+
+TEST_F(PostgresTest, VectorSnapshotCatchesUpOnWritesInFlightWhenRead) {
+    const auto path = std::filesystem::temp_directory_path() / ("brain_memory_vectors_late_" + std::to_string(::getpid()) + ".bin");
+    const std::string prefix = "hnsw_late_" + std::to_string(::getpid()) + "_";
+    std::vector<double> north(384, 0.0), south(384, 0.0);
+    north[0] = 1.0;
+    south[0] = -1.0;
+    PostgresStorage slow(conn_str), fast(conn_str);
+    if (!slow.connect() || !fast.connect()) {
+        SUCCEED() << "Skipping Postgres test: database not reachable";
+        return;
+    }
+    fast.store_embedding(prefix + "late", south);
+
+    // The update draws its embedding_version now but commits only after a
+    // higher version has committed and the snapshot was read and saved
+    ASSERT_TRUE(slow.begin_transaction());
+    slow.store_embedding(prefix + "late", north);
+    fast.store_embedding(prefix + "fast", north);
+    {
+        MemoryStore store(conn_str);
+        store.set_index_path("");
+        store.set_vector_path(path.string());
+        ASSERT_TRUE(store.init());
+        EXPECT_NEAR(store.retrieve_embedding(prefix + "late")[0], -1.0, 1e-6);
+        ASSERT_TRUE(store.save_index());
+    }
+    ASSERT_TRUE(slow.commit());
+
+    MemoryStore store(conn_str);
+    store.set_index_path("");
+    store.set_vector_path(path.string());
+    ASSERT_TRUE(store.init());
+    EXPECT_NEAR(store.retrieve_embedding(prefix + "late")[0], 1.0, 1e-6);
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,221 @@
+#include <gtest/gtest.h>
+#include "posting_index.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <set>
+#include <unistd.h>
+
+using dnn::PostingIndex;
+
+TEST(PostingIndexTest, InternsTermsOnce) {
+    PostingIndex index;
+    auto a = index.intern("apple");
+    EXPECT_EQ(index.intern("apple"), a);
+    EXPECT_NE(index.intern("pear"), a);
+    EXPECT_EQ(index.find("apple"), a);
+    EXPECT_EQ(index.find("plum"), PostingIndex::kNoTerm);
+    EXPECT_EQ(index.term(a), "apple");
+    EXPECT_EQ(index.term_count(), 2u);
+}
+
+TEST(PostingIndexTest, KeepsPostingsSortedAndUnique) {
+    PostingIndex index;
+    auto t = index.intern("word");
+    for (int id : {5, 5, 9, 300, 300, 2, 9, 1000, 7}) index.add(t, id); // Repeats and late arrivals
+    EXPECT_EQ(index.postings(t), (std::vector<int>{2, 5, 7, 9, 300, 1000}));
+    EXPECT_EQ(index.doc_frequency(t), 6u);
+    EXPECT_EQ(index.newest(t, 3), (std::vector<int>{1000, 300, 9}));
+    EXPECT_TRUE(index.newest(PostingIndex::kNoTerm, 3).empty());
+}
+
+TEST(PostingIndexTest, CursorSeeksAcrossBlocks) {
+    PostingIndex index;
+    auto t = index.intern("even");
+    for (int id = 0; id < 2000; id += 2) index.add(t, id);
+
+    auto c = index.cursor(t);
+    ASSERT_TRUE(c.valid());
+    EXPECT_EQ(c.doc(), 0);
+    c.seek(501);
+    EXPECT_EQ(c.doc(), 502);
+    c.seek(502); // Never moves back
+    EXPECT_EQ(c.doc(), 502);
+    c.next();
+    EXPECT_EQ(c.doc(), 504);
+    c.seek(1998);
+    EXPECT_EQ(c.doc(), 1998);
+    c.next();
+    EXPECT_FALSE(c.valid());
+
+    auto d = index.cursor(t);
+    d.seek(5000);
+    EXPECT_FALSE(d.valid());
+    EXPECT_EQ(index.newest(t, 130).back(), 1998 - 2 * 129); // Spans two blocks
+}
+
+TEST(PostingIndexTest, IntersectionMatchesSets) {
+    PostingIndex index;
+    auto a = index.intern("a");
+    auto b = index.intern("b");
+    std::mt19937 rng(7);
+    std::set<int> sa, sb;
+    for (int i = 0; i < 5000; ++i) {
+        int x = static_cast<int>(rng() % 20000), y = static_cast<int>(rng() % 20000);
+        sa.insert(x);
+        sb.insert(y);
+    }
+    for (int x : sa) index.add(a, x);
+    for (int y : sb) index.add(b, y);
+    std::vector<int> both;
+    std::set_intersection(sa.begin(), sa.end(), sb.begin(), sb.end(), std::back_inserter(both));
+    EXPECT_EQ(index.intersect_count(a, b), both.size());
+    EXPECT_EQ(index.intersect_count(b, a), both.size());
+    EXPECT_EQ(index.postings(a), std::vector<int>(sa.begin(), sa.end()));
+}
+
+TEST(PostingIndexTest, CompressesDensePostings) {
+    PostingIndex index;
+    auto t = index.intern("common");
+    for (int id = 1; id <= 100000; ++id) index.add(t, id);
+    index.shrink_to_fit();
+    auto s = index.stats();
+    EXPECT_EQ(s.postings, 100000u);
+    EXPECT_LT(s.posting_bytes, 100000u * sizeof(int) / 3); // One byte per gap plus skips
+}
+
+namespace {
+    std::vector<std::string> words(std::initializer_list<const char*> list) {
+        return std::vector<std::string>(list.begin(), list.end());
+    }
+}
+
+TEST(PostingIndexTest, Bm25PrefersFrequentTermsInShortDocuments) {
+    PostingIndex index;
+    index.add_document(1, words({"robot", "arm", "motor", "gear", "belt", "wheel"}));
+    index.add_document(2, words({"robot", "robot", "arm"}));
+    index.add_document(3, words({"cat", "dog"}));
+    index.add_document(4, words({"robot", "cat"}));
+    EXPECT_EQ(index.document_length(2), 3u);
+    EXPECT_EQ(index.stats().documents, 4u);
+
+    const PostingIndex::QueryTerm robot[] = {{index.find("robot")}};
+    auto hits = index.search(robot, 10);
+    ASSERT_EQ(hits.size(), 3u);
+    EXPECT_EQ(hits[0].doc, 2); // tf 2 in a short document
+    EXPECT_EQ(hits[1].doc, 4); // tf 1, length 2
+    EXPECT_EQ(hits[2].doc, 1); // tf 1, length 6
+    EXPECT_GT(hits[0].score, hits[1].score);
+    EXPECT_GT(hits[1].score, hits[2].score);
+
+    // A rare term outweighs a common one
+    const PostingIndex::QueryTerm mixed[] = {{index.find("robot")}, {index.find("dog")}};
+    hits = index.search(mixed, 1);
+    ASSERT_EQ(hits.size(), 1u);
+    EXPECT_EQ(hits[0].doc, 3);
+}
+
+TEST(PostingIndexTest, SearchRequireAllIntersects) {
+    PostingIndex index;
+    for (int doc = 0; doc < 1000; ++doc) {
+        std::vector<std::string> tokens{"common"};
+        if (doc % 3 == 0) tokens.push_back("three");
+        if (doc % 5 == 0) tokens.push_back("five");
+        index.add_document(doc, tokens);
+    }
+    const PostingIndex::QueryTerm both[] = {{index.find("three")}, {index.find("five")}};
+    auto hits = index.search(both, 1000, true);
+    EXPECT_EQ(hits.size(), 67u); // Multiples of 15 below 1000
+    for (const auto& h : hits) EXPECT_EQ(h.doc % 15, 0);
+    EXPECT_EQ(index.search(both, 1000).size(), 334u + 200u - 67u);
+
+    const PostingIndex::QueryTerm missing[] = {{index.find("three")}, {index.find("seven")}};
+    EXPECT_TRUE(index.search(missing, 10, true).empty());
+    EXPECT_EQ(index.search(missing, 10).size(), 10u);
+}
+
+TEST(PostingIndexTest, SearchKeepsTopKNewestOnTies) {
+    PostingIndex index;
+    for (int doc = 1; doc <= 500; ++doc) index.add_document(doc, words({"same", "text"}));
+    const PostingIndex::QueryTerm q[] = {{index.find("same")}};
+    auto hits = index.search(q, 3);
+    ASSERT_EQ(hits.size(), 3u);
+    EXPECT_EQ(hits[0].doc, 500);
+    EXPECT_EQ(hits[1].doc, 499);
+    EXPECT_EQ(hits[2].doc, 498);
+    EXPECT_TRUE(index.search(q, 0).empty());
+}
+
+namespace {
+    std::filesystem::path snapshot_path(const char* name) {
+        return std::filesystem::temp_directory_path() /
+               (std::string("brain_posting_") + name + "_" + std::to_string(::getpid()) + ".bin");
+    }
+
+    bool write_snapshot(const PostingIndex& index, const std::filesystem::path& p, const PostingIndex::SnapshotInfo& info) {
+        std::ofstream out(p, std::ios::binary);
+        return index.write(out, info);
+    }
+}
+
+TEST(PostingIndexTest, SnapshotMapsBackAndCopiesListsOnWrite) {
+    PostingIndex index;
+    for (int doc = 1; doc <= 1000; ++doc) {
+        std::vector<std::string> tokens{"every"};
+        if (doc % 7 == 0) tokens.insert(tokens.end(), {"seven", "seven"});
+        index.add_document(doc, tokens);
+    }
+    const auto path = snapshot_path("roundtrip");
+    ASSERT_TRUE(write_snapshot(index, path, {1000, 1000, 42}));
+
+    PostingIndex mapped;
+    PostingIndex::SnapshotInfo info;
+    ASSERT_TRUE(mapped.map_file(path.string(), info));
+    EXPECT_EQ(info.max_doc, 1000);
+    EXPECT_EQ(info.rows, 1000u);
+    EXPECT_EQ(info.fingerprint, 42u);
+    EXPECT_GT(mapped.stats().mapped_bytes, 0u);
+    EXPECT_TRUE(mapped.equivalent(index));
+    EXPECT_EQ(mapped.document_length(7), 3u);
+
+    const PostingIndex::QueryTerm q[] = {{mapped.find("seven")}, {mapped.find("every")}};
+    const PostingIndex::QueryTerm q0[] = {{index.find("seven")}, {index.find("every")}};
+    auto hits = mapped.search(q, 5), expected = index.search(q0, 5);
+    ASSERT_EQ(hits.size(), expected.size());
+    for (std::size_t i = 0; i < hits.size(); ++i) EXPECT_EQ(hits[i].doc, expected[i].doc);
+
+    // Appending copies the list out; the file and other lists are untouched
+    mapped.add_document(1001, words({"seven", "fresh"}));
+    EXPECT_EQ(mapped.newest(mapped.find("seven"), 2), (std::vector<int>{1001, 994}));
+    EXPECT_EQ(mapped.doc_frequency(mapped.find("every")), 1000u);
+    EXPECT_FALSE(mapped.equivalent(index));
+    index.add_document(1001, words({"seven", "fresh"}));
+    EXPECT_TRUE(mapped.equivalent(index));
+
+    PostingIndex reread;
+    ASSERT_TRUE(reread.map_file(path.string(), info));
+    EXPECT_EQ(reread.find("fresh"), PostingIndex::kNoTerm);
+    std::filesystem::remove(path);
+}
+
+TEST(PostingIndexTest, RejectsDamagedSnapshots) {
+    PostingIndex index;
+    index.add_document(3, words({"alpha", "beta"}));
+    const auto path = snapshot_path("damaged");
+    ASSERT_TRUE(write_snapshot(index, path, {}));
+
+    PostingIndex mapped;
+    PostingIndex::SnapshotInfo info;
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+    EXPECT_FALSE(mapped.map_file(path.string(), info));
+    EXPECT_EQ(mapped.term_count(), 0u);
+    EXPECT_FALSE(mapped.map_file((path.string() + ".missing"), info));
+
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "not a snapshot";
+    }
+    EXPECT_FALSE(mapped.map_file(path.string(), info));
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+#include "recall_cache.hpp"
+#include <atomic>
+#include <future>
+#include <thread>
+
+using dnn::RecallCache;
+
+TEST(RecallCacheTest, ExpiresAndEvictsPerShard) {
+    RecallCache cache({.capacity = 2, .shards = 1, .ttl = std::chrono::milliseconds(50)});
+    cache.put("a", "1");
+    cache.put("b", "2");
+    EXPECT_EQ(cache.get("a"), "1"); // Now most recent
+    cache.put("c", "3");            // Evicts b
+    EXPECT_FALSE(cache.get("b"));
+    EXPECT_EQ(cache.get("c"), "3");
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(80));
+    EXPECT_FALSE(cache.get("a"));
+    auto stats = cache.stats();
+    EXPECT_EQ(stats.evictions, 1u);
+    EXPECT_EQ(stats.expired, 1u);
+    EXPECT_EQ(stats.hits, 2u);
+    EXPECT_EQ(stats.entries, 1u);
+
+    EXPECT_EQ(RecallCache({.shards = 5}).options().shards, 8u);
+}
+
+TEST(RecallCacheTest, CoalescesConcurrentMisses) {
+    RecallCache cache;
+    std::atomic<int> loads{0};
+    std::promise<void> release;
+    auto gate = release.get_future().share();
+    auto load = [&]() -> std::optional<std::string> {
+        ++loads;
+        gate.wait();
+        return std::string("value");
+    };
+
+    std::vector<std::future<std::optional<std::string>>> callers;
+    for (int i = 0; i < 8; ++i) callers.push_back(std::async(std::launch::async, [&] { return cache.get_or_load("k", load); }));
+    while (loads == 0 || cache.stats().coalesced < 7) std::this_thread::yield();
+    release.set_value();
+    for (auto& caller : callers) EXPECT_EQ(caller.get(), "value");
+    EXPECT_EQ(loads, 1);
+    EXPECT_EQ(cache.get_or_load("k", load), "value"); // Served from L1
+    EXPECT_EQ(loads, 1);
+
+    // Nothing is cached for nullopt, and a failed load reaches every caller
+    EXPECT_FALSE(cache.get_or_load("none", [] { return std::optional<std::string>(); }));
+    EXPECT_FALSE(cache.get("none"));
+    EXPECT_THROW(cache.get_or_load("bad", []() -> std::optional<std::string> { throw std::runtime_error("down"); }), std::runtime_error);
+    EXPECT_EQ(cache.get_or_load("bad", [] { return std::optional<std::string>("ok"); }), "ok");
+}
+
+TEST(RecallCacheTest, InvalidationDuringLoadIsNotCached) {
+    RecallCache cache;
+    cache.put("query:owls", "old");
+    cache.put("query:cats", "old");
+    const std::vector<std::string> keys{"query:owls", "query:cats"};
+    cache.invalidate(keys);
+    EXPECT_FALSE(cache.get("query:owls"));
+    EXPECT_FALSE(cache.get("query:cats"));
+    EXPECT_EQ(cache.stats().invalidations, 2u);
+
+    // The loader read before a concurrent write: its caller gets the result,
+    // later callers load again
+    auto stale = cache.get_or_load("query:owls", [&] {
+        cache.invalidate("query:owls");
+        return std::optional<std::string>("stale");
+    });
+    EXPECT_EQ(stale, "stale");
+    EXPECT_FALSE(cache.get("query:owls"));
+
+    // A caller arriving after the invalidation (store, then query) must not
+    // join the stale load still in flight
+    std::future<std::optional<std::string>> after;
+    stale = cache.get_or_load("query:cats", [&] {
+        cache.invalidate("query:cats");
+        after = std::async(std::launch::async, [&] {
+            return cache.get_or_load("query:cats", [] { return std::optional<std::string>("fresh"); });
+        });
+        after.wait_for(std::chrono::seconds(2)); // Would time out if it joined this load
+        return std::optional<std::string>("stale");
+    });
+    EXPECT_EQ(stale, "stale");
+    EXPECT_EQ(after.get(), "fresh");
+    EXPECT_EQ(cache.get("query:cats"), "fresh");
+
+    cache.put("x", "1");
+    cache.clear();
+    EXPECT_FALSE(cache.get("x"));
+    EXPECT_EQ(cache.stats().entries, 0u);
+}
+
+TEST(RecallCacheTest, MemoryCodecRoundTripsAnyBytes) {
+    std::vector<Memory> memories(2);
+    memories[0] = {7, 1700000000, "Observation", "a|b\nc", "tag|x"};
+    memories[0].score = 2.5;
+    memories[1] = {-1, -5, "Thought", std::string("nul\0byte", 8), ""};
+    memories[1].acl_label = "PRIVATE";
+    memories[1].strength = 0.25;
+    memories[1].last_recall_time = 42;
+
+    const std::string bytes = dnn::encode_memories(memories);
+    auto decoded = dnn::decode_memories(bytes);
+    ASSERT_TRUE(decoded);
+    ASSERT_EQ(decoded->size(), 2u);
+    EXPECT_EQ((*decoded)[0].content, "a|b\nc");
+    EXPECT_EQ((*decoded)[0].tags, "tag|x");
+    EXPECT_EQ((*decoded)[0].timestamp, 1700000000);
+    EXPECT_DOUBLE_EQ((*decoded)[0].score, 2.5);
+    EXPECT_EQ((*decoded)[1].id, -1);
+    EXPECT_EQ((*decoded)[1].timestamp, -5);
+    EXPECT_EQ((*decoded)[1].content, std::string("nul\0byte", 8));
+    EXPECT_EQ((*decoded)[1].acl_label, "PRIVATE");
+    EXPECT_DOUBLE_EQ((*decoded)[1].strength, 0.25);
+    EXPECT_EQ((*decoded)[1].last_recall_time, 42);
+
+    EXPECT_TRUE(dnn::decode_memories(dnn::encode_memories({}))->empty());
+    EXPECT_FALSE(dnn::decode_memories(std::string_view(bytes).substr(0, bytes.size() - 1)));
+    EXPECT_FALSE(dnn::decode_memories(bytes + "x"));
+    EXPECT_FALSE(dnn::decode_memories(std::string("\xff\xff\xff\xff", 4)));
+}
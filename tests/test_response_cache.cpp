@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+#include "brain.hpp"
+#include "response_cache.hpp"
+
+namespace {
+    dnn::ResponseCache::Options enabled(size_t capacity = 8) {
+        dnn::ResponseCache::Options options;
+        options.enabled = true;
+        options.capacity = capacity;
+        options.ttl = std::chrono::seconds(10);
+        return options;
+    }
+}
+
+TEST(ResponseCacheTest, Normalise) {
+    EXPECT_EQ(dnn::ResponseCache::normalise("  Hello,   World!! "), "hello, world");
+    EXPECT_EQ(dnn::ResponseCache::normalise("ping?"), "ping");
+    EXPECT_EQ(dnn::ResponseCache::normalise("\t\n"), "");
+}
+
+TEST(ResponseCacheTest, HitsUntilEpochOrTtlMoves) {
+    dnn::ResponseCache cache(enabled());
+    auto t0 = dnn::ResponseCache::Clock::now();
+    EXPECT_FALSE(cache.lookup("hi", 1, t0));
+    cache.insert("hi", "Hi", "hello there", 1, t0);
+    EXPECT_EQ(cache.lookup("hi", 1, t0 + std::chrono::seconds(1)).value_or(""), "hello there");
+    EXPECT_FALSE(cache.lookup("hi", 2, t0)); // Newer epoch: stale and dropped
+
+    cache.insert("hi", "Hi", "hello again", 2, t0);
+    EXPECT_FALSE(cache.lookup("hi", 2, t0 + std::chrono::seconds(11))); // Expired
+
+    auto s = cache.stats();
+    EXPECT_EQ(s.hits, 1u);
+    EXPECT_EQ(s.misses, 3u);
+    EXPECT_EQ(s.stale, 2u);
+    EXPECT_EQ(s.entries, 0u);
+    EXPECT_DOUBLE_EQ(s.hit_rate(), 0.25);
+}
+
+TEST(ResponseCacheTest, EvictsLeastRecentlyUsed) {
+    dnn::ResponseCache cache(enabled(2));
+    auto now = dnn::ResponseCache::Clock::now();
+    cache.insert("a", "a", "A", 0, now);
+    cache.insert("b", "b", "B", 0, now);
+    EXPECT_TRUE(cache.lookup("a", 0, now)); // b is now least recent
+    cache.insert("c", "c", "C", 0, now);
+    EXPECT_TRUE(cache.lookup("a", 0, now));
+    EXPECT_FALSE(cache.lookup("b", 0, now));
+    EXPECT_TRUE(cache.lookup("c", 0, now));
+    EXPECT_EQ(cache.stats().evictions, 1u);
+}
+
+TEST(ResponseCacheTest, DisabledCacheStoresNothing) {
+    dnn::ResponseCache cache;
+    auto now = dnn::ResponseCache::Clock::now();
+    cache.insert("a", "a", "A", 0, now);
+    EXPECT_FALSE(cache.lookup("a", 0, now));
+    EXPECT_EQ(cache.stats().misses, 0u);
+}
+
+TEST(ResponseCacheTest, HitsAreHandedToReplayWhenLearning) {
+    auto options = enabled();
+    options.learn_on_hit = true;
+    dnn::ResponseCache cache(options);
+    auto now = dnn::ResponseCache::Clock::now();
+    cache.insert("k", "Good morning", "morning!", 0, now);
+    cache.lookup("k", 0, now);
+    cache.lookup("k", 0, now);
+    auto pairs = cache.take_hit_pairs();
+    ASSERT_EQ(pairs.size(), 2u);
+    EXPECT_EQ(pairs[0], (std::pair<std::string, std::string>{"Good morning", "morning!"}));
+    EXPECT_TRUE(cache.take_hit_pairs().empty());
+}
+
+TEST(ResponseCacheTest, BrainServesRepeatsFromCache) {
+    BrainOptions options;
+    options.headless = true;
+    Brain brain(options);
+    auto cache_options = enabled();
+    cache_options.learn_on_hit = true;
+    brain.response_cache.configure(cache_options);
+
+    std::string first = brain.interact("describe purple zebras quietly");
+    brain.conversation_context.clear(); // Starting over is a repeat
+    std::string second = brain.interact("  Describe purple zebras quietly. ");
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(brain.response_cache.stats().hits, 1u);
+
+    // Later in the conversation the same input has other history to answer from
+    brain.interact("describe purple zebras quietly");
+    EXPECT_EQ(brain.response_cache.stats().hits, 1u);
+
+    // Teaching changes the weights; the cached reply no longer applies
+    brain.teach("describe purple zebras quietly", "they are striped");
+    brain.conversation_context.clear();
+    brain.interact("describe purple zebras quietly");
+    auto s = brain.response_cache.stats();
+    EXPECT_EQ(s.hits, 1u);
+    EXPECT_EQ(s.stale, 1u);
+
+    ReplayReport replay = brain.perform_rem_cycle();
+    EXPECT_EQ(replay.cache_hit_pairs, 1u);
+}
@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+#include "scheduler.hpp"
+#include "brain.hpp"
+#include <atomic>
+#include <thread>
+#include <algorithm>
+
+using namespace std::chrono_literals;
+
+namespace {
+dnn::Scheduler::JobStats stats_for(const dnn::Scheduler& s, const std::string& name) {
+    auto all = s.stats();
+    auto it = std::find_if(all.begin(), all.end(), [&](const auto& st) { return st.name == name; });
+    return it == all.end() ? dnn::Scheduler::JobStats{} : *it;
+}
+
+// Polls instead of asserting after a fixed sleep; the timeout only matters if the condition never holds
+template <typename Pred>
+bool eventually(Pred pred, std::chrono::milliseconds timeout = 5000ms) {
+    auto give_up = std::chrono::steady_clock::now() + timeout;
+    while (!pred()) {
+        if (std::chrono::steady_clock::now() > give_up) return false;
+        std::this_thread::sleep_for(1ms);
+    }
+    return true;
+}
+} // namespace
+
+TEST(SchedulerTest, RunsJobsAtTheirOwnPeriods) {
+    auto clock = std::make_shared<dnn::VirtualClock>();
+    dnn::Scheduler scheduler(clock);
+    int fast = 0, slow = 0;
+    scheduler.add_job("fast", 10ms, [&] { ++fast; });
+    scheduler.add_job("slow", 100ms, [&] { ++slow; });
+    scheduler.start();
+
+    EXPECT_EQ(scheduler.advance(350ms), 35u + 3u);
+    EXPECT_EQ(fast, 35);
+    EXPECT_EQ(slow, 3);
+    EXPECT_EQ(stats_for(scheduler, "fast").runs, 35u);
+}
+
+TEST(SchedulerTest, SlowJobMissesDeadlinesWithoutStallingOthers) {
+    auto clock = std::make_shared<dnn::VirtualClock>();
+    dnn::Scheduler scheduler(clock);
+    int slow_runs = 0, ticks = 0;
+    scheduler.add_job("slow", 5ms, [&] {
+        ++slow_runs;
+        clock->sleep_for(60ms); // Takes 60 ms of virtual time
+    });
+    scheduler.add_job("tick", 10ms, [&] { ++ticks; });
+    scheduler.start();
+    scheduler.advance(300ms);
+
+    // Ticks that fall due during a slow run still run afterwards; the slow
+    // job's missed ticks are dropped rather than queued (one run per 60 ms)
+    EXPECT_GT(ticks, 0);
+    auto slow = stats_for(scheduler, "slow");
+    EXPECT_EQ(slow.runs, static_cast<std::uint64_t>(slow_runs));
+    EXPECT_LE(slow_runs, 300 / 60 + 1);
+    EXPECT_EQ(slow.deadline_misses, slow.runs);
+    EXPECT_DOUBLE_EQ(slow.max_ms, 60.0);
+}
+
+TEST(SchedulerTest, JobNeverOverlapsItself) {
+    dnn::Scheduler scheduler(2);
+    std::atomic<int> concurrent{0}, max_concurrent{0}, runs{0};
+    scheduler.add_job("slow", 5ms, [&] {
+        int now = ++concurrent;
+        max_concurrent = std::max(max_concurrent.load(), now);
+        std::this_thread::sleep_for(30ms);
+        --concurrent;
+        ++runs;
+    });
+    scheduler.start();
+    // A tick due while the job runs is skipped, not started on the idle worker
+    EXPECT_TRUE(eventually([&] { return runs >= 3 && stats_for(scheduler, "slow").skipped_overlaps > 0; }));
+    scheduler.stop();
+
+    EXPECT_EQ(max_concurrent.load(), 1);
+}
+
+TEST(SchedulerTest, AsyncJobsRunOffThePeriodicPool) {
+    dnn::Scheduler scheduler(1, 1);
+    std::atomic<int> ticks{0};
+    scheduler.add_job("tick", 10ms, [&] { ++ticks; });
+    scheduler.start();
+
+    std::promise<void> release;
+    std::shared_future<void> gate = release.get_future().share();
+    auto done = scheduler.submit_async("long", [gate] { gate.wait(); });
+    // The single periodic worker keeps ticking while the async job is blocked
+    const int before = ticks.load();
+    EXPECT_TRUE(eventually([&] { return ticks.load() >= before + 3; }));
+    EXPECT_EQ(scheduler.async_pending(), 1u);
+    release.set_value();
+    done.get();
+
+    auto failed = scheduler.submit_async("boom", [] { throw std::runtime_error("boom"); });
+    EXPECT_THROW(failed.get(), std::runtime_error);
+    scheduler.stop();
+}
+
+TEST(SchedulerTest, PeriodCanBeRetunedAndJobsRemoved) {
+    auto clock = std::make_shared<dnn::VirtualClock>();
+    dnn::Scheduler scheduler(clock);
+    int runs = 0;
+    scheduler.add_job("job", 1000ms, [&] { ++runs; });
+    scheduler.start();
+    EXPECT_TRUE(scheduler.set_period("job", 10ms));
+    scheduler.advance(120ms);
+    EXPECT_EQ(runs, 12);
+    EXPECT_EQ(stats_for(scheduler, "job").period, 10ms);
+
+    EXPECT_TRUE(scheduler.remove_job("job"));
+    EXPECT_EQ(scheduler.advance(2000ms), 0u); // Neither the old period nor the new one fires
+    EXPECT_EQ(runs, 12);
+    EXPECT_FALSE(scheduler.set_period("job", 10ms));
+    scheduler.stop();
+}
+
+TEST(SchedulerTest, BrainRegistersAutonomyJobs) {
+    Brain brain;
+    ASSERT_NE(brain.scheduler, nullptr);
+    EXPECT_TRUE(brain.scheduler->is_running());
+    auto stats = brain.scheduler->stats();
+    for (const char* job : {"rl_step", "sensory_focus", "tasks", "metabolism", "regulation"}) {
+        EXPECT_TRUE(std::any_of(stats.begin(), stats.end(), [&](const auto& s) { return s.name == job; })) << job;
+    }
+
+    double energy_before;
+    {
+        std::lock_guard<std::recursive_mutex> lock(brain.brain_mutex);
+        energy_before = brain.emotions.energy;
+    }
+    brain.scheduler->set_period("metabolism", 5ms);
+    EXPECT_TRUE(eventually([&] {
+        std::lock_guard<std::recursive_mutex> lock(brain.brain_mutex);
+        return brain.emotions.energy < energy_before;
+    }));
+}
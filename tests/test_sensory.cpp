@@ -2,6 +2,8 @@
 #include "brain.hpp"
 #include "vision_unit.hpp"
 #include <memory>
+#include <thread>
+#include <atomic>
 
 class SensoryTest : public ::testing::Test {
 protected:
@@ -27,6 +29,67 @@ TEST_F(SensoryTest, SensoryFocusDecay) {
     EXPECT_EQ(aggregate.size(), 384);
 }
 
+namespace {
+    // Publishes frames whose elements all equal the frame number
+    class ConstantUnit : public dnn::SensoryUnit {
+    public:
+        explicit ConstantUnit(size_t dims) { active_features_.resize(dims, 0.0); publish(active_features_); }
+        std::string name() const override { return "Constant"; }
+        dnn::SensoryType type() const override { return dnn::SensoryType::Internal; }
+        std::vector<double> process_raw(const std::vector<unsigned char>& raw_data) override {
+            std::lock_guard<std::mutex> lock(mu_);
+            std::fill(active_features_.begin(), active_features_.end(), raw_data.empty() ? 0.0 : raw_data[0]);
+            publish(active_features_);
+            return active_features_;
+        }
+    };
+}
+
+TEST(SensoryUnitTest, ReadersSeeWholeFrames) {
+    ConstantUnit unit(384);
+    EXPECT_EQ(unit.feature_version(), 1u);
+    EXPECT_EQ(unit.get_current_activity(), std::vector<double>(384, 0.0));
+
+    std::atomic<bool> done{false};
+    std::thread producer([&] {
+        for (int frame = 0; frame < 20000; ++frame) unit.process_raw({static_cast<unsigned char>(frame % 251)});
+        done = true;
+    });
+    size_t torn = 0, reads = 0;
+    while (!done) {
+        auto view = unit.read_begin();
+        ASSERT_EQ(view.size, 384u);
+        bool uniform = std::all_of(view.data, view.data + view.size, [&](double v) { return v == view.data[0]; });
+        if (unit.read_valid(view)) {
+            ++reads;
+            if (!uniform) ++torn;
+        }
+        auto copy = unit.snapshot();
+        EXPECT_TRUE(std::all_of(copy.begin(), copy.end(), [&](double v) { return v == copy[0]; }));
+    }
+    producer.join();
+    EXPECT_EQ(torn, 0u);
+    EXPECT_GT(reads, 0u);
+    EXPECT_EQ(unit.feature_version(), 20001u);
+}
+
+TEST_F(SensoryTest, AggregateIsFocusWeightedMean) {
+    for (auto& unit : brain->sensory_inputs) unit->set_active(false);
+    auto a = std::make_unique<ConstantUnit>(384);
+    auto b = std::make_unique<ConstantUnit>(384);
+    a->process_raw({10});
+    b->process_raw({40});
+    a->set_focus(0.75);
+    b->set_focus(0.25);
+    brain->register_sensory_unit(std::move(a));
+    brain->register_sensory_unit(std::move(b));
+    brain->register_sensory_unit(std::make_unique<ConstantUnit>(16)); // Wrong width: ignored
+
+    auto aggregate = brain->get_aggregate_sensory_input();
+    ASSERT_EQ(aggregate.size(), 384u);
+    for (double v : aggregate) EXPECT_DOUBLE_EQ(v, 17.5);
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+#include "brain_simulation.hpp"
+#include "scheduler.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <unistd.h>
+
+using namespace std::chrono_literals;
+
+TEST(SimulationTest, ManualSchedulerRunsJobsInVirtualTime) {
+    auto clock = std::make_shared<dnn::VirtualClock>();
+    dnn::Scheduler scheduler(clock);
+    std::vector<std::pair<std::string, long long>> trace;
+    auto at = [&] { return std::chrono::duration_cast<std::chrono::milliseconds>(clock->now().time_since_epoch()).count(); };
+
+    scheduler.add_job("a", 1000ms, [&] { trace.emplace_back("a", at()); });
+    scheduler.add_job("b", 3000ms, [&] { trace.emplace_back("b", at()); });
+    scheduler.start();
+
+    EXPECT_EQ(scheduler.advance(10000ms), 10u + 3u);
+    EXPECT_EQ(at(), 10000);
+    ASSERT_EQ(trace.size(), 13u);
+    EXPECT_EQ(trace.front(), std::make_pair(std::string("a"), 1000LL));
+    // Each job runs at its own due time, not at the end of the step
+    for (const auto& [name, t] : trace) EXPECT_EQ(t % (name == "a" ? 1000 : 3000), 0) << name << "@" << t;
+
+    clock->sleep_for(500ms); // Simulated waits move virtual time, not wall time
+    EXPECT_EQ(at(), 10500);
+    EXPECT_EQ(scheduler.advance(500ms), 1u);
+
+    bool ran = false;
+    auto done = scheduler.submit_async("inline", [&] { ran = true; });
+    EXPECT_TRUE(ran); // Manual mode runs async work immediately
+    done.get();
+}
+
+TEST(SimulationTest, HeadlessBrainFastForwardsHours) {
+    SimulationConfig config;
+    config.duration = 2h;
+    int steps = 0;
+    config.on_step = [&](Brain& brain, std::chrono::milliseconds) {
+        ++steps;
+        EXPECT_TRUE(brain.is_headless());
+    };
+
+    auto result = BrainSimulation::run(config);
+    ASSERT_TRUE(result.error.empty()) << result.error;
+    EXPECT_EQ(result.simulated, 2h);
+    EXPECT_EQ(steps, 2 * 60);
+    // 5 jobs every 2 s plus goal selection every 10 s
+    EXPECT_GE(result.job_runs, 2u * 3600u / 2u * 5u);
+    EXPECT_GT(result.speedup, 100.0);
+
+    auto rl = std::find_if(result.job_stats.begin(), result.job_stats.end(),
+                           [](const auto& s) { return s.name == "rl_step"; });
+    ASSERT_NE(rl, result.job_stats.end());
+    EXPECT_EQ(rl->runs, 2u * 3600u / 2u);
+    EXPECT_GT(result.completed_tasks.size(), 0u); // Goals produced tasks that ran to completion
+}
+
+TEST(SimulationTest, BatchRunsIndependentSimulationsInOrder) {
+    std::vector<SimulationConfig> configs(3);
+    for (size_t i = 0; i < configs.size(); ++i) {
+        configs[i].name = "run" + std::to_string(i);
+        configs[i].duration = std::chrono::minutes(30 * (i + 1));
+        configs[i].job_periods = {{"metabolism", 1000ms}};
+    }
+
+    auto results = BrainSimulation::run_batch(configs, 2);
+    ASSERT_EQ(results.size(), 3u);
+    for (size_t i = 0; i < results.size(); ++i) {
+        EXPECT_EQ(results[i].name, configs[i].name);
+        EXPECT_TRUE(results[i].error.empty()) << results[i].error;
+        EXPECT_EQ(results[i].simulated, configs[i].duration);
+        auto metabolism = std::find_if(results[i].job_stats.begin(), results[i].job_stats.end(),
+                                       [](const auto& s) { return s.name == "metabolism"; });
+        ASSERT_NE(metabolism, results[i].job_stats.end());
+        EXPECT_EQ(metabolism->runs, static_cast<uint64_t>(configs[i].duration / 1000ms));
+    }
+}
+
+TEST(SimulationTest, HeadlessSleepCycleTouchesNoStore) {
+    namespace fs = std::filesystem;
+    // Run where state/ exists and is writable, so any write would land
+    const fs::path dir = fs::temp_directory_path() / ("brain_headless_" + std::to_string(::getpid()));
+    fs::create_directories(dir / "state");
+    const fs::path cwd = fs::current_path();
+    fs::current_path(dir);
+    {
+        BrainOptions options;
+        options.headless = true;
+        Brain brain(options);
+        EXPECT_EQ(brain.memory_store, nullptr);
+        EXPECT_EQ(brain.redis_cache, nullptr);
+        EXPECT_EQ(brain.ros_bridge, nullptr);
+
+        brain.interact("tell me everything about the quiet northern forests");
+        brain.interact_batch(std::vector<std::string>{"describe the slow rivers of the southern plains"});
+        brain.sleep();
+        EXPECT_EQ(brain.memory_store, nullptr);
+    }
+    fs::current_path(cwd);
+    EXPECT_TRUE(fs::is_empty(dir / "state"));
+    fs::remove_all(dir);
+}
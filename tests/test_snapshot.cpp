@@ -0,0 +1,327 @@
+#include <gtest/gtest.h>
+#include "brain.hpp"
+#include "snapshot_writer.hpp"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <random>
+
+namespace fs = std::filesystem;
+
+class SnapshotTest : public ::testing::Test {
+protected:
+    fs::path dir;
+
+    void SetUp() override {
+        dir = fs::temp_directory_path() / ("brain_snapshot_test_" + std::to_string(::getpid()));
+        fs::create_directories(dir);
+    }
+
+    void TearDown() override {
+        fs::remove_all(dir);
+    }
+
+    static std::string read_file(const fs::path& p) {
+        std::ifstream in(p, std::ios::binary);
+        std::stringstream ss;
+        ss << in.rdbuf();
+        return ss.str();
+    }
+};
+
+TEST_F(SnapshotTest, WriterReplacesFileAtomically) {
+    dnn::SnapshotWriter writer(16); // Tiny buffer to exercise the flush paths
+    auto path = (dir / "state.bin").string();
+
+    std::string big(1000, 'x');
+    ASSERT_TRUE(writer.write_now(path, [&](std::ostream& os) {
+        os << "header";
+        os.write(big.data(), static_cast<std::streamsize>(big.size()));
+        return true;
+    }));
+    EXPECT_EQ(read_file(path), "header" + big);
+    EXPECT_FALSE(fs::exists(path + ".tmp"));
+
+    // A failing job must leave the previous snapshot untouched
+    EXPECT_FALSE(writer.write_now(path, [](std::ostream& os) {
+        os << "partial";
+        return false;
+    }));
+    EXPECT_EQ(read_file(path), "header" + big);
+    EXPECT_FALSE(fs::exists(path + ".tmp"));
+}
+
+TEST_F(SnapshotTest, BackgroundJobsRunInOrder) {
+    dnn::SnapshotWriter writer;
+    auto path = (dir / "ordered.bin").string();
+
+    std::vector<std::future<bool>> results;
+    for (int i = 0; i < 5; ++i) {
+        results.push_back(writer.submit(path, [i](std::ostream& os) {
+            os << "gen" << i;
+            return true;
+        }));
+    }
+    for (auto& r : results) EXPECT_TRUE(r.get());
+    writer.wait_idle();
+
+    EXPECT_EQ(writer.pending(), 0u);
+    EXPECT_EQ(read_file(path), "gen4");
+}
+
+TEST_F(SnapshotTest, AsyncSaveRoundTripsThroughLoad) {
+    auto path = (dir / "brain.bin").string();
+    std::vector<double> probe(Brain::VOCAB_SIZE, 0.0);
+    probe[42] = 1.0;
+
+    std::vector<double> expected;
+    {
+        Brain brain;
+        brain.personality.curiosity = 0.123;
+        brain.vocab_decode[7] = "snapshot";
+        expected = brain.language_encoder->network.predict(probe);
+
+        auto saved = brain.save_async(path);
+        // The snapshot is frozen at capture time; later mutations must not leak into it
+        brain.personality.curiosity = 0.9;
+        brain.language_encoder->train(probe, std::vector<double>(Brain::VECTOR_DIM, 5.0), 0.5);
+        ASSERT_TRUE(saved.get());
+    }
+
+    Brain restored;
+    restored.load(path);
+    EXPECT_DOUBLE_EQ(restored.personality.curiosity, 0.123);
+    EXPECT_EQ(restored.vocab_decode[7], "snapshot");
+
+    auto actual = restored.language_encoder->network.predict(probe);
+    ASSERT_EQ(actual.size(), expected.size());
+    for (size_t i = 0; i < actual.size(); ++i) EXPECT_DOUBLE_EQ(actual[i], expected[i]);
+}
+
+TEST_F(SnapshotTest, DirtyRangesFollowTouchedRows) {
+    std::mt19937_64 rng(1);
+    dnn::PlasticLayer layer(4, 8, rng);
+    EXPECT_EQ(layer.dirty_row_count(), 8u); // Fresh layers have never been checkpointed
+
+    layer.clear_dirty();
+    layer.dirty_rows[2] = layer.dirty_rows[3] = layer.dirty_rows[6] = 1;
+    auto ranges = layer.dirty_ranges();
+    ASSERT_EQ(ranges.size(), 2u);
+    EXPECT_EQ(ranges[0], std::make_pair(std::size_t{2}, std::size_t{4}));
+    EXPECT_EQ(ranges[1], std::make_pair(std::size_t{6}, std::size_t{7}));
+
+    std::stringstream ss;
+    layer.save_rows(ss, 2, 4);
+    EXPECT_EQ(ss.str().size(), 2 * layer.row_bytes());
+
+    std::mt19937_64 other_rng(2);
+    dnn::PlasticLayer copy(4, 8, other_rng);
+    ASSERT_TRUE(copy.load_rows(ss, 2, 4));
+    for (std::size_t k = 2 * 4; k < 4 * 4; ++k) EXPECT_DOUBLE_EQ(copy.weights[k], layer.weights[k]);
+    EXPECT_DOUBLE_EQ(copy.biases[3], layer.biases[3]);
+}
+
+TEST_F(SnapshotTest, CheckpointDeltaReplaysOnLoad) {
+    auto path = (dir / "ckpt.bin").string();
+    std::vector<double> probe(Brain::VECTOR_DIM, 0.1);
+    std::vector<double> expected;
+    {
+        Brain brain;
+        brain.checkpoint(path);
+        brain.snapshot_writer->wait_idle();
+        auto base_size = fs::file_size(path);
+
+        // Touch a single row: the delta must scale with that, not the model
+        auto& layer = brain.language_decoder->network.layers()[0];
+        layer.weights[0] += 0.25;
+        layer.dirty_rows[0] = 1;
+        brain.personality.curiosity = 0.321;
+        brain.vocab_decode[9] = "delta";
+        expected = brain.language_decoder->network.predict(probe);
+
+        brain.checkpoint(path);
+        brain.snapshot_writer->wait_idle();
+        EXPECT_LT(fs::file_size(path + ".delta"), base_size / 10);
+    }
+
+    Brain restored;
+    restored.load(path);
+    EXPECT_DOUBLE_EQ(restored.personality.curiosity, 0.321);
+    EXPECT_EQ(restored.vocab_decode[9], "delta");
+    auto actual = restored.language_decoder->network.predict(probe);
+    ASSERT_EQ(actual.size(), expected.size());
+    for (size_t i = 0; i < actual.size(); ++i) EXPECT_DOUBLE_EQ(actual[i], expected[i]);
+}
+
+TEST_F(SnapshotTest, WideLayerDeltaTracksColumns) {
+    std::mt19937_64 rng(3);
+    dnn::PlasticLayer layer(64, 4, rng);
+    ASSERT_TRUE(layer.tracks_columns());
+    layer.homeostatic_targets = {0.5, 0.5, 0.5, 0.5};
+    std::stringstream base;
+    layer.save(base);
+    layer.clear_dirty();
+
+    // One-hot input: every row moves, but only column 5 beyond the homeostatic shift
+    std::vector<double> input(64, 0.0), output = {0.2, 0.0, 0.7, 0.1};
+    input[5] = 1.0;
+    std::vector<double> grad_w(64 * 4, 0.0), grad_b = {0.1, 0.0, -0.2, 0.05};
+    for (std::size_t j = 0; j < 4; ++j) grad_w[j * 64 + 5] = grad_b[j];
+    for (int step = 0; step < 3; ++step) layer.apply_gradients(grad_w, grad_b, 0.1, input, output);
+
+    EXPECT_EQ(layer.dirty_row_count(), 0u);
+    ASSERT_EQ(layer.dirty_column_ranges().size(), 1u);
+    EXPECT_EQ(layer.dirty_column_ranges()[0], std::make_pair(std::size_t{5}, std::size_t{6}));
+    EXPECT_LT(layer.delta_bytes(), layer.out_size * layer.row_bytes() / 4);
+
+    std::stringstream delta;
+    layer.save_delta(delta);
+    EXPECT_EQ(delta.str().size(), layer.delta_bytes());
+
+    dnn::PlasticLayer copy;
+    copy.load(base);
+    ASSERT_TRUE(copy.skip_delta(delta));
+    delta.seekg(0);
+    copy.load_delta(delta);
+    for (std::size_t k = 0; k < layer.weights.size(); ++k) EXPECT_EQ(copy.weights[k], layer.weights[k]);
+    for (std::size_t j = 0; j < 4; ++j) EXPECT_EQ(copy.biases[j], layer.biases[j]);
+}
+
+TEST_F(SnapshotTest, SparseTeachCheckpointsAsSmallDelta) {
+    auto path = (dir / "teach.bin").string();
+    std::vector<double> probe(Brain::VECTOR_DIM, 0.1);
+    std::vector<double> expected;
+    std::vector<double> word(Brain::VOCAB_SIZE, 0.0);
+    word[42] = 1.0;
+    std::vector<double> expected_encoding;
+    {
+        Brain brain;
+        brain.checkpoint(path);
+        brain.snapshot_writer->wait_idle();
+        auto base_size = fs::file_size(path);
+
+        // One lesson trains every region, but only touches a few vocabulary columns
+        brain.teach("hello there", "general kenobi");
+        expected = brain.language_decoder->network.predict(probe);
+        expected_encoding = brain.language_encoder->network.predict(word);
+
+        brain.checkpoint(path);
+        brain.snapshot_writer->wait_idle();
+        auto delta_size = fs::file_size(path + ".delta");
+        EXPECT_GT(delta_size, 16u); // A delta record, not a compaction
+        EXPECT_LT(delta_size, base_size / 4);
+    }
+
+    Brain restored;
+    restored.load(path);
+    auto actual = restored.language_decoder->network.predict(probe);
+    ASSERT_EQ(actual.size(), expected.size());
+    for (size_t i = 0; i < actual.size(); ++i) EXPECT_DOUBLE_EQ(actual[i], expected[i]);
+    auto encoding = restored.language_encoder->network.predict(word);
+    ASSERT_EQ(encoding.size(), expected_encoding.size());
+    for (size_t i = 0; i < encoding.size(); ++i) EXPECT_DOUBLE_EQ(encoding[i], expected_encoding[i]);
+}
+
+TEST_F(SnapshotTest, CheckpointCompactsAndSurvivesTornTail) {
+    auto path = (dir / "compact.bin").string();
+    {
+        Brain brain;
+        brain.checkpoint_max_deltas = 1;
+        brain.checkpoint(path);                 // full
+        brain.personality.curiosity = 0.4;
+        brain.checkpoint(path);                 // delta
+        brain.snapshot_writer->wait_idle();
+        EXPECT_GT(fs::file_size(path + ".delta"), 16u);
+
+        brain.personality.curiosity = 0.6;
+        brain.checkpoint(path);                 // chain full: compacts
+        brain.snapshot_writer->wait_idle();
+        EXPECT_EQ(fs::file_size(path + ".delta"), 16u); // header only
+
+        brain.personality.curiosity = 0.8;
+        brain.checkpoint(path);                 // delta on the new base
+        brain.snapshot_writer->wait_idle();
+    }
+
+    // A crash mid-append leaves a partial record; replay stops before it
+    {
+        std::ofstream out(path + ".delta", std::ios::binary | std::ios::app);
+        uint64_t bogus_len = 1 << 20;
+        out.write(reinterpret_cast<const char*>(&bogus_len), sizeof(bogus_len));
+        out << "torn";
+    }
+
+    Brain restored;
+    restored.load(path);
+    EXPECT_DOUBLE_EQ(restored.personality.curiosity, 0.8);
+}
+
+TEST_F(SnapshotTest, CorruptDeltaRecordIsNotBuiltOn) {
+    auto path = (dir / "corrupt.bin").string();
+    {
+        Brain brain;
+        brain.checkpoint(path);                 // full
+        brain.personality.curiosity = 0.4;
+        brain.checkpoint(path);                 // delta
+        brain.snapshot_writer->wait_idle();
+    }
+    // Garbage after the good record, with a length no file could hold
+    {
+        std::ofstream out(path + ".delta", std::ios::binary | std::ios::app);
+        uint64_t bogus_len = ~uint64_t{0};
+        uint64_t bogus_sum = 0;
+        out.write(reinterpret_cast<const char*>(&bogus_len), sizeof(bogus_len));
+        out.write(reinterpret_cast<const char*>(&bogus_sum), sizeof(bogus_sum));
+        out << "garbage";
+    }
+    {
+        Brain brain;
+        brain.load(path);
+        EXPECT_DOUBLE_EQ(brain.personality.curiosity, 0.4);
+
+        // A delta appended after the garbage would never replay: this one is full
+        brain.personality.curiosity = 0.6;
+        brain.checkpoint(path);
+        brain.snapshot_writer->wait_idle();
+        EXPECT_EQ(fs::file_size(path + ".delta"), 16u);
+        brain.personality.curiosity = 0.7;
+        brain.checkpoint(path);
+        brain.snapshot_writer->wait_idle();
+    }
+
+    Brain restored;
+    restored.load(path);
+    EXPECT_DOUBLE_EQ(restored.personality.curiosity, 0.7);
+}
+
+TEST_F(SnapshotTest, FailedCheckpointWriteForcesFullCheckpoint) {
+    auto path = (dir / "failed.bin").string();
+    std::vector<double> probe(Brain::VECTOR_DIM, 0.1);
+    std::vector<double> expected;
+    {
+        Brain brain;
+        brain.checkpoint(path);
+        brain.snapshot_writer->wait_idle();
+
+        // The delta append fails: its rows' dirty flags are already cleared
+        fs::remove(path + ".delta");
+        fs::create_directory(path + ".delta");
+        auto& layer = brain.language_decoder->network.layers()[0];
+        layer.weights[0] += 0.25;
+        layer.dirty_rows[0] = 1;
+        expected = brain.language_decoder->network.predict(probe);
+        brain.checkpoint(path);
+        brain.snapshot_writer->wait_idle();
+
+        fs::remove(path + ".delta");
+        brain.checkpoint(path); // Full, so the lost row is written with the base
+        brain.snapshot_writer->wait_idle();
+        EXPECT_EQ(fs::file_size(path + ".delta"), 16u);
+    }
+
+    Brain restored;
+    restored.load(path);
+    auto actual = restored.language_decoder->network.predict(probe);
+    ASSERT_EQ(actual.size(), expected.size());
+    for (size_t i = 0; i < actual.size(); ++i) EXPECT_DOUBLE_EQ(actual[i], expected[i]);
+}
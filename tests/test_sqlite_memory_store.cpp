@@ -0,0 +1,160 @@
+#include <gtest/gtest.h>
+#include "memory_store.hpp"
+#include "sqlite_memory_store.hpp"
+#include "sqlite_storage.hpp"
+#include <filesystem>
+#include <unistd.h>
+
+namespace {
+    class SqliteMemoryStoreTest : public ::testing::Test {
+    protected:
+        std::filesystem::path dir;
+
+        void SetUp() override {
+            dir = std::filesystem::temp_directory_path() / ("brain_sqlite_" + std::to_string(::getpid()) + "_" +
+                                                            ::testing::UnitTest::GetInstance()->current_test_info()->name());
+            std::filesystem::remove_all(dir);
+        }
+        void TearDown() override { std::filesystem::remove_all(dir); }
+        std::string db() const { return (dir / "memory.db").string(); }
+    };
+
+    std::vector<double> direction(double x, double y) {
+        std::vector<double> v(384, 0.0);
+        v[0] = x;
+        v[1] = y;
+        return v;
+    }
+}
+
+TEST_F(SqliteMemoryStoreTest, QueriesAndRanksWithFts5) {
+    SqliteMemoryStore store(db());
+    ASSERT_TRUE(store.init());
+    ASSERT_TRUE(store.store("Observation", "Paris is the capital of France", "geo"));
+    ASSERT_TRUE(store.store("Observation", "Paris has the Louvre; Paris hosts millions of visitors", "travel"));
+    ASSERT_TRUE(store.store("Thought", "Berlin is the capital of Germany", "geo"));
+    ASSERT_TRUE(store.store("Thought", "Secret plans for Paris", "", "PRIVATE"));
+    EXPECT_EQ(store.get_memory_count(), 4);
+
+    auto paris = store.query("Paris");
+    ASSERT_EQ(paris.size(), 2u); // The PRIVATE row is hidden
+    EXPECT_GT(paris[0].id, paris[1].id);
+    EXPECT_EQ(store.query("paris", "PRIVATE").size(), 3u);
+    EXPECT_TRUE(store.query("Pa").empty()); // Shorter than an index token
+    auto many = store.query_many({"capital", "louvre", "missing"});
+    EXPECT_EQ(many["capital"].size(), 2u);
+    EXPECT_EQ(many["louvre"].size(), 1u);
+    EXPECT_FALSE(many.count("missing"));
+
+    // More occurrences in a shorter text rank higher; require_all intersects
+    auto ranked = store.search({{"paris"}, {"capital"}}, 5);
+    ASSERT_EQ(ranked.size(), 3u);
+    EXPECT_EQ(ranked[0].content, "Paris is the capital of France");
+    EXPECT_GT(ranked[0].score, ranked[1].score);
+    auto both = store.search({{"paris capital"}}, 5, "PUBLIC", true);
+    ASSERT_EQ(both.size(), 1u);
+    EXPECT_EQ(both[0].tags, "geo");
+    auto weighted = store.search({{"germany", 3.0}, {"louvre"}}, 1);
+    ASSERT_EQ(weighted.size(), 1u);
+    EXPECT_EQ(weighted[0].content, "Berlin is the capital of Germany");
+    auto batch = store.search_many({{{"berlin"}}, {{"nothing"}}, {}}, 2);
+    ASSERT_EQ(batch.size(), 3u);
+    EXPECT_EQ(batch[0].size(), 1u);
+    EXPECT_TRUE(batch[1].empty());
+    EXPECT_TRUE(batch[2].empty());
+
+    EXPECT_EQ(store.get_recent(2).size(), 2u);
+    const std::string graph = store.get_graph_json(10);
+    EXPECT_NE(graph.find("{\"id\": \"paris\", \"val\": 3}"), std::string::npos);
+    EXPECT_NE(graph.find("\"source\""), std::string::npos);
+    EXPECT_TRUE(store.verify_index());
+
+    store.clear();
+    EXPECT_EQ(store.get_memory_count(), 0);
+    EXPECT_TRUE(store.query("paris", "PRIVATE").empty());
+    EXPECT_TRUE(store.verify_index());
+}
+
+TEST_F(SqliteMemoryStoreTest, BatchesPersistRowsAndEmbeddings) {
+    {
+        SqliteMemoryStore store(db());
+        ASSERT_TRUE(store.init());
+        std::vector<MemoryRecord> records;
+        for (int i = 0; i < 300; ++i) records.push_back({"Research", "record number " + std::to_string(i) + " about owls", "bulk"});
+        records[0].embedding_key = "north";
+        records[0].embedding = direction(0.0, 1.0);
+        records[1].embedding_key = "east";
+        records[1].embedding = direction(1.0, 0.0);
+        EXPECT_TRUE(store.store_batch(records));
+        EXPECT_EQ(store.store_many({{"Thought", "owls hunt at night"}}), 1u);
+        EXPECT_EQ(store.bulk_load({{"Thought", "owls nest in trees", "", "PUBLIC", "north_east", direction(1.0, 1.0)}}), 1u);
+        EXPECT_EQ(store.get_memory_count(), 302);
+        EXPECT_EQ(store.vector_stats().nodes, 3u);
+        EXPECT_EQ(store.search_similar(direction(0.1, 1.0), 1), std::vector<std::string>{"north"});
+        EXPECT_LE(store.prepared_count(), 8u); // One INSERT reused for every row
+    }
+
+    // A second process sees the committed rows; the vector snapshot is reused
+    {
+        SqliteMemoryStore reopened(db());
+        ASSERT_TRUE(reopened.init());
+        EXPECT_TRUE(std::filesystem::exists(db() + ".vectors"));
+        EXPECT_EQ(reopened.get_memory_count(), 302);
+        EXPECT_EQ(reopened.query("owls").size(), 20u);
+        EXPECT_EQ(reopened.search_similar(direction(1.0, 0.9), 1), std::vector<std::string>{"north_east"});
+        auto v = reopened.retrieve_embedding("east");
+        ASSERT_EQ(v.size(), 384u);
+        EXPECT_NEAR(v[0], 1.0, 1e-6);
+    }
+
+    // An embedding rewritten behind the snapshot keeps the count the same;
+    // its newer version is caught up on the next load
+    {
+        SqliteStorage storage(db());
+        ASSERT_TRUE(storage.connect());
+        storage.store_embedding("east", direction(0.0, -1.0));
+    }
+    SqliteMemoryStore caught_up(db());
+    ASSERT_TRUE(caught_up.init());
+    EXPECT_EQ(caught_up.vector_stats().nodes, 3u);
+    EXPECT_EQ(caught_up.search_similar(direction(0.1, -1.0), 1), std::vector<std::string>{"east"});
+}
+
+TEST_F(SqliteMemoryStoreTest, StorageImplementsDatabaseInterface) {
+    SqliteStorage storage(db());
+    ASSERT_TRUE(storage.connect());
+    storage.store_memory("greeting", "hello");
+    storage.store_memories_bulk({{"a", "1"}, {"b", "2"}});
+    EXPECT_EQ(storage.retrieve_memory("greeting"), "hello");
+    EXPECT_EQ(storage.retrieve_memory("b"), "2");
+
+    storage.store_embedding("north", direction(0.0, 1.0));
+    storage.store_embedding("east", direction(1.0, 0.0));
+    EXPECT_EQ(storage.search_similar(direction(0.9, 0.1), 2), (std::vector<std::string>{"east", "north"}));
+    EXPECT_NEAR(storage.retrieve_embedding("north")[1], 1.0, 1e-6);
+    EXPECT_EQ(storage.retrieve_memory("north"), ""); // Embedding-only keys keep an empty value
+
+    ASSERT_TRUE(storage.begin_transaction());
+    storage.store_memory("greeting", "changed");
+    EXPECT_TRUE(storage.rollback());
+    EXPECT_EQ(storage.retrieve_memory("greeting"), "hello");
+    ASSERT_TRUE(storage.begin_transaction());
+    storage.store_memory("greeting", "committed");
+    EXPECT_TRUE(storage.commit());
+    EXPECT_EQ(storage.retrieve_memory("greeting"), "committed");
+}
+
+TEST_F(SqliteMemoryStoreTest, MemoryStoreSelectsSqliteAtRuntime) {
+    EXPECT_TRUE(MemoryStore::is_embedded("sqlite:" + db()));
+    EXPECT_FALSE(MemoryStore::is_embedded("host=postgres dbname=brain_db"));
+
+    MemoryStore store("sqlite:" + db());
+    ASSERT_TRUE(store.init());
+    ASSERT_TRUE(store.store("Observation", "Embedded recall needs no server"));
+    auto found = store.search({{"embedded"}, {"server"}}, 1);
+    ASSERT_EQ(found.size(), 1u);
+    EXPECT_EQ(found[0].content, "Embedded recall needs no server");
+    store.store_embedding("word", direction(1.0, 0.0));
+    EXPECT_EQ(store.search_similar(direction(1.0, 0.1), 1), std::vector<std::string>{"word"});
+    EXPECT_EQ(store.get_memory_count(), 1);
+}
@@ -0,0 +1,49 @@
+#include <gtest/gtest.h>
+#include "brain.hpp"
+#include <algorithm>
+
+namespace {
+const StartupReport::Phase* find_phase(const StartupReport& report, const std::string& name) {
+    auto it = std::find_if(report.phases.begin(), report.phases.end(),
+                           [&](const StartupReport::Phase& p) { return p.name == name; });
+    return it == report.phases.end() ? nullptr : &*it;
+}
+} // namespace
+
+TEST(StartupTest, ReportsPerPhaseTimings) {
+    Brain brain;
+    auto report = brain.get_startup_report();
+
+    EXPECT_GT(report.total_ms, 0.0);
+    for (const char* region : {"region:LanguageEncoder", "region:LanguageDecoder", "region:Memory", "region:Cognitive"}) {
+        const auto* phase = find_phase(report, region);
+        ASSERT_NE(phase, nullptr) << region;
+        EXPECT_TRUE(phase->parallel);
+        EXPECT_LE(phase->ms, report.total_ms);
+    }
+    ASSERT_NE(find_phase(report, "config"), nullptr);
+    EXPECT_FALSE(find_phase(report, "config")->parallel);
+
+    // Everything the automata thread touches exists once the constructor returns
+    EXPECT_NE(brain.language_encoder, nullptr);
+    EXPECT_NE(brain.cognitive_center, nullptr);
+    EXPECT_NE(brain.cognitive_engine, nullptr);
+    EXPECT_NE(brain.ros_bridge, nullptr);
+    EXPECT_NE(report.to_string().find("region:LanguageEncoder="), std::string::npos);
+}
+
+TEST(StartupTest, RarelyUsedSubsystemsAreBuiltOnFirstUse) {
+    Brain brain;
+    auto report = brain.get_startup_report();
+    EXPECT_NE(std::find(report.deferred.begin(), report.deferred.end(), "CognitiveCore"), report.deferred.end());
+    EXPECT_EQ(brain.cognitive_core, nullptr);
+    EXPECT_EQ(brain.skill_manager, nullptr);
+
+    brain.query_commonsense("bird", "CapableOf");
+    EXPECT_NE(brain.cognitive_core, nullptr);
+    auto* core = brain.cognitive_core.get();
+    brain.get_cognitive_status();
+    EXPECT_EQ(brain.cognitive_core.get(), core); // Built exactly once
+
+    EXPECT_NE(find_phase(brain.get_startup_report(), "deferred:CognitiveCore"), nullptr);
+}
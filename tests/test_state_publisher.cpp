@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+#include "brain.hpp"
+#include "state_publisher.hpp"
+#include "json.hpp"
+
+using json = nlohmann::json;
+
+TEST(StatePublisherTest, SerialisesOnlyChangedSections) {
+    dnn::StatePublisher pub({"a", "b"});
+    int calls = 0;
+    auto make = [&](std::string v) { return [&calls, v] { ++calls; return v; }; };
+
+    EXPECT_TRUE(pub.update(0, 1, make("1")));
+    EXPECT_TRUE(pub.update(1, 7, make("\"x\"")));
+    EXPECT_EQ(pub.full(), "{\"a\":1,\"b\":\"x\"}");
+    uint64_t seen = pub.version();
+
+    EXPECT_FALSE(pub.update(0, 1, make("unused")));
+    EXPECT_FALSE(pub.update(1, 7, make("unused")));
+    EXPECT_EQ(calls, 2);
+    EXPECT_EQ(pub.delta(seen), "");
+
+    EXPECT_TRUE(pub.update(1, 8, make("\"y\"")));
+    EXPECT_EQ(pub.delta(seen), "{\"b\":\"y\"}");
+    EXPECT_EQ(pub.delta(0), "{\"a\":1,\"b\":\"y\"}");
+
+    // A forced refresh that produces the same text is not a change
+    seen = pub.version();
+    pub.invalidate();
+    EXPECT_FALSE(pub.update(0, 1, make("1")));
+    EXPECT_EQ(pub.delta(seen), "");
+    EXPECT_EQ(pub.stats().serialised, 4u);
+}
+
+TEST(StatePublisherTest, Helpers) {
+    auto bins = dnn::StatePublisher::downsample({1, 3, 5, 7, 9, 11}, 3);
+    EXPECT_EQ(bins, (std::vector<double>{2, 6, 10}));
+    EXPECT_EQ(dnn::StatePublisher::downsample({1, 2}, 4).size(), 2u);
+
+    std::string out;
+    dnn::StatePublisher::append_string(out, "say \"hi\"\n");
+    EXPECT_EQ(out, "\"say \\\"hi\\\"\\n\"");
+    out.clear();
+    dnn::StatePublisher::append_number(out, 0.123456);
+    EXPECT_EQ(out, "0.1235");
+}
+
+TEST(StatePublisherTest, BrainStateDeltas) {
+    BrainOptions options;
+    options.headless = true; // No autonomy ticks changing state under the test
+    Brain brain(options);
+    brain.state_activity_bins = 16;
+
+    auto state = json::parse(brain.get_json_state());
+    for (const char* key : {"personality", "emotions", "sensory_activity", "thought", "learning", "metadata"}) {
+        EXPECT_TRUE(state.contains(key)) << key;
+    }
+    ASSERT_FALSE(state["sensory_activity"].empty());
+    for (const auto& unit : state["sensory_activity"]) EXPECT_LE(unit["activity"].size(), 16u);
+
+    uint64_t version = 0;
+    EXPECT_FALSE(brain.get_json_state_delta(version).empty()); // Version 0: everything
+    EXPECT_EQ(brain.get_json_state_delta(version), "");
+
+    {
+        std::lock_guard<std::recursive_mutex> lock(brain.brain_mutex);
+        brain.emotions.fear = 0.75;
+        brain.current_thought = "line \"one\"";
+    }
+    auto delta = json::parse(brain.get_json_state_delta(version));
+    EXPECT_EQ(delta.size(), 2u);
+    EXPECT_DOUBLE_EQ(delta["emotions"]["fear"].get<double>(), 0.75);
+    EXPECT_EQ(delta["thought"], "line \"one\"");
+    EXPECT_EQ(brain.get_json_state_delta(version), "");
+}
@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+#include "brain.hpp"
+
+TEST(TeachTest, BatchedCurriculumReportsProgress) {
+    BrainOptions options;
+    options.headless = true;
+    Brain brain(options);
+
+    std::vector<std::pair<std::string, std::string>> pairs;
+    for (int i = 0; i < 40; ++i) {
+        pairs.emplace_back("hello number " + std::to_string(i), "hi there friend " + std::to_string(i % 5));
+    }
+
+    TeachOptions teach;
+    teach.epochs = 3;
+    teach.batch_size = 8;
+    std::vector<TeachProgress> progress;
+    teach.on_progress = [&](const TeachProgress& p) { progress.push_back(p); };
+
+    TeachReport report = brain.teach_batch(pairs, teach);
+    EXPECT_EQ(report.pairs, pairs.size());
+    EXPECT_EQ(report.epochs, 3);
+    EXPECT_GT(report.pairs_per_sec, 0.0);
+    EXPECT_GE(report.total_ms, report.train_ms);
+    EXPECT_NE(report.to_string().find("40 pairs x 3 epochs"), std::string::npos);
+
+    ASSERT_EQ(progress.size(), 3u);
+    EXPECT_EQ(progress.back().epoch, 3);
+    EXPECT_LE(progress.back().loss, progress.front().loss);
+    EXPECT_DOUBLE_EQ(report.final_loss, progress.back().loss);
+
+    // Target words are decodable afterwards, as with teach()
+    size_t idx = std::hash<std::string>{}("friend") % Brain::VOCAB_SIZE;
+    ASSERT_TRUE(brain.vocab_decode.count(idx));
+    EXPECT_EQ(brain.vocab_decode[idx], "friend");
+}
+
+TEST(TeachTest, MissingCurriculumIsEmpty) {
+    BrainOptions options;
+    options.headless = true;
+    Brain brain(options);
+    EXPECT_EQ(brain.teach_curriculum("data/does_not_exist.txt").pairs, 0u);
+}
+
+TEST(TeachTest, TimeBudgetStopsEarly) {
+    BrainOptions options;
+    options.headless = true;
+    Brain brain(options);
+
+    std::vector<std::pair<std::string, std::string>> pairs;
+    for (int i = 0; i < 64; ++i) pairs.emplace_back("question " + std::to_string(i), "answer " + std::to_string(i));
+
+    TeachOptions teach;
+    teach.epochs = 1000;
+    teach.batch_size = 8;
+    teach.time_budget_ms = 50.0;
+    teach.on_progress = [](const TeachProgress&) {};
+    TeachReport report = brain.teach_batch(pairs, teach);
+    EXPECT_TRUE(report.budget_exhausted);
+    EXPECT_LT(report.epochs, 1000);
+    EXPECT_LE(report.pairs, pairs.size());
+    EXPECT_NE(report.to_string().find("time budget"), std::string::npos);
+}
+
+TEST(TeachTest, RemCycleReplaysConversationSample) {
+    BrainOptions options;
+    options.headless = true;
+    Brain brain(options);
+    for (int i = 0; i < 4; ++i) {
+        brain.conversation_history.push_back({"User", "tell me about rivers " + std::to_string(i), "", 0});
+        brain.conversation_history.push_back({"Brain", "rivers flow to the sea", "", 0});
+    }
+    brain.replay_options.samples = 3;
+    brain.replay_options.teach.epochs = 1;
+
+    ReplayReport report = brain.perform_rem_cycle();
+    EXPECT_EQ(report.conversation_pairs, 4u);
+    EXPECT_EQ(report.journal_pairs, 0u); // Headless brains do not read state/
+    EXPECT_EQ(report.teach.pairs, 3u);
+    EXPECT_EQ(report.teach.epochs, 1);
+
+    brain.conversation_history.clear();
+    EXPECT_EQ(brain.perform_rem_cycle().teach.pairs, 0u);
+}
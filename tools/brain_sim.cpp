@@ -0,0 +1,55 @@
+// Headless fast-forward of Brain life on a virtual clock.
+//
+// Usage: brain_sim [hours=24] [simulations=1] [threads=0 (all cores)]
+#include "brain_simulation.hpp"
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+namespace {
+const char* task_name(TaskType t) {
+    switch (t) {
+        case TaskType::RESEARCH: return "research";
+        case TaskType::SLEEP: return "sleep";
+        case TaskType::INTERACTION: return "interaction";
+        case TaskType::MAINTENANCE: return "maintenance";
+        case TaskType::IDLE: return "idle";
+        case TaskType::EAT: return "eat";
+        case TaskType::DRINK: return "drink";
+        case TaskType::MOTORS: return "motors";
+    }
+    return "?";
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    double hours = argc > 1 ? std::stod(argv[1]) : 24.0;
+    std::size_t sims = argc > 2 ? std::stoul(argv[2]) : 1;
+    std::size_t threads = argc > 3 ? std::stoul(argv[3]) : 0;
+
+    std::vector<SimulationConfig> configs(sims);
+    for (std::size_t i = 0; i < sims; ++i) {
+        configs[i].name = "sim-" + std::to_string(i);
+        configs[i].duration = std::chrono::milliseconds(static_cast<long long>(hours * 3600.0 * 1000.0));
+    }
+
+    auto results = BrainSimulation::run_batch(configs, threads);
+
+    std::cout << std::fixed << std::setprecision(2);
+    for (const auto& r : results) {
+        if (!r.error.empty()) {
+            std::cout << r.name << ": FAILED: " << r.error << "\n";
+            continue;
+        }
+        std::cout << r.name << ": " << r.simulated.count() / 3600000.0 << " h simulated in " << r.run_ms
+                  << " ms (x" << std::setprecision(0) << r.speedup * 1.0 << std::setprecision(2)
+                  << ", setup " << r.setup_ms << " ms), " << r.job_runs << " job runs\n";
+        std::cout << "  energy " << r.emotions.energy << " happiness " << r.emotions.happiness
+                  << " hunger " << r.metabolism.hunger << " thirst " << r.metabolism.thirst
+                  << " cortisol " << r.hormones.cortisol << " melatonin " << r.hormones.melatonin << "\n";
+        std::cout << "  tasks:";
+        for (const auto& [type, n] : r.completed_tasks) std::cout << " " << task_name(type) << "=" << n;
+        std::cout << "\n";
+    }
+    return 0;
+}
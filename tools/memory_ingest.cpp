@@ -0,0 +1,71 @@
+// Loads a text corpus into long-term memory through the COPY bulk path
+// (MemoryStore::bulk_load), one memory per non-empty line, and reports the
+// load rate. The database comes from DB_HOST/DB_PORT/DB_NAME/DB_USER/DB_PASS.
+//
+// Usage: memory_ingest <corpus.txt> [type] [tags] [batch_rows]
+#include "memory_store.hpp"
+#include "infra/config.hpp"
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: memory_ingest <corpus.txt> [type] [tags] [batch_rows]" << std::endl;
+        return 1;
+    }
+    const std::string path = argv[1];
+    const std::string type = argc > 2 ? argv[2] : "Knowledge";
+    const std::string tags = argc > 3 ? argv[3] : "Corpus";
+    const std::size_t batch_rows = argc > 4 ? std::stoul(argv[4]) : 10000;
+
+    std::ifstream in(path);
+    if (!in) {
+        std::cerr << "Cannot open " << path << std::endl;
+        return 1;
+    }
+
+    MemoryStore store(dnn::infra::Config::get_db_conn_str());
+    if (!store.init()) {
+        std::cerr << "Cannot reach the memory database" << std::endl;
+        return 1;
+    }
+
+    std::size_t rows = 0, failed = 0, bytes = 0;
+    double read_ms = 0.0, load_ms = 0.0;
+    std::vector<MemoryRecord> batch;
+    batch.reserve(batch_rows);
+    auto flush = [&] {
+        if (batch.empty()) return;
+        auto start = std::chrono::steady_clock::now();
+        std::size_t written = store.bulk_load(batch);
+        load_ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        rows += written;
+        failed += batch.size() - written;
+        batch.clear();
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    std::string line;
+    while (true) {
+        auto read_start = std::chrono::steady_clock::now();
+        bool more = static_cast<bool>(std::getline(in, line));
+        read_ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - read_start).count();
+        if (!more) break;
+        bytes += line.size() + 1;
+        if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+        batch.push_back(MemoryRecord{type, line, tags});
+        if (batch.size() >= batch_rows) flush();
+    }
+    flush();
+    const double total_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Loaded " << rows << " rows (" << bytes / 1024 << " KiB) from " << path << " in " << total_s << " s: "
+              << (total_s > 0 ? static_cast<double>(rows) / total_s : 0.0) << " rows/s; read " << read_ms << " ms, load "
+              << load_ms << " ms";
+    if (failed) std::cout << "; " << failed << " rows failed";
+    std::cout << std::endl;
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,32 @@
+// Converts a legacy text vocabulary ("word v1 v2 ... vN" per line) into the
+// binary, mmap-able embedding file read by Brain::load_vocab.
+//
+// Usage: vocab_convert [in.txt] [out.bin] [dim]
+#include "embedding_store.hpp"
+#include <chrono>
+#include <iostream>
+#include <string>
+
+int main(int argc, char** argv) {
+    std::string in = argc > 1 ? argv[1] : "state/vocab.txt";
+    std::string out = argc > 2 ? argv[2] : "state/vocab.bin";
+    std::size_t dim = argc > 3 ? std::stoul(argv[3]) : 384;
+
+    auto start = std::chrono::steady_clock::now();
+    std::size_t words = 0;
+    if (!dnn::EmbeddingStore::convert_text(in, out, dim, &words)) {
+        std::cerr << "Failed to convert " << in << " -> " << out << std::endl;
+        return 1;
+    }
+    auto convert_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    // Report what startup now costs: a validated mmap instead of a text parse
+    start = std::chrono::steady_clock::now();
+    dnn::EmbeddingStore store(dim);
+    bool mapped = store.map_file(out);
+    auto map_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Converted " << words << " words (dim " << dim << ") in " << convert_ms << " ms; "
+              << "mapping " << out << (mapped ? " takes " : " FAILED after ") << map_ms << " ms" << std::endl;
+    return mapped ? 0 : 1;
+}